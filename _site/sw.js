@@ -1,25 +1,78 @@
 // Service Worker för SWEREF 99 TM PWA
 // Hanterar offline-caching av alla nödvändiga resurser
 
-const CACHE_VERSION = '28';
+importScripts('/byte-lru.js');
+
+const CACHE_VERSION = '54';
 const CACHE_NAME = `sweref99-${CACHE_VERSION}`;
 
+// Kartrutor cachas när de används, i en egen cache som överlever
+// uppdateringar av appen. Versionen byts bara när rutornas format ändras.
+const TILE_CACHE_NAME = 'sweref99-tiles-1';
+const TILE_PATH_PREFIX = '/tiles/';
+const TILE_CACHE_MAX_BYTES = 25 * 1024 * 1024;
+const TILE_BYTES_HEADER = 'X-Tile-Bytes';
+const TILE_STORED_HEADER = 'X-Tile-Stored';
+
 // Alla resurser som behövs för att appen ska fungera offline
 const ASSETS_TO_CACHE = [
 	'/',
 	'/index.html',
 	'/om.html',
+	'/konvertera.html',
 	'/stil.css',
 	'/pico.min.css',
 	'/script.js',
-	'/proj4.js',
+	'/track-codec.js',
+	'/track-store.js',
+	'/map-sheet.js',
+	'/byte-lru.js',
+	'/map-tile.js',
+	'/map-view.js',
+	'/time-series.js',
+	'/quality-chart.js',
+	'/fix-list.js',
+	'/track-export.js',
+	'/track-simplify.js',
+	'/track-worker.js',
+	'/track-plot.js',
+	'/track-plot-worker.js',
+	'/tab-leader.js',
+	'/gnss-parser.js',
+	'/position-source.js',
+	'/position-filter.js',
+	'/motion-estimator.js',
+	'/measurement.js',
+	'/waypoint-index.js',
+	'/waypoint-store.js',
+	'/geo-xml-import.js',
+	'/stake-out.js',
+	'/geofence-index.js',
+	'/geofence-store.js',
+	'/flatgeobuf-export.js',
+	'/admin-area-codec.js',
+	'/admin-area-index.js',
+	'/gazetteer.js',
+	'/replay-source.js',
+	'/replay-harness.js',
+	'/sweref-projection.js',
+	'/csv-convert.js',
+	'/csv-convert-worker.js',
+	'/csv-convert-page.js',
+	'/sweden-territory-data.js',
+	'/sweden-territory.js',
 	'/app.webmanifest',
 	'/favicon.ico',
 	'/icon-192.png',
 	'/icon-512.png',
 	'/apple-touch-icon.png'
 ];
-const PRECACHED_ASSET_PATHS = new Set(ASSETS_TO_CACHE);
+// Data som inte ingår i alla byggen; saknas filen installeras appen ändå
+const OPTIONAL_ASSETS_TO_CACHE = [
+	'/admin-areas.bin',
+	'/places.bin'
+];
+const PRECACHED_ASSET_PATHS = new Set([...ASSETS_TO_CACHE, ...OPTIONAL_ASSETS_TO_CACHE]);
 
 function createTextResponse(message, status) {
 	return new Response(message, {
@@ -71,6 +124,79 @@ async function cacheResponse(request, response) {
 	return response;
 }
 
+function isTileRequest(request) {
+	const url = new URL(request.url);
+	return url.origin === self.location.origin && url.pathname.startsWith(TILE_PATH_PREFIX);
+}
+
+let tileIndexPromise = null;
+
+/**
+ * LRU-index över de cachade rutorna och deras storlek
+ * Byggs om från cachen när service workern startar. Ordningen mellan
+ * starterna är då den ordning rutorna sparades i, inte senaste användning.
+ */
+function getTileIndex() {
+	tileIndexPromise ??= (async () => {
+		const index = new ByteLru(TILE_CACHE_MAX_BYTES);
+		const cache = await caches.open(TILE_CACHE_NAME);
+		const entries = [];
+		for (const request of await cache.keys()) {
+			const response = await cache.match(request);
+			entries.push({
+				url: request.url,
+				bytes: Number(response?.headers.get(TILE_BYTES_HEADER)) || 0,
+				stored: Number(response?.headers.get(TILE_STORED_HEADER)) || 0
+			});
+		}
+		entries.sort((a, b) => a.stored - b.stored);
+		const evicted = entries.flatMap((entry) => index.set(entry.url, null, entry.bytes));
+		await Promise.all(evicted.map((url) => cache.delete(url)));
+		return index;
+	})();
+	return tileIndexPromise;
+}
+
+/**
+ * Svarar med en ruta ur rutcachen eller hämtar och cachar den
+ * Cachen hålls under TILE_CACHE_MAX_BYTES genom att rutorna som använts
+ * längst sedan tas bort. Rutor som saknas (404) cachas inte.
+ */
+async function handleTileRequest(request) {
+	const [cache, index] = await Promise.all([caches.open(TILE_CACHE_NAME), getTileIndex()]);
+	const cachedResponse = await cache.match(request);
+	if (cachedResponse) {
+		index.get(request.url);
+		return cachedResponse;
+	}
+
+	try {
+		const response = await fetch(request);
+		if (!response.ok) {
+			return response;
+		}
+		const body = await response.arrayBuffer();
+		const stored = new Response(body, {
+			headers: new Headers({
+				'Content-Type': response.headers.get('Content-Type') ?? 'application/octet-stream',
+				[TILE_BYTES_HEADER]: String(body.byteLength),
+				[TILE_STORED_HEADER]: String(Date.now())
+			})
+		});
+		try {
+			await cache.put(request, stored.clone());
+			const evicted = index.set(request.url, null, body.byteLength);
+			await Promise.all(evicted.map((url) => cache.delete(url)));
+		} catch (error) {
+			console.warn('ServiceWorker: Kunde inte cacha kartruta:', error);
+		}
+		return stored;
+	} catch (error) {
+		console.error('ServiceWorker: Kartruta kunde inte hämtas:', error);
+		return createTextResponse('Offline och kartrutan saknas i cache', 503);
+	}
+}
+
 async function handleRequest(request) {
 	const cachedResponse = await caches.match(request);
 	if (cachedResponse) {
@@ -92,7 +218,10 @@ self.addEventListener('install', (event) => {
 		caches.open(CACHE_NAME)
 			.then((cache) => {
 				console.log('ServiceWorker: Cachar resurser');
-				return cache.addAll(ASSETS_TO_CACHE);
+				return cache.addAll(ASSETS_TO_CACHE)
+					.then(() => Promise.all(OPTIONAL_ASSETS_TO_CACHE.map((asset) => cache.add(asset).catch(() => {
+						console.log('ServiceWorker: Valfri resurs saknas:', asset);
+					}))));
 			})
 			.then(() => {
 				// Aktivera den nya service workern direkt
@@ -112,7 +241,7 @@ self.addEventListener('activate', (event) => {
 			.then((cacheNames) => {
 				return Promise.all(
 					cacheNames
-						.filter((cacheName) => cacheName !== CACHE_NAME)
+						.filter((cacheName) => cacheName !== CACHE_NAME && cacheName !== TILE_CACHE_NAME)
 						.map((cacheName) => {
 							console.log('ServiceWorker: Tar bort gammal cache:', cacheName);
 							return caches.delete(cacheName);
@@ -136,7 +265,7 @@ self.addEventListener('fetch', (event) => {
 	}
 
 	event.respondWith(
-		handleRequest(event.request)
+		(isTileRequest(event.request) ? handleTileRequest(event.request) : handleRequest(event.request))
 			.catch((error) => {
 				console.error('ServiceWorker: Cache match misslyckades:', error);
 				return createTextResponse('Cache-fel', 500);
@@ -0,0 +1,182 @@
+// Genererar _site/admin-areas.bin ur kommungränser i GeoJSON.
+//
+// Usage: node scripts/generate-admin-areas.mjs <kommuner.geojson> <admin-areas.bin> [tolerans i meter]
+//
+// Indata är en polygon eller multipolygon per kommun i WGS 84 eller
+// SWEREF 99 TM, t.ex. Lantmäteriets eller SCB:s öppna kommungränser.
+// Kommunkod och namn läses ur de vanligaste egenskapsnamnen; länskoden är de
+// två första siffrorna i kommunkoden om den saknas. Varje ring förenklas med
+// Douglas–Peucker (standard 50 m) och avrundas till hela meter. Kommunerna
+// förenklas var för sig, så längs en gemensam gräns kan glipor och överlapp
+// upp till toleransen uppstå.
+
+import fs from 'node:fs';
+import path from 'node:path';
+import { fileURLToPath } from 'node:url';
+import { stripTypeScriptTypes } from 'node:module';
+
+const DEFAULT_TOLERANCE_METERS = 50;
+const PROJECTED_THRESHOLD = 1000;
+
+const MUNICIPALITY_CODE_PROPERTIES = ['kommunkod', 'KnKod', 'KOMMUNKOD', 'kom_kod', 'code', 'id'];
+const MUNICIPALITY_NAME_PROPERTIES = ['kommunnamn', 'KnNamn', 'KOMMUNNAMN', 'kom_namn', 'namn', 'name'];
+const COUNTY_CODE_PROPERTIES = ['lanskod', 'länskod', 'LnKod', 'LANSKOD', 'lan_kod'];
+const COUNTY_NAME_PROPERTIES = ['lansnamn', 'länsnamn', 'LnNamn', 'LANSNAMN', 'lan_namn'];
+
+/**
+ * Länsnamn per länskod, används när indata saknar länsnamn
+ */
+const COUNTY_NAMES = {
+	'01': 'Stockholms län',
+	'03': 'Uppsala län',
+	'04': 'Södermanlands län',
+	'05': 'Östergötlands län',
+	'06': 'Jönköpings län',
+	'07': 'Kronobergs län',
+	'08': 'Kalmar län',
+	'09': 'Gotlands län',
+	'10': 'Blekinge län',
+	'12': 'Skåne län',
+	'13': 'Hallands län',
+	'14': 'Västra Götalands län',
+	'17': 'Värmlands län',
+	'18': 'Örebro län',
+	'19': 'Västmanlands län',
+	'20': 'Dalarnas län',
+	'21': 'Gävleborgs län',
+	'22': 'Västernorrlands län',
+	'23': 'Jämtlands län',
+	'24': 'Västerbottens län',
+	'25': 'Norrbottens län'
+};
+
+const root = path.join(path.dirname(fileURLToPath(import.meta.url)), '..');
+const source = ['sweref-projection.ts', 'track-codec.ts', 'admin-area-codec.ts']
+	.map((name) => stripTypeScriptTypes(fs.readFileSync(path.join(root, 'src', name), 'utf8')))
+	.join('\n');
+const { projectToSweref99tm, encodeAdminAreas } = new Function(`${source}\nreturn { projectToSweref99tm, encodeAdminAreas };`)();
+
+const [input, output, toleranceArgument] = process.argv.slice(2);
+if (!input || !output) {
+	console.error('Usage: node scripts/generate-admin-areas.mjs <kommuner.geojson> <admin-areas.bin> [tolerance]');
+	process.exit(1);
+}
+const tolerance = toleranceArgument !== undefined ? Number(toleranceArgument) : DEFAULT_TOLERANCE_METERS;
+
+function readProperty(properties, keys) {
+	for (const key of keys) {
+		const value = properties?.[key];
+		if (typeof value === 'string' && value.trim() !== '') {
+			return value.trim();
+		}
+		if (typeof value === 'number') {
+			return String(value);
+		}
+	}
+	return null;
+}
+
+function toSweref([x, y]) {
+	if (Math.abs(x) > PROJECTED_THRESHOLD || Math.abs(y) > PROJECTED_THRESHOLD) {
+		return [Math.max(x, y), Math.min(x, y)];
+	}
+	const projected = projectToSweref99tm(y, x);
+	return [projected.northing, projected.easting];
+}
+
+/**
+ * Douglas–Peucker on a closed ring given without its closing point
+ */
+function simplifyRing(points) {
+	const keep = new Uint8Array(points.length);
+	keep[0] = 1;
+	keep[points.length - 1] = 1;
+	// Dela ringen vid punkten längst från startpunkten så att båda halvorna är öppna linjer
+	let far = 0;
+	let farDistance = -1;
+	points.forEach(([n, e], i) => {
+		const distance = Math.hypot(n - points[0][0], e - points[0][1]);
+		if (distance > farDistance) {
+			far = i;
+			farDistance = distance;
+		}
+	});
+	keep[far] = 1;
+	const stack = [[0, far], [far, points.length - 1]];
+	while (stack.length > 0) {
+		const [first, last] = stack.pop();
+		const [n1, e1] = points[first];
+		const [n2, e2] = points[last];
+		const length = Math.hypot(n2 - n1, e2 - e1);
+		let worst = -1;
+		let worstDistance = tolerance;
+		for (let i = first + 1; i < last; i++) {
+			const [n, e] = points[i];
+			const distance = length === 0
+				? Math.hypot(n - n1, e - e1)
+				: Math.abs((n2 - n1) * (e1 - e) - (n1 - n) * (e2 - e1)) / length;
+			if (distance > worstDistance) {
+				worst = i;
+				worstDistance = distance;
+			}
+		}
+		if (worst >= 0) {
+			keep[worst] = 1;
+			stack.push([first, worst], [worst, last]);
+		}
+	}
+	return points.filter((_, i) => keep[i] === 1);
+}
+
+const geojson = JSON.parse(fs.readFileSync(input, 'utf8'));
+const areas = [];
+let inputPoints = 0;
+for (const feature of geojson.features ?? []) {
+	const { geometry, properties } = feature;
+	if (!geometry || (geometry.type !== 'Polygon' && geometry.type !== 'MultiPolygon')) {
+		continue;
+	}
+	const municipalityCode = readProperty(properties, MUNICIPALITY_CODE_PROPERTIES) ?? '';
+	const countyCode = readProperty(properties, COUNTY_CODE_PROPERTIES) ?? municipalityCode.slice(0, 2);
+	const polygons = geometry.type === 'MultiPolygon' ? geometry.coordinates : [geometry.coordinates];
+	const coordinates = [];
+	const ringStarts = [0];
+	for (const polygon of polygons) {
+		for (const ring of polygon) {
+			inputPoints += ring.length;
+			let points = ring.map(toSweref).map(([n, e]) => [Math.round(n), Math.round(e)]);
+			// GeoJSON upprepar första punkten sist
+			points = points.filter(([n, e], i) => i === 0 || n !== points[i - 1][0] || e !== points[i - 1][1]);
+			if (points.length > 1 && points[0][0] === points[points.length - 1][0] && points[0][1] === points[points.length - 1][1]) {
+				points.pop();
+			}
+			if (points.length < 3) {
+				continue;
+			}
+			points = simplifyRing(points);
+			if (points.length < 3) {
+				continue;
+			}
+			for (const [n, e] of points) {
+				coordinates.push(n, e);
+			}
+			ringStarts.push(coordinates.length / 2);
+		}
+	}
+	if (ringStarts.length > 1) {
+		areas.push({
+			municipalityCode,
+			municipalityName: readProperty(properties, MUNICIPALITY_NAME_PROPERTIES) ?? municipalityCode,
+			countyCode,
+			countyName: readProperty(properties, COUNTY_NAME_PROPERTIES) ?? COUNTY_NAMES[countyCode] ?? '',
+			coordinates: Int32Array.from(coordinates),
+			ringStarts: Int32Array.from(ringStarts)
+		});
+	}
+}
+areas.sort((a, b) => a.municipalityCode.localeCompare(b.municipalityCode));
+
+const bytes = encodeAdminAreas(areas);
+fs.writeFileSync(output, bytes);
+const outputPoints = areas.reduce((sum, area) => sum + area.coordinates.length / 2, 0);
+console.error(`${areas.length} områden, ${inputPoints} → ${outputPoints} punkter, ${bytes.length} byte`);
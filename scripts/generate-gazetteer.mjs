@@ -0,0 +1,28 @@
+// Genererar _site/places.bin ur en ortnamnslista i CSV.
+//
+// Usage: node scripts/generate-gazetteer.mjs <orter.csv> <places.bin>
+//
+// Indata har samma format som vid import av punkter: namn;latitud;longitud
+// i WGS 84 eller namn;N;E i SWEREF 99 TM, en ort per rad.
+
+import fs from 'node:fs';
+import path from 'node:path';
+import { fileURLToPath } from 'node:url';
+import { stripTypeScriptTypes } from 'node:module';
+
+const root = path.join(path.dirname(fileURLToPath(import.meta.url)), '..');
+const source = ['sweref-projection.ts', 'waypoint-store.ts', 'gazetteer.ts']
+	.map((name) => stripTypeScriptTypes(fs.readFileSync(path.join(root, 'src', name), 'utf8')))
+	.join('\n');
+const { parseWaypointCsv, encodeGazetteer } = new Function(`${source}\nreturn { parseWaypointCsv, encodeGazetteer };`)();
+
+const [input, output] = process.argv.slice(2);
+if (!input || !output) {
+	console.error('Usage: node scripts/generate-gazetteer.mjs <places.csv> <places.bin>');
+	process.exit(1);
+}
+
+const places = parseWaypointCsv(fs.readFileSync(input, 'utf8'));
+const bytes = encodeGazetteer(places);
+fs.writeFileSync(output, bytes);
+console.error(`${places.length} orter, ${bytes.length} byte`);
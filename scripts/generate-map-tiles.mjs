@@ -0,0 +1,302 @@
+// Genererar kartrutorna i _site/tiles ur GeoJSON och ortnamnslistor.
+//
+// Usage: node scripts/generate-map-tiles.mjs <katalog> <indata>...
+//
+// Indata är GeoJSON i WGS 84 eller SWEREF 99 TM, eller CSV i samma format
+// som ortnamnslistan (namn;latitud;longitud eller namn;N;E). Egenskapen
+// "kind" (land, water, border, road eller place) anger vad ett objekt är;
+// utan den ritas polygoner som gränslinjer, linjer som vägar och punkter som
+// orter. Objekten klipps till varje rutstorlek i kartbladsindelningen och
+// förenklas mer ju större rutan är. Katalogen töms först.
+
+import fs from 'node:fs';
+import path from 'node:path';
+import { fileURLToPath } from 'node:url';
+import { stripTypeScriptTypes } from 'node:module';
+
+const PROJECTED_THRESHOLD = 1000;
+/** Förenklingstolerans som andel av rutstorleken */
+const TOLERANCE_PER_TILE_SIZE = 1 / 500;
+
+const root = path.join(path.dirname(fileURLToPath(import.meta.url)), '..');
+const source = ['sweref-projection.ts', 'track-codec.ts', 'waypoint-store.ts', 'map-sheet.ts', 'map-tile.ts']
+	.map((name) => stripTypeScriptTypes(fs.readFileSync(path.join(root, 'src', name), 'utf8')))
+	.join('\n');
+const {
+	projectToSweref99tm,
+	parseWaypointCsv,
+	MAP_SHEET_SIZES,
+	MAP_FEATURE_KIND,
+	MAP_GEOMETRY,
+	mapTileKey,
+	encodeMapTile
+} = new Function(`${source}\nreturn { projectToSweref99tm, parseWaypointCsv, MAP_SHEET_SIZES, MAP_FEATURE_KIND, MAP_GEOMETRY, mapTileKey, encodeMapTile };`)();
+
+const [outputDirectory, ...inputs] = process.argv.slice(2);
+if (!outputDirectory || inputs.length === 0) {
+	console.error('Usage: node scripts/generate-map-tiles.mjs <directory> <input.geojson|input.csv>...');
+	process.exit(1);
+}
+
+const KINDS = {
+	land: MAP_FEATURE_KIND.LAND,
+	water: MAP_FEATURE_KIND.WATER,
+	border: MAP_FEATURE_KIND.BORDER,
+	road: MAP_FEATURE_KIND.ROAD,
+	place: MAP_FEATURE_KIND.PLACE
+};
+
+function toSweref([x, y]) {
+	if (Math.abs(x) > PROJECTED_THRESHOLD || Math.abs(y) > PROJECTED_THRESHOLD) {
+		return [Math.max(x, y), Math.min(x, y)];
+	}
+	const projected = projectToSweref99tm(y, x);
+	return [projected.northing, projected.easting];
+}
+
+/**
+ * Douglas–Peucker on an open line
+ */
+function simplifyLine(points, tolerance) {
+	if (points.length < 3) {
+		return points;
+	}
+	const keep = new Uint8Array(points.length);
+	keep[0] = 1;
+	keep[points.length - 1] = 1;
+	const stack = [[0, points.length - 1]];
+	while (stack.length > 0) {
+		const [first, last] = stack.pop();
+		const [n1, e1] = points[first];
+		const [n2, e2] = points[last];
+		const length = Math.hypot(n2 - n1, e2 - e1);
+		let worst = -1;
+		let worstDistance = tolerance;
+		for (let i = first + 1; i < last; i++) {
+			const [n, e] = points[i];
+			const distance = length === 0
+				? Math.hypot(n - n1, e - e1)
+				: Math.abs((n2 - n1) * (e1 - e) - (n1 - n) * (e2 - e1)) / length;
+			if (distance > worstDistance) {
+				worst = i;
+				worstDistance = distance;
+			}
+		}
+		if (worst >= 0) {
+			keep[worst] = 1;
+			stack.push([first, worst], [worst, last]);
+		}
+	}
+	return points.filter((_, i) => keep[i] === 1);
+}
+
+/**
+ * Clips a line to a rectangle (Liang–Barsky per segment)
+ * @returns The pieces inside the rectangle
+ */
+function clipLine(points, minN, minE, maxN, maxE) {
+	const pieces = [];
+	let current = null;
+	for (let i = 0; i + 1 < points.length; i++) {
+		const [n1, e1] = points[i];
+		const [n2, e2] = points[i + 1];
+		const dn = n2 - n1;
+		const de = e2 - e1;
+		let t0 = 0;
+		let t1 = 1;
+		const limits = [[-de, e1 - minE], [de, maxE - e1], [-dn, n1 - minN], [dn, maxN - n1]];
+		let outside = false;
+		for (const [p, q] of limits) {
+			if (p === 0) {
+				if (q < 0) {
+					outside = true;
+					break;
+				}
+				continue;
+			}
+			const t = q / p;
+			if (p < 0) {
+				t0 = Math.max(t0, t);
+			} else {
+				t1 = Math.min(t1, t);
+			}
+		}
+		if (outside || t0 > t1) {
+			current = null;
+			continue;
+		}
+		const start = [n1 + t0 * dn, e1 + t0 * de];
+		const end = [n1 + t1 * dn, e1 + t1 * de];
+		if (current === null || t0 > 0) {
+			current = [start];
+			pieces.push(current);
+		}
+		current.push(end);
+		if (t1 < 1) {
+			current = null;
+		}
+	}
+	return pieces;
+}
+
+/**
+ * Clips a closed ring to a rectangle (Sutherland–Hodgman)
+ */
+function clipRing(points, minN, minE, maxN, maxE) {
+	const edges = [
+		[(p) => p[1] >= minE, (a, b) => { const t = (minE - a[1]) / (b[1] - a[1]); return [a[0] + t * (b[0] - a[0]), minE]; }],
+		[(p) => p[1] <= maxE, (a, b) => { const t = (maxE - a[1]) / (b[1] - a[1]); return [a[0] + t * (b[0] - a[0]), maxE]; }],
+		[(p) => p[0] >= minN, (a, b) => { const t = (minN - a[0]) / (b[0] - a[0]); return [minN, a[1] + t * (b[1] - a[1])]; }],
+		[(p) => p[0] <= maxN, (a, b) => { const t = (maxN - a[0]) / (b[0] - a[0]); return [maxN, a[1] + t * (b[1] - a[1])]; }]
+	];
+	let ring = points;
+	for (const [inside, intersect] of edges) {
+		const clipped = [];
+		for (let i = 0; i < ring.length; i++) {
+			const current = ring[i];
+			const previous = ring[(i + ring.length - 1) % ring.length];
+			if (inside(current)) {
+				if (!inside(previous)) {
+					clipped.push(intersect(previous, current));
+				}
+				clipped.push(current);
+			} else if (inside(previous)) {
+				clipped.push(intersect(previous, current));
+			}
+		}
+		ring = clipped;
+		if (ring.length === 0) {
+			break;
+		}
+	}
+	return ring;
+}
+
+/**
+ * Reads the inputs as features with SWEREF 99 TM parts:
+ * { kind, geometry, name, parts: [[n, e], ...][] }
+ */
+function readFeatures(file) {
+	const text = fs.readFileSync(file, 'utf8');
+	if (file.endsWith('.csv')) {
+		return parseWaypointCsv(text).map((place) => ({
+			kind: MAP_FEATURE_KIND.PLACE,
+			geometry: MAP_GEOMETRY.POINT,
+			name: place.name,
+			parts: [[[place.northing, place.easting]]]
+		}));
+	}
+	const features = [];
+	for (const feature of JSON.parse(text).features ?? []) {
+		const { geometry, properties } = feature;
+		if (!geometry) {
+			continue;
+		}
+		const kind = KINDS[properties?.kind];
+		const name = String(properties?.name ?? properties?.namn ?? '');
+		const project = (line) => line.map(toSweref);
+		switch (geometry.type) {
+			case 'Point':
+				features.push({ kind: kind ?? MAP_FEATURE_KIND.PLACE, geometry: MAP_GEOMETRY.POINT, name, parts: [[toSweref(geometry.coordinates)]] });
+				break;
+			case 'LineString':
+			case 'MultiLineString': {
+				const lines = geometry.type === 'LineString' ? [geometry.coordinates] : geometry.coordinates;
+				features.push({ kind: kind ?? MAP_FEATURE_KIND.ROAD, geometry: MAP_GEOMETRY.LINE, name, parts: lines.map(project) });
+				break;
+			}
+			case 'Polygon':
+			case 'MultiPolygon': {
+				const rings = (geometry.type === 'Polygon' ? [geometry.coordinates] : geometry.coordinates).flat();
+				const filled = kind === MAP_FEATURE_KIND.LAND || kind === MAP_FEATURE_KIND.WATER;
+				features.push({
+					kind: kind ?? MAP_FEATURE_KIND.BORDER,
+					geometry: filled ? MAP_GEOMETRY.POLYGON : MAP_GEOMETRY.LINE,
+					name,
+					// GeoJSON upprepar första punkten sist; fyllda ytor stängs av ritningen
+					parts: rings.map((ring) => (filled ? project(ring.slice(0, -1)) : project(ring)))
+				});
+				break;
+			}
+		}
+	}
+	return features;
+}
+
+function bounds(parts) {
+	let minN = Infinity;
+	let minE = Infinity;
+	let maxN = -Infinity;
+	let maxE = -Infinity;
+	for (const part of parts) {
+		for (const [n, e] of part) {
+			minN = Math.min(minN, n);
+			minE = Math.min(minE, e);
+			maxN = Math.max(maxN, n);
+			maxE = Math.max(maxE, e);
+		}
+	}
+	return { minN, minE, maxN, maxE };
+}
+
+const features = inputs.flatMap(readFeatures);
+fs.rmSync(outputDirectory, { recursive: true, force: true });
+
+for (const size of MAP_SHEET_SIZES) {
+	const tolerance = size * TOLERANCE_PER_TILE_SIZE;
+	const tiles = new Map();
+	for (const feature of features) {
+		const parts = feature.geometry === MAP_GEOMETRY.POINT
+			? feature.parts
+			: feature.parts.map((part) => simplifyLine(part, tolerance));
+		const box = bounds(parts);
+		for (let row = Math.floor(box.minN / size); row <= Math.floor(box.maxN / size); row++) {
+			for (let column = Math.floor(box.minE / size); column <= Math.floor(box.maxE / size); column++) {
+				const minN = row * size;
+				const minE = column * size;
+				const maxN = minN + size;
+				const maxE = minE + size;
+				let pieces;
+				if (feature.geometry === MAP_GEOMETRY.POINT) {
+					pieces = parts.filter(([[n, e]]) => n >= minN && n < maxN && e >= minE && e < maxE);
+				} else if (feature.geometry === MAP_GEOMETRY.POLYGON) {
+					pieces = parts.map((ring) => clipRing(ring, minN, minE, maxN, maxE)).filter((ring) => ring.length >= 3);
+				} else {
+					pieces = parts.flatMap((line) => clipLine(line, minN, minE, maxN, maxE));
+				}
+				pieces = pieces
+					.map((piece) => piece.map(([n, e]) => [Math.round(n), Math.round(e)]))
+					.map((piece) => piece.filter(([n, e], i) => i === 0 || n !== piece[i - 1][0] || e !== piece[i - 1][1]))
+					.filter((piece) => piece.length >= (feature.geometry === MAP_GEOMETRY.POINT ? 1 : 2));
+				if (pieces.length === 0) {
+					continue;
+				}
+				const key = mapTileKey(size, row, column);
+				if (!tiles.has(key)) {
+					tiles.set(key, { size, minNorthing: minN, minEasting: minE, features: [] });
+				}
+				const ringStarts = [0];
+				for (const piece of pieces) {
+					ringStarts.push(ringStarts[ringStarts.length - 1] + piece.length);
+				}
+				tiles.get(key).features.push({
+					kind: feature.kind,
+					geometry: feature.geometry,
+					name: feature.name,
+					coordinates: Int32Array.from(pieces.flat(2)),
+					ringStarts: Int32Array.from(ringStarts)
+				});
+			}
+		}
+	}
+
+	let bytes = 0;
+	for (const [key, tile] of tiles) {
+		const file = path.join(outputDirectory, `${key}.bin`);
+		fs.mkdirSync(path.dirname(file), { recursive: true });
+		const encoded = encodeMapTile(tile);
+		fs.writeFileSync(file, encoded);
+		bytes += encoded.length;
+	}
+	console.error(`${size / 1000} km: ${tiles.size} rutor, ${bytes} byte`);
+}
@@ -0,0 +1,243 @@
+// Genererar src/sweden-territory-data.ts ur en GeoJSON-polygon över Sveriges
+// territorium (land och territorialhav) i WGS 84.
+//
+// Usage: node scripts/generate-territory.mjs data/sweden-territory.geojson [tolerans i meter] > src/sweden-territory-data.ts
+//
+// Polygonen projiceras till SWEREF 99 TM med appens egen projektion,
+// förenklas med Douglas–Peucker (standard 50 m) så att ett detaljerat
+// gränsdataset, t.ex. Lantmäteriets, ger ett hanterbart antal kanter, och
+// läggs över ett rutnät. Varje ruta får ett av fyra lägen: helt utanför,
+// helt innanför, eller gränsruta med mittpunkten utanför respektive
+// innanför. För gränsrutorna sparas de polygonkanter som skär rutan, så att
+// en position i en gränsruta bara behöver testas mot dessa kanter.
+
+import fs from 'node:fs';
+import path from 'node:path';
+import { fileURLToPath } from 'node:url';
+import { stripTypeScriptTypes } from 'node:module';
+
+const CELL_SIZE = 5000;
+const DEFAULT_TOLERANCE_METERS = 50;
+// Rutnätets utbredning i SWEREF 99 TM, med marginal runt territoriet
+const MIN_NORTHING = 6080000;
+const MAX_NORTHING = 7700000;
+const MIN_EASTING = 160000;
+const MAX_EASTING = 980000;
+
+const STATE_OUTSIDE = 0;
+const STATE_INSIDE = 1;
+const STATE_BORDER_OUTSIDE = 2;
+const STATE_BORDER_INSIDE = 3;
+
+const root = path.join(path.dirname(fileURLToPath(import.meta.url)), '..');
+const projectionSource = stripTypeScriptTypes(fs.readFileSync(path.join(root, 'src', 'sweref-projection.ts'), 'utf8'));
+const projectToSweref99tm = new Function(`${projectionSource}\nreturn projectToSweref99tm;`)();
+
+const [input, toleranceArgument] = process.argv.slice(2);
+if (!input) {
+	console.error('Usage: node scripts/generate-territory.mjs <territory.geojson> [tolerance]');
+	process.exit(1);
+}
+const tolerance = toleranceArgument !== undefined ? Number(toleranceArgument) : DEFAULT_TOLERANCE_METERS;
+const geojson = JSON.parse(fs.readFileSync(input, 'utf8'));
+
+/**
+ * Douglas–Peucker on a closed ring given without its closing point
+ */
+function simplifyRing(points) {
+	const keep = new Uint8Array(points.length);
+	keep[0] = 1;
+	keep[points.length - 1] = 1;
+	// Dela ringen vid punkten längst från startpunkten så att båda halvorna är öppna linjer
+	let far = 0;
+	let farDistance = -1;
+	points.forEach(([n, e], i) => {
+		const distance = Math.hypot(n - points[0][0], e - points[0][1]);
+		if (distance > farDistance) {
+			far = i;
+			farDistance = distance;
+		}
+	});
+	keep[far] = 1;
+	const stack = [[0, far], [far, points.length - 1]];
+	while (stack.length > 0) {
+		const [first, last] = stack.pop();
+		const [n1, e1] = points[first];
+		const [n2, e2] = points[last];
+		const length = Math.hypot(n2 - n1, e2 - e1);
+		let worst = -1;
+		let worstDistance = tolerance;
+		for (let i = first + 1; i < last; i++) {
+			const [n, e] = points[i];
+			const distance = length === 0
+				? Math.hypot(n - n1, e - e1)
+				: Math.abs((n2 - n1) * (e1 - e) - (n1 - n) * (e2 - e1)) / length;
+			if (distance > worstDistance) {
+				worst = i;
+				worstDistance = distance;
+			}
+		}
+		if (worst >= 0) {
+			keep[worst] = 1;
+			stack.push([first, worst], [worst, last]);
+		}
+	}
+	return points.filter((_, i) => keep[i] === 1);
+}
+
+// Kanter som fyra tal: nord och öst för start- och slutpunkt, hela meter
+const edges = [];
+let inputPoints = 0;
+for (const feature of geojson.features) {
+	const { geometry } = feature;
+	const polygons = geometry.type === 'MultiPolygon' ? geometry.coordinates : [geometry.coordinates];
+	for (const polygon of polygons) {
+		for (const ring of polygon) {
+			inputPoints += ring.length;
+			let points = ring.map(([longitude, latitude]) => {
+				const projected = projectToSweref99tm(latitude, longitude);
+				return [Math.round(projected.northing), Math.round(projected.easting)];
+			});
+			// GeoJSON upprepar första punkten sist
+			points = points.filter(([n, e], i) => i === 0 || n !== points[i - 1][0] || e !== points[i - 1][1]);
+			if (points.length > 1 && points[0][0] === points[points.length - 1][0] && points[0][1] === points[points.length - 1][1]) {
+				points.pop();
+			}
+			if (points.length < 3) {
+				continue;
+			}
+			points = simplifyRing(points);
+			for (let i = 0; i < points.length; i++) {
+				edges.push([...points[i], ...points[(i + 1) % points.length]]);
+			}
+		}
+	}
+}
+
+function isInside(north, east) {
+	let inside = false;
+	for (const [n1, e1, n2, e2] of edges) {
+		if ((n1 > north) !== (n2 > north) && east < e1 + (north - n1) * (e2 - e1) / (n2 - n1)) {
+			inside = !inside;
+		}
+	}
+	return inside;
+}
+
+/**
+ * Liang–Barsky: does the edge touch the closed rectangle?
+ */
+function edgeTouchesCell(edge, minNorth, minEast, maxNorth, maxEast) {
+	const [n1, e1, n2, e2] = edge;
+	let t0 = 0;
+	let t1 = 1;
+	const dn = n2 - n1;
+	const de = e2 - e1;
+	const clips = [[-dn, n1 - minNorth], [dn, maxNorth - n1], [-de, e1 - minEast], [de, maxEast - e1]];
+	for (const [p, q] of clips) {
+		if (p === 0) {
+			if (q < 0) {
+				return false;
+			}
+		} else {
+			const t = q / p;
+			if (p < 0) {
+				t0 = Math.max(t0, t);
+			} else {
+				t1 = Math.min(t1, t);
+			}
+			if (t0 > t1) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+const columns = Math.ceil((MAX_EASTING - MIN_EASTING) / CELL_SIZE);
+const rows = Math.ceil((MAX_NORTHING - MIN_NORTHING) / CELL_SIZE);
+const states = new Uint8Array(Math.ceil(rows * columns / 4));
+const borderEdgeStarts = [0];
+const borderEdges = [];
+let borderCellCount = 0;
+
+for (let row = 0; row < rows; row++) {
+	for (let column = 0; column < columns; column++) {
+		const minNorth = MIN_NORTHING + row * CELL_SIZE;
+		const minEast = MIN_EASTING + column * CELL_SIZE;
+		const crossing = [];
+		edges.forEach((edge, index) => {
+			if (edgeTouchesCell(edge, minNorth, minEast, minNorth + CELL_SIZE, minEast + CELL_SIZE)) {
+				crossing.push(index);
+			}
+		});
+		const centerInside = isInside(minNorth + CELL_SIZE / 2, minEast + CELL_SIZE / 2);
+		let state;
+		if (crossing.length > 0) {
+			state = centerInside ? STATE_BORDER_INSIDE : STATE_BORDER_OUTSIDE;
+			borderEdges.push(...crossing);
+			borderEdgeStarts.push(borderEdges.length);
+			borderCellCount++;
+		} else {
+			state = centerInside ? STATE_INSIDE : STATE_OUTSIDE;
+		}
+		const cell = row * columns + column;
+		states[cell >> 2] |= state << ((cell & 3) * 2);
+	}
+}
+
+const wrap = (values) => {
+	const lines = [];
+	for (let i = 0; i < values.length; i += 16) {
+		lines.push(`\t${values.slice(i, i + 16).join(', ')}`);
+	}
+	return lines.join(',\n');
+};
+const base64 = Buffer.from(states).toString('base64');
+const base64Lines = base64.match(/.{1,96}/g).map((line) => `\t'${line}'`).join(' +\n');
+
+process.stdout.write(`// ============================================================================
+// SWEDISH TERRITORY DATA (generated)
+// ============================================================================
+//
+// Genererad av scripts/generate-territory.mjs från ${path.relative(root, path.resolve(input))}.
+// Ändra inte för hand; kör make src/sweden-territory-data.ts.
+//
+// ${inputPoints} punkter förenklade med toleransen ${tolerance} m till ${edges.length} kanter,
+// ${rows} × ${columns} rutor à ${CELL_SIZE / 1000} km, varav ${borderCellCount} gränsrutor.
+
+const TERRITORY_GRID = {
+	MIN_NORTHING: ${MIN_NORTHING},
+	MIN_EASTING: ${MIN_EASTING},
+	CELL_SIZE: ${CELL_SIZE},
+	COLUMNS: ${columns},
+	ROWS: ${rows}
+} as const;
+
+/**
+ * Two bits per cell, four cells per byte, lowest bits first:
+ * 0 outside, 1 inside, 2 border cell with its centre outside, 3 border cell with its centre inside
+ */
+const TERRITORY_CELL_STATES =
+${base64Lines};
+
+/**
+ * Boundary edges as northing, easting of the start and end point, metres
+ */
+const TERRITORY_EDGES: readonly number[] = [
+${wrap(edges.flat())}
+];
+
+/**
+ * Edges crossing each border cell, border cells in cell order
+ * Border cell b has the edges TERRITORY_BORDER_EDGES[TERRITORY_BORDER_EDGE_STARTS[b]] up to
+ * TERRITORY_BORDER_EDGES[TERRITORY_BORDER_EDGE_STARTS[b + 1] - 1].
+ */
+const TERRITORY_BORDER_EDGE_STARTS: readonly number[] = [
+${wrap(borderEdgeStarts)}
+];
+
+const TERRITORY_BORDER_EDGES: readonly number[] = [
+${wrap(borderEdges)}
+];
+`);
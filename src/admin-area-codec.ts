@@ -0,0 +1,155 @@
+// ============================================================================
+// BINARY ADMINISTRATIVE AREA FORMAT
+// ============================================================================
+//
+// Förenklade kommungränser i SWEREF 99 TM, med län för varje kommun. Hela
+// meter räcker för gränser som ändå är förenklade, och koordinaterna lagras
+// som skillnad mot föregående punkt, zigzag-kodad och skriven som varint
+// (samma teknik som spårblocken i track-codec.ts). En punkt tar därför
+// omkring fyra byte.
+//
+// Layout (little endian):
+//   0  u8[2]  magiskt värde "SK"
+//   2  u8     formatversion
+//   3  u8     reserverad
+//   4  u32    antal områden
+//   8  u32    antal punkter totalt
+//  12         varintdata, för varje område:
+//               kommunkod, kommunnamn, länskod, länsnamn (längd + UTF-8)
+//               antal ringar, antal punkter per ring
+//               N och E för varje punkt som skillnad mot föregående punkt
+//
+// Filen innehåller ingen DOM-kod och kan därför även laddas i Web Workers.
+
+/**
+ * A municipality with the county it belongs to
+ */
+interface AdminArea {
+	municipalityCode: string;
+	municipalityName: string;
+	countyCode: string;
+	countyName: string;
+	/** SWEREF 99 TM northing, easting interleaved, whole metres */
+	coordinates: Int32Array;
+	/** First point of each ring, followed by the point count */
+	ringStarts: Int32Array;
+}
+
+const ADMIN_AREA_MAGIC_0 = 0x53; // 'S'
+const ADMIN_AREA_MAGIC_1 = 0x4b; // 'K'
+const ADMIN_AREA_VERSION = 1;
+const ADMIN_AREA_HEADER_BYTES = 12;
+
+function writeAdminAreaString(writer: ByteWriter, encoder: TextEncoder, text: string): void {
+	const bytes = encoder.encode(text);
+	writer.writeVarint(bytes.length);
+	writer.ensureCapacity(bytes.length);
+	writer.bytes.set(bytes, writer.length);
+	writer.length += bytes.length;
+}
+
+/**
+ * Encodes administrative areas into the binary format
+ */
+function encodeAdminAreas(areas: AdminArea[]): Uint8Array {
+	const encoder = new TextEncoder();
+	const pointCount = areas.reduce((sum, area) => sum + area.coordinates.length / 2, 0);
+	const writer = new ByteWriter(ADMIN_AREA_HEADER_BYTES + pointCount * 4 + areas.length * 64);
+	writer.length = ADMIN_AREA_HEADER_BYTES;
+
+	let previousNorth = 0;
+	let previousEast = 0;
+	for (const area of areas) {
+		writeAdminAreaString(writer, encoder, area.municipalityCode);
+		writeAdminAreaString(writer, encoder, area.municipalityName);
+		writeAdminAreaString(writer, encoder, area.countyCode);
+		writeAdminAreaString(writer, encoder, area.countyName);
+		const ringCount = area.ringStarts.length - 1;
+		writer.writeVarint(ringCount);
+		for (let ring = 0; ring < ringCount; ring++) {
+			writer.writeVarint(area.ringStarts[ring + 1] - area.ringStarts[ring]);
+		}
+		const { coordinates } = area;
+		for (let i = 0; i < coordinates.length; i += 2) {
+			writer.writeVarint(zigzagEncode(coordinates[i] - previousNorth));
+			writer.writeVarint(zigzagEncode(coordinates[i + 1] - previousEast));
+			previousNorth = coordinates[i];
+			previousEast = coordinates[i + 1];
+		}
+	}
+
+	const view = new DataView(writer.bytes.buffer, writer.bytes.byteOffset, ADMIN_AREA_HEADER_BYTES);
+	view.setUint8(0, ADMIN_AREA_MAGIC_0);
+	view.setUint8(1, ADMIN_AREA_MAGIC_1);
+	view.setUint8(2, ADMIN_AREA_VERSION);
+	view.setUint8(3, 0);
+	view.setUint32(4, areas.length, true);
+	view.setUint32(8, pointCount, true);
+	return writer.toUint8Array();
+}
+
+/**
+ * Decodes the binary format
+ * @throws Error if the data is not a supported or complete area file
+ */
+function decodeAdminAreas(bytes: Uint8Array): AdminArea[] {
+	if (bytes.length < ADMIN_AREA_HEADER_BYTES || bytes[0] !== ADMIN_AREA_MAGIC_0 || bytes[1] !== ADMIN_AREA_MAGIC_1) {
+		throw new Error('Ogiltig fil med kommungränser');
+	}
+	const view = new DataView(bytes.buffer, bytes.byteOffset, ADMIN_AREA_HEADER_BYTES);
+	const version = view.getUint8(2);
+	if (version !== ADMIN_AREA_VERSION) {
+		throw new Error(`Kommungränserna har okänd version ${version}`);
+	}
+	const areaCount = view.getUint32(4, true);
+
+	let pos = ADMIN_AREA_HEADER_BYTES;
+	const readVarint = (): number => {
+		let value = 0;
+		let multiplier = 1;
+		let byte: number;
+		do {
+			if (pos >= bytes.length) {
+				throw new Error('Filen med kommungränser är trunkerad');
+			}
+			byte = bytes[pos++];
+			value += (byte & 0x7f) * multiplier;
+			multiplier *= 0x80;
+		} while (byte & 0x80);
+		return value;
+	};
+	const decoder = new TextDecoder();
+	const readString = (): string => {
+		const length = readVarint();
+		if (pos + length > bytes.length) {
+			throw new Error('Filen med kommungränser är trunkerad');
+		}
+		const text = decoder.decode(bytes.subarray(pos, pos + length));
+		pos += length;
+		return text;
+	};
+
+	const areas: AdminArea[] = [];
+	let north = 0;
+	let east = 0;
+	for (let a = 0; a < areaCount; a++) {
+		const municipalityCode = readString();
+		const municipalityName = readString();
+		const countyCode = readString();
+		const countyName = readString();
+		const ringCount = readVarint();
+		const ringStarts = new Int32Array(ringCount + 1);
+		for (let ring = 0; ring < ringCount; ring++) {
+			ringStarts[ring + 1] = ringStarts[ring] + readVarint();
+		}
+		const coordinates = new Int32Array(ringStarts[ringCount] * 2);
+		for (let i = 0; i < coordinates.length; i += 2) {
+			north += zigzagDecode(readVarint());
+			east += zigzagDecode(readVarint());
+			coordinates[i] = north;
+			coordinates[i + 1] = east;
+		}
+		areas.push({ municipalityCode, municipalityName, countyCode, countyName, coordinates, ringStarts });
+	}
+	return areas;
+}
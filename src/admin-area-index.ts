@@ -0,0 +1,311 @@
+// ============================================================================
+// ADMINISTRATIVE AREA INDEX (municipality and county per position)
+// ============================================================================
+//
+// Slår upp kommun och län för en position i SWEREF 99 TM. Ett rutnät läggs
+// över alla kommuner när filen har lästs in. En ruta som ingen gräns går
+// igenom ligger helt i en kommun (eller utanför alla) och ger svaret direkt.
+// I en gränsruta sparas de gränskanter som skär rutan, grupperade per
+// kommun, tillsammans med om rutans mittpunkt ligger i kommunen. Sträckan
+// från mittpunkten till positionen prövas bara mot dessa kanter.
+//
+// Positioner i följd ligger nästan alltid i samma kommun, så i en gränsruta
+// prövas kommunen från förra uppslagningen först.
+//
+// Filen innehåller ingen DOM-kod och kan därför även laddas i Web Workers.
+
+/**
+ * Grid cell size, metres
+ */
+const ADMIN_AREA_CELL_SIZE = 5000;
+
+const ADMIN_AREA_OUTSIDE = -1;
+const ADMIN_AREA_BORDER = -2;
+
+/**
+ * Even-odd point-in-polygon over all rings of an area
+ */
+function isInsideAdminArea(area: AdminArea, northing: number, easting: number): boolean {
+	const { coordinates, ringStarts } = area;
+	let inside = false;
+	for (let ring = 0; ring < ringStarts.length - 1; ring++) {
+		const start = ringStarts[ring];
+		const end = ringStarts[ring + 1];
+		for (let i = start, j = end - 1; i < end; j = i++) {
+			const northI = coordinates[2 * i];
+			const northJ = coordinates[2 * j];
+			if ((northI > northing) !== (northJ > northing)) {
+				const eastI = coordinates[2 * i + 1];
+				const eastJ = coordinates[2 * j + 1];
+				if (easting < eastI + (northing - northI) * (eastJ - eastI) / (northJ - northI)) {
+					inside = !inside;
+				}
+			}
+		}
+	}
+	return inside;
+}
+
+/**
+ * Liang–Barsky test of a segment against a closed rectangle
+ */
+function segmentTouchesRectangle(n1: number, e1: number, n2: number, e2: number,
+	minNorth: number, minEast: number, maxNorth: number, maxEast: number): boolean {
+	let t0 = 0;
+	let t1 = 1;
+	const dn = n2 - n1;
+	const de = e2 - e1;
+	const p = [-dn, dn, -de, de];
+	const q = [n1 - minNorth, maxNorth - n1, e1 - minEast, maxEast - e1];
+	for (let k = 0; k < 4; k++) {
+		if (p[k] === 0) {
+			if (q[k] < 0) {
+				return false;
+			}
+		} else {
+			const t = q[k] / p[k];
+			if (p[k] < 0) {
+				t0 = Math.max(t0, t);
+			} else {
+				t1 = Math.min(t1, t);
+			}
+			if (t0 > t1) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+function isLeftOf(aN: number, aE: number, bN: number, bE: number, pN: number, pE: number): boolean {
+	return (bE - aE) * (pN - aN) - (bN - aN) * (pE - aE) > 0;
+}
+
+class AdminAreaIndex {
+	readonly areas: AdminArea[];
+	private readonly minNorthing: number;
+	private readonly minEasting: number;
+	private readonly cellSize: number;
+	private readonly columns: number;
+	private readonly rows: number;
+	/** Area of each cell, ADMIN_AREA_OUTSIDE, or ADMIN_AREA_BORDER */
+	private readonly cellAreas: Int32Array;
+	/** Edges crossing cell c are cellEdges[cellEdgeStarts[c]] to cellEdges[cellEdgeStarts[c + 1] - 1], grouped by area */
+	private readonly cellEdgeStarts: Int32Array;
+	private readonly cellEdges: Int32Array;
+	/** Whether the cell centre is inside the area of the edge at the same position in cellEdges */
+	private readonly centerInside: Uint8Array;
+	/** Edges as northing, easting of the start and end point */
+	private readonly edges: Int32Array;
+	private readonly edgeAreas: Int32Array;
+	private lastArea: number = -1;
+
+	constructor(areas: AdminArea[], cellSize: number = ADMIN_AREA_CELL_SIZE) {
+		this.areas = areas;
+		this.cellSize = cellSize;
+
+		let edgeCount = 0;
+		let minNorth = Infinity;
+		let minEast = Infinity;
+		let maxNorth = -Infinity;
+		let maxEast = -Infinity;
+		for (const area of areas) {
+			edgeCount += area.coordinates.length / 2;
+			for (let i = 0; i < area.coordinates.length; i += 2) {
+				minNorth = Math.min(minNorth, area.coordinates[i]);
+				maxNorth = Math.max(maxNorth, area.coordinates[i]);
+				minEast = Math.min(minEast, area.coordinates[i + 1]);
+				maxEast = Math.max(maxEast, area.coordinates[i + 1]);
+			}
+		}
+		if (edgeCount === 0) {
+			minNorth = maxNorth = minEast = maxEast = 0;
+		}
+		this.minNorthing = Math.floor(minNorth / cellSize) * cellSize;
+		this.minEasting = Math.floor(minEast / cellSize) * cellSize;
+		this.rows = Math.floor((maxNorth - this.minNorthing) / cellSize) + 1;
+		this.columns = Math.floor((maxEast - this.minEasting) / cellSize) + 1;
+		const cellCount = this.rows * this.columns;
+
+		// Varje ring sluter sig själv: sista punkten går tillbaka till den första
+		this.edges = new Int32Array(edgeCount * 4);
+		this.edgeAreas = new Int32Array(edgeCount);
+		let edge = 0;
+		areas.forEach((area, index) => {
+			const { coordinates, ringStarts } = area;
+			for (let ring = 0; ring < ringStarts.length - 1; ring++) {
+				const start = ringStarts[ring];
+				const end = ringStarts[ring + 1];
+				for (let i = start, j = end - 1; i < end; j = i++) {
+					this.edges.set([coordinates[2 * j], coordinates[2 * j + 1], coordinates[2 * i], coordinates[2 * i + 1]], edge * 4);
+					this.edgeAreas[edge++] = index;
+				}
+			}
+		});
+
+		// Par av ruta och kant, sorterade per ruta med räknesortering. Kanterna
+		// ligger i områdesordning, så sorteringen håller dem grupperade per område.
+		const pairCells: number[] = [];
+		const pairEdges: number[] = [];
+		for (let e = 0; e < edgeCount; e++) {
+			const [n1, e1, n2, e2] = this.edges.subarray(e * 4, e * 4 + 4);
+			const firstRow = this.rowOf(Math.min(n1, n2));
+			const lastRow = this.rowOf(Math.max(n1, n2));
+			const firstColumn = this.columnOf(Math.min(e1, e2));
+			const lastColumn = this.columnOf(Math.max(e1, e2));
+			for (let row = firstRow; row <= lastRow; row++) {
+				for (let column = firstColumn; column <= lastColumn; column++) {
+					const north = this.minNorthing + row * cellSize;
+					const east = this.minEasting + column * cellSize;
+					if (segmentTouchesRectangle(n1, e1, n2, e2, north, east, north + cellSize, east + cellSize)) {
+						pairCells.push(row * this.columns + column);
+						pairEdges.push(e);
+					}
+				}
+			}
+		}
+		this.cellEdgeStarts = new Int32Array(cellCount + 1);
+		for (const cell of pairCells) {
+			this.cellEdgeStarts[cell + 1]++;
+		}
+		for (let cell = 0; cell < cellCount; cell++) {
+			this.cellEdgeStarts[cell + 1] += this.cellEdgeStarts[cell];
+		}
+		this.cellEdges = new Int32Array(pairEdges.length);
+		const fill = this.cellEdgeStarts.slice(0, cellCount);
+		pairCells.forEach((cell, i) => {
+			this.cellEdges[fill[cell]++] = pairEdges[i];
+		});
+
+		// Mittpunktens läge för varje område i en gränsruta
+		this.centerInside = new Uint8Array(this.cellEdges.length);
+		this.cellAreas = new Int32Array(cellCount);
+		for (let cell = 0; cell < cellCount; cell++) {
+			const start = this.cellEdgeStarts[cell];
+			const end = this.cellEdgeStarts[cell + 1];
+			if (start === end) {
+				continue;
+			}
+			this.cellAreas[cell] = ADMIN_AREA_BORDER;
+			const [centerN, centerE] = this.cellCenter(cell);
+			let inside = false;
+			for (let i = start; i < end; i++) {
+				if (i === start || this.edgeAreas[this.cellEdges[i]] !== this.edgeAreas[this.cellEdges[i - 1]]) {
+					inside = isInsideAdminArea(areas[this.edgeAreas[this.cellEdges[i]]], centerN, centerE);
+				}
+				this.centerInside[i] = inside ? 1 : 0;
+			}
+		}
+
+		// Rutor utan gräns: två grannrutor i samma rad utan gräns ligger i samma område
+		for (let row = 0; row < this.rows; row++) {
+			let previous = ADMIN_AREA_BORDER;
+			for (let column = 0; column < this.columns; column++) {
+				const cell = row * this.columns + column;
+				if (this.cellAreas[cell] === ADMIN_AREA_BORDER) {
+					previous = ADMIN_AREA_BORDER;
+					continue;
+				}
+				if (previous === ADMIN_AREA_BORDER) {
+					const [centerN, centerE] = this.cellCenter(cell);
+					previous = areas.findIndex((area) => isInsideAdminArea(area, centerN, centerE));
+				}
+				this.cellAreas[cell] = previous;
+			}
+		}
+	}
+
+	get size(): number {
+		return this.areas.length;
+	}
+
+	/**
+	 * Finds the area containing a SWEREF 99 TM position, or null outside all areas
+	 */
+	lookup(northing: number, easting: number): AdminArea | null {
+		const row = this.rowOf(northing);
+		const column = this.columnOf(easting);
+		if (!(row >= 0 && row < this.rows && column >= 0 && column < this.columns)) {
+			return null;
+		}
+		const cell = row * this.columns + column;
+		const state = this.cellAreas[cell];
+		if (state !== ADMIN_AREA_BORDER) {
+			if (state !== ADMIN_AREA_OUTSIDE) {
+				this.lastArea = state;
+			}
+			return state === ADMIN_AREA_OUTSIDE ? null : this.areas[state];
+		}
+
+		const start = this.cellEdgeStarts[cell];
+		const end = this.cellEdgeStarts[cell + 1];
+		const centerN = this.minNorthing + (row + 0.5) * this.cellSize;
+		const centerE = this.minEasting + (column + 0.5) * this.cellSize;
+		// Förra träffens område först, sedan de övriga
+		if (this.lastArea >= 0 && this.isInsideGroup(this.lastArea, start, end, centerN, centerE, northing, easting)) {
+			return this.areas[this.lastArea];
+		}
+		for (let i = start; i < end; i++) {
+			const area = this.edgeAreas[this.cellEdges[i]];
+			if (i > start && area === this.edgeAreas[this.cellEdges[i - 1]]) {
+				continue;
+			}
+			if (area !== this.lastArea && this.isInsideGroup(area, i, end, centerN, centerE, northing, easting)) {
+				this.lastArea = area;
+				return this.areas[area];
+			}
+		}
+		return null;
+	}
+
+	/**
+	 * Flips the cell centre's side for each of the area's edges crossing the
+	 * segment from the centre to the position. Zero orientations count as
+	 * right of both edges meeting at a vertex, so a vertex is counted once.
+	 */
+	private isInsideGroup(area: number, start: number, end: number,
+		centerN: number, centerE: number, northing: number, easting: number): boolean {
+		const { edges, cellEdges, edgeAreas } = this;
+		let found = false;
+		let inside = false;
+		for (let i = start; i < end; i++) {
+			const e = cellEdges[i];
+			if (edgeAreas[e] !== area) {
+				if (found) {
+					break;
+				}
+				continue;
+			}
+			if (!found) {
+				found = true;
+				inside = this.centerInside[i] === 1;
+			}
+			const aN = edges[e * 4];
+			const aE = edges[e * 4 + 1];
+			const bN = edges[e * 4 + 2];
+			const bE = edges[e * 4 + 3];
+			if (isLeftOf(aN, aE, bN, bE, centerN, centerE) !== isLeftOf(aN, aE, bN, bE, northing, easting) &&
+				isLeftOf(centerN, centerE, northing, easting, aN, aE) !== isLeftOf(centerN, centerE, northing, easting, bN, bE)) {
+				inside = !inside;
+			}
+		}
+		return found && inside;
+	}
+
+	private rowOf(northing: number): number {
+		return Math.floor((northing - this.minNorthing) / this.cellSize);
+	}
+
+	private columnOf(easting: number): number {
+		return Math.floor((easting - this.minEasting) / this.cellSize);
+	}
+
+	private cellCenter(cell: number): [number, number] {
+		const row = Math.floor(cell / this.columns);
+		const column = cell - row * this.columns;
+		return [
+			this.minNorthing + (row + 0.5) * this.cellSize,
+			this.minEasting + (column + 0.5) * this.cellSize
+		];
+	}
+}
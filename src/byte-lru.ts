@@ -0,0 +1,82 @@
+// ============================================================================
+// BYTE-BOUNDED LRU
+// ============================================================================
+//
+// Håller poster upp till ett antal byte och kastar de som använts längst
+// sedan när gränsen passeras. En Map behåller insättningsordningen, så en
+// post flyttas sist genom att tas bort och sättas in igen; den första posten
+// är alltid den som använts längst sedan. Varje operation är O(1) utom
+// utkastningen, som är linjär i antalet utkastade poster.
+//
+// Används både för kartrutor i minnet och för kartrutornas cache i
+// service workern. Filen innehåller ingen DOM-kod.
+
+class ByteLru<V> {
+	private readonly entries = new Map<string, { value: V; bytes: number }>();
+	private totalBytes: number = 0;
+
+	constructor(readonly maxBytes: number) {}
+
+	get size(): number {
+		return this.entries.size;
+	}
+
+	get bytes(): number {
+		return this.totalBytes;
+	}
+
+	has(key: string): boolean {
+		return this.entries.has(key);
+	}
+
+	/**
+	 * Returns the value and marks it as most recently used
+	 */
+	get(key: string): V | undefined {
+		const entry = this.entries.get(key);
+		if (entry === undefined) {
+			return undefined;
+		}
+		this.entries.delete(key);
+		this.entries.set(key, entry);
+		return entry.value;
+	}
+
+	/**
+	 * Stores a value as most recently used
+	 * @returns Keys evicted to stay within maxBytes, least recently used
+	 * first; includes key itself if the value alone is larger than maxBytes
+	 */
+	set(key: string, value: V, bytes: number): string[] {
+		this.delete(key);
+		this.entries.set(key, { value, bytes });
+		this.totalBytes += bytes;
+		const evicted: string[] = [];
+		for (const [oldest, entry] of this.entries) {
+			if (this.totalBytes <= this.maxBytes) {
+				break;
+			}
+			this.entries.delete(oldest);
+			this.totalBytes -= entry.bytes;
+			evicted.push(oldest);
+		}
+		return evicted;
+	}
+
+	delete(key: string): boolean {
+		const entry = this.entries.get(key);
+		if (entry === undefined) {
+			return false;
+		}
+		this.entries.delete(key);
+		this.totalBytes -= entry.bytes;
+		return true;
+	}
+
+	/**
+	 * Keys from least to most recently used
+	 */
+	keys(): IterableIterator<string> {
+		return this.entries.keys();
+	}
+}
@@ -0,0 +1,197 @@
+// ============================================================================
+// CSV CONVERSION PAGE
+// ============================================================================
+//
+// Sidan för massomvandling av koordinatfiler. En släppt, vald eller
+// inklistrad fil lämnas till csv-convert-worker.js, som läser och omvandlar
+// den; sidan visar bara förloppet och erbjuder resultatet som nedladdning.
+
+const CONVERT_TEXT = {
+	PROGRESS: "Omvandlar",
+	OF: "av",
+	ROWS: "rader",
+	DONE_WGS84: "omvandlade till SWEREF 99 TM.",
+	DONE_SWEREF: "omvandlade till WGS 84.",
+	FAILED_SUFFIX: "kunde inte tolkas och har tomma kolumner.",
+	ERROR_PREFIX: "Fel:",
+	NO_WORKER: "Webbläsaren saknar stöd för Web Workers.",
+	PASTED_FILE_NAME: "koordinater.csv"
+} as const;
+
+/**
+ * Results up to this size are also shown on the page
+ */
+const CONVERT_PREVIEW_MAX_BYTES = 256 * 1024;
+const CONVERT_FILE_SUFFIXES: Record<CsvCoordinateKind, string> = {
+	wgs84: '-sweref99tm.csv',
+	sweref: '-wgs84.csv'
+};
+
+const convertDropZone = document.getElementById("convert-drop");
+const convertFileInput = document.getElementById("convert-file") as HTMLInputElement | null;
+const convertTextInput = document.getElementById("convert-text") as HTMLTextAreaElement | null;
+const convertTextBtn = document.getElementById("convert-text-btn") as HTMLButtonElement | null;
+const convertProgress = document.getElementById("convert-progress") as HTMLProgressElement | null;
+const convertStatus = document.getElementById("convert-status");
+const convertDownload = document.getElementById("convert-download") as HTMLAnchorElement | null;
+const convertCancelBtn = document.getElementById("convert-cancel-btn") as HTMLButtonElement | null;
+const convertOutput = document.getElementById("convert-output") as HTMLTextAreaElement | null;
+
+const convertNumberFormat = new Intl.NumberFormat('sv-SE');
+const convertMegabyteFormat = new Intl.NumberFormat('sv-SE', { minimumFractionDigits: 1, maximumFractionDigits: 1 });
+
+let convertWorker: Worker | null = null;
+let convertResultUrl: string | null = null;
+
+function setConvertStatus(text: string): void {
+	if (convertStatus) {
+		convertStatus.textContent = text;
+	}
+}
+
+/**
+ * Formats e.g. "Omvandlar 12,3 av 1 024,0 MB · 150 000 rader"
+ */
+function formatConvertProgress(bytesRead: number, totalBytes: number, rowCount: number): string {
+	const megabytes = (bytes: number) => convertMegabyteFormat.format(bytes / (1024 * 1024));
+	return `${CONVERT_TEXT.PROGRESS} ${megabytes(bytesRead)} ${CONVERT_TEXT.OF} ${megabytes(totalBytes)}\u00A0MB · ` +
+		`${convertNumberFormat.format(rowCount)}\u00A0${CONVERT_TEXT.ROWS}`;
+}
+
+/**
+ * Formats e.g. "150 000 rader omvandlade till SWEREF 99 TM. 3 rader kunde inte tolkas …"
+ */
+function formatConvertResult(kind: CsvCoordinateKind, rowCount: number, failedCount: number): string {
+	const done = kind === 'wgs84' ? CONVERT_TEXT.DONE_WGS84 : CONVERT_TEXT.DONE_SWEREF;
+	const converted = `${convertNumberFormat.format(rowCount)}\u00A0${CONVERT_TEXT.ROWS} ${done}`;
+	if (failedCount === 0) {
+		return converted;
+	}
+	return `${converted} ${convertNumberFormat.format(failedCount)}\u00A0${CONVERT_TEXT.ROWS} ${CONVERT_TEXT.FAILED_SUFFIX}`;
+}
+
+/**
+ * Name of the converted file, e.g. "punkter-sweref99tm.csv" for "punkter.csv"
+ */
+function getConvertedFileName(name: string, kind: CsvCoordinateKind): string {
+	return name.replace(/\.(csv|txt|tsv)$/i, '') + CONVERT_FILE_SUFFIXES[kind];
+}
+
+function resetConvertResult(): void {
+	if (convertResultUrl !== null) {
+		URL.revokeObjectURL(convertResultUrl);
+		convertResultUrl = null;
+	}
+	if (convertDownload) {
+		convertDownload.hidden = true;
+		convertDownload.removeAttribute('href');
+	}
+	if (convertOutput) {
+		convertOutput.hidden = true;
+		convertOutput.value = '';
+	}
+}
+
+function stopFileConversion(): void {
+	convertWorker?.terminate();
+	convertWorker = null;
+	if (convertProgress) {
+		convertProgress.hidden = true;
+	}
+	if (convertCancelBtn) {
+		convertCancelBtn.hidden = true;
+	}
+}
+
+async function showConvertResult(response: CsvConvertDoneResponse, name: string): Promise<void> {
+	setConvertStatus(formatConvertResult(response.kind, response.rowCount, response.failedCount));
+	convertResultUrl = URL.createObjectURL(response.result);
+	if (convertDownload) {
+		convertDownload.href = convertResultUrl;
+		convertDownload.download = getConvertedFileName(name, response.kind);
+		convertDownload.hidden = false;
+	}
+	if (convertOutput && response.result.size <= CONVERT_PREVIEW_MAX_BYTES) {
+		convertOutput.value = await response.result.text();
+		convertOutput.hidden = false;
+	}
+}
+
+/**
+ * Converts a file in the worker; a running conversion is stopped first
+ */
+function startFileConversion(file: Blob, name: string): void {
+	stopFileConversion();
+	resetConvertResult();
+	if (typeof Worker === 'undefined') {
+		setConvertStatus(CONVERT_TEXT.NO_WORKER);
+		return;
+	}
+	const worker = new Worker('/csv-convert-worker.js');
+	convertWorker = worker;
+	worker.addEventListener('message', (event: MessageEvent<CsvConvertResponse>) => {
+		const response = event.data;
+		if (worker !== convertWorker) {
+			return;
+		}
+		switch (response.type) {
+			case 'progress':
+				if (convertProgress) {
+					convertProgress.value = response.totalBytes > 0 ? response.bytesRead / response.totalBytes : 0;
+				}
+				setConvertStatus(formatConvertProgress(response.bytesRead, response.totalBytes, response.rowCount));
+				break;
+			case 'done':
+				stopFileConversion();
+				void showConvertResult(response, name);
+				break;
+			case 'error':
+				stopFileConversion();
+				setConvertStatus(`${CONVERT_TEXT.ERROR_PREFIX} ${response.message}`);
+				break;
+		}
+	});
+	if (convertProgress) {
+		convertProgress.value = 0;
+		convertProgress.hidden = false;
+	}
+	if (convertCancelBtn) {
+		convertCancelBtn.hidden = false;
+	}
+	setConvertStatus(formatConvertProgress(0, file.size, 0));
+	const request: CsvConvertRequest = { type: 'convert', file };
+	worker.postMessage(request);
+}
+
+function initializeConvertPage(): void {
+	convertFileInput?.addEventListener("change", () => {
+		const file = convertFileInput.files?.[0];
+		if (file) {
+			startFileConversion(file, file.name);
+		}
+	});
+	convertTextBtn?.addEventListener("click", () => {
+		if (convertTextInput?.value.trim()) {
+			startFileConversion(new Blob([convertTextInput.value], { type: 'text/csv' }), CONVERT_TEXT.PASTED_FILE_NAME);
+		}
+	});
+	convertCancelBtn?.addEventListener("click", () => {
+		stopFileConversion();
+		setConvertStatus('');
+	});
+	convertDropZone?.addEventListener("dragover", (event) => {
+		event.preventDefault();
+		convertDropZone.classList.add("dragover");
+	});
+	convertDropZone?.addEventListener("dragleave", () => convertDropZone.classList.remove("dragover"));
+	convertDropZone?.addEventListener("drop", (event) => {
+		event.preventDefault();
+		convertDropZone.classList.remove("dragover");
+		const file = event.dataTransfer?.files[0];
+		if (file) {
+			startFileConversion(file, file.name);
+		}
+	});
+}
+
+initializeConvertPage();
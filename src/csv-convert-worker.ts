@@ -0,0 +1,88 @@
+// ============================================================================
+// CSV CONVERSION WORKER
+// ============================================================================
+//
+// Web Worker som läser en CSV-fil som en ström, omvandlar den med
+// CsvStreamConverter och samlar resultatet som Blob-delar. Webbläsaren
+// håller Blob-data utanför JavaScript-minnet och kan lägga den på disk, så
+// varken indata eller utdata behöver rymmas i minnet, och sidan förblir
+// responsiv under hela omvandlingen.
+
+declare function importScripts(...urls: string[]): void;
+
+interface CsvConvertRequest {
+	type: 'convert';
+	file: Blob;
+}
+
+interface CsvConvertProgressResponse {
+	type: 'progress';
+	bytesRead: number;
+	totalBytes: number;
+	rowCount: number;
+}
+
+interface CsvConvertDoneResponse {
+	type: 'done';
+	result: Blob;
+	kind: CsvCoordinateKind;
+	rowCount: number;
+	failedCount: number;
+}
+
+interface CsvConvertErrorResponse {
+	type: 'error';
+	message: string;
+}
+
+type CsvConvertResponse = CsvConvertProgressResponse | CsvConvertDoneResponse | CsvConvertErrorResponse;
+
+/**
+ * Shortest time between two progress messages
+ */
+const CSV_CONVERT_PROGRESS_INTERVAL_MS = 100;
+
+importScripts(
+	'sweref-projection.js',
+	'csv-convert.js'
+);
+
+async function convertCsvFile(file: Blob): Promise<CsvConvertDoneResponse> {
+	const parts: Blob[] = [];
+	const converter = new CsvStreamConverter((text) => parts.push(new Blob([text])));
+	const reader = file.stream().getReader();
+	const decoder = new TextDecoder();
+	let bytesRead = 0;
+	let lastProgress = performance.now();
+	for (;;) {
+		const { done, value } = await reader.read();
+		if (done) {
+			break;
+		}
+		bytesRead += value.byteLength;
+		converter.push(decoder.decode(value, { stream: true }));
+		if (performance.now() - lastProgress >= CSV_CONVERT_PROGRESS_INTERVAL_MS) {
+			lastProgress = performance.now();
+			const progress: CsvConvertProgressResponse = { type: 'progress', bytesRead, totalBytes: file.size, rowCount: converter.rowCount };
+			self.postMessage(progress);
+		}
+	}
+	converter.push(decoder.decode());
+	converter.end();
+	return {
+		type: 'done',
+		result: new Blob(parts, { type: 'text/csv' }),
+		kind: converter.layout!.kind,
+		rowCount: converter.rowCount,
+		failedCount: converter.failedCount
+	};
+}
+
+self.onmessage = (event: MessageEvent<CsvConvertRequest>) => {
+	convertCsvFile(event.data.file)
+		.then((response) => self.postMessage(response))
+		.catch((error) => {
+			const response: CsvConvertErrorResponse = { type: 'error', message: error instanceof Error ? error.message : String(error) };
+			self.postMessage(response);
+		});
+};
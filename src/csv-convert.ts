@@ -0,0 +1,470 @@
+// ============================================================================
+// CSV CONVERSION (streaming coordinate conversion of spreadsheet files)
+// ============================================================================
+//
+// Omvandlar en CSV-fil med koordinater rad för rad: WGS 84 i decimalgrader,
+// grader och minuter eller grader, minuter och sekunder får kolumner i
+// SWEREF 99 TM, och SWEREF 99 TM får kolumner i WGS 84. Varje rad skrivs ut
+// oförändrad med de nya kolumnerna sist.
+//
+// Texten tas emot i bitar av valfri storlek och delas i rader även när en
+// rad eller ett citerat fält sträcker sig över flera bitar. Raderna samlas
+// i satser som projiceras i ett svep och skrivs ut direkt, så minnet beror
+// på satsens storlek och inte på filens.
+//
+// Latitud och longitud behandlas som SWEREF 99 (ETRS89) utan korrektion för
+// kontinentaldrift, som vid import av punkter. Filen innehåller ingen
+// DOM-kod och körs i en Web Worker.
+
+type CsvCoordinateKind = 'wgs84' | 'sweref';
+
+/**
+ * Where the coordinates are and how the file is written
+ */
+interface CsvLayout {
+	separator: string;
+	kind: CsvCoordinateKind;
+	/** Column of the latitude or northing */
+	firstColumn: number;
+	/** Column of the longitude or easting */
+	secondColumn: number;
+	hasHeader: boolean;
+	/** Write decimal commas, as the input does */
+	decimalComma: boolean;
+}
+
+/**
+ * Rows projected per batch
+ */
+const CSV_CONVERT_BATCH_SIZE = 4096;
+/** Values above this are SWEREF 99 TM metres, below it degrees */
+const CSV_CONVERT_PROJECTED_THRESHOLD = 1000;
+/** Lines read to find the layout: a header and the first data row */
+const CSV_CONVERT_LAYOUT_LINES = 2;
+
+/**
+ * Header names of each coordinate column, lower case
+ */
+const CSV_LATITUDE_NAMES = ['lat', 'latitud', 'latitude', 'wgs84_lat', 'breddgrad'];
+const CSV_LONGITUDE_NAMES = ['lon', 'lng', 'long', 'longitud', 'longitude', 'wgs84_lon', 'längdgrad'];
+const CSV_NORTHING_NAMES = ['n', 'north', 'northing', 'nord', 'norr', 'x', 'sweref99tm_n'];
+const CSV_EASTING_NAMES = ['e', 'east', 'easting', 'öst', 'ost', 'y', 'sweref99tm_e'];
+
+/**
+ * Added columns for each input kind
+ */
+const CSV_OUTPUT_HEADERS: Record<CsvCoordinateKind, readonly [string, string]> = {
+	wgs84: ['sweref99tm_n', 'sweref99tm_e'],
+	sweref: ['wgs84_lat', 'wgs84_lon']
+};
+
+const CSV_PLAIN_NUMBER_PATTERN = /^-?\d+(?:[.,]\d+)?$/;
+const CSV_NUMBER_PATTERN = /^\d+(?:\.\d+)?$/;
+const CSV_GROUPED_NUMBER_PATTERN = /^\d{1,3}(?: \d{3})+(?:\.\d+)?$/;
+const CSV_ANGLE_SEPARATOR_PATTERN = /[°'′"″\s]+/;
+const CSV_HEMISPHERE_PATTERN = /^([NSEWÖV])\s*(.+)$|^(.+?)\s*([NSEWÖV])$/;
+
+/**
+ * Parses a coordinate as written in a spreadsheet
+ *
+ * Accepts decimal numbers with point or comma, degrees and minutes, and
+ * degrees, minutes and seconds, with a sign or a hemisphere letter (S, W
+ * and V are negative), e.g. "59,3293", "59 19.758" or 18°4'7.2"Ö. Metres
+ * may be grouped with spaces, e.g. "6 580 822".
+ * @returns NaN when the text is not a coordinate
+ */
+function parseCsvCoordinate(text: string): number {
+	// De flesta värden är vanliga decimaltal
+	if (CSV_PLAIN_NUMBER_PATTERN.test(text)) {
+		return Number(text.replace(',', '.'));
+	}
+	let value = text.trim().replace(/[\u00A0\u202F]/g, ' ').replace(/,/g, '.').toUpperCase();
+	let sign = 1;
+	const hemisphere = CSV_HEMISPHERE_PATTERN.exec(value);
+	if (hemisphere) {
+		const letter = hemisphere[1] ?? hemisphere[4];
+		value = hemisphere[2] ?? hemisphere[3];
+		sign = letter === 'S' || letter === 'W' || letter === 'V' ? -1 : 1;
+	}
+	if (value.startsWith('-') || value.startsWith('+')) {
+		sign *= value[0] === '-' ? -1 : 1;
+		value = value.slice(1).trimStart();
+	}
+	if (CSV_NUMBER_PATTERN.test(value)) {
+		return sign * Number(value);
+	}
+	if (CSV_GROUPED_NUMBER_PATTERN.test(value)) {
+		return sign * Number(value.replace(/ /g, ''));
+	}
+
+	const parts = value.split(CSV_ANGLE_SEPARATOR_PATTERN).filter((part) => part !== '');
+	if (parts.length < 1 || parts.length > 3 || !parts.every((part) => CSV_NUMBER_PATTERN.test(part))) {
+		return Number.NaN;
+	}
+	const numbers = parts.map(Number);
+	// Bara den sista delen får ha decimaler, och minuter och sekunder är under 60
+	for (let i = 0; i < numbers.length; i++) {
+		if ((i < numbers.length - 1 && !Number.isInteger(numbers[i])) || (i > 0 && numbers[i] >= 60)) {
+			return Number.NaN;
+		}
+	}
+	const [degrees, minutes = 0, seconds = 0] = numbers;
+	return sign * (degrees + minutes / 60 + seconds / 3600);
+}
+
+/**
+ * Splits a CSV line into fields; quoted fields may contain the separator
+ * and doubled quotes
+ */
+function splitCsvFields(line: string, separator: string): string[] {
+	if (!line.includes('"')) {
+		return line.split(separator);
+	}
+	const fields: string[] = [];
+	let field = '';
+	let inQuotes = false;
+	for (let i = 0; i < line.length; i++) {
+		const character = line[i];
+		if (inQuotes) {
+			if (character !== '"') {
+				field += character;
+			} else if (line[i + 1] === '"') {
+				field += '"';
+				i++;
+			} else {
+				inQuotes = false;
+			}
+		} else if (character === '"') {
+			inQuotes = true;
+		} else if (character === separator) {
+			fields.push(field);
+			field = '';
+		} else {
+			field += character;
+		}
+	}
+	fields.push(field);
+	return fields;
+}
+
+/**
+ * Picks tab, semicolon or comma, in that order, like the waypoint import
+ */
+function detectCsvSeparator(line: string): string {
+	return line.includes('\t') ? '\t' : line.includes(';') ? ';' : ',';
+}
+
+/**
+ * How well two adjacent values fit as a coordinate pair, in either order
+ * @returns 2 inside Sweden, 1 for any valid coordinate, else 0
+ */
+function scoreCsvCoordinatePair(first: number, second: number): number {
+	const inRange = (a: number, b: number, minA: number, maxA: number, minB: number, maxB: number) =>
+		(a >= minA && a <= maxA && b >= minB && b <= maxB) || (b >= minA && b <= maxA && a >= minB && a <= maxB);
+	if (!Number.isFinite(first) || !Number.isFinite(second)) {
+		return 0;
+	}
+	if (Math.abs(first) > CSV_CONVERT_PROJECTED_THRESHOLD && Math.abs(second) > CSV_CONVERT_PROJECTED_THRESHOLD) {
+		return inRange(first, second, 6100000, 7700000, 250000, 950000) ? 2 : 1;
+	}
+	if (inRange(first, second, 55, 70, 10, 25)) {
+		return 2;
+	}
+	return inRange(first, second, -90, 90, -180, 180) ? 1 : 0;
+}
+
+/**
+ * Finds the coordinate columns from the header names, or else as the
+ * adjacent pair of fields in the first data row that best fits a
+ * coordinate in Sweden
+ * The order of the two columns is then taken from the values, since
+ * latitude and longitude, and northing and easting, do not overlap in
+ * Sweden.
+ * @param lines - The first non-empty lines
+ * @returns null when no coordinates are found
+ */
+function detectCsvLayout(lines: readonly string[]): CsvLayout | null {
+	if (lines.length === 0) {
+		return null;
+	}
+	const separator = detectCsvSeparator(lines[0]);
+	const rows = lines.map((line) => splitCsvFields(line, separator));
+	const names = rows[0].map((field) => field.trim().toLowerCase());
+	const findName = (candidates: readonly string[]) => names.findIndex((name) => candidates.includes(name));
+
+	const latitude = findName(CSV_LATITUDE_NAMES);
+	const longitude = findName(CSV_LONGITUDE_NAMES);
+	const northing = findName(CSV_NORTHING_NAMES);
+	const easting = findName(CSV_EASTING_NAMES);
+	if (latitude >= 0 && longitude >= 0) {
+		return orderCsvLayout({ separator, kind: 'wgs84', firstColumn: latitude, secondColumn: longitude, hasHeader: true, decimalComma: false }, rows[1]);
+	}
+	if (northing >= 0 && easting >= 0) {
+		return orderCsvLayout({ separator, kind: 'sweref', firstColumn: northing, secondColumn: easting, hasHeader: true, decimalComma: false }, rows[1]);
+	}
+
+	// Utan kända namn är första raden en rubrik om den saknar koordinater
+	for (let rowIndex = 0; rowIndex < rows.length; rowIndex++) {
+		const values = rows[rowIndex].map(parseCsvCoordinate);
+		let bestColumn = -1;
+		let bestScore = 0;
+		for (let i = 0; i + 1 < values.length; i++) {
+			// Heltal är oftare id eller nummer än koordinater, så de förlorar en jämn match
+			const wholeNumbers = Number.isInteger(values[i]) || Number.isInteger(values[i + 1]);
+			const score = scoreCsvCoordinatePair(values[i], values[i + 1]) - (wholeNumbers ? 0.5 : 0);
+			if (score > bestScore) {
+				bestColumn = i;
+				bestScore = score;
+			}
+		}
+		if (bestColumn >= 0) {
+			const layout: CsvLayout = { separator, kind: 'wgs84', firstColumn: bestColumn, secondColumn: bestColumn + 1, hasHeader: rowIndex > 0, decimalComma: false };
+			return orderCsvLayout(layout, rows[rowIndex]);
+		}
+	}
+	return null;
+}
+
+/**
+ * Takes the kind and order of the columns from the values of the data row,
+ * since names such as x and y are used both ways, and notes whether it
+ * writes decimal commas
+ */
+function orderCsvLayout(layout: CsvLayout, data: string[] | undefined): CsvLayout {
+	if (data === undefined) {
+		return layout;
+	}
+	const first = parseCsvCoordinate(data[layout.firstColumn] ?? '');
+	const second = parseCsvCoordinate(data[layout.secondColumn] ?? '');
+	if (Number.isFinite(first) && Number.isFinite(second)) {
+		const isProjected = Math.abs(first) > CSV_CONVERT_PROJECTED_THRESHOLD && Math.abs(second) > CSV_CONVERT_PROJECTED_THRESHOLD;
+		layout.kind = isProjected ? 'sweref' : 'wgs84';
+	}
+	const swapped = layout.kind === 'sweref'
+		? first < second
+		: (Math.abs(first) > 90 && Math.abs(second) <= 90) || (first >= 10 && first <= 25 && second >= 55 && second <= 70);
+	if (swapped) {
+		[layout.firstColumn, layout.secondColumn] = [layout.secondColumn, layout.firstColumn];
+	}
+	layout.decimalComma = (data[layout.firstColumn] ?? '').includes(',') || (data[layout.secondColumn] ?? '').includes(',');
+	return layout;
+}
+
+/**
+ * CsvLineSplitter - splits text arriving in pieces into lines
+ *
+ * Newlines inside quoted fields do not end a line. A trailing carriage
+ * return is removed.
+ */
+class CsvLineSplitter {
+	private rest: string = '';
+	/** Offset in rest up to which quotes have been counted */
+	private scanned: number = 0;
+	private inQuotes: boolean = false;
+
+	push(text: string, onLine: (line: string) => void): void {
+		const data = this.rest + text;
+		let lineStart = 0;
+		let scan = this.scanned;
+		// Nästa citattecken söks en gång och inte för varje rad
+		let quote = data.indexOf('"', scan);
+		for (;;) {
+			const newline = data.indexOf('\n', scan);
+			if (newline < 0) {
+				break;
+			}
+			for (; quote >= 0 && quote < newline; quote = data.indexOf('"', quote + 1)) {
+				this.inQuotes = !this.inQuotes;
+			}
+			scan = newline + 1;
+			if (!this.inQuotes) {
+				onLine(trimCarriageReturn(data.slice(lineStart, newline)));
+				lineStart = scan;
+			}
+		}
+		this.rest = data.slice(lineStart);
+		this.scanned = scan - lineStart;
+	}
+
+	/**
+	 * Emits the last line when the text does not end with a newline
+	 */
+	end(onLine: (line: string) => void): void {
+		if (this.rest !== '') {
+			onLine(trimCarriageReturn(this.rest));
+		}
+		this.rest = '';
+		this.scanned = 0;
+		this.inQuotes = false;
+	}
+}
+
+function trimCarriageReturn(line: string): string {
+	return line.endsWith('\r') ? line.slice(0, -1) : line;
+}
+
+/**
+ * CsvStreamConverter - converts CSV text arriving in pieces
+ *
+ * Output is handed to onOutput once per batch, so neither the input nor the
+ * output is held in full.
+ */
+class CsvStreamConverter {
+	private readonly splitter = new CsvLineSplitter();
+	private readonly headLines: string[] = [];
+	private csvLayout: CsvLayout | null = null;
+	private readonly lines: string[] = [];
+	/** 1 for lines written as they are: the header, already extended, and empty lines */
+	private readonly passThrough = new Uint8Array(CSV_CONVERT_BATCH_SIZE);
+	private readonly first = new Float64Array(CSV_CONVERT_BATCH_SIZE);
+	private readonly second = new Float64Array(CSV_CONVERT_BATCH_SIZE);
+	private readonly outFirst = new Float64Array(CSV_CONVERT_BATCH_SIZE);
+	private readonly outSecond = new Float64Array(CSV_CONVERT_BATCH_SIZE);
+	private batchCount: number = 0;
+	private rows: number = 0;
+	private failed: number = 0;
+	private readonly handleLine = (line: string) => this.addLine(line);
+
+	constructor(private readonly onOutput: (text: string) => void) {}
+
+	get layout(): CsvLayout | null {
+		return this.csvLayout;
+	}
+
+	/**
+	 * Data rows read, header and empty lines excluded
+	 */
+	get rowCount(): number {
+		return this.rows;
+	}
+
+	/**
+	 * Data rows without a valid coordinate; written with empty columns
+	 */
+	get failedCount(): number {
+		return this.failed;
+	}
+
+	push(text: string): void {
+		this.splitter.push(text, this.handleLine);
+	}
+
+	/**
+	 * Converts what is left
+	 * @throws When no coordinate columns were found
+	 */
+	end(): void {
+		this.splitter.end(this.handleLine);
+		if (this.csvLayout === null) {
+			this.startConversion();
+		}
+		this.flush();
+	}
+
+	private addLine(line: string): void {
+		if (this.csvLayout !== null) {
+			this.convertLine(line);
+			return;
+		}
+		this.headLines.push(line);
+		if (this.headLines.filter((head) => head.trim() !== '').length >= CSV_CONVERT_LAYOUT_LINES) {
+			this.startConversion();
+		}
+	}
+
+	private startConversion(): void {
+		const layout = detectCsvLayout(this.headLines.filter((line) => line.trim() !== ''));
+		if (layout === null) {
+			throw new Error('Hittade inga koordinater i filen');
+		}
+		this.csvLayout = layout;
+		let headerPending = layout.hasHeader;
+		for (const line of this.headLines.splice(0)) {
+			if (headerPending && line.trim() !== '') {
+				headerPending = false;
+				const [firstHeader, secondHeader] = CSV_OUTPUT_HEADERS[layout.kind];
+				this.addPassThrough(`${line}${layout.separator}${firstHeader}${layout.separator}${secondHeader}`);
+			} else {
+				this.convertLine(line);
+			}
+		}
+	}
+
+	private addPassThrough(line: string): void {
+		const i = this.batchCount++;
+		this.lines.push(line);
+		this.passThrough[i] = 1;
+		if (this.batchCount === CSV_CONVERT_BATCH_SIZE) {
+			this.flush();
+		}
+	}
+
+	private convertLine(line: string): void {
+		if (line.trim() === '') {
+			this.addPassThrough(line);
+			return;
+		}
+		const layout = this.csvLayout!;
+		const fields = splitCsvFields(line, layout.separator);
+		let first = parseCsvCoordinate(fields[layout.firstColumn] ?? '');
+		let second = parseCsvCoordinate(fields[layout.secondColumn] ?? '');
+		const isValid = layout.kind === 'sweref'
+			? Number.isFinite(first) && Number.isFinite(second)
+			: Math.abs(first) <= 90 && Math.abs(second) <= 180;
+		this.rows++;
+		if (!isValid) {
+			// NaN ger tomma kolumner i utdata
+			this.failed++;
+			first = Number.NaN;
+			second = Number.NaN;
+		}
+		const i = this.batchCount++;
+		this.lines.push(line);
+		this.passThrough[i] = 0;
+		this.first[i] = first;
+		this.second[i] = second;
+		if (this.batchCount === CSV_CONVERT_BATCH_SIZE) {
+			this.flush();
+		}
+	}
+
+	/**
+	 * Projects the batch and hands the converted lines to onOutput
+	 */
+	private flush(): void {
+		const layout = this.csvLayout;
+		const count = this.batchCount;
+		if (layout === null || count === 0) {
+			return;
+		}
+		const first = this.first.subarray(0, count);
+		const second = this.second.subarray(0, count);
+		if (layout.kind === 'wgs84') {
+			projectToSweref99tmBatch(first, second, this.outFirst, this.outSecond);
+		} else {
+			unprojectSweref99tmBatch(first, second, this.outFirst, this.outSecond);
+		}
+
+		const { separator } = layout;
+		const digits = layout.kind === 'wgs84' ? 3 : 8;
+		// Decimalkomma i en kommaseparerad fil kräver citattecken
+		const quote = layout.decimalComma && separator === ',' ? '"' : '';
+		const format = (value: number) => layout.decimalComma
+			? `${quote}${value.toFixed(digits).replace('.', ',')}${quote}`
+			: value.toFixed(digits);
+		let output = '';
+		for (let i = 0; i < count; i++) {
+			const line = this.lines[i];
+			if (this.passThrough[i] === 1) {
+				output += `${line}\n`;
+			} else if (Number.isFinite(this.outFirst[i]) && Number.isFinite(this.outSecond[i])) {
+				output += `${line}${separator}${format(this.outFirst[i])}${separator}${format(this.outSecond[i])}\n`;
+			} else {
+				output += `${line}${separator}${separator}\n`;
+			}
+		}
+		this.lines.length = 0;
+		this.batchCount = 0;
+		this.onOutput(output);
+	}
+}
@@ -0,0 +1,374 @@
+// ============================================================================
+// FIX LIST (virtualised list of the track's fixes)
+// ============================================================================
+//
+// Listar spårets positioner en rad per position utan att skapa en DOM-nod
+// per position. Positionerna hålls i växande kolumner (TrackFixBuffer) med
+// ett tak, över vilket de äldsta släpps, och listan har bara så många rader
+// som får plats i fönstret plus en marginal. Raderna placeras med transform
+// och återanvänds: rad i ritas alltid i samma element (i modulo antalet
+// element), så vid rullning och nya positioner skrivs bara de rader om som
+// bytt index.
+//
+// Att gå till en tid är en binärsökning i tidskolumnen, som är sorterad
+// eftersom positionerna sparas i den ordning de kommer.
+
+/**
+ * Row height used until a row has been laid out, CSS pixels
+ */
+const FIX_LIST_DEFAULT_ROW_HEIGHT = 24;
+/** Rows rendered above and below the visible ones */
+const FIX_LIST_OVERSCAN = 8;
+/** Initial capacity of a TrackFixBuffer, one stored chunk */
+const FIX_LIST_INITIAL_CAPACITY = 256;
+/** Most fixes a TrackFixBuffer keeps, about 18 hours at 1 Hz (2.6 MB) */
+const FIX_LIST_MAX_FIXES = 65536;
+
+/**
+ * Index of the fix closest in time, earlier on a tie
+ * @param timestamp - Times in increasing order
+ * @returns -1 when there are no fixes
+ */
+function findFixIndexAtTime(timestamp: Float64Array, count: number, time: number): number {
+	if (count === 0) {
+		return -1;
+	}
+	// Första index med en tid som inte är före den sökta
+	let low = 0;
+	let high = count;
+	while (low < high) {
+		const middle = (low + high) >>> 1;
+		if (timestamp[middle] < time) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	if (low === count) {
+		return count - 1;
+	}
+	if (low > 0 && time - timestamp[low - 1] <= timestamp[low] - time) {
+		return low - 1;
+	}
+	return low;
+}
+
+/**
+ * Resolves a time of day to a time within the track
+ * A track that passes midnight is searched on the day after its start when
+ * the time of day is earlier than the start.
+ * @param secondsOfDay - Local time since midnight
+ */
+function resolveTrackTimeOfDay(firstTimestamp: number, lastTimestamp: number, secondsOfDay: number): number {
+	const midnight = new Date(firstTimestamp);
+	midnight.setHours(0, 0, 0, 0);
+	const time = midnight.getTime() + secondsOfDay * 1000;
+	if (time >= firstTimestamp) {
+		return time;
+	}
+	const nextDay = new Date(midnight);
+	nextDay.setDate(nextDay.getDate() + 1);
+	const nextDayTime = nextDay.getTime() + secondsOfDay * 1000;
+	return nextDayTime <= lastTimestamp ? nextDayTime : time;
+}
+
+/**
+ * TrackFixBuffer - the latest fixes of a track in columns that grow by doubling
+ *
+ * When the cap is reached the oldest quarter is dropped, so the columns stay
+ * sorted by time and the cost per fix stays constant on average.
+ */
+class TrackFixBuffer {
+	private data: TrackColumns;
+	private droppedCount: number = 0;
+
+	constructor(private readonly maxFixes: number = FIX_LIST_MAX_FIXES) {
+		this.data = createTrackColumns(Math.min(FIX_LIST_INITIAL_CAPACITY, maxFixes));
+	}
+
+	get count(): number {
+		return this.data.count;
+	}
+
+	/**
+	 * Number of fixes dropped from the start of the track to stay within the cap
+	 */
+	get dropped(): number {
+		return this.droppedCount;
+	}
+
+	/**
+	 * The columns; replaced when they grow, so do not keep a reference
+	 */
+	get columns(): TrackColumns {
+		return this.data;
+	}
+
+	clear(): void {
+		this.data.count = 0;
+		this.droppedCount = 0;
+	}
+
+	append(fix: TrackFix): void {
+		this.reserve(1);
+		const i = this.data.count++;
+		this.data.timestamp[i] = fix.timestamp;
+		this.data.northing[i] = fix.northing;
+		this.data.easting[i] = fix.easting;
+		this.data.accuracy[i] = fix.accuracy;
+		this.data.speed[i] = fix.speed ?? Number.NaN;
+	}
+
+	/**
+	 * Adds a chunk of stored fixes
+	 */
+	load(columns: TrackColumns): void {
+		const skip = Math.max(0, columns.count - this.maxFixes);
+		const count = columns.count - skip;
+		this.droppedCount += skip;
+		this.reserve(count);
+		const offset = this.data.count;
+		this.data.timestamp.set(columns.timestamp.subarray(skip, columns.count), offset);
+		this.data.northing.set(columns.northing.subarray(skip, columns.count), offset);
+		this.data.easting.set(columns.easting.subarray(skip, columns.count), offset);
+		this.data.accuracy.set(columns.accuracy.subarray(skip, columns.count), offset);
+		this.data.speed.set(columns.speed.subarray(skip, columns.count), offset);
+		this.data.count += count;
+	}
+
+	private reserve(extra: number): void {
+		const overflow = this.data.count + extra - this.maxFixes;
+		if (overflow > 0) {
+			this.dropOldest(Math.min(this.data.count, Math.max(overflow, this.maxFixes >> 2)));
+		}
+		const needed = this.data.count + extra;
+		let capacity = this.data.timestamp.length;
+		if (needed <= capacity) {
+			return;
+		}
+		while (capacity < needed) {
+			capacity *= 2;
+		}
+		const grown = createTrackColumns(Math.min(capacity, this.maxFixes));
+		grown.timestamp.set(this.data.timestamp.subarray(0, this.data.count));
+		grown.northing.set(this.data.northing.subarray(0, this.data.count));
+		grown.easting.set(this.data.easting.subarray(0, this.data.count));
+		grown.accuracy.set(this.data.accuracy.subarray(0, this.data.count));
+		grown.speed.set(this.data.speed.subarray(0, this.data.count));
+		grown.count = this.data.count;
+		this.data = grown;
+	}
+
+	private dropOldest(dropped: number): void {
+		const { data } = this;
+		for (const column of [data.timestamp, data.northing, data.easting, data.accuracy, data.speed]) {
+			column.copyWithin(0, dropped, data.count);
+		}
+		data.count -= dropped;
+		this.droppedCount += dropped;
+	}
+}
+
+/**
+ * VirtualList - a scrolling list that only renders the visible rows
+ *
+ * The viewport is the scrolling element and needs a fixed height. A spacer
+ * inside it gives the full scroll height; rows are absolutely positioned
+ * children of the spacer.
+ */
+class VirtualList {
+	private readonly spacer: HTMLElement;
+	private readonly rows: HTMLElement[] = [];
+	/** Index shown by each row element, -1 when it must be rewritten */
+	private readonly rowIndex: number[] = [];
+	private rowHeight: number = 0;
+	private spacerHeight: number = -1;
+	private itemCount: number = 0;
+	private selected: number = -1;
+	private following: boolean = false;
+	private firstVisible: number = 0;
+	private lastVisible: number = -1;
+	private frameRequest: number | null = null;
+
+	/**
+	 * @param renderRow - Writes item index into a row element
+	 * @param onRender - Called after each render with the visible range
+	 */
+	constructor(
+		private readonly viewport: HTMLElement,
+		private readonly renderRow: (row: HTMLElement, index: number) => void,
+		private readonly onRender?: (first: number, last: number, count: number) => void
+	) {
+		this.spacer = document.createElement('div');
+		this.spacer.className = 'virtual-list-spacer';
+		this.viewport.replaceChildren(this.spacer);
+		this.viewport.addEventListener('scroll', () => this.requestRender(), { passive: true });
+	}
+
+	get count(): number {
+		return this.itemCount;
+	}
+
+	/**
+	 * Number of row elements in the DOM
+	 */
+	get rowCount(): number {
+		return this.rows.length;
+	}
+
+	get selectedIndex(): number {
+		return this.selected;
+	}
+
+	/**
+	 * Whether the last item was in view at the latest render
+	 */
+	isAtEnd(): boolean {
+		return this.lastVisible >= this.itemCount - 1;
+	}
+
+	/**
+	 * Sets the number of items and rewrites every row at the next frame
+	 * @param follow - Scroll to the last item
+	 */
+	setCount(count: number, follow: boolean = false): void {
+		this.itemCount = count;
+		if (this.selected >= count) {
+			this.selected = -1;
+		}
+		this.following = follow;
+		this.rowIndex.fill(-1);
+		this.requestRender();
+	}
+
+	/**
+	 * Raises the number of items after items were added at the end
+	 * Rows already written keep their content, so only the set size, the
+	 * scroll height and rows for new items are written.
+	 * @param follow - Scroll to the last item
+	 */
+	grow(count: number, follow: boolean = false): void {
+		if (count < this.itemCount) {
+			this.setCount(count, follow);
+			return;
+		}
+		this.itemCount = count;
+		this.following = follow;
+		const setSize = String(count);
+		for (const row of this.rows) {
+			row.setAttribute('aria-setsize', setSize);
+		}
+		this.requestRender();
+	}
+
+	/**
+	 * Marks an item and scrolls it to the middle of the viewport
+	 */
+	select(index: number): void {
+		this.selected = index;
+		this.following = false;
+		this.rowIndex.fill(-1);
+		this.updateSpacer();
+		if (index >= 0) {
+			const rowHeight = this.getRowHeight();
+			this.viewport.scrollTop = Math.max(0, index * rowHeight - (this.viewport.clientHeight - rowHeight) / 2);
+		}
+		this.render();
+	}
+
+	/**
+	 * Renders at the next frame; repeated requests share one frame
+	 */
+	requestRender(): void {
+		if (this.frameRequest !== null) {
+			return;
+		}
+		this.frameRequest = requestAnimationFrame(() => {
+			this.frameRequest = null;
+			this.render();
+		});
+	}
+
+	/**
+	 * Renders the rows in view now
+	 */
+	render(): void {
+		if (this.frameRequest !== null) {
+			cancelAnimationFrame(this.frameRequest);
+			this.frameRequest = null;
+		}
+		const height = this.viewport.clientHeight;
+		const visibleCount = Math.ceil(height / this.getRowHeight()) + 1;
+		this.ensureRows(Math.min(visibleCount + 2 * FIX_LIST_OVERSCAN, this.itemCount));
+		// Radhöjden kan mätas först när det finns en rad
+		const rowHeight = this.getRowHeight();
+		this.updateSpacer();
+		if (this.following) {
+			this.following = false;
+			this.viewport.scrollTop = this.viewport.scrollHeight;
+		}
+
+		const scrollTop = this.viewport.scrollTop;
+		const top = Math.floor(scrollTop / rowHeight);
+		const poolSize = this.rows.length;
+		const first = Math.max(0, Math.min(top - FIX_LIST_OVERSCAN, this.itemCount - poolSize));
+		for (let index = first; index < first + poolSize; index++) {
+			const slot = index % poolSize;
+			if (this.rowIndex[slot] === index) {
+				continue;
+			}
+			const row = this.rows[slot];
+			this.rowIndex[slot] = index;
+			row.style.transform = `translateY(${index * rowHeight}px)`;
+			row.setAttribute('aria-posinset', String(index + 1));
+			row.setAttribute('aria-setsize', String(this.itemCount));
+			row.classList.toggle('selected', index === this.selected);
+			this.renderRow(row, index);
+		}
+
+		this.firstVisible = Math.min(top, Math.max(0, this.itemCount - 1));
+		this.lastVisible = Math.min(Math.ceil((scrollTop + height) / rowHeight), this.itemCount) - 1;
+		this.onRender?.(this.firstVisible, this.lastVisible, this.itemCount);
+	}
+
+	/**
+	 * Grows or shrinks the pool of row elements
+	 */
+	private ensureRows(count: number): void {
+		if (this.rows.length === count) {
+			return;
+		}
+		while (this.rows.length < count) {
+			const row = document.createElement('div');
+			row.className = 'virtual-list-row';
+			row.setAttribute('role', 'listitem');
+			this.spacer.appendChild(row);
+			this.rows.push(row);
+			this.rowIndex.push(-1);
+		}
+		for (const row of this.rows.splice(count)) {
+			row.remove();
+		}
+		this.rowIndex.length = count;
+		// Varje index har en fast plats i poolen, som flyttas när poolen byter storlek
+		this.rowIndex.fill(-1);
+	}
+
+	private updateSpacer(): void {
+		const height = this.itemCount * this.getRowHeight();
+		if (height !== this.spacerHeight) {
+			this.spacerHeight = height;
+			this.spacer.style.height = `${height}px`;
+		}
+	}
+
+	/**
+	 * Height of a laid-out row, measured once
+	 */
+	private getRowHeight(): number {
+		if (this.rowHeight === 0 && this.rows.length > 0) {
+			this.rowHeight = this.rows[0].offsetHeight;
+		}
+		return this.rowHeight || FIX_LIST_DEFAULT_ROW_HEIGHT;
+	}
+}
@@ -0,0 +1,675 @@
+// ============================================================================
+// FLATGEOBUF EXPORT (EPSG:3006 with packed Hilbert R-tree)
+// ============================================================================
+//
+// FlatGeobuf är ett binärt format där ett GIS kan läsa bara de objekt som
+// ligger inom ett område, även direkt över HTTP med range-förfrågningar.
+// Filen består av en signatur, ett huvud, ett packat R-träd över objektens
+// rektanglar och till sist objekten i trädets ordning, sorterade längs en
+// Hilbertkurva. Huvud och objekt är FlatBuffers.
+//
+// Varje position i spåret och varje sparad punkt blir ett punktobjekt med
+// koordinaterna i SWEREF 99 TM (EPSG:3006), x = öst och y = nord. Trädet
+// skrivs före objekten och pekar ut var i filen de ligger, så spåret läses
+// två gånger: först positionerna och objektens storlek, sedan objekten.
+// Andra gången fylls utdata ett fönster i taget. Varje block som har
+// objekt i fönstret läses en gång och dess objekt kodas direkt på sin plats
+// i fönstret. Ett spår som inte går samma väg flera gånger läses därför
+// nästan bara en gång till, och även ett spår med hundratals varv på samma
+// bana läses högst en gång per fönster. Minnet per objekt är några tiotal
+// byte för trädet och sorteringen, plus ett fönster för utdata.
+//
+// Filen innehåller ingen DOM-kod och körs i spårarbetaren.
+
+/**
+ * Reads the stored chunks of a track, in any order
+ */
+interface FlatGeobufSource {
+	chunkCount: number;
+	readChunk(seq: number): Promise<TrackColumns | null>;
+}
+
+interface FlatGeobufColumn {
+	name: string;
+	type: number;
+}
+
+interface FlatGeobufStats {
+	featureCount: number;
+	byteCount: number;
+	/** Chunks read in the second pass, at least the number of chunks */
+	chunkReads: number;
+	durationMs: number;
+}
+
+const FLATGEOBUF_MAGIC = new Uint8Array([0x66, 0x67, 0x62, 0x03, 0x66, 0x67, 0x62, 0x00]);
+const FLATGEOBUF_MIME_TYPE = 'application/flatgeobuf';
+const FLATGEOBUF_EXTENSION = 'fgb';
+/**
+ * Number of children per R-tree node, the FlatGeobuf default
+ */
+const FLATGEOBUF_NODE_SIZE = 16;
+/** Bytes per R-tree node: min x, min y, max x, max y and an offset */
+const FLATGEOBUF_NODE_BYTES = 40;
+const FLATGEOBUF_EPSG_SWEREF99TM = 3006;
+const FLATGEOBUF_GEOMETRY_POINT = 1;
+const FLATGEOBUF_COLUMN_DOUBLE = 10;
+const FLATGEOBUF_COLUMN_STRING = 11;
+const FLATGEOBUF_COLUMN_DATETIME = 13;
+/**
+ * Size of the output window filled per round of chunk reads; also the
+ * largest piece handed to the output after the index
+ */
+const FLATGEOBUF_WINDOW_BYTES = 16 * 1024 * 1024;
+/** Most fields of any table in the FlatGeobuf schema */
+const FLATBUFFER_MAX_FIELDS = 16;
+
+/** Same names as the columns of the other export formats */
+const FLATGEOBUF_COLUMNS: FlatGeobufColumn[] = [
+	{ name: 'tid', type: FLATGEOBUF_COLUMN_DATETIME },
+	{ name: 'noggrannhet_m', type: FLATGEOBUF_COLUMN_DOUBLE },
+	{ name: 'fart_ms', type: FLATGEOBUF_COLUMN_DOUBLE },
+	...MAP_SHEET_FIELDS.map((name) => ({ name, type: FLATGEOBUF_COLUMN_STRING })),
+	{ name: 'namn', type: FLATGEOBUF_COLUMN_STRING }
+];
+const FLATGEOBUF_SHEET_COLUMN = 3;
+const FLATGEOBUF_NAME_COLUMN = FLATGEOBUF_COLUMNS.length - 1;
+
+/**
+ * FlatBufferBuilder - writes a FlatBuffer back to front
+ *
+ * Follows the reference builder: data grows from the end of the buffer
+ * towards the start, so offsets to earlier written objects point forward.
+ * Only the parts FlatGeobuf needs are implemented, and vtables are not
+ * shared between tables.
+ */
+class FlatBufferBuilder {
+	private bytes: Uint8Array<ArrayBuffer>;
+	private view: DataView;
+	/** Start of the written data */
+	private space: number;
+	private minAlign: number = 1;
+	/** Offsets of the fields of the table being built, 0 when absent */
+	private readonly vtable = new Int32Array(FLATBUFFER_MAX_FIELDS);
+	private fieldCount: number = 0;
+	private objectStart: number = 0;
+	private readonly encoder = new TextEncoder();
+
+	constructor(capacity: number) {
+		this.bytes = new Uint8Array(capacity);
+		this.view = new DataView(this.bytes.buffer);
+		this.space = capacity;
+	}
+
+	clear(): void {
+		this.space = this.bytes.length;
+		this.minAlign = 1;
+	}
+
+	/**
+	 * Offset of the latest written data, counted from the end
+	 */
+	offset(): number {
+		return this.bytes.length - this.space;
+	}
+
+	/**
+	 * The finished buffer; valid until the builder is used again
+	 */
+	asUint8Array(): Uint8Array<ArrayBuffer> {
+		return this.bytes.subarray(this.space);
+	}
+
+	/**
+	 * Pads so that size bytes can be written aligned after additional bytes
+	 */
+	private prep(size: number, additional: number): void {
+		if (size > this.minAlign) {
+			this.minAlign = size;
+		}
+		const alignSize = (-(this.offset() + additional)) & (size - 1);
+		while (this.space < alignSize + size + additional) {
+			this.grow();
+		}
+		for (let i = 0; i < alignSize; i++) {
+			this.bytes[--this.space] = 0;
+		}
+	}
+
+	private grow(): void {
+		const used = this.offset();
+		const bytes = new Uint8Array(this.bytes.length * 2);
+		bytes.set(this.asUint8Array(), bytes.length - used);
+		this.bytes = bytes;
+		this.view = new DataView(bytes.buffer);
+		this.space = bytes.length - used;
+	}
+
+	private addUint8(value: number): void {
+		this.prep(1, 0);
+		this.view.setUint8(--this.space, value);
+	}
+
+	private addUint16(value: number): void {
+		this.prep(2, 0);
+		this.view.setUint16(this.space -= 2, value, true);
+	}
+
+	private addInt32(value: number): void {
+		this.prep(4, 0);
+		this.view.setInt32(this.space -= 4, value, true);
+	}
+
+	private addUint64(value: number): void {
+		this.prep(8, 0);
+		this.space -= 8;
+		this.view.setUint32(this.space, value >>> 0, true);
+		this.view.setUint32(this.space + 4, Math.floor(value / 0x100000000), true);
+	}
+
+	private addOffset(offset: number): void {
+		this.prep(4, 0);
+		const relative = this.offset() - offset + 4;
+		this.view.setUint32(this.space -= 4, relative, true);
+	}
+
+	/**
+	 * Writes the length of a vector whose elements were just written
+	 */
+	private endVector(length: number): number {
+		this.view.setUint32(this.space -= 4, length, true);
+		return this.offset();
+	}
+
+	createString(text: string): number {
+		const utf8 = this.encoder.encode(text);
+		this.addUint8(0);
+		this.prep(4, utf8.length);
+		this.bytes.set(utf8, this.space -= utf8.length);
+		return this.endVector(utf8.length);
+	}
+
+	createByteVector(values: Uint8Array): number {
+		this.prep(4, values.length);
+		this.bytes.set(values, this.space -= values.length);
+		return this.endVector(values.length);
+	}
+
+	createDoubleVector(values: ArrayLike<number>): number {
+		this.prep(4, values.length * 8);
+		this.prep(8, values.length * 8);
+		for (let i = values.length - 1; i >= 0; i--) {
+			this.view.setFloat64(this.space -= 8, values[i], true);
+		}
+		return this.endVector(values.length);
+	}
+
+	createOffsetVector(offsets: number[]): number {
+		this.prep(4, offsets.length * 4);
+		for (let i = offsets.length - 1; i >= 0; i--) {
+			this.addOffset(offsets[i]);
+		}
+		return this.endVector(offsets.length);
+	}
+
+	startTable(fieldCount: number): void {
+		this.vtable.fill(0, 0, fieldCount);
+		this.fieldCount = fieldCount;
+		this.objectStart = this.offset();
+	}
+
+	// Fält med standardvärdet utelämnas, som i referensbyggaren
+	addFieldUint8(slot: number, value: number, defaultValue: number): void {
+		if (value !== defaultValue) {
+			this.addUint8(value);
+			this.vtable[slot] = this.offset();
+		}
+	}
+
+	addFieldUint16(slot: number, value: number, defaultValue: number): void {
+		if (value !== defaultValue) {
+			this.addUint16(value);
+			this.vtable[slot] = this.offset();
+		}
+	}
+
+	addFieldInt32(slot: number, value: number, defaultValue: number): void {
+		if (value !== defaultValue) {
+			this.addInt32(value);
+			this.vtable[slot] = this.offset();
+		}
+	}
+
+	addFieldUint64(slot: number, value: number, defaultValue: number): void {
+		if (value !== defaultValue) {
+			this.addUint64(value);
+			this.vtable[slot] = this.offset();
+		}
+	}
+
+	addFieldOffset(slot: number, offset: number): void {
+		if (offset !== 0) {
+			this.addOffset(offset);
+			this.vtable[slot] = this.offset();
+		}
+	}
+
+	/**
+	 * Writes the vtable in front of the table
+	 * @returns Offset of the table
+	 */
+	endTable(): number {
+		this.addInt32(0);
+		const tableOffset = this.offset();
+		let fieldCount = this.fieldCount;
+		while (fieldCount > 0 && this.vtable[fieldCount - 1] === 0) {
+			fieldCount--;
+		}
+		for (let i = fieldCount - 1; i >= 0; i--) {
+			this.addUint16(this.vtable[i] !== 0 ? tableOffset - this.vtable[i] : 0);
+		}
+		this.addUint16(tableOffset - this.objectStart);
+		this.addUint16((fieldCount + 2) * 2);
+		// Tabellen börjar med avståndet bakåt till sin vtable
+		this.view.setInt32(this.bytes.length - tableOffset, this.offset() - tableOffset, true);
+		return tableOffset;
+	}
+
+	/**
+	 * Finishes the buffer with the root table, preceded by its size as
+	 * FlatGeobuf expects
+	 */
+	finishSizePrefixed(root: number): void {
+		this.prep(this.minAlign, 8);
+		this.addOffset(root);
+		this.addInt32(this.offset());
+	}
+}
+
+/**
+ * Encodes the header: point geometry, the columns and EPSG:3006
+ * @param envelope - Min x, min y, max x, max y, or null without features
+ */
+function encodeFlatGeobufHeader(name: string, envelope: number[] | null, featureCount: number): Uint8Array<ArrayBuffer> {
+	const builder = new FlatBufferBuilder(1024);
+	const columns = FLATGEOBUF_COLUMNS.map((column) => {
+		const columnName = builder.createString(column.name);
+		builder.startTable(11);
+		builder.addFieldOffset(0, columnName);
+		builder.addFieldUint8(1, column.type, 0);
+		return builder.endTable();
+	});
+	const columnVector = builder.createOffsetVector(columns);
+	const crsOrg = builder.createString('EPSG');
+	builder.startTable(6);
+	builder.addFieldOffset(0, crsOrg);
+	builder.addFieldInt32(1, FLATGEOBUF_EPSG_SWEREF99TM, 0);
+	const crs = builder.endTable();
+	const headerName = builder.createString(name);
+	const envelopeVector = envelope ? builder.createDoubleVector(envelope) : 0;
+
+	builder.startTable(14);
+	builder.addFieldOffset(0, headerName);
+	builder.addFieldOffset(1, envelopeVector);
+	builder.addFieldUint8(2, FLATGEOBUF_GEOMETRY_POINT, 0);
+	builder.addFieldOffset(7, columnVector);
+	builder.addFieldUint64(8, featureCount, 0);
+	// Utan objekt finns inget träd, vilket anges med nodstorlek 0
+	builder.addFieldUint16(9, featureCount > 0 ? FLATGEOBUF_NODE_SIZE : 0, FLATGEOBUF_NODE_SIZE);
+	builder.addFieldOffset(10, crs);
+	builder.finishSizePrefixed(builder.endTable());
+	return builder.asUint8Array().slice();
+}
+
+/**
+ * FlatGeobufFeatureEncoder - encodes track fixes and waypoints as point features
+ * The returned bytes are size-prefixed and valid until the next call.
+ */
+class FlatGeobufFeatureEncoder {
+	private readonly builder = new FlatBufferBuilder(512);
+	private properties = new Uint8Array(256);
+	private propertiesView = new DataView(this.properties.buffer);
+	private propertiesLength: number = 0;
+	private readonly encoder = new TextEncoder();
+	private readonly nameSheets = createMapSheetNamer();
+	private readonly formatTime = createExportTimeFormatter();
+	private readonly xy = new Float64Array(2);
+
+	encodeFix(columns: TrackColumns, index: number): Uint8Array<ArrayBuffer> {
+		const northing = columns.northing[index];
+		const easting = columns.easting[index];
+		const speed = columns.speed[index];
+		this.propertiesLength = 0;
+		this.addString(0, this.formatTime(columns.timestamp[index]));
+		this.addDouble(1, columns.accuracy[index]);
+		// Saknad fart blir null genom att värdet utelämnas
+		if (!Number.isNaN(speed)) {
+			this.addDouble(2, speed);
+		}
+		this.addSheets(northing, easting);
+		return this.finish(easting, northing);
+	}
+
+	encodeWaypoint(waypoint: Waypoint): Uint8Array<ArrayBuffer> {
+		this.propertiesLength = 0;
+		this.addSheets(waypoint.northing, waypoint.easting);
+		this.addString(FLATGEOBUF_NAME_COLUMN, waypoint.name);
+		return this.finish(waypoint.easting, waypoint.northing);
+	}
+
+	private addSheets(northing: number, easting: number): void {
+		const sheets = this.nameSheets(northing, easting);
+		for (let k = 0; k < sheets.length; k++) {
+			this.addString(FLATGEOBUF_SHEET_COLUMN + k, sheets[k]);
+		}
+	}
+
+	/**
+	 * Makes room for at least size more property bytes
+	 */
+	private reserve(size: number): void {
+		if (this.propertiesLength + size <= this.properties.length) {
+			return;
+		}
+		const properties = new Uint8Array(Math.max(this.properties.length * 2, this.propertiesLength + size));
+		properties.set(this.properties.subarray(0, this.propertiesLength));
+		this.properties = properties;
+		this.propertiesView = new DataView(properties.buffer);
+	}
+
+	// Egenskaper kodas som kolumnnummer följt av värdet, strängar och
+	// tider med längden först
+	private addDouble(column: number, value: number): void {
+		this.reserve(10);
+		this.propertiesView.setUint16(this.propertiesLength, column, true);
+		this.propertiesView.setFloat64(this.propertiesLength + 2, value, true);
+		this.propertiesLength += 10;
+	}
+
+	private addString(column: number, text: string): void {
+		// UTF-8 tar högst tre byte per UTF-16-enhet
+		this.reserve(6 + text.length * 3);
+		const start = this.propertiesLength + 6;
+		this.propertiesView.setUint16(this.propertiesLength, column, true);
+		// Tider och rutnamn är ASCII och kopieras direkt
+		let written = 0;
+		while (written < text.length) {
+			const code = text.charCodeAt(written);
+			if (code >= 0x80) {
+				written = this.encoder.encodeInto(text, this.properties.subarray(start)).written;
+				break;
+			}
+			this.properties[start + written++] = code;
+		}
+		this.propertiesView.setUint32(this.propertiesLength + 2, written, true);
+		this.propertiesLength = start + written;
+	}
+
+	private finish(x: number, y: number): Uint8Array<ArrayBuffer> {
+		const builder = this.builder;
+		builder.clear();
+		const properties = builder.createByteVector(this.properties.subarray(0, this.propertiesLength));
+		this.xy[0] = x;
+		this.xy[1] = y;
+		const xy = builder.createDoubleVector(this.xy);
+		builder.startTable(8);
+		builder.addFieldOffset(1, xy);
+		const geometry = builder.endTable();
+		builder.startTable(3);
+		builder.addFieldOffset(0, geometry);
+		builder.addFieldOffset(1, properties);
+		builder.finishSizePrefixed(builder.endTable());
+		return builder.asUint8Array();
+	}
+}
+
+/**
+ * Node ranges of each R-tree level, leaves first
+ * The root is node 0 and the leaves come last, as FlatGeobuf requires.
+ * Even a single item gets a root above its leaf.
+ */
+function getFlatGeobufLevelBounds(count: number): Array<[number, number]> {
+	const levelSizes = [count];
+	let size = count;
+	do {
+		size = Math.ceil(size / FLATGEOBUF_NODE_SIZE);
+		levelSizes.push(size);
+	} while (size !== 1);
+	let end = levelSizes.reduce((sum, levelSize) => sum + levelSize, 0);
+	return levelSizes.map((levelSize) => {
+		const bounds: [number, number] = [end - levelSize, end];
+		end -= levelSize;
+		return bounds;
+	});
+}
+
+/**
+ * Sorts points along a Hilbert curve over their extent
+ * @returns Point indices in curve order
+ */
+function sortByHilbertCurve(x: Float64Array, y: Float64Array, count: number, envelope: number[]): Uint32Array {
+	const [minX, minY, maxX, maxY] = envelope;
+	const steps = (1 << GEOFENCE_HILBERT_ORDER) - 1;
+	const xScale = maxX > minX ? steps / (maxX - minX) : 0;
+	const yScale = maxY > minY ? steps / (maxY - minY) : 0;
+	const hilbertValues = new Uint32Array(count);
+	const order = new Uint32Array(count);
+	for (let i = 0; i < count; i++) {
+		hilbertValues[i] = hilbertIndex(Math.floor((x[i] - minX) * xScale), Math.floor((y[i] - minY) * yScale));
+		order[i] = i;
+	}
+	return order.sort((a, b) => hilbertValues[a] - hilbertValues[b]);
+}
+
+function setFlatGeobufNode(
+	view: DataView,
+	node: number,
+	minX: number,
+	minY: number,
+	maxX: number,
+	maxY: number,
+	offset: number
+): void {
+	const position = node * FLATGEOBUF_NODE_BYTES;
+	view.setFloat64(position, minX, true);
+	view.setFloat64(position + 8, minY, true);
+	view.setFloat64(position + 16, maxX, true);
+	view.setFloat64(position + 24, maxY, true);
+	view.setUint32(position + 32, offset >>> 0, true);
+	view.setUint32(position + 36, Math.floor(offset / 0x100000000), true);
+}
+
+/**
+ * Builds the packed R-tree over points in curve order
+ * Leaves point at the byte offset of their feature after the index; inner
+ * nodes at their first child node.
+ * @param featureOffsets - Byte offset of the feature at each curve position
+ */
+function buildFlatGeobufIndex(x: Float64Array, y: Float64Array, order: Uint32Array, featureOffsets: Float64Array): Uint8Array<ArrayBuffer> {
+	const levelBounds = getFlatGeobufLevelBounds(order.length);
+	const index = new Uint8Array(levelBounds[0][1] * FLATGEOBUF_NODE_BYTES);
+	const view = new DataView(index.buffer);
+
+	for (let position = 0; position < order.length; position++) {
+		const item = order[position];
+		setFlatGeobufNode(view, levelBounds[0][0] + position, x[item], y[item], x[item], y[item], featureOffsets[position]);
+	}
+
+	// Föräldranoder omsluter FLATGEOBUF_NODE_SIZE noder i följd på nivån under
+	for (let level = 0; level < levelBounds.length - 1; level++) {
+		const [start, end] = levelBounds[level];
+		let parent = levelBounds[level + 1][0];
+		for (let child = start; child < end; child += FLATGEOBUF_NODE_SIZE) {
+			let minX = Number.POSITIVE_INFINITY;
+			let minY = Number.POSITIVE_INFINITY;
+			let maxX = Number.NEGATIVE_INFINITY;
+			let maxY = Number.NEGATIVE_INFINITY;
+			for (let node = child; node < Math.min(child + FLATGEOBUF_NODE_SIZE, end); node++) {
+				const position = node * FLATGEOBUF_NODE_BYTES;
+				minX = Math.min(minX, view.getFloat64(position, true));
+				minY = Math.min(minY, view.getFloat64(position + 8, true));
+				maxX = Math.max(maxX, view.getFloat64(position + 16, true));
+				maxY = Math.max(maxY, view.getFloat64(position + 24, true));
+			}
+			setFlatGeobufNode(view, parent++, minX, minY, maxX, maxY, child);
+		}
+	}
+	return index;
+}
+
+/**
+ * Writes a track and waypoints as FlatGeobuf
+ *
+ * The first pass reads every chunk for the positions and feature sizes, the
+ * second encodes the features again, window by window in curve order.
+ * Output arrives in pieces of at most FLATGEOBUF_WINDOW_BYTES, except for
+ * the index; a piece is only valid during the call.
+ */
+async function writeFlatGeobuf(
+	name: string,
+	source: FlatGeobufSource,
+	waypoints: readonly Waypoint[],
+	onOutput: (bytes: Uint8Array<ArrayBuffer>) => void
+): Promise<FlatGeobufStats> {
+	const startTime = performance.now();
+	const encoder = new FlatGeobufFeatureEncoder();
+	let capacity = source.chunkCount * TRACK_CHUNK_SIZE + waypoints.length;
+	let x = new Float64Array(capacity);
+	let y = new Float64Array(capacity);
+	let sizes = new Uint32Array(capacity);
+	let chunkOf = new Uint32Array(capacity);
+	const chunkStarts = new Uint32Array(source.chunkCount);
+	let count = 0;
+
+	const add = (easting: number, northing: number, size: number, seq: number) => {
+		// Block kan i princip vara större än TRACK_CHUNK_SIZE
+		if (count === capacity) {
+			capacity *= 2;
+			const grow = <T extends Float64Array | Uint32Array>(array: T, larger: T): T => {
+				larger.set(array);
+				return larger;
+			};
+			x = grow(x, new Float64Array(capacity));
+			y = grow(y, new Float64Array(capacity));
+			sizes = grow(sizes, new Uint32Array(capacity));
+			chunkOf = grow(chunkOf, new Uint32Array(capacity));
+		}
+		x[count] = easting;
+		y[count] = northing;
+		sizes[count] = size;
+		chunkOf[count] = seq;
+		count++;
+	};
+
+	for (let seq = 0; seq < source.chunkCount; seq++) {
+		chunkStarts[seq] = count;
+		const columns = await source.readChunk(seq);
+		for (let i = 0; columns && i < columns.count; i++) {
+			add(columns.easting[i], columns.northing[i], encoder.encodeFix(columns, i).length, seq);
+		}
+	}
+	const fixCount = count;
+	for (const waypoint of waypoints) {
+		add(waypoint.easting, waypoint.northing, encoder.encodeWaypoint(waypoint).length, 0);
+	}
+
+	let envelope: number[] | null = null;
+	if (count > 0) {
+		envelope = [x[0], y[0], x[0], y[0]];
+		for (let i = 1; i < count; i++) {
+			envelope[0] = Math.min(envelope[0], x[i]);
+			envelope[1] = Math.min(envelope[1], y[i]);
+			envelope[2] = Math.max(envelope[2], x[i]);
+			envelope[3] = Math.max(envelope[3], y[i]);
+		}
+	}
+
+	const header = encodeFlatGeobufHeader(name, envelope, count);
+	let byteCount = FLATGEOBUF_MAGIC.length + header.length;
+	onOutput(FLATGEOBUF_MAGIC);
+	onOutput(header);
+	if (envelope === null) {
+		return { featureCount: 0, byteCount, chunkReads: 0, durationMs: performance.now() - startTime };
+	}
+
+	const order = sortByHilbertCurve(x, y, count, envelope);
+	const rank = new Uint32Array(count);
+	const featureOffsets = new Float64Array(count + 1);
+	for (let position = 0; position < count; position++) {
+		rank[order[position]] = position;
+		featureOffsets[position + 1] = featureOffsets[position] + sizes[order[position]];
+	}
+	const index = buildFlatGeobufIndex(x, y, order, featureOffsets);
+	byteCount += index.length + featureOffsets[count];
+	onOutput(index);
+
+	const windowBuffer = new Uint8Array(FLATGEOBUF_WINDOW_BYTES);
+	// Senaste fönstret som varje block lästes för
+	const chunkWindow = new Int32Array(source.chunkCount).fill(-1);
+	let chunkReads = 0;
+	for (let first = 0, windowNumber = 0; first < count; windowNumber++) {
+		let last = first + 1;
+		while (last < count && featureOffsets[last + 1] - featureOffsets[first] <= windowBuffer.length) {
+			last++;
+		}
+		const windowStart = featureOffsets[first];
+		const windowLength = featureOffsets[last] - windowStart;
+		// Bara ett objekt större än fönstret, t.ex. en punkt med mycket långt namn
+		const output = windowLength <= windowBuffer.length ? windowBuffer : new Uint8Array(windowLength);
+		const place = (feature: Uint8Array, item: number, position: number) => {
+			// Trädet pekar på storleken från första läsningen
+			if (feature.length !== sizes[item]) {
+				throw new Error('Spåret ändrades under exporten');
+			}
+			output.set(feature, featureOffsets[position] - windowStart);
+		};
+
+		const seqs: number[] = [];
+		for (let position = first; position < last; position++) {
+			const item = order[position];
+			if (item >= fixCount) {
+				place(encoder.encodeWaypoint(waypoints[item - fixCount]), item, position);
+			} else if (chunkWindow[chunkOf[item]] !== windowNumber) {
+				chunkWindow[chunkOf[item]] = windowNumber;
+				seqs.push(chunkOf[item]);
+			}
+		}
+		seqs.sort((a, b) => a - b);
+		for (const seq of seqs) {
+			const columns = await source.readChunk(seq);
+			chunkReads++;
+			const chunkEnd = seq + 1 < source.chunkCount ? chunkStarts[seq + 1] : fixCount;
+			if (!columns || columns.count !== chunkEnd - chunkStarts[seq]) {
+				throw new Error('Spåret ändrades under exporten');
+			}
+			for (let i = 0; i < columns.count; i++) {
+				const item = chunkStarts[seq] + i;
+				const position = rank[item];
+				if (position >= first && position < last) {
+					place(encoder.encodeFix(columns, i), item, position);
+				}
+			}
+		}
+		onOutput(output.subarray(0, windowLength));
+		first = last;
+	}
+	return { featureCount: count, byteCount, chunkReads, durationMs: performance.now() - startTime };
+}
+
+/**
+ * Exports a stored track and all stored waypoints to a FlatGeobuf File
+ * The pieces are collected as Blob parts, which the browser may keep on
+ * disk, as for the other export formats.
+ */
+async function exportFlatGeobufFile(db: IDBDatabase, track: TrackRecord): Promise<{ file: File; stats: FlatGeobufStats }> {
+	const waypoints = await readAllWaypoints(await openWaypointDatabase());
+	const parts: Blob[] = [];
+	const stats = await writeFlatGeobuf(
+		formatExportTime(track.startTime),
+		{ chunkCount: track.chunkCount, readChunk: (seq) => readTrackChunk(db, track.id, seq) },
+		waypoints,
+		(bytes) => parts.push(new Blob([bytes]))
+	);
+	const file = new File(parts, getTrackExportFileName(track, FLATGEOBUF_EXTENSION, false), { type: FLATGEOBUF_MIME_TYPE });
+	return { file, stats };
+}
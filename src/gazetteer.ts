@@ -0,0 +1,221 @@
+// ============================================================================
+// GAZETTEER (nearest place name from a compact binary file)
+// ============================================================================
+//
+// Ortnamn med positioner i SWEREF 99 TM, sorterade efter ruta i ett
+// rutnät och inom rutan efter namn. Filen läses in som en enda ArrayBuffer
+// och används direkt genom typade vyer: ingenting avkodas i förväg, och
+// bara namnet på närmaste ort avkodas vid en sökning. Minnet är därför
+// filens storlek oavsett hur många frågor som ställs.
+//
+// Layout (little endian, alla fält 4-bytesjusterade):
+//   0  u8[2]       magiskt värde "SG"
+//   2  u8          formatversion
+//   3  u8          reserverad
+//   4  u32         antal orter
+//   8  i32         rutnätets minsta N
+//  12  i32         rutnätets minsta E
+//  16  u32         rutstorlek (m)
+//  20  u32         antal kolumner
+//  24  u32         antal rader
+//  28  u32         antal byte namn
+//  32  u32[r·k+1]  första ort i varje ruta
+//      i32[2n]     N och E för varje ort, hela meter
+//      u32[n+1]    början på varje namn
+//      u8[]        namnen i UTF-8
+//
+// Filen innehåller ingen DOM-kod och kan därför även laddas i Web Workers.
+
+interface GazetteerPlace {
+	name: string;
+	northing: number;
+	easting: number;
+	/** Distance in the SWEREF 99 TM plane, metres */
+	gridDistance: number;
+}
+
+const GAZETTEER_MAGIC_0 = 0x53; // 'S'
+const GAZETTEER_MAGIC_1 = 0x47; // 'G'
+const GAZETTEER_VERSION = 1;
+const GAZETTEER_HEADER_BYTES = 32;
+
+/**
+ * Default grid cell size, metres
+ */
+const GAZETTEER_CELL_SIZE = 10000;
+
+/**
+ * Places further away than this are not reported, metres
+ * Also bounds the number of cells a query visits.
+ */
+const GAZETTEER_MAX_DISTANCE = 100000;
+
+/**
+ * Encodes places into the binary gazetteer format
+ */
+function encodeGazetteer(places: Waypoint[], cellSize: number = GAZETTEER_CELL_SIZE): Uint8Array {
+	const count = places.length;
+	const northing = places.map((place) => Math.round(place.northing));
+	const easting = places.map((place) => Math.round(place.easting));
+	// Inte Math.min(...värden), som spränger stacken för stora ortnamnslistor
+	const min = (values: number[]) => values.reduce((a, b) => Math.min(a, b), Infinity);
+	const max = (values: number[]) => values.reduce((a, b) => Math.max(a, b), -Infinity);
+	const minNorthing = count > 0 ? Math.floor(min(northing) / cellSize) * cellSize : 0;
+	const minEasting = count > 0 ? Math.floor(min(easting) / cellSize) * cellSize : 0;
+	const rows = count > 0 ? Math.floor((max(northing) - minNorthing) / cellSize) + 1 : 1;
+	const columns = count > 0 ? Math.floor((max(easting) - minEasting) / cellSize) + 1 : 1;
+	const cellOf = (i: number) =>
+		Math.floor((northing[i] - minNorthing) / cellSize) * columns + Math.floor((easting[i] - minEasting) / cellSize);
+
+	const order = places.map((_, i) => i).sort((a, b) =>
+		cellOf(a) - cellOf(b) || (places[a].name < places[b].name ? -1 : places[a].name > places[b].name ? 1 : 0));
+
+	const cellCount = rows * columns;
+	const cellStarts = new Uint32Array(cellCount + 1);
+	for (let i = 0; i < count; i++) {
+		cellStarts[cellOf(i) + 1]++;
+	}
+	for (let cell = 0; cell < cellCount; cell++) {
+		cellStarts[cell + 1] += cellStarts[cell];
+	}
+
+	const encoder = new TextEncoder();
+	const names = order.map((i) => encoder.encode(places[i].name));
+	const nameBytes = names.reduce((sum, name) => sum + name.length, 0);
+	const coordinateOffset = GAZETTEER_HEADER_BYTES + 4 * (cellCount + 1);
+	const nameOffsetOffset = coordinateOffset + 8 * count;
+	const nameOffset = nameOffsetOffset + 4 * (count + 1);
+	const bytes = new Uint8Array(nameOffset + nameBytes);
+	const view = new DataView(bytes.buffer);
+
+	view.setUint8(0, GAZETTEER_MAGIC_0);
+	view.setUint8(1, GAZETTEER_MAGIC_1);
+	view.setUint8(2, GAZETTEER_VERSION);
+	view.setUint32(4, count, true);
+	view.setInt32(8, minNorthing, true);
+	view.setInt32(12, minEasting, true);
+	view.setUint32(16, cellSize, true);
+	view.setUint32(20, columns, true);
+	view.setUint32(24, rows, true);
+	view.setUint32(28, nameBytes, true);
+	cellStarts.forEach((start, cell) => view.setUint32(GAZETTEER_HEADER_BYTES + 4 * cell, start, true));
+	let offset = 0;
+	order.forEach((i, position) => {
+		view.setInt32(coordinateOffset + 8 * position, northing[i], true);
+		view.setInt32(coordinateOffset + 8 * position + 4, easting[i], true);
+		view.setUint32(nameOffsetOffset + 4 * position, offset, true);
+		bytes.set(names[position], nameOffset + offset);
+		offset += names[position].length;
+	});
+	view.setUint32(nameOffsetOffset + 4 * count, offset, true);
+	return bytes;
+}
+
+class Gazetteer {
+	private readonly minNorthing: number;
+	private readonly minEasting: number;
+	private readonly cellSize: number;
+	private readonly columns: number;
+	private readonly rows: number;
+	private readonly cellStarts: Uint32Array;
+	private readonly coordinates: Int32Array;
+	private readonly nameOffsets: Uint32Array;
+	private readonly names: Uint8Array;
+	private readonly decoder = new TextDecoder();
+	private lastIndex: number = -1;
+	private lastName: string = '';
+
+	/**
+	 * Wraps a gazetteer file without copying or decoding it
+	 * The views assume little endian, which every browser in use has.
+	 * @throws Error if the data is not a complete gazetteer file
+	 */
+	constructor(buffer: ArrayBuffer) {
+		const view = new DataView(buffer);
+		if (buffer.byteLength < GAZETTEER_HEADER_BYTES || view.getUint8(0) !== GAZETTEER_MAGIC_0 || view.getUint8(1) !== GAZETTEER_MAGIC_1) {
+			throw new Error('Ogiltig ortnamnsfil');
+		}
+		const version = view.getUint8(2);
+		if (version !== GAZETTEER_VERSION) {
+			throw new Error(`Ortnamnsfilen har okänd version ${version}`);
+		}
+		const count = view.getUint32(4, true);
+		this.minNorthing = view.getInt32(8, true);
+		this.minEasting = view.getInt32(12, true);
+		this.cellSize = view.getUint32(16, true);
+		this.columns = view.getUint32(20, true);
+		this.rows = view.getUint32(24, true);
+		const nameBytes = view.getUint32(28, true);
+
+		const coordinateOffset = GAZETTEER_HEADER_BYTES + 4 * (this.rows * this.columns + 1);
+		const nameOffsetOffset = coordinateOffset + 8 * count;
+		const nameOffset = nameOffsetOffset + 4 * (count + 1);
+		if (buffer.byteLength < nameOffset + nameBytes) {
+			throw new Error('Ortnamnsfilen är trunkerad');
+		}
+		this.cellStarts = new Uint32Array(buffer, GAZETTEER_HEADER_BYTES, this.rows * this.columns + 1);
+		this.coordinates = new Int32Array(buffer, coordinateOffset, 2 * count);
+		this.nameOffsets = new Uint32Array(buffer, nameOffsetOffset, count + 1);
+		this.names = new Uint8Array(buffer, nameOffset, nameBytes);
+	}
+
+	get size(): number {
+		return this.nameOffsets.length - 1;
+	}
+
+	/**
+	 * Finds the nearest place within maxDistance metres of a SWEREF 99 TM position
+	 * Searches rings of cells outwards and stops when the next ring cannot
+	 * hold anything nearer.
+	 */
+	nearest(northing: number, easting: number, maxDistance: number = GAZETTEER_MAX_DISTANCE): GazetteerPlace | null {
+		const { coordinates, cellStarts, cellSize, columns, rows } = this;
+		const centerRow = Math.floor((northing - this.minNorthing) / cellSize);
+		const centerColumn = Math.floor((easting - this.minEasting) / cellSize);
+		const maxRing = Math.ceil(maxDistance / cellSize);
+		let best = -1;
+		let bestDistanceSquared = maxDistance * maxDistance;
+
+		for (let ring = 0; ring <= maxRing; ring++) {
+			const gap = (ring - 1) * cellSize;
+			if (ring > 0 && gap * gap >= bestDistanceSquared) {
+				break;
+			}
+			const rowLow = centerRow - ring;
+			const rowHigh = centerRow + ring;
+			for (let row = Math.max(rowLow, 0); row <= Math.min(rowHigh, rows - 1); row++) {
+				const step = row === rowLow || row === rowHigh ? 1 : 2 * ring;
+				for (let column = centerColumn - ring; column <= centerColumn + ring; column += Math.max(step, 1)) {
+					if (column < 0 || column >= columns) {
+						continue;
+					}
+					const cell = row * columns + column;
+					for (let i = cellStarts[cell]; i < cellStarts[cell + 1]; i++) {
+						const dn = coordinates[2 * i] - northing;
+						const de = coordinates[2 * i + 1] - easting;
+						const distanceSquared = dn * dn + de * de;
+						if (distanceSquared < bestDistanceSquared) {
+							best = i;
+							bestDistanceSquared = distanceSquared;
+						}
+					}
+				}
+			}
+		}
+
+		if (best < 0) {
+			return null;
+		}
+		// Positioner i följd har oftast samma närmaste ort; avkoda namnet bara när den byts
+		if (best !== this.lastIndex) {
+			this.lastIndex = best;
+			this.lastName = this.decoder.decode(this.names.subarray(this.nameOffsets[best], this.nameOffsets[best + 1]));
+		}
+		return {
+			name: this.lastName,
+			northing: coordinates[2 * best],
+			easting: coordinates[2 * best + 1],
+			gridDistance: Math.sqrt(bestDistanceSquared)
+		};
+	}
+}
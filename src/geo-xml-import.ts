@@ -0,0 +1,633 @@
+// ============================================================================
+// GPX AND KML IMPORT (streaming XML parser)
+// ============================================================================
+//
+// Läser GPX- och KML-filer som en ström utan att bygga ett DOM-träd. En
+// SAX-liknande tolk (XmlStreamParser) tar emot texten i bitar av valfri
+// storlek och rapporterar start- och sluttaggar och text. GeoXmlImporter
+// plockar ut punkter (GPX wpt och rtept, KML Point) och spårpunkter (GPX
+// trkpt, KML LineString och gx:Track), samlar dem i satser som projiceras
+// till SWEREF 99 TM i ett svep och lämnar satserna vidare. Även en
+// LineString med miljontals koordinater i ett enda textelement tolkas
+// bit för bit, så minnet beror på satsens storlek och inte på filens.
+//
+// Latitud och longitud behandlas som SWEREF 99 (ETRS89) utan korrektion
+// för kontinentaldrift, som vid import av CSV. Filen innehåller ingen
+// DOM-kod och körs i spårarbetaren.
+
+/**
+ * Receives the parts of an XML document in order
+ * Names are local names, without a namespace prefix.
+ */
+interface XmlStreamHandler {
+	/**
+	 * @param attributes - Raw attribute text, read with getXmlAttribute()
+	 */
+	open(name: string, attributes: string): void;
+	close(name: string): void;
+	/** Text, possibly split in several calls, with entities decoded */
+	text(text: string): void;
+}
+
+/**
+ * What an import added
+ */
+interface GeoImportStats {
+	waypointCount: number;
+	trackCount: number;
+	trackPointCount: number;
+	byteCount: number;
+	durationMs: number;
+}
+
+/**
+ * Points projected per batch
+ */
+const GEO_IMPORT_BATCH_SIZE = 4096;
+/** Accuracy of track points without hdop or accuracy, as in trace replay */
+const GEO_IMPORT_DEFAULT_ACCURACY_METERS = 5;
+/** Time between track points without a time, ms */
+const GEO_IMPORT_DEFAULT_INTERVAL_MS = 1000;
+const GEO_IMPORT_DEFAULT_NAME = 'Punkt';
+
+const XML_ENTITY_PATTERN = /&(?:#(\d+)|#x([0-9a-fA-F]+)|(amp|lt|gt|quot|apos));/g;
+const XML_NAMED_ENTITIES: Record<string, string> = { amp: '&', lt: '<', gt: '>', quot: '"', apos: "'" };
+const XML_ATTRIBUTE_PATTERN = /([^\s=]+)\s*=\s*(?:"([^"]*)"|'([^']*)')/g;
+const XML_WHITESPACE_PATTERN = /\s+/;
+
+function decodeXmlEntities(text: string): string {
+	if (!text.includes('&')) {
+		return text;
+	}
+	return text.replace(XML_ENTITY_PATTERN, (entity, decimal?: string, hex?: string, named?: string) => {
+		if (decimal !== undefined) {
+			return String.fromCodePoint(Number(decimal));
+		}
+		if (hex !== undefined) {
+			return String.fromCodePoint(Number.parseInt(hex, 16));
+		}
+		return XML_NAMED_ENTITIES[named ?? ''] ?? entity;
+	});
+}
+
+function getXmlLocalName(name: string): string {
+	const colon = name.indexOf(':');
+	return colon < 0 ? name : name.slice(colon + 1);
+}
+
+/**
+ * Reads an attribute by local name from the raw attribute text of a tag
+ * @returns null when the attribute is missing
+ */
+function getXmlAttribute(attributes: string, name: string): string | null {
+	XML_ATTRIBUTE_PATTERN.lastIndex = 0;
+	let match: RegExpExecArray | null;
+	while ((match = XML_ATTRIBUTE_PATTERN.exec(attributes)) !== null) {
+		if (getXmlLocalName(match[1]) === name) {
+			return decodeXmlEntities(match[2] ?? match[3]);
+		}
+	}
+	return null;
+}
+
+/**
+ * XmlStreamParser - a SAX-style XML tokenizer for text arriving in pieces
+ *
+ * Comments, processing instructions and declarations are skipped; CDATA is
+ * reported as text. Only an unfinished tag, or an entity split between two
+ * pieces, is held back until the next piece.
+ */
+class XmlStreamParser {
+	private rest: string = '';
+
+	constructor(private readonly handler: XmlStreamHandler) {}
+
+	push(text: string): void {
+		const data = this.rest + text;
+		let position = 0;
+		for (;;) {
+			const start = data.indexOf('<', position);
+			if (start < 0) {
+				position = this.emitText(data, position, data.length, true);
+				break;
+			}
+			this.emitText(data, position, start, false);
+			const end = this.findMarkupEnd(data, start);
+			if (end < 0) {
+				position = start;
+				break;
+			}
+			this.handleMarkup(data, start, end);
+			position = end;
+		}
+		this.rest = data.slice(position);
+	}
+
+	/**
+	 * Reports text left after the last tag
+	 */
+	end(): void {
+		this.emitText(this.rest, 0, this.rest.length, false);
+		this.rest = '';
+	}
+
+	/**
+	 * Reports text between start and end
+	 * @param keepEntity - Hold back a trailing entity that may be incomplete
+	 * @returns Where the held-back text starts
+	 */
+	private emitText(data: string, start: number, end: number, keepEntity: boolean): number {
+		let textEnd = end;
+		if (keepEntity) {
+			const ampersand = data.lastIndexOf('&', end - 1);
+			if (ampersand >= start && data.indexOf(';', ampersand) < 0) {
+				textEnd = ampersand;
+			}
+		}
+		if (textEnd > start) {
+			this.handler.text(decodeXmlEntities(data.slice(start, textEnd)));
+		}
+		return textEnd;
+	}
+
+	/**
+	 * Offset just past the markup starting at start
+	 * @returns -1 when the markup continues in the next piece
+	 */
+	private findMarkupEnd(data: string, start: number): number {
+		const find = (terminator: string, from: number) => {
+			const index = data.indexOf(terminator, from);
+			return index < 0 ? -1 : index + terminator.length;
+		};
+		if (data.startsWith('<!--', start)) {
+			return find('-->', start + 4);
+		}
+		if (data.startsWith('<![CDATA[', start)) {
+			return find(']]>', start + 9);
+		}
+		if (data.startsWith('<?', start)) {
+			return find('?>', start + 2);
+		}
+		// Citerade attributvärden får innehålla '>'
+		let quote = '';
+		for (let i = start + 1; i < data.length; i++) {
+			const character = data[i];
+			if (quote !== '') {
+				if (character === quote) {
+					quote = '';
+				}
+			} else if (character === '"' || character === "'") {
+				quote = character;
+			} else if (character === '>') {
+				return i + 1;
+			}
+		}
+		// Ett prefix som ännu kan bli en kommentar eller CDATA väntar också
+		return -1;
+	}
+
+	private handleMarkup(data: string, start: number, end: number): void {
+		const second = data[start + 1];
+		if (second === '!') {
+			if (data.startsWith('<![CDATA[', start)) {
+				this.handler.text(data.slice(start + 9, end - 3));
+			}
+			return;
+		}
+		if (second === '?') {
+			return;
+		}
+		if (second === '/') {
+			this.handler.close(getXmlLocalName(data.slice(start + 2, end - 1).trim()));
+			return;
+		}
+		const selfClosing = data[end - 2] === '/';
+		const content = data.slice(start + 1, selfClosing ? end - 2 : end - 1);
+		const space = content.search(XML_WHITESPACE_PATTERN);
+		const name = getXmlLocalName(space < 0 ? content : content.slice(0, space));
+		this.handler.open(name, space < 0 ? '' : content.slice(space));
+		if (selfClosing) {
+			this.handler.close(name);
+		}
+	}
+}
+
+/**
+ * Whether a file name is a GPX or KML file
+ */
+function isGeoXmlFileName(name: string): boolean {
+	return /\.(gpx|kml)$/i.test(name);
+}
+
+/**
+ * GeoXmlImporter - extracts waypoints and tracks from GPX or KML
+ *
+ * Waypoints and track points are handed on in projected batches: waypoints
+ * through onWaypoints and track points through onTrackPoints, followed by
+ * onTrackEnd for each track (GPX trk, KML LineString or gx:Track) that had
+ * points. Batch columns are reused and must be copied by the receiver.
+ * Track points without a time follow the previous one by a second, the
+ * first of them at defaultStartTime.
+ */
+class GeoXmlImporter implements XmlStreamHandler {
+	onWaypoints: (waypoints: Waypoint[]) => void = () => {};
+	onTrackPoints: (columns: TrackColumns) => void = () => {};
+	onTrackEnd: () => void = () => {};
+
+	private readonly parser = new XmlStreamParser(this);
+	/** Local names of the open elements */
+	private readonly path: string[] = [];
+	/** Collected text of the element being read, or null */
+	private capture: string | null = null;
+
+	private waypointNames: string[] = [];
+	private readonly waypointLatitude = new Float64Array(GEO_IMPORT_BATCH_SIZE);
+	private readonly waypointLongitude = new Float64Array(GEO_IMPORT_BATCH_SIZE);
+	private readonly waypointNorthing = new Float64Array(GEO_IMPORT_BATCH_SIZE);
+	private readonly waypointEasting = new Float64Array(GEO_IMPORT_BATCH_SIZE);
+
+	private readonly trackBatch: TrackColumns = createTrackColumns(GEO_IMPORT_BATCH_SIZE);
+	private readonly trackLatitude = new Float64Array(GEO_IMPORT_BATCH_SIZE);
+	private readonly trackLongitude = new Float64Array(GEO_IMPORT_BATCH_SIZE);
+	private inTrack: boolean = false;
+	private lastTimestamp: number;
+
+	/** The point being read: a GPX wpt, rtept or trkpt */
+	private pointLatitude: number = Number.NaN;
+	private pointLongitude: number = Number.NaN;
+	private pointName: string = '';
+	private pointTime: number = Number.NaN;
+	private pointHdop: number = Number.NaN;
+	private pointAccuracy: number = Number.NaN;
+	private pointSpeed: number = Number.NaN;
+
+	/** The KML Placemark being read */
+	private placemarkName: string = '';
+	private readonly placemarkPoints: number[] = [];
+	/** Unfinished coordinate tuple at the end of the latest text piece */
+	private coordinateRest: string = '';
+	/** Times of the gx:Track being read; its coordinates follow them */
+	private trackTimes: number[] = [];
+	private trackCoordinateIndex: number = 0;
+
+	private waypoints: number = 0;
+	private tracks: number = 0;
+	private trackPoints: number = 0;
+	private trackHasPoints: boolean = false;
+
+	constructor(defaultStartTime: number) {
+		this.lastTimestamp = defaultStartTime - GEO_IMPORT_DEFAULT_INTERVAL_MS;
+	}
+
+	get waypointCount(): number {
+		return this.waypoints;
+	}
+
+	/**
+	 * Tracks with at least one point
+	 */
+	get trackCount(): number {
+		return this.tracks;
+	}
+
+	get trackPointCount(): number {
+		return this.trackPoints;
+	}
+
+	push(text: string): void {
+		this.parser.push(text);
+	}
+
+	/**
+	 * Hands on the last batches
+	 */
+	end(): void {
+		this.parser.end();
+		this.endTrack();
+		this.flushWaypoints();
+	}
+
+	open(name: string, attributes: string): void {
+		const parent = this.path.length > 0 ? this.path[this.path.length - 1] : '';
+		this.path.push(name);
+		switch (name) {
+			case 'wpt':
+			case 'rtept':
+			case 'trkpt':
+				this.pointLatitude = Number.parseFloat(getXmlAttribute(attributes, 'lat') ?? '');
+				this.pointLongitude = Number.parseFloat(getXmlAttribute(attributes, 'lon') ?? '');
+				this.pointName = '';
+				this.pointTime = Number.NaN;
+				this.pointHdop = Number.NaN;
+				this.pointAccuracy = Number.NaN;
+				this.pointSpeed = Number.NaN;
+				break;
+			case 'trk':
+			case 'LineString':
+				this.startTrack();
+				break;
+			case 'Track':
+				this.startTrack();
+				this.trackTimes = [];
+				this.trackCoordinateIndex = 0;
+				break;
+			case 'Placemark':
+				this.placemarkName = '';
+				this.placemarkPoints.length = 0;
+				break;
+			case 'coordinates':
+				this.coordinateRest = '';
+				break;
+			case 'name':
+			case 'time':
+			case 'hdop':
+			case 'accuracy':
+			case 'speed':
+			case 'when':
+			case 'coord':
+				if (this.isCapturedChild(name, parent)) {
+					this.capture = '';
+				}
+				break;
+		}
+	}
+
+	text(text: string): void {
+		if (this.capture !== null) {
+			this.capture += text;
+		} else if (this.path[this.path.length - 1] === 'coordinates') {
+			this.readCoordinates(text, false);
+		}
+	}
+
+	close(name: string): void {
+		if (name === 'coordinates') {
+			// Den sista koordinaten läses medan elementet ännu är öppet
+			this.readCoordinates('', true);
+		}
+		this.path.pop();
+		const parent = this.path.length > 0 ? this.path[this.path.length - 1] : '';
+		const value = this.capture ?? '';
+		const isCaptured = this.capture !== null;
+		this.capture = null;
+		switch (name) {
+			case 'wpt':
+			case 'rtept':
+				this.addWaypoint(this.pointName, this.pointLatitude, this.pointLongitude);
+				break;
+			case 'trkpt':
+				this.addTrackPoint(this.pointLatitude, this.pointLongitude, this.pointTime, this.pointHdop, this.pointAccuracy, this.pointSpeed);
+				break;
+			case 'trk':
+			case 'LineString':
+			case 'Track':
+				this.endTrack();
+				break;
+			case 'Placemark':
+				for (let i = 0; i + 1 < this.placemarkPoints.length; i += 2) {
+					this.addWaypoint(this.placemarkName, this.placemarkPoints[i + 1], this.placemarkPoints[i]);
+				}
+				break;
+		}
+		if (isCaptured) {
+			this.readCapturedText(name, parent, value.trim());
+		}
+	}
+
+	private readCapturedText(name: string, parent: string, value: string): void {
+		switch (name) {
+			case 'name':
+				if (parent === 'Placemark') {
+					this.placemarkName = value;
+				} else {
+					this.pointName = value;
+				}
+				break;
+			case 'time':
+				this.pointTime = Date.parse(value);
+				break;
+			case 'hdop':
+				this.pointHdop = Number.parseFloat(value);
+				break;
+			case 'accuracy':
+				this.pointAccuracy = Number.parseFloat(value);
+				break;
+			case 'speed':
+				this.pointSpeed = Number.parseFloat(value);
+				break;
+			case 'when':
+				this.trackTimes.push(Date.parse(value));
+				break;
+			case 'coord': {
+				const [longitude, latitude] = value.split(XML_WHITESPACE_PATTERN).map(Number);
+				const time = this.trackTimes[this.trackCoordinateIndex++] ?? Number.NaN;
+				this.addTrackPoint(latitude, longitude, time, Number.NaN, Number.NaN, Number.NaN);
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Whether the text of an element is needed: the children of a GPX point
+	 * and its extensions, the name of a Placemark and the times and
+	 * coordinates of a gx:Track
+	 */
+	private isCapturedChild(name: string, parent: string): boolean {
+		switch (parent) {
+			case 'wpt':
+			case 'rtept':
+			case 'trkpt':
+			case 'extensions':
+			case 'TrackPointExtension':
+				return name !== 'when' && name !== 'coord';
+			case 'Placemark':
+				return name === 'name';
+			case 'Track':
+				return name === 'when' || name === 'coord';
+			default:
+				return false;
+		}
+	}
+
+	/**
+	 * Reads "lon,lat[,alt]" tuples separated by whitespace
+	 * @param isLast - The element ends, so the held-back tuple is complete
+	 */
+	private readCoordinates(text: string, isLast: boolean): void {
+		const data = this.coordinateRest + text;
+		const tuples = data.split(XML_WHITESPACE_PATTERN);
+		// Den sista kan fortsätta i nästa textbit
+		this.coordinateRest = isLast ? '' : tuples.pop() ?? '';
+		const geometry = this.path[this.path.length - 2];
+		for (const tuple of tuples) {
+			if (tuple === '') {
+				continue;
+			}
+			const comma = tuple.indexOf(',');
+			if (comma < 0) {
+				continue;
+			}
+			const longitude = Number(tuple.slice(0, comma));
+			const latitude = Number.parseFloat(tuple.slice(comma + 1));
+			if (geometry === 'Point') {
+				this.placemarkPoints.push(longitude, latitude);
+			} else if (geometry === 'LineString') {
+				this.addTrackPoint(latitude, longitude, Number.NaN, Number.NaN, Number.NaN, Number.NaN);
+			}
+		}
+	}
+
+	private addWaypoint(name: string, latitude: number, longitude: number): void {
+		if (!isValidGeoCoordinate(latitude, longitude)) {
+			return;
+		}
+		const i = this.waypointNames.length;
+		this.waypointNames.push(name !== '' ? name : `${GEO_IMPORT_DEFAULT_NAME} ${this.waypoints + 1}`);
+		this.waypointLatitude[i] = latitude;
+		this.waypointLongitude[i] = longitude;
+		this.waypoints++;
+		if (this.waypointNames.length === GEO_IMPORT_BATCH_SIZE) {
+			this.flushWaypoints();
+		}
+	}
+
+	private addTrackPoint(latitude: number, longitude: number, time: number, hdop: number, accuracy: number, speed: number): void {
+		if (!this.inTrack || !isValidGeoCoordinate(latitude, longitude)) {
+			return;
+		}
+		const timestamp = Number.isFinite(time) ? time : this.lastTimestamp + GEO_IMPORT_DEFAULT_INTERVAL_MS;
+		this.lastTimestamp = timestamp;
+		const batch = this.trackBatch;
+		const i = batch.count++;
+		batch.timestamp[i] = timestamp;
+		batch.accuracy[i] = Number.isFinite(accuracy)
+			? accuracy
+			: Number.isFinite(hdop) ? hdop * NMEA_HDOP_ACCURACY_METERS : GEO_IMPORT_DEFAULT_ACCURACY_METERS;
+		batch.speed[i] = Number.isFinite(speed) ? speed : Number.NaN;
+		this.trackLatitude[i] = latitude;
+		this.trackLongitude[i] = longitude;
+		this.trackPoints++;
+		if (!this.trackHasPoints) {
+			this.trackHasPoints = true;
+			this.tracks++;
+		}
+		if (batch.count === GEO_IMPORT_BATCH_SIZE) {
+			this.flushTrackPoints();
+		}
+	}
+
+	private startTrack(): void {
+		// Ett gx:Track i en gx:MultiTrack blir ett eget spår
+		this.endTrack();
+		this.inTrack = true;
+	}
+
+	private endTrack(): void {
+		if (!this.inTrack) {
+			return;
+		}
+		this.flushTrackPoints();
+		this.inTrack = false;
+		if (this.trackHasPoints) {
+			this.trackHasPoints = false;
+			this.onTrackEnd();
+		}
+	}
+
+	private flushTrackPoints(): void {
+		const batch = this.trackBatch;
+		if (batch.count === 0) {
+			return;
+		}
+		projectToSweref99tmBatch(
+			this.trackLatitude.subarray(0, batch.count),
+			this.trackLongitude.subarray(0, batch.count),
+			batch.northing,
+			batch.easting
+		);
+		this.onTrackPoints(batch);
+		batch.count = 0;
+	}
+
+	private flushWaypoints(): void {
+		const count = this.waypointNames.length;
+		if (count === 0) {
+			return;
+		}
+		projectToSweref99tmBatch(
+			this.waypointLatitude.subarray(0, count),
+			this.waypointLongitude.subarray(0, count),
+			this.waypointNorthing,
+			this.waypointEasting
+		);
+		const waypoints: Waypoint[] = this.waypointNames.map((name, i) => ({
+			name,
+			northing: this.waypointNorthing[i],
+			easting: this.waypointEasting[i]
+		}));
+		this.waypointNames = [];
+		this.onWaypoints(waypoints);
+	}
+}
+
+function isValidGeoCoordinate(latitude: number, longitude: number): boolean {
+	return Math.abs(latitude) <= 90 && Math.abs(longitude) <= 180;
+}
+
+/**
+ * Imports the waypoints and tracks of a GPX or KML file into storage
+ * The file is read as a stream; each piece is written before the next is
+ * read, so memory does not depend on the file size. Each track becomes a
+ * stored track of its own.
+ */
+async function importGeoXmlFile(file: Blob): Promise<GeoImportStats> {
+	const startTime = performance.now();
+	const waypointDb = await openWaypointDatabase();
+	const importer = new GeoXmlImporter(Date.now());
+	const recorder = new TrackRecorder();
+	let waypointWrites: Promise<void> = Promise.resolve();
+
+	importer.onWaypoints = (waypoints) => {
+		waypointWrites = waypointWrites.then(() => addWaypoints(waypointDb, waypoints));
+	};
+	importer.onTrackPoints = (columns) => {
+		// Spåret skapas med den första punktens tid
+		recorder.start(columns.timestamp[0]);
+		for (let i = 0; i < columns.count; i++) {
+			const speed = columns.speed[i];
+			recorder.append({
+				timestamp: columns.timestamp[i],
+				northing: columns.northing[i],
+				easting: columns.easting[i],
+				accuracy: columns.accuracy[i],
+				speed: Number.isNaN(speed) ? null : speed
+			});
+		}
+	};
+	importer.onTrackEnd = () => {
+		void recorder.stop();
+	};
+
+	const reader = file.stream().getReader();
+	const decoder = new TextDecoder();
+	for (;;) {
+		const { done, value } = await reader.read();
+		if (done) {
+			break;
+		}
+		importer.push(decoder.decode(value, { stream: true }));
+		// Vänta in skrivningar så att köade satser inte växer obegränsat
+		await Promise.all([waypointWrites, recorder.waitForWrites()]);
+	}
+	importer.push(decoder.decode());
+	importer.end();
+	await Promise.all([waypointWrites, recorder.stop()]);
+
+	return {
+		waypointCount: importer.waypointCount,
+		trackCount: importer.trackCount,
+		trackPointCount: importer.trackPointCount,
+		byteCount: file.size,
+		durationMs: performance.now() - startTime
+	};
+}
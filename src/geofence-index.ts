@@ -0,0 +1,354 @@
+// ============================================================================
+// GEOFENCE INDEX (packed R-tree and point-in-polygon in SWEREF 99 TM)
+// ============================================================================
+//
+// Larm när man går in i eller ut ur ett område, t.ex. fastigheter,
+// skyddsområden eller arbetsområden, med tusentals polygoner per projekt.
+// Polygonerna ligger i SWEREF 99 TM så att varje position bara behöver
+// plana jämförelser.
+//
+// Områdenas omslutande rektanglar ligger i ett packat R-träd: rektanglarna
+// sorteras längs en Hilbertkurva och packas nedifrån och upp i noder med ett
+// fast antal barn. Trädet byggs en gång och ändras inte. En position söker
+// fram de få områden vars rektangel innehåller den, och bara dessa testas
+// med punkt-i-polygon.
+//
+// Nära en gräns hoppar positionen fram och tillbaka över den. Ett område
+// räknas därför som lämnat eller inträtt först när positionen ligger en bit
+// från gränsen.
+//
+// Filen innehåller ingen DOM-kod och kan därför även laddas i Web Workers.
+
+/**
+ * Polygon or multipolygon in SWEREF 99 TM
+ * Vertices are interleaved northing, easting pairs. Ring r covers vertices
+ * ringStarts[r] to ringStarts[r + 1] - 1; outer rings and holes are not told
+ * apart, since the even-odd rule handles both.
+ */
+interface GeofencePolygon {
+	name: string;
+	coordinates: Float64Array;
+	ringStarts: Int32Array;
+}
+
+interface GeofenceEvents {
+	entered: string[];
+	exited: string[];
+	/**
+	 * Whether the set of areas the position is inside changed; the set starts
+	 * empty, so a first position outside all areas does not change it
+	 */
+	changed: boolean;
+}
+
+/**
+ * Number of children per R-tree node
+ */
+const GEOFENCE_NODE_SIZE = 16;
+
+/**
+ * Distance from the boundary a position must reach before the state of an
+ * area changes, metres
+ */
+const GEOFENCE_HYSTERESIS_METERS = 3;
+
+/**
+ * Hilbert curve order used to sort the boxes; 2^16 steps per axis
+ */
+const GEOFENCE_HILBERT_ORDER = 16;
+
+/**
+ * Distance along a Hilbert curve of order GEOFENCE_HILBERT_ORDER
+ */
+function hilbertIndex(x: number, y: number): number {
+	const n = 1 << GEOFENCE_HILBERT_ORDER;
+	let d = 0;
+	for (let s = n >> 1; s > 0; s >>= 1) {
+		const rx = (x & s) > 0 ? 1 : 0;
+		const ry = (y & s) > 0 ? 1 : 0;
+		d += s * s * ((3 * rx) ^ ry);
+		// Vrid kvadranten så att kurvan hänger ihop
+		if (ry === 0) {
+			if (rx === 1) {
+				x = n - 1 - x;
+				y = n - 1 - y;
+			}
+			const swap = x;
+			x = y;
+			y = swap;
+		}
+	}
+	return d;
+}
+
+/**
+ * PackedRTree - statiskt R-träd över rektanglar i SWEREF 99 TM
+ */
+class PackedRTree {
+	readonly size: number;
+	// Fyra tal per nod: minsta och största nord, minsta och största öst
+	private boxes: Float64Array;
+	// Löv: index till rektangeln; inre noder: nodnummer för första barnet
+	private indices: Int32Array;
+	// Slutposition i boxes för varje nivå, löven först
+	private levelBounds: number[];
+	private stack: number[] = [];
+
+	/**
+	 * @param bounds - Four numbers per item: min northing, min easting, max northing, max easting
+	 */
+	constructor(bounds: Float64Array) {
+		const count = bounds.length / 4;
+		this.size = count;
+
+		let nodeCount = count;
+		let levelSize = count;
+		this.levelBounds = [count * 4];
+		while (levelSize > 1) {
+			levelSize = Math.ceil(levelSize / GEOFENCE_NODE_SIZE);
+			nodeCount += levelSize;
+			this.levelBounds.push(nodeCount * 4);
+		}
+		this.boxes = new Float64Array(nodeCount * 4);
+		this.indices = new Int32Array(nodeCount);
+		if (count === 0) {
+			return;
+		}
+
+		// Löven sorteras efter rektanglarnas mittpunkter längs Hilbertkurvan
+		let minNorth = Number.POSITIVE_INFINITY;
+		let minEast = Number.POSITIVE_INFINITY;
+		let maxNorth = Number.NEGATIVE_INFINITY;
+		let maxEast = Number.NEGATIVE_INFINITY;
+		for (let i = 0; i < count; i++) {
+			minNorth = Math.min(minNorth, bounds[4 * i]);
+			minEast = Math.min(minEast, bounds[4 * i + 1]);
+			maxNorth = Math.max(maxNorth, bounds[4 * i + 2]);
+			maxEast = Math.max(maxEast, bounds[4 * i + 3]);
+		}
+		const steps = (1 << GEOFENCE_HILBERT_ORDER) - 1;
+		const northScale = maxNorth > minNorth ? steps / (maxNorth - minNorth) : 0;
+		const eastScale = maxEast > minEast ? steps / (maxEast - minEast) : 0;
+		const hilbertValues = new Float64Array(count);
+		for (let i = 0; i < count; i++) {
+			const centerNorth = (bounds[4 * i] + bounds[4 * i + 2]) / 2;
+			const centerEast = (bounds[4 * i + 1] + bounds[4 * i + 3]) / 2;
+			hilbertValues[i] = hilbertIndex(
+				Math.floor((centerEast - minEast) * eastScale),
+				Math.floor((centerNorth - minNorth) * northScale)
+			);
+		}
+		const order = Array.from({ length: count }, (_, i) => i).sort((a, b) => hilbertValues[a] - hilbertValues[b]);
+		order.forEach((item, position) => {
+			this.boxes.set(bounds.subarray(4 * item, 4 * item + 4), 4 * position);
+			this.indices[position] = item;
+		});
+
+		// Föräldranoder omsluter GEOFENCE_NODE_SIZE noder i följd på nivån under
+		let parent = count;
+		for (let level = 0; level < this.levelBounds.length - 1; level++) {
+			const end = this.levelBounds[level] / 4;
+			for (let child = level === 0 ? 0 : this.levelBounds[level - 1] / 4; child < end; child += GEOFENCE_NODE_SIZE) {
+				let nodeMinNorth = Number.POSITIVE_INFINITY;
+				let nodeMinEast = Number.POSITIVE_INFINITY;
+				let nodeMaxNorth = Number.NEGATIVE_INFINITY;
+				let nodeMaxEast = Number.NEGATIVE_INFINITY;
+				for (let i = child; i < Math.min(child + GEOFENCE_NODE_SIZE, end); i++) {
+					nodeMinNorth = Math.min(nodeMinNorth, this.boxes[4 * i]);
+					nodeMinEast = Math.min(nodeMinEast, this.boxes[4 * i + 1]);
+					nodeMaxNorth = Math.max(nodeMaxNorth, this.boxes[4 * i + 2]);
+					nodeMaxEast = Math.max(nodeMaxEast, this.boxes[4 * i + 3]);
+				}
+				this.boxes[4 * parent] = nodeMinNorth;
+				this.boxes[4 * parent + 1] = nodeMinEast;
+				this.boxes[4 * parent + 2] = nodeMaxNorth;
+				this.boxes[4 * parent + 3] = nodeMaxEast;
+				this.indices[parent] = child;
+				parent++;
+			}
+		}
+	}
+
+	/**
+	 * Collects the items whose box contains a position
+	 * @param results - Receives the item indices; cleared first
+	 */
+	search(northing: number, easting: number, results: number[]): number[] {
+		results.length = 0;
+		if (this.size === 0) {
+			return results;
+		}
+
+		const { boxes, indices, levelBounds, stack } = this;
+		const leafEnd = this.size * 4;
+		let level = levelBounds.length - 1;
+		let position = boxes.length - 4;
+		stack.length = 0;
+		for (;;) {
+			const end = Math.min(position + GEOFENCE_NODE_SIZE * 4, levelBounds[level]);
+			for (let i = position; i < end; i += 4) {
+				if (northing < boxes[i] || easting < boxes[i + 1] || northing > boxes[i + 2] || easting > boxes[i + 3]) {
+					continue;
+				}
+				if (i < leafEnd) {
+					results.push(indices[i >> 2]);
+				} else {
+					stack.push(indices[i >> 2] * 4, level - 1);
+				}
+			}
+			if (stack.length === 0) {
+				return results;
+			}
+			level = stack.pop()!;
+			position = stack.pop()!;
+		}
+	}
+}
+
+/**
+ * Tests a position against a polygon with the even-odd rule
+ */
+function isInsideGeofence(polygon: GeofencePolygon, northing: number, easting: number): boolean {
+	const { coordinates, ringStarts } = polygon;
+	let inside = false;
+	for (let ring = 0; ring < ringStarts.length - 1; ring++) {
+		const start = ringStarts[ring];
+		const end = ringStarts[ring + 1];
+		for (let i = start, j = end - 1; i < end; j = i++) {
+			const northI = coordinates[2 * i];
+			const northJ = coordinates[2 * j];
+			if ((northI > northing) !== (northJ > northing)) {
+				const eastI = coordinates[2 * i + 1];
+				const eastJ = coordinates[2 * j + 1];
+				if (easting < eastI + (northing - northI) * (eastJ - eastI) / (northJ - northI)) {
+					inside = !inside;
+				}
+			}
+		}
+	}
+	return inside;
+}
+
+/**
+ * Shortest distance from a position to the polygon boundary, metres
+ */
+function distanceToGeofenceBoundary(polygon: GeofencePolygon, northing: number, easting: number): number {
+	const { coordinates, ringStarts } = polygon;
+	let nearestSquared = Number.POSITIVE_INFINITY;
+	for (let ring = 0; ring < ringStarts.length - 1; ring++) {
+		const start = ringStarts[ring];
+		const end = ringStarts[ring + 1];
+		for (let i = start, j = end - 1; i < end; j = i++) {
+			const segmentNorth = coordinates[2 * i] - coordinates[2 * j];
+			const segmentEast = coordinates[2 * i + 1] - coordinates[2 * j + 1];
+			const pointNorth = northing - coordinates[2 * j];
+			const pointEast = easting - coordinates[2 * j + 1];
+			const lengthSquared = segmentNorth * segmentNorth + segmentEast * segmentEast;
+			const t = lengthSquared > 0
+				? Math.min(Math.max((pointNorth * segmentNorth + pointEast * segmentEast) / lengthSquared, 0), 1)
+				: 0;
+			const offsetNorth = pointNorth - t * segmentNorth;
+			const offsetEast = pointEast - t * segmentEast;
+			nearestSquared = Math.min(nearestSquared, offsetNorth * offsetNorth + offsetEast * offsetEast);
+		}
+	}
+	return Math.sqrt(nearestSquared);
+}
+
+/**
+ * Bounding boxes of polygons as min northing, min easting, max northing, max easting
+ */
+function computeGeofenceBounds(polygons: GeofencePolygon[]): Float64Array {
+	const bounds = new Float64Array(polygons.length * 4);
+	polygons.forEach((polygon, index) => {
+		let minNorth = Number.POSITIVE_INFINITY;
+		let minEast = Number.POSITIVE_INFINITY;
+		let maxNorth = Number.NEGATIVE_INFINITY;
+		let maxEast = Number.NEGATIVE_INFINITY;
+		const { coordinates } = polygon;
+		for (let i = 0; i < coordinates.length; i += 2) {
+			minNorth = Math.min(minNorth, coordinates[i]);
+			minEast = Math.min(minEast, coordinates[i + 1]);
+			maxNorth = Math.max(maxNorth, coordinates[i]);
+			maxEast = Math.max(maxEast, coordinates[i + 1]);
+		}
+		bounds.set([minNorth, minEast, maxNorth, maxEast], index * 4);
+	});
+	return bounds;
+}
+
+/**
+ * GeofenceEngine - in- och utpassager för en uppsättning områden
+ */
+class GeofenceEngine {
+	private polygons: GeofencePolygon[];
+	private tree: PackedRTree;
+	// Områden positionen är inne i, i den ordning de inträddes
+	private inside: number[] = [];
+	private candidates: number[] = [];
+	private hasPosition: boolean = false;
+
+	constructor(polygons: GeofencePolygon[]) {
+		this.polygons = polygons;
+		this.tree = new PackedRTree(computeGeofenceBounds(polygons));
+	}
+
+	get size(): number {
+		return this.polygons.length;
+	}
+
+	/**
+	 * Names of the areas the position is inside
+	 */
+	insideNames(): string[] {
+		return this.inside.map((index) => this.polygons[index].name);
+	}
+
+	/**
+	 * Forgets the current state; the next position sets it without events
+	 */
+	reset(): void {
+		this.inside = [];
+		this.hasPosition = false;
+	}
+
+	/**
+	 * Updates the state with a position and returns the areas entered and left
+	 * The first position only sets the state.
+	 */
+	update(northing: number, easting: number): GeofenceEvents {
+		const events: GeofenceEvents = { entered: [], exited: [], changed: false };
+		const isFirst = !this.hasPosition;
+		this.hasPosition = true;
+
+		// Utträde: bara områden vi är inne i behöver testas
+		const stillInside: number[] = [];
+		for (const index of this.inside) {
+			const polygon = this.polygons[index];
+			if (isInsideGeofence(polygon, northing, easting)
+				|| distanceToGeofenceBoundary(polygon, northing, easting) < GEOFENCE_HYSTERESIS_METERS) {
+				stillInside.push(index);
+			} else {
+				events.exited.push(polygon.name);
+			}
+		}
+
+		// Inträde: områden vars rektangel innehåller positionen
+		for (const index of this.tree.search(northing, easting, this.candidates)) {
+			if (stillInside.includes(index)) {
+				continue;
+			}
+			const polygon = this.polygons[index];
+			if (isInsideGeofence(polygon, northing, easting)
+				&& (isFirst || distanceToGeofenceBoundary(polygon, northing, easting) >= GEOFENCE_HYSTERESIS_METERS)) {
+				stillInside.push(index);
+				if (!isFirst) {
+					events.entered.push(polygon.name);
+				}
+			}
+		}
+		events.changed = stillInside.length !== this.inside.length - events.exited.length || events.exited.length > 0;
+		this.inside = stillInside;
+		return events;
+	}
+}
@@ -0,0 +1,170 @@
+// ============================================================================
+// GEOFENCE STORAGE (GeoJSON import and IndexedDB)
+// ============================================================================
+//
+// Områden importeras från GeoJSON i WGS 84 eller SWEREF 99 TM. De
+// transformeras en gång till SWEREF 99 TM vid importen och sparas så i
+// IndexedDB, så att varje position sedan bara kräver plana beräkningar.
+//
+// Filen innehåller ingen DOM-kod och kan därför även laddas i Web Workers.
+
+const GEOFENCE_DB_NAME = 'sweref99-omraden';
+const GEOFENCE_DB_VERSION = 1;
+const GEOFENCE_STORE = 'geofences';
+
+/**
+ * Coordinates above this are SWEREF 99 TM metres, below it WGS84 degrees
+ */
+const GEOFENCE_PROJECTED_THRESHOLD = 1000;
+
+/**
+ * Feature properties tried in order for the area name
+ */
+const GEOFENCE_NAME_PROPERTIES = ['name', 'namn', 'title', 'beteckning', 'id'];
+
+let geofenceDatabasePromise: Promise<IDBDatabase> | null = null;
+
+/**
+ * Opens (and if needed creates) the geofence database
+ * The connection is shared by all callers.
+ */
+function openGeofenceDatabase(): Promise<IDBDatabase> {
+	if (geofenceDatabasePromise === null) {
+		geofenceDatabasePromise = new Promise<IDBDatabase>((resolve, reject) => {
+			const request = indexedDB.open(GEOFENCE_DB_NAME, GEOFENCE_DB_VERSION);
+			request.onupgradeneeded = () => {
+				const db = request.result;
+				if (!db.objectStoreNames.contains(GEOFENCE_STORE)) {
+					db.createObjectStore(GEOFENCE_STORE, { keyPath: 'id', autoIncrement: true });
+				}
+			};
+			request.onsuccess = () => resolve(request.result);
+			request.onerror = () => reject(request.error);
+		});
+		// Tillåt nytt försök om öppningen misslyckades
+		geofenceDatabasePromise.catch(() => {
+			geofenceDatabasePromise = null;
+		});
+	}
+	return geofenceDatabasePromise;
+}
+
+/**
+ * Adds geofences in a single transaction
+ */
+async function addGeofences(db: IDBDatabase, polygons: GeofencePolygon[]): Promise<void> {
+	const transaction = db.transaction(GEOFENCE_STORE, 'readwrite');
+	const store = transaction.objectStore(GEOFENCE_STORE);
+	for (const polygon of polygons) {
+		store.add({ name: polygon.name, coordinates: polygon.coordinates, ringStarts: polygon.ringStarts });
+	}
+	await transactionDone(transaction);
+}
+
+async function readAllGeofences(db: IDBDatabase): Promise<GeofencePolygon[]> {
+	const transaction = db.transaction(GEOFENCE_STORE, 'readonly');
+	return await requestToPromise(transaction.objectStore(GEOFENCE_STORE).getAll()) as GeofencePolygon[];
+}
+
+async function clearGeofences(db: IDBDatabase): Promise<void> {
+	const transaction = db.transaction(GEOFENCE_STORE, 'readwrite');
+	transaction.objectStore(GEOFENCE_STORE).clear();
+	await transactionDone(transaction);
+}
+
+function getGeofenceName(properties: Record<string, unknown> | null | undefined, fallback: string): string {
+	for (const key of GEOFENCE_NAME_PROPERTIES) {
+		const value = properties?.[key];
+		if (typeof value === 'string' && value.trim() !== '') {
+			return value.trim();
+		}
+		if (typeof value === 'number') {
+			return String(value);
+		}
+	}
+	return fallback;
+}
+
+/**
+ * Converts GeoJSON polygon rings to interleaved SWEREF 99 TM northing, easting
+ *
+ * Positions are [longitude, latitude] in WGS84, or easting and northing in
+ * SWEREF 99 TM in either order; in Sweden the northing is always the larger.
+ */
+function convertGeofenceRings(rings: number[][][], coordinates: number[], ringStarts: number[]): void {
+	for (const ring of rings) {
+		let count = ring.length;
+		// GeoJSON upprepar första punkten sist
+		if (count > 1 && ring[0][0] === ring[count - 1][0] && ring[0][1] === ring[count - 1][1]) {
+			count--;
+		}
+		if (count < 3) {
+			continue;
+		}
+		for (let i = 0; i < count; i++) {
+			const [x, y] = ring[i];
+			if (!Number.isFinite(x) || !Number.isFinite(y)) {
+				throw new Error('Ogiltig koordinat i GeoJSON');
+			}
+			if (Math.abs(x) > GEOFENCE_PROJECTED_THRESHOLD || Math.abs(y) > GEOFENCE_PROJECTED_THRESHOLD) {
+				coordinates.push(Math.max(x, y), Math.min(x, y));
+			} else {
+				const projected = projectToSweref99tm(y, x);
+				coordinates.push(projected.northing, projected.easting);
+			}
+		}
+		ringStarts.push(coordinates.length / 2);
+	}
+}
+
+interface GeoJsonGeometry {
+	type: string;
+	coordinates?: unknown;
+	geometries?: GeoJsonGeometry[];
+}
+
+interface GeoJsonFeature {
+	type: string;
+	geometry?: GeoJsonGeometry | null;
+	properties?: Record<string, unknown> | null;
+	features?: GeoJsonFeature[];
+}
+
+/**
+ * Parses Polygon and MultiPolygon features from GeoJSON text into geofences
+ * Other geometry types are skipped. A multipolygon becomes one area.
+ */
+function parseGeofenceGeoJson(text: string): GeofencePolygon[] {
+	const root = JSON.parse(text) as GeoJsonFeature;
+	const features: GeoJsonFeature[] = root.type === 'FeatureCollection'
+		? root.features ?? []
+		: root.type === 'Feature'
+			? [root]
+			: [{ type: 'Feature', geometry: root as GeoJsonGeometry, properties: null }];
+
+	const polygons: GeofencePolygon[] = [];
+	for (const feature of features) {
+		const geometries = feature.geometry?.type === 'GeometryCollection'
+			? feature.geometry.geometries ?? []
+			: feature.geometry ? [feature.geometry] : [];
+		const coordinates: number[] = [];
+		const ringStarts: number[] = [0];
+		for (const geometry of geometries) {
+			if (geometry.type === 'Polygon') {
+				convertGeofenceRings(geometry.coordinates as number[][][], coordinates, ringStarts);
+			} else if (geometry.type === 'MultiPolygon') {
+				for (const polygon of geometry.coordinates as number[][][][]) {
+					convertGeofenceRings(polygon, coordinates, ringStarts);
+				}
+			}
+		}
+		if (ringStarts.length > 1) {
+			polygons.push({
+				name: getGeofenceName(feature.properties, `Område ${polygons.length + 1}`),
+				coordinates: Float64Array.from(coordinates),
+				ringStarts: Int32Array.from(ringStarts)
+			});
+		}
+	}
+	return polygons;
+}
@@ -0,0 +1,353 @@
+// ============================================================================
+// GNSS STREAM PARSER (NMEA 0183 and gpsd JSON)
+// ============================================================================
+//
+// Tolkar dataströmmen från en extern GNSS-mottagare. Strömmen kan vara rå
+// NMEA 0183 (t.ex. `gpspipe -r`) eller gpsd:s JSON-protokoll (`gpspipe -w`),
+// och får delas upp godtyckligt mellan meddelanden. Filen innehåller ingen
+// DOM-kod så att samma tolkning kan användas i Web Workers och under Node.
+
+/**
+ * A position fix decoded from a GNSS stream
+ * Coordinates are WGS 84 degrees; speed in m/s and heading in degrees.
+ */
+interface GnssFix {
+	timestamp: number;
+	latitude: number;
+	longitude: number;
+	accuracy: number;
+	altitude: number | null;
+	speed: number | null;
+	heading: number | null;
+}
+
+const KNOTS_TO_MS = 0.514444;
+
+/**
+ * Approximate horizontal accuracy per unit of HDOP, used when the receiver
+ * sends no error estimate (GST or gpsd eph)
+ */
+const NMEA_HDOP_ACCURACY_METERS = 5;
+
+/**
+ * Converts the GST latitude and longitude standard deviations to a 95 %
+ * radius, the accuracy convention of the Geolocation API: for a circular
+ * Gaussian that radius is about 2.45 times the per-axis deviation
+ */
+const NMEA_GST_SIGMA_TO_ACCURACY = 2.45;
+
+/**
+ * How long a GST error estimate stays valid for later epochs
+ */
+const NMEA_GST_MAX_AGE_MS = 2000;
+
+/**
+ * Longest line kept while waiting for a newline, to bound memory on garbage input
+ */
+const GNSS_MAX_LINE_LENGTH = 4096;
+
+/**
+ * Verifies the XOR checksum of an NMEA sentence
+ * Sentences without a checksum are accepted, as some bridges strip it.
+ */
+function isNmeaChecksumValid(sentence: string): boolean {
+	const star = sentence.lastIndexOf('*');
+	if (star === -1) {
+		return true;
+	}
+	let checksum = 0;
+	for (let i = 1; i < star; i++) {
+		checksum ^= sentence.charCodeAt(i);
+	}
+	return checksum === Number.parseInt(sentence.slice(star + 1, star + 3), 16);
+}
+
+/**
+ * Parses an NMEA coordinate (ddmm.mmmm / dddmm.mmmm) with hemisphere
+ * @returns Decimal degrees, or NaN if the field is empty or invalid
+ */
+function parseNmeaCoordinate(value: string, hemisphere: string): number {
+	const dot = value.indexOf('.');
+	const degreeDigits = (dot === -1 ? value.length : dot) - 2;
+	if (degreeDigits < 1) {
+		return Number.NaN;
+	}
+	const degrees = Number.parseInt(value.slice(0, degreeDigits), 10);
+	const minutes = Number.parseFloat(value.slice(degreeDigits));
+	const result = degrees + minutes / 60;
+	return hemisphere === 'S' || hemisphere === 'W' ? -result : result;
+}
+
+/**
+ * Milliseconds since UTC midnight for an NMEA time field (hhmmss.ss)
+ */
+function parseNmeaTimeOfDay(value: string): number {
+	if (value.length < 6) {
+		return Number.NaN;
+	}
+	const hours = Number.parseInt(value.slice(0, 2), 10);
+	const minutes = Number.parseInt(value.slice(2, 4), 10);
+	const seconds = Number.parseFloat(value.slice(4));
+	return ((hours * 60 + minutes) * 60 + seconds) * 1000;
+}
+
+/**
+ * UTC midnight in milliseconds for an NMEA date field (ddmmyy)
+ */
+function parseNmeaDate(value: string): number {
+	if (value.length !== 6) {
+		return Number.NaN;
+	}
+	const day = Number.parseInt(value.slice(0, 2), 10);
+	const month = Number.parseInt(value.slice(2, 4), 10);
+	const year = 2000 + Number.parseInt(value.slice(4, 6), 10);
+	return Date.UTC(year, month - 1, day);
+}
+
+function parseOptionalNumber(value: string | undefined): number | null {
+	if (value === undefined || value === '') {
+		return null;
+	}
+	const number = Number.parseFloat(value);
+	return Number.isFinite(number) ? number : null;
+}
+
+/**
+ * Converts a gpsd TPV report into a fix
+ * @returns null for other message classes and reports without a 2D fix
+ */
+function parseGpsdReport(report: Record<string, unknown>): GnssFix | null {
+	if (report.class !== 'TPV' || typeof report.mode !== 'number' || report.mode < 2) {
+		return null;
+	}
+	const { lat, lon } = report;
+	if (typeof lat !== 'number' || typeof lon !== 'number') {
+		return null;
+	}
+
+	let accuracy = Number.NaN;
+	if (typeof report.eph === 'number') {
+		accuracy = report.eph;
+	} else if (typeof report.epx === 'number' && typeof report.epy === 'number') {
+		accuracy = Math.hypot(report.epx, report.epy);
+	}
+	if (!Number.isFinite(accuracy)) {
+		return null;
+	}
+
+	const timestamp = typeof report.time === 'string' ? Date.parse(report.time) : Number.NaN;
+	const altitude = typeof report.altHAE === 'number' ? report.altHAE : report.alt;
+	return {
+		timestamp: Number.isFinite(timestamp) ? timestamp : Date.now(),
+		latitude: lat,
+		longitude: lon,
+		accuracy,
+		altitude: typeof altitude === 'number' ? altitude : null,
+		speed: typeof report.speed === 'number' ? report.speed : null,
+		heading: typeof report.track === 'number' ? report.track : null
+	};
+}
+
+/**
+ * NmeaEpochAssembler - slår ihop GGA, RMC och GST från samma epok till en position
+ *
+ * Mottagare skickar flera meningar per epok i varierande ordning. En position
+ * lämnas så snart både GGA och RMC för epoken har kommit, eller när en ny
+ * epok börjar om mottagaren bara skickar en av dem. GST kommer ofta efter
+ * GGA, så den senaste feluppskattningen används även för nästa epok.
+ */
+class NmeaEpochAssembler {
+	private epochTime: number = Number.NaN;
+	private hasGga: boolean = false;
+	private hasRmc: boolean = false;
+	private emitted: boolean = false;
+	private latitude: number = Number.NaN;
+	private longitude: number = Number.NaN;
+	private hdop: number | null = null;
+	private gstAccuracy: number | null = null;
+	private gstTime: number = Number.NaN;
+	private altitude: number | null = null;
+	private speed: number | null = null;
+	private heading: number | null = null;
+	private lastDate: number = Number.NaN;
+
+	constructor(private now: () => number = Date.now) {}
+
+	/**
+	 * Handles one NMEA sentence
+	 * @returns A completed fix, or null if the epoch is not complete yet
+	 */
+	push(sentence: string): GnssFix | null {
+		if (!isNmeaChecksumValid(sentence)) {
+			return null;
+		}
+		const star = sentence.lastIndexOf('*');
+		const fields = (star === -1 ? sentence : sentence.slice(0, star)).split(',');
+		// Talker-id (GP, GN, GL, GA, GB ...) spelar ingen roll här
+		const type = fields[0].slice(3);
+		const time = parseNmeaTimeOfDay(fields[1] ?? '');
+		if (!Number.isFinite(time) || (type !== 'GGA' && type !== 'RMC' && type !== 'GST')) {
+			return null;
+		}
+
+		let completed: GnssFix | null = null;
+		if (time !== this.epochTime) {
+			completed = this.emitted ? null : this.buildFix();
+			this.startEpoch(time);
+		}
+
+		if (type === 'GGA') {
+			this.readGga(fields);
+		} else if (type === 'RMC') {
+			this.readRmc(fields);
+		} else {
+			this.readGst(fields);
+		}
+
+		if (completed === null && !this.emitted && this.hasGga && this.hasRmc) {
+			completed = this.buildFix();
+			this.emitted = true;
+		}
+		return completed;
+	}
+
+	private startEpoch(time: number): void {
+		this.epochTime = time;
+		this.hasGga = false;
+		this.hasRmc = false;
+		this.emitted = false;
+		this.latitude = Number.NaN;
+		this.longitude = Number.NaN;
+		this.hdop = null;
+		this.altitude = null;
+		this.speed = null;
+		this.heading = null;
+	}
+
+	private readGga(fields: string[]): void {
+		// Fält 6 är fixkvalitet, 0 betyder ingen fix
+		if (fields[6] === undefined || fields[6] === '0' || fields[6] === '') {
+			return;
+		}
+		this.hasGga = true;
+		this.setPosition(fields[2], fields[3], fields[4], fields[5]);
+		this.hdop = parseOptionalNumber(fields[8]);
+		this.altitude = parseOptionalNumber(fields[9]);
+	}
+
+	private readRmc(fields: string[]): void {
+		const date = parseNmeaDate(fields[9] ?? '');
+		if (Number.isFinite(date)) {
+			this.lastDate = date;
+		}
+		if (fields[2] !== 'A') {
+			return;
+		}
+		this.hasRmc = true;
+		this.setPosition(fields[3], fields[4], fields[5], fields[6]);
+		const knots = parseOptionalNumber(fields[7]);
+		this.speed = knots === null ? null : knots * KNOTS_TO_MS;
+		this.heading = parseOptionalNumber(fields[8]);
+	}
+
+	private readGst(fields: string[]): void {
+		const latitudeError = parseOptionalNumber(fields[6]);
+		const longitudeError = parseOptionalNumber(fields[7]);
+		if (latitudeError !== null && longitudeError !== null) {
+			this.gstAccuracy = NMEA_GST_SIGMA_TO_ACCURACY * Math.sqrt((latitudeError ** 2 + longitudeError ** 2) / 2);
+			this.gstTime = this.epochTime;
+		}
+	}
+
+	private setPosition(latitude = '', latHemisphere = '', longitude = '', lonHemisphere = ''): void {
+		const lat = parseNmeaCoordinate(latitude, latHemisphere);
+		const lon = parseNmeaCoordinate(longitude, lonHemisphere);
+		if (Number.isFinite(lat) && Number.isFinite(lon)) {
+			this.latitude = lat;
+			this.longitude = lon;
+		}
+	}
+
+	private buildFix(): GnssFix | null {
+		if (!Number.isFinite(this.latitude) || !Number.isFinite(this.longitude)) {
+			return null;
+		}
+		const gstAge = Math.abs(this.epochTime - this.gstTime);
+		const gstAccuracy = gstAge <= NMEA_GST_MAX_AGE_MS ? this.gstAccuracy : null;
+		const accuracy = gstAccuracy ?? (this.hdop !== null ? this.hdop * NMEA_HDOP_ACCURACY_METERS : null);
+		if (accuracy === null) {
+			return null;
+		}
+		return {
+			timestamp: this.resolveTimestamp(),
+			latitude: this.latitude,
+			longitude: this.longitude,
+			accuracy,
+			altitude: this.altitude,
+			speed: this.speed,
+			heading: this.heading
+		};
+	}
+
+	/**
+	 * Combines the epoch time of day with the last RMC date, or today's date
+	 */
+	private resolveTimestamp(): number {
+		if (Number.isFinite(this.lastDate)) {
+			return this.lastDate + this.epochTime;
+		}
+		const now = this.now();
+		const dayMs = 86400000;
+		const timestamp = now - (now % dayMs) + this.epochTime;
+		// Strax efter midnatt kan epoken tillhöra föregående dygn
+		return timestamp - now > dayMs / 2 ? timestamp - dayMs : timestamp;
+	}
+}
+
+/**
+ * GnssStreamParser - delar upp en textström i rader och tolkar varje rad
+ * som gpsd-JSON eller NMEA-mening
+ */
+class GnssStreamParser {
+	private pendingLine: string = '';
+	private nmea: NmeaEpochAssembler;
+
+	constructor(now: () => number = Date.now) {
+		this.nmea = new NmeaEpochAssembler(now);
+	}
+
+	/**
+	 * Parses a piece of the stream
+	 * @returns Fixes completed by this piece, in stream order
+	 */
+	push(text: string): GnssFix[] {
+		const fixes: GnssFix[] = [];
+		const lines = (this.pendingLine + text).split('\n');
+		this.pendingLine = lines.pop() ?? '';
+		if (this.pendingLine.length > GNSS_MAX_LINE_LENGTH) {
+			this.pendingLine = '';
+		}
+
+		for (const rawLine of lines) {
+			const fix = this.parseLine(rawLine.trim());
+			if (fix !== null) {
+				fixes.push(fix);
+			}
+		}
+		return fixes;
+	}
+
+	private parseLine(line: string): GnssFix | null {
+		if (line.startsWith('$')) {
+			return this.nmea.push(line);
+		}
+		if (line.startsWith('{')) {
+			try {
+				return parseGpsdReport(JSON.parse(line) as Record<string, unknown>);
+			} catch {
+				return null;
+			}
+		}
+		return null;
+	}
+}
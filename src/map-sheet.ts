@@ -0,0 +1,67 @@
+// ============================================================================
+// MAP SHEETS (grid squares in SWEREF 99 TM)
+// ============================================================================
+//
+// Rutorna är axelparallella kvadrater i SWEREF 99 TM med hörn på jämna
+// multipler av rutstorleken, räknat från koordinatsystemets origo. Rutan för
+// en position fås därför direkt ur koordinaten genom heltalsdivision, utan
+// tabeller. En ruta namnges efter sitt sydvästra hörn i kilometer, N_E,
+// t.ex. 6580_670 för 5 km-rutan som börjar i N 6580000 E 670000. Indelningen
+// och namnen är appens egna och är inte avstämda mot Lantmäteriets
+// bladindelning.
+//
+// Rutstorlekarna är multipler av varandra, så en större ruta kan bara bytas
+// när den minsta rutan byts.
+//
+// Filen innehåller ingen DOM-kod och kan därför även laddas i Web Workers.
+
+/**
+ * Grid square sizes in metres, smallest first
+ */
+const MAP_SHEET_SIZES = [5000, 10000, 50000] as const;
+
+type MapSheetSize = typeof MAP_SHEET_SIZES[number];
+
+/**
+ * Index of the grid square of a given size, unique within SWEREF 99 TM
+ * Usable to detect when a position moves to another square without
+ * building the name.
+ */
+function mapSheetIndex(northing: number, easting: number, size: MapSheetSize): number {
+	// Östkoordinaten ligger under 10 000 km, så raden ryms ovanför kolumnen
+	return Math.floor(northing / size) * Math.ceil(10000000 / size) + Math.floor(easting / size);
+}
+
+/**
+ * Name of the grid square of a given size, the south-west corner in km as N_E
+ */
+function formatMapSheet(northing: number, easting: number, size: MapSheetSize): string {
+	const northKm = Math.floor(northing / size) * size / 1000;
+	const eastKm = Math.floor(easting / size) * size / 1000;
+	return `${northKm}_${eastKm}`;
+}
+
+/**
+ * Names of the grid squares of every size, in the order of MAP_SHEET_SIZES
+ */
+function formatMapSheets(northing: number, easting: number): string[] {
+	return MAP_SHEET_SIZES.map((size) => formatMapSheet(northing, easting, size));
+}
+
+/**
+ * Returns a function that names the squares of consecutive positions
+ * The names are only rebuilt when the position leaves the smallest square,
+ * which for a track or a sorted batch is rare.
+ */
+function createMapSheetNamer(): (northing: number, easting: number) => readonly string[] {
+	let lastIndex = Number.NaN;
+	let lastNames: readonly string[] = [];
+	return (northing, easting) => {
+		const index = mapSheetIndex(northing, easting, MAP_SHEET_SIZES[0]);
+		if (index !== lastIndex) {
+			lastIndex = index;
+			lastNames = formatMapSheets(northing, easting);
+		}
+		return lastNames;
+	};
+}
@@ -0,0 +1,259 @@
+// ============================================================================
+// MAP TILES (pre-tiled vector data in SWEREF 99 TM)
+// ============================================================================
+//
+// Kartan delas i rutor som följer kartbladsindelningen i map-sheet.ts: 5, 10
+// och 50 km, där de större rutorna har mer förenklad data. En ruta hämtas
+// som tiles/<storlek i km>/<N_E>.bin, t.ex. tiles/5/6580_670.bin, så vilken
+// fil som behövs räknas fram direkt ur koordinaten. Rutor utan innehåll
+// finns inte som filer.
+//
+// Koordinaterna lagras i hela meter som skillnad mot föregående punkt,
+// zigzag-kodad och skriven som varint, med början i rutans sydvästra hörn
+// (samma teknik som admin-area-codec.ts).
+//
+// Layout (little endian):
+//   0  u8[2]  magiskt värde "SV"
+//   2  u8     formatversion
+//   3  u8     reserverad
+//   4  i32    rutans minsta N
+//   8  i32    rutans minsta E
+//  12  u32    rutstorlek (m)
+//  16  u32    antal objekt
+//  20  u32    antal punkter totalt
+//  24         varintdata, för varje objekt:
+//               slag · 4 + geometrityp, namn (längd + UTF-8)
+//               antal ringar eller linjer, antal punkter i varje
+//               N och E för varje punkt som skillnad mot föregående punkt
+//
+// Filen innehåller ingen DOM-kod och kan därför även laddas i Web Workers.
+
+/**
+ * What a map feature depicts; decides its style and drawing order
+ */
+const MAP_FEATURE_KIND = {
+	LAND: 0,
+	WATER: 1,
+	BORDER: 2,
+	ROAD: 3,
+	PLACE: 4
+} as const;
+
+const MAP_GEOMETRY = {
+	POINT: 0,
+	LINE: 1,
+	POLYGON: 2
+} as const;
+
+type MapFeatureKind = typeof MAP_FEATURE_KIND[keyof typeof MAP_FEATURE_KIND];
+type MapGeometry = typeof MAP_GEOMETRY[keyof typeof MAP_GEOMETRY];
+
+interface MapFeature {
+	kind: MapFeatureKind;
+	geometry: MapGeometry;
+	/** Label, empty when the feature has none */
+	name: string;
+	/** SWEREF 99 TM northing, easting interleaved, whole metres */
+	coordinates: Int32Array;
+	/** First point of each ring, line or point, followed by the point count */
+	ringStarts: Int32Array;
+}
+
+interface MapTile {
+	size: number;
+	minNorthing: number;
+	minEasting: number;
+	features: MapFeature[];
+}
+
+const MAP_TILE_MAGIC_0 = 0x53; // 'S'
+const MAP_TILE_MAGIC_1 = 0x56; // 'V'
+const MAP_TILE_VERSION = 1;
+const MAP_TILE_HEADER_BYTES = 24;
+
+/**
+ * Directory of the tile files, relative to the page
+ */
+const MAP_TILE_DIRECTORY = 'tiles';
+
+/**
+ * Key of a tile, e.g. "5/6580_670", from its size and grid row and column
+ */
+function mapTileKey(size: number, row: number, column: number): string {
+	return `${size / 1000}/${row * size / 1000}_${column * size / 1000}`;
+}
+
+function mapTileUrl(key: string): string {
+	return `${MAP_TILE_DIRECTORY}/${key}.bin`;
+}
+
+/**
+ * Smallest tile size for which a view of the given width in metres spans
+ * at most about three tiles; larger tiles hold coarser data
+ */
+function chooseMapTileSize(viewWidth: number): number {
+	for (const size of MAP_SHEET_SIZES) {
+		if (viewWidth <= 3 * size) {
+			return size;
+		}
+	}
+	return MAP_SHEET_SIZES[MAP_SHEET_SIZES.length - 1];
+}
+
+/**
+ * Appends the keys of all tiles overlapping a rectangle
+ */
+function collectMapTiles(minNorthing: number, minEasting: number, maxNorthing: number, maxEasting: number, size: number, keys: string[]): void {
+	const lastRow = Math.floor(maxNorthing / size);
+	const lastColumn = Math.floor(maxEasting / size);
+	for (let row = Math.floor(minNorthing / size); row <= lastRow; row++) {
+		for (let column = Math.floor(minEasting / size); column <= lastColumn; column++) {
+			keys.push(mapTileKey(size, row, column));
+		}
+	}
+}
+
+/**
+ * Appends the keys of the tiles along a straight path, nearest first
+ * @param gridBearing - Direction of travel in the grid, degrees from grid north
+ * @param distance - Path length in metres
+ */
+function collectMapTilesAhead(northing: number, easting: number, gridBearing: number, distance: number, size: number, keys: string[]): void {
+	const radians = gridBearing * Math.PI / 180;
+	const stepNorth = Math.cos(radians);
+	const stepEast = Math.sin(radians);
+	// Halva rutstorleken per steg hoppar inte över någon ruta som vägen korsar mitt i
+	const step = size / 2;
+	let lastKey = '';
+	for (let travelled = 0; travelled <= distance; travelled += step) {
+		const row = Math.floor((northing + stepNorth * travelled) / size);
+		const column = Math.floor((easting + stepEast * travelled) / size);
+		const key = mapTileKey(size, row, column);
+		if (key !== lastKey && !keys.includes(key)) {
+			keys.push(key);
+		}
+		lastKey = key;
+	}
+}
+
+function writeMapTileString(writer: ByteWriter, encoder: TextEncoder, text: string): void {
+	const bytes = encoder.encode(text);
+	writer.writeVarint(bytes.length);
+	writer.ensureCapacity(bytes.length);
+	writer.bytes.set(bytes, writer.length);
+	writer.length += bytes.length;
+}
+
+/**
+ * Encodes the features of one tile
+ */
+function encodeMapTile(tile: MapTile): Uint8Array {
+	const encoder = new TextEncoder();
+	const pointCount = tile.features.reduce((sum, feature) => sum + feature.coordinates.length / 2, 0);
+	const writer = new ByteWriter(MAP_TILE_HEADER_BYTES + pointCount * 3 + tile.features.length * 8);
+	writer.length = MAP_TILE_HEADER_BYTES;
+
+	let previousNorth = tile.minNorthing;
+	let previousEast = tile.minEasting;
+	for (const feature of tile.features) {
+		writer.writeVarint(feature.kind * 4 + feature.geometry);
+		writeMapTileString(writer, encoder, feature.name);
+		const ringCount = feature.ringStarts.length - 1;
+		writer.writeVarint(ringCount);
+		for (let ring = 0; ring < ringCount; ring++) {
+			writer.writeVarint(feature.ringStarts[ring + 1] - feature.ringStarts[ring]);
+		}
+		const { coordinates } = feature;
+		for (let i = 0; i < coordinates.length; i += 2) {
+			writer.writeVarint(zigzagEncode(coordinates[i] - previousNorth));
+			writer.writeVarint(zigzagEncode(coordinates[i + 1] - previousEast));
+			previousNorth = coordinates[i];
+			previousEast = coordinates[i + 1];
+		}
+	}
+
+	const view = new DataView(writer.bytes.buffer, writer.bytes.byteOffset, MAP_TILE_HEADER_BYTES);
+	view.setUint8(0, MAP_TILE_MAGIC_0);
+	view.setUint8(1, MAP_TILE_MAGIC_1);
+	view.setUint8(2, MAP_TILE_VERSION);
+	view.setUint8(3, 0);
+	view.setInt32(4, tile.minNorthing, true);
+	view.setInt32(8, tile.minEasting, true);
+	view.setUint32(12, tile.size, true);
+	view.setUint32(16, tile.features.length, true);
+	view.setUint32(20, pointCount, true);
+	return writer.toUint8Array();
+}
+
+/**
+ * Decodes one tile
+ * @throws Error if the data is not a supported or complete tile
+ */
+function decodeMapTile(bytes: Uint8Array): MapTile {
+	if (bytes.length < MAP_TILE_HEADER_BYTES || bytes[0] !== MAP_TILE_MAGIC_0 || bytes[1] !== MAP_TILE_MAGIC_1) {
+		throw new Error('Ogiltig kartruta');
+	}
+	const view = new DataView(bytes.buffer, bytes.byteOffset, MAP_TILE_HEADER_BYTES);
+	const version = view.getUint8(2);
+	if (version !== MAP_TILE_VERSION) {
+		throw new Error(`Kartrutan har okänd version ${version}`);
+	}
+	const minNorthing = view.getInt32(4, true);
+	const minEasting = view.getInt32(8, true);
+	const size = view.getUint32(12, true);
+	const featureCount = view.getUint32(16, true);
+
+	let pos = MAP_TILE_HEADER_BYTES;
+	const readVarint = (): number => {
+		let value = 0;
+		let multiplier = 1;
+		let byte: number;
+		do {
+			if (pos >= bytes.length) {
+				throw new Error('Kartrutan är trunkerad');
+			}
+			byte = bytes[pos++];
+			value += (byte & 0x7f) * multiplier;
+			multiplier *= 0x80;
+		} while (byte & 0x80);
+		return value;
+	};
+	const decoder = new TextDecoder();
+	const readString = (): string => {
+		const length = readVarint();
+		if (pos + length > bytes.length) {
+			throw new Error('Kartrutan är trunkerad');
+		}
+		const text = decoder.decode(bytes.subarray(pos, pos + length));
+		pos += length;
+		return text;
+	};
+
+	const features: MapFeature[] = [];
+	let north = minNorthing;
+	let east = minEasting;
+	for (let f = 0; f < featureCount; f++) {
+		const type = readVarint();
+		const name = readString();
+		const ringCount = readVarint();
+		const ringStarts = new Int32Array(ringCount + 1);
+		for (let ring = 0; ring < ringCount; ring++) {
+			ringStarts[ring + 1] = ringStarts[ring] + readVarint();
+		}
+		const coordinates = new Int32Array(ringStarts[ringCount] * 2);
+		for (let i = 0; i < coordinates.length; i += 2) {
+			north += zigzagDecode(readVarint());
+			east += zigzagDecode(readVarint());
+			coordinates[i] = north;
+			coordinates[i + 1] = east;
+		}
+		features.push({
+			kind: Math.floor(type / 4) as MapFeatureKind,
+			geometry: (type % 4) as MapGeometry,
+			name,
+			coordinates,
+			ringStarts
+		});
+	}
+	return { size, minNorthing, minEasting, features };
+}
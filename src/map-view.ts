@@ -0,0 +1,452 @@
+// ============================================================================
+// MAP VIEW (canvas renderer for the map tiles)
+// ============================================================================
+//
+// Ritar kartrutorna runt positionen på en canvas, med rutnätsnorr uppåt
+// direkt i SWEREF 99 TM-planet, så ingen projektion behövs vid ritning.
+// Varje ruta görs vid första ritningen om till en Path2D per slag i rutans
+// egna koordinater. En bildruta är sedan en transform och ett fill- eller
+// stroke-anrop per ruta och slag, oavsett hur många punkter rutan har.
+//
+// Kartan ritas bara när något ändrats, högst en gång per skärmuppdatering
+// och bara när den syns. Tiden för varje bildruta mäts. Går snittet över
+// budgeten slutar ortnamnen ritas, eftersom text är det dyraste, tills
+// tiden är nere igen.
+//
+// Rutorna hämtas med fetch, så att service workern cachar dem. Under
+// förflyttning hämtas även rutorna längs färdriktningen i förväg.
+
+/**
+ * Zoom levels as metres per CSS pixel
+ */
+const MAP_ZOOM_LEVELS = [1, 2.5, 5, 10, 25, 50, 100, 250] as const;
+const MAP_DEFAULT_ZOOM_INDEX = 3;
+
+/**
+ * Drawing time per frame that leaves room for the rest of the page within
+ * a 60 Hz frame on a low-end phone, milliseconds
+ */
+const MAP_FRAME_BUDGET_MS = 8;
+const MAP_FRAME_SAMPLES = 240;
+/** Weight of the newest frame in the running average */
+const MAP_FRAME_AVERAGE_WEIGHT = 0.1;
+/** Sharper canvases cost fill rate without visible gain */
+const MAP_MAX_PIXEL_RATIO = 2;
+
+/**
+ * Decoded tiles kept in memory, estimated bytes
+ */
+const MAP_TILE_MEMORY_BYTES = 16 * 1024 * 1024;
+const MAP_MAX_CONCURRENT_FETCHES = 4;
+/** Wait before fetching a tile again after a network error */
+const MAP_TILE_RETRY_MS = 30000;
+
+/**
+ * Prefetching covers this many seconds of travel, between one tile and
+ * MAP_PREFETCH_MAX_TILES tiles ahead
+ */
+const MAP_PREFETCH_SECONDS = 120;
+const MAP_PREFETCH_MAX_TILES = 6;
+/** Slower than this counts as standing still, m/s */
+const MAP_PREFETCH_MIN_SPEED = 1;
+
+interface MapStyle {
+	fill: string | null;
+	stroke: string | null;
+	/** Line width in CSS pixels */
+	width: number;
+}
+
+/**
+ * Styles of the area and line kinds, in drawing order; null uses the text colour
+ */
+const MAP_STYLES: [MapFeatureKind, MapStyle][] = [
+	[MAP_FEATURE_KIND.LAND, { fill: 'rgba(120, 170, 90, 0.18)', stroke: null, width: 0 }],
+	[MAP_FEATURE_KIND.WATER, { fill: 'rgba(60, 130, 200, 0.35)', stroke: null, width: 0 }],
+	[MAP_FEATURE_KIND.BORDER, { fill: null, stroke: 'rgba(170, 60, 160, 0.8)', width: 1.5 }],
+	[MAP_FEATURE_KIND.ROAD, { fill: null, stroke: 'rgba(200, 120, 40, 0.9)', width: 1.5 }]
+];
+
+interface MapTileEntry {
+	tile: MapTile;
+	/** One path per feature kind in tile coordinates, built on first draw */
+	paths: (Path2D | null)[] | null;
+}
+
+interface MapFrameStats extends ReplayTimingStats {
+	count: number;
+}
+
+type MapTileLoader = (url: string) => Promise<ArrayBuffer | null>;
+
+/**
+ * Fetches a tile; null when the tile does not exist, i.e. is empty
+ */
+async function fetchMapTile(url: string): Promise<ArrayBuffer | null> {
+	const response = await fetch(url);
+	if (response.status === 404) {
+		return null;
+	}
+	if (!response.ok) {
+		throw new Error(`Kartrutan kunde inte hämtas (${response.status})`);
+	}
+	return response.arrayBuffer();
+}
+
+/**
+ * Builds one path per feature kind with y downwards from the tile's north edge
+ */
+function buildMapTilePaths(tile: MapTile): (Path2D | null)[] {
+	const paths: (Path2D | null)[] = [];
+	const top = tile.minNorthing + tile.size;
+	for (const feature of tile.features) {
+		if (feature.geometry === MAP_GEOMETRY.POINT) {
+			continue;
+		}
+		const path = paths[feature.kind] ?? new Path2D();
+		paths[feature.kind] = path;
+		const { coordinates, ringStarts } = feature;
+		for (let ring = 0; ring < ringStarts.length - 1; ring++) {
+			for (let i = ringStarts[ring]; i < ringStarts[ring + 1]; i++) {
+				const x = coordinates[2 * i + 1] - tile.minEasting;
+				const y = top - coordinates[2 * i];
+				if (i === ringStarts[ring]) {
+					path.moveTo(x, y);
+				} else {
+					path.lineTo(x, y);
+				}
+			}
+			if (feature.geometry === MAP_GEOMETRY.POLYGON) {
+				path.closePath();
+			}
+		}
+	}
+	return paths;
+}
+
+class MapView {
+	private context: CanvasRenderingContext2D | null = null;
+	private readonly tiles = new ByteLru<MapTileEntry>(MAP_TILE_MEMORY_BYTES);
+	/** Tiles that do not exist; the directory only holds tiles with content */
+	private readonly missing = new Set<string>();
+	private readonly failedAt = new Map<string, number>();
+	private readonly loading = new Set<string>();
+	private queue: string[] = [];
+	private visibleKeys: string[] = [];
+	private tileSize: number = MAP_SHEET_SIZES[0];
+	private northing: number = Number.NaN;
+	private easting: number = Number.NaN;
+	private accuracy: number = 0;
+	private gridBearing: number | null = null;
+	private speed: number | null = null;
+	private zoomIndex: number;
+	private visible: boolean = false;
+	private framePending: boolean = false;
+	private readonly frameTimes = new Float64Array(MAP_FRAME_SAMPLES);
+	private frameCount: number = 0;
+	private averageFrameMs: number = 0;
+
+	constructor(
+		private readonly canvas: HTMLCanvasElement,
+		private readonly loadTile: MapTileLoader = fetchMapTile,
+		zoomIndex: number = MAP_DEFAULT_ZOOM_INDEX
+	) {
+		this.zoomIndex = Math.min(Math.max(Math.round(zoomIndex), 0), MAP_ZOOM_LEVELS.length - 1);
+	}
+
+	get zoom(): number {
+		return this.zoomIndex;
+	}
+
+	get metresPerPixel(): number {
+		return MAP_ZOOM_LEVELS[this.zoomIndex];
+	}
+
+	/**
+	 * Number of decoded tiles in memory
+	 */
+	get tileCount(): number {
+		return this.tiles.size;
+	}
+
+	setZoom(zoomIndex: number): void {
+		const clamped = Math.min(Math.max(zoomIndex, 0), MAP_ZOOM_LEVELS.length - 1);
+		if (clamped !== this.zoomIndex) {
+			this.zoomIndex = clamped;
+			this.update();
+		}
+	}
+
+	/**
+	 * Starts or stops loading and drawing; a hidden map costs nothing
+	 */
+	setVisible(visible: boolean): void {
+		this.visible = visible;
+		this.update();
+	}
+
+	/**
+	 * Centres the map on a position
+	 * @param gridBearing - Direction of travel in the grid, null when unknown
+	 * @param speed - Speed in m/s, null when unknown
+	 */
+	setPosition(northing: number, easting: number, accuracy: number, gridBearing: number | null, speed: number | null): void {
+		this.northing = northing;
+		this.easting = easting;
+		this.accuracy = accuracy;
+		this.gridBearing = gridBearing;
+		this.speed = speed;
+		this.update();
+	}
+
+	/**
+	 * Drawing times of the most recent frames, milliseconds
+	 */
+	frameStats(): MapFrameStats {
+		return { count: this.frameCount, ...summarizeTimings(this.frameTimes, Math.min(this.frameCount, MAP_FRAME_SAMPLES)) };
+	}
+
+	private viewSize(): { width: number; height: number } {
+		return {
+			width: this.canvas.clientWidth || this.canvas.width,
+			height: this.canvas.clientHeight || this.canvas.height
+		};
+	}
+
+	/**
+	 * Works out the visible and upcoming tiles and starts loading them
+	 */
+	private update(): void {
+		if (!this.visible || !Number.isFinite(this.northing) || !Number.isFinite(this.easting)) {
+			return;
+		}
+		const { width, height } = this.viewSize();
+		const halfWidth = width * this.metresPerPixel / 2;
+		const halfHeight = height * this.metresPerPixel / 2;
+		const size = chooseMapTileSize(2 * Math.max(halfWidth, halfHeight));
+		this.tileSize = size;
+
+		const keys: string[] = [];
+		collectMapTiles(this.northing - halfHeight, this.easting - halfWidth, this.northing + halfHeight, this.easting + halfWidth, size, keys);
+		this.visibleKeys = keys.slice();
+		if (this.gridBearing !== null && this.speed !== null && this.speed >= MAP_PREFETCH_MIN_SPEED) {
+			const distance = Math.min(Math.max(this.speed * MAP_PREFETCH_SECONDS, size), MAP_PREFETCH_MAX_TILES * size);
+			collectMapTilesAhead(this.northing, this.easting, this.gridBearing, distance, size, keys);
+		}
+		const now = performance.now();
+		this.queue = keys.filter((key) => this.needsLoading(key, now));
+		this.pump();
+		this.requestRender();
+	}
+
+	private needsLoading(key: string, now: number): boolean {
+		const failedAt = this.failedAt.get(key);
+		return !this.tiles.has(key) && !this.missing.has(key) && !this.loading.has(key) &&
+			(failedAt === undefined || now - failedAt >= MAP_TILE_RETRY_MS);
+	}
+
+	/**
+	 * Starts queued fetches up to the concurrency limit, visible tiles first
+	 */
+	private pump(): void {
+		while (this.loading.size < MAP_MAX_CONCURRENT_FETCHES && this.queue.length > 0) {
+			const key = this.queue.shift()!;
+			if (!this.needsLoading(key, performance.now())) {
+				continue;
+			}
+			this.loading.add(key);
+			this.loadTile(mapTileUrl(key))
+				.then((buffer) => {
+					if (buffer === null) {
+						this.missing.add(key);
+						return;
+					}
+					// Avkodade rutor med sökvägar tar ungefär fyra gånger filens storlek
+					this.tiles.set(key, { tile: decodeMapTile(new Uint8Array(buffer)), paths: null }, buffer.byteLength * 4);
+					this.failedAt.delete(key);
+					if (this.visibleKeys.includes(key)) {
+						this.requestRender();
+					}
+				})
+				.catch((error) => {
+					this.failedAt.set(key, performance.now());
+					console.warn("Kunde inte läsa kartruta:", key, error);
+				})
+				.finally(() => {
+					this.loading.delete(key);
+					this.pump();
+				});
+		}
+	}
+
+	private requestRender(): void {
+		if (!this.visible || this.framePending || typeof requestAnimationFrame !== 'function') {
+			return;
+		}
+		this.framePending = true;
+		requestAnimationFrame(() => {
+			this.framePending = false;
+			this.render();
+		});
+	}
+
+	private render(): void {
+		if (!this.visible || typeof Path2D !== 'function') {
+			return;
+		}
+		this.context ??= this.canvas.getContext('2d');
+		const context = this.context;
+		if (context === null) {
+			return;
+		}
+		const start = performance.now();
+
+		// Utan layout, t.ex. i en stängd details, finns inget att rita på
+		if (this.canvas.clientWidth === 0 || this.canvas.clientHeight === 0) {
+			return;
+		}
+		const ratio = Math.min(window.devicePixelRatio || 1, MAP_MAX_PIXEL_RATIO);
+		const width = Math.round(this.canvas.clientWidth * ratio);
+		const height = Math.round(this.canvas.clientHeight * ratio);
+		if (this.canvas.width !== width || this.canvas.height !== height) {
+			this.canvas.width = width;
+			this.canvas.height = height;
+		}
+		context.setTransform(1, 0, 0, 1, 0, 0);
+		context.clearRect(0, 0, width, height);
+		if (!Number.isFinite(this.northing) || !Number.isFinite(this.easting)) {
+			return;
+		}
+
+		const foreground = getComputedStyle(this.canvas).color;
+		const scale = ratio / this.metresPerPixel;
+		const centerX = width / 2;
+		const centerY = height / 2;
+		const entries: MapTileEntry[] = [];
+		for (const key of this.visibleKeys) {
+			const entry = this.tiles.get(key);
+			if (entry !== undefined) {
+				entries.push(entry);
+			}
+		}
+
+		for (const [kind, style] of MAP_STYLES) {
+			context.fillStyle = style.fill ?? foreground;
+			context.strokeStyle = style.stroke ?? foreground;
+			context.lineWidth = style.width * ratio / scale;
+			for (const entry of entries) {
+				entry.paths ??= buildMapTilePaths(entry.tile);
+				const path = entry.paths[kind];
+				if (!path) {
+					continue;
+				}
+				const { tile } = entry;
+				context.setTransform(scale, 0, 0, scale,
+					centerX + (tile.minEasting - this.easting) * scale,
+					centerY - (tile.minNorthing + tile.size - this.northing) * scale);
+				if (style.fill !== null) {
+					context.fill(path, 'evenodd');
+				}
+				if (style.stroke !== null) {
+					context.stroke(path);
+				}
+			}
+		}
+		context.setTransform(1, 0, 0, 1, 0, 0);
+
+		this.drawSheetGrid(context, scale, width, height, ratio, foreground);
+		this.drawPlaces(context, entries, scale, centerX, centerY, ratio, foreground);
+		this.drawPosition(context, scale, centerX, centerY, ratio, foreground);
+
+		this.recordFrame(performance.now() - start);
+	}
+
+	/**
+	 * Draws the edges of the tiles in use, i.e. the map sheets of that size
+	 */
+	private drawSheetGrid(context: CanvasRenderingContext2D, scale: number, width: number, height: number, ratio: number, foreground: string): void {
+		const size = this.tileSize;
+		const left = this.easting - width / 2 / scale;
+		const bottom = this.northing - height / 2 / scale;
+		context.save();
+		context.globalAlpha = 0.25;
+		context.strokeStyle = foreground;
+		context.lineWidth = ratio;
+		context.beginPath();
+		for (let e = Math.ceil(left / size) * size; e < left + width / scale; e += size) {
+			const x = Math.round((e - left) * scale) + 0.5;
+			context.moveTo(x, 0);
+			context.lineTo(x, height);
+		}
+		for (let n = Math.ceil(bottom / size) * size; n < bottom + height / scale; n += size) {
+			const y = Math.round(height - (n - bottom) * scale) + 0.5;
+			context.moveTo(0, y);
+			context.lineTo(width, y);
+		}
+		context.stroke();
+		context.restore();
+	}
+
+	private drawPlaces(context: CanvasRenderingContext2D, entries: MapTileEntry[], scale: number, centerX: number, centerY: number, ratio: number, foreground: string): void {
+		const drawLabels = this.averageFrameMs < MAP_FRAME_BUDGET_MS;
+		const dot = 3 * ratio;
+		context.fillStyle = foreground;
+		context.font = `${12 * ratio}px system-ui, sans-serif`;
+		context.textBaseline = 'middle';
+		for (const { tile } of entries) {
+			for (const feature of tile.features) {
+				if (feature.geometry !== MAP_GEOMETRY.POINT) {
+					continue;
+				}
+				const { coordinates } = feature;
+				for (let i = 0; i < coordinates.length; i += 2) {
+					const x = centerX + (coordinates[i + 1] - this.easting) * scale;
+					const y = centerY - (coordinates[i] - this.northing) * scale;
+					context.fillRect(x - dot / 2, y - dot / 2, dot, dot);
+					if (drawLabels && feature.name !== '') {
+						context.fillText(feature.name, x + dot * 1.5, y);
+					}
+				}
+			}
+		}
+	}
+
+	/**
+	 * Draws the position with its accuracy circle and direction of travel
+	 */
+	private drawPosition(context: CanvasRenderingContext2D, scale: number, centerX: number, centerY: number, ratio: number, foreground: string): void {
+		context.fillStyle = 'rgba(30, 120, 220, 0.15)';
+		context.strokeStyle = 'rgba(30, 120, 220, 0.9)';
+		context.lineWidth = ratio;
+		const radius = this.accuracy * scale;
+		if (radius > 4 * ratio) {
+			context.beginPath();
+			context.arc(centerX, centerY, radius, 0, 2 * Math.PI);
+			context.fill();
+			context.stroke();
+		}
+		if (this.gridBearing !== null) {
+			const angle = this.gridBearing * Math.PI / 180;
+			const length = 14 * ratio;
+			context.beginPath();
+			context.moveTo(centerX + Math.sin(angle) * length, centerY - Math.cos(angle) * length);
+			context.lineTo(centerX + Math.sin(angle + 2.6) * length / 2, centerY - Math.cos(angle + 2.6) * length / 2);
+			context.lineTo(centerX + Math.sin(angle - 2.6) * length / 2, centerY - Math.cos(angle - 2.6) * length / 2);
+			context.closePath();
+			context.fillStyle = foreground;
+			context.fill();
+		}
+		context.fillStyle = 'rgb(30, 120, 220)';
+		context.beginPath();
+		context.arc(centerX, centerY, 4 * ratio, 0, 2 * Math.PI);
+		context.fill();
+	}
+
+	private recordFrame(milliseconds: number): void {
+		this.frameTimes[this.frameCount % MAP_FRAME_SAMPLES] = milliseconds;
+		this.averageFrameMs = this.frameCount === 0
+			? milliseconds
+			: this.averageFrameMs + (milliseconds - this.averageFrameMs) * MAP_FRAME_AVERAGE_WEIGHT;
+		this.frameCount++;
+	}
+}
@@ -0,0 +1,154 @@
+// ============================================================================
+// MOTION ESTIMATOR (speed and course from successive SWEREF 99 TM fixes)
+// ============================================================================
+//
+// Många enheter anger inte fart och kurs (coords.speed/heading är null).
+// Här skattas de ur de senaste positionerna i SWEREF 99 TM-planet, där
+// avstånd är euklidiska när de delats med skalfaktorn. Skalfaktor och
+// meridiankonvergens kommer från framåtprojektionen i sweref-projection.ts.
+// Skattningen är en Theil–Sen-skattning över ett fast fönster: komponentvis
+// median av hastigheten mellan alla par av positioner, som tål att nästan
+// var tredje position är en avvikare. Fönstret är fast, så kostnaden per
+// position är konstant. Mottagare som ger flera positioner per sekund glesas
+// ut till ungefär en per sekund, så att fönstret alltid hinner spänna över
+// minst två sekunder.
+
+interface MotionEstimate {
+	/** Ground speed, m/s */
+	speed: number;
+	/** Course over ground relative to true north, degrees 0–360, null when too slow to tell */
+	course: number | null;
+}
+
+/**
+ * Number of fixes in the estimation window
+ */
+const MOTION_WINDOW_SIZE = 10;
+
+/**
+ * Shortest time span the window must cover before an estimate is given
+ */
+const MOTION_MIN_SPAN_MS = 2000;
+
+/**
+ * Shortest time between fixes taken into the window; faster fixes only
+ * return the current estimate. Slightly under a second so that 1 Hz
+ * receivers with jitter keep every fix.
+ */
+const MOTION_MIN_INTERVAL_MS = 900;
+
+/**
+ * Time without fixes after which the window starts over
+ */
+const MOTION_MAX_GAP_MS = 30000;
+
+/**
+ * Below this speed the course is dominated by noise and is not reported
+ */
+const MOTION_MIN_COURSE_SPEED_MS = 0.5;
+
+/**
+ * Speeds below this many standard deviations of the speed noise are
+ * reported as standing still, since position noise alone produces them
+ */
+const MOTION_STANDSTILL_SIGMAS = 2.5;
+
+/**
+ * Median of the first count values; reorders them
+ */
+function medianInPlace(values: Float64Array, count: number): number {
+	const sorted = values.subarray(0, count).sort();
+	const middle = count >> 1;
+	return count % 2 === 1 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+}
+
+/**
+ * SwerefMotionEstimator - fart och kurs ur de senaste positionerna
+ */
+class SwerefMotionEstimator {
+	private timestamps = new Float64Array(MOTION_WINDOW_SIZE);
+	private northings = new Float64Array(MOTION_WINDOW_SIZE);
+	private eastings = new Float64Array(MOTION_WINDOW_SIZE);
+	private slopesNorth = new Float64Array(MOTION_WINDOW_SIZE * (MOTION_WINDOW_SIZE - 1) / 2);
+	private slopesEast = new Float64Array(MOTION_WINDOW_SIZE * (MOTION_WINDOW_SIZE - 1) / 2);
+	private count: number = 0;
+	private next: number = 0;
+	private estimate: MotionEstimate | null = null;
+
+	reset(): void {
+		this.count = 0;
+		this.next = 0;
+		this.estimate = null;
+	}
+
+	/**
+	 * Adds a fix and returns the current estimate
+	 *
+	 * @param accuracy - Geolocation accuracy (95 % radius) in metres
+	 * @param convergence - Meridian convergence at the fix, degrees
+	 * @param scaleFactor - Point scale factor at the fix
+	 * @returns null until the window spans MOTION_MIN_SPAN_MS, and for fixes
+	 * that are not newer than the previous one; fixes less than
+	 * MOTION_MIN_INTERVAL_MS after the previous one return the current estimate
+	 */
+	update(timestamp: number, northing: number, easting: number, accuracy: number, convergence: number, scaleFactor: number): MotionEstimate | null {
+		if (this.count > 0) {
+			const last = (this.next + MOTION_WINDOW_SIZE - 1) % MOTION_WINDOW_SIZE;
+			const dt = timestamp - this.timestamps[last];
+			if (dt <= 0) {
+				return null;
+			}
+			if (dt < MOTION_MIN_INTERVAL_MS) {
+				return this.estimate;
+			}
+			if (dt > MOTION_MAX_GAP_MS) {
+				this.reset();
+			}
+		}
+
+		this.timestamps[this.next] = timestamp;
+		this.northings[this.next] = northing;
+		this.eastings[this.next] = easting;
+		this.next = (this.next + 1) % MOTION_WINDOW_SIZE;
+		this.count = Math.min(this.count + 1, MOTION_WINDOW_SIZE);
+
+		const oldest = (this.next + MOTION_WINDOW_SIZE - this.count) % MOTION_WINDOW_SIZE;
+		const spanMs = timestamp - this.timestamps[oldest];
+		if (this.count < 3 || spanMs < MOTION_MIN_SPAN_MS) {
+			this.estimate = null;
+			return null;
+		}
+
+		let pairs = 0;
+		for (let i = 0; i < this.count; i++) {
+			for (let j = i + 1; j < this.count; j++) {
+				const a = (oldest + i) % MOTION_WINDOW_SIZE;
+				const b = (oldest + j) % MOTION_WINDOW_SIZE;
+				const seconds = (this.timestamps[b] - this.timestamps[a]) / 1000;
+				this.slopesNorth[pairs] = (this.northings[b] - this.northings[a]) / seconds;
+				this.slopesEast[pairs] = (this.eastings[b] - this.eastings[a]) / seconds;
+				pairs++;
+			}
+		}
+
+		const velocityNorth = medianInPlace(this.slopesNorth, pairs) / scaleFactor;
+		const velocityEast = medianInPlace(this.slopesEast, pairs) / scaleFactor;
+		const speed = Math.hypot(velocityNorth, velocityEast);
+		// Lutningens standardavvikelse vid jämnt fördelade positioner
+		const speedNoise = accuracy * GEOLOCATION_ACCURACY_TO_SIGMA * Math.sqrt(12 / this.count) / (spanMs / 1000);
+		this.estimate = this.describeVelocity(speed, velocityNorth, velocityEast, speedNoise, convergence);
+		return this.estimate;
+	}
+
+	private describeVelocity(speed: number, velocityNorth: number, velocityEast: number, speedNoise: number, convergence: number): MotionEstimate {
+		if (speed < MOTION_STANDSTILL_SIGMAS * speedNoise) {
+			return { speed: 0, course: null };
+		}
+		if (speed < MOTION_MIN_COURSE_SPEED_MS) {
+			return { speed, course: null };
+		}
+		const gridBearing = Math.atan2(velocityEast, velocityNorth) * 180 / Math.PI;
+		const course = gridBearing + convergence;
+		return { speed, course: (course % 360 + 360) % 360 };
+	}
+}
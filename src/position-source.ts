@@ -0,0 +1,188 @@
+// ============================================================================
+// POSITION SOURCES
+// ============================================================================
+//
+// En positionskälla har samma form som navigator.geolocation (watchPosition
+// och clearWatch) och levererar GeolocationPosition-liknande objekt, så att
+// resten av appen från handlePositionSuccess och framåt inte behöver veta
+// var positionerna kommer ifrån. Standard är enhetens platstjänst; en extern
+// GNSS-mottagare kan anslutas via en lokal WebSocket-brygga, t.ex.
+// `websocketd --port=2947 gpspipe -w` (gpsd-JSON) eller `gpspipe -r` (NMEA).
+
+type PositionSourceKind = 'browser' | 'gnss-websocket' | 'replay';
+
+interface PositionSource {
+	readonly kind: PositionSourceKind;
+	isSupported(): boolean;
+	watchPosition(onSuccess: PositionCallback, onError: PositionErrorCallback, options?: PositionOptions): number;
+	clearWatch(id: number): void;
+}
+
+const POSITION_SOURCE_KINDS: PositionSourceKind[] = ['browser', 'gnss-websocket'];
+const DEFAULT_GNSS_WEBSOCKET_URL = 'ws://localhost:2947';
+
+/**
+ * Delay before reconnecting after the bridge connection is lost
+ */
+const GNSS_RECONNECT_DELAY_MS = 3000;
+
+// Felkoder enligt GeolocationPositionError
+const POSITION_ERROR_CODE = {
+	PERMISSION_DENIED: 1,
+	POSITION_UNAVAILABLE: 2,
+	TIMEOUT: 3
+} as const;
+
+function isPositionSourceKind(value: string): value is PositionSourceKind {
+	return POSITION_SOURCE_KINDS.includes(value as PositionSourceKind);
+}
+
+/**
+ * Checks that a bridge URL is a WebSocket URL
+ */
+function isValidGnssWebSocketUrl(value: string): boolean {
+	try {
+		const url = new URL(value);
+		return url.protocol === 'ws:' || url.protocol === 'wss:';
+	} catch {
+		return false;
+	}
+}
+
+function createPositionError(code: number, message: string): GeolocationPositionError {
+	return {
+		code,
+		message,
+		...POSITION_ERROR_CODE
+	};
+}
+
+/**
+ * Wraps a GNSS fix in the shape of a Geolocation API position
+ */
+function createGeolocationPosition(fix: GnssFix): GeolocationPosition {
+	const coords = {
+		latitude: fix.latitude,
+		longitude: fix.longitude,
+		accuracy: fix.accuracy,
+		altitude: fix.altitude,
+		altitudeAccuracy: null,
+		heading: fix.heading,
+		speed: fix.speed,
+		toJSON() {
+			return { ...this };
+		}
+	};
+	return {
+		coords,
+		timestamp: fix.timestamp,
+		toJSON() {
+			return { coords: coords.toJSON(), timestamp: fix.timestamp };
+		}
+	};
+}
+
+/**
+ * The device's own location service
+ */
+class BrowserPositionSource implements PositionSource {
+	readonly kind = 'browser';
+
+	isSupported(): boolean {
+		return typeof navigator !== 'undefined' && 'geolocation' in navigator;
+	}
+
+	watchPosition(onSuccess: PositionCallback, onError: PositionErrorCallback, options?: PositionOptions): number {
+		return navigator.geolocation.watchPosition(onSuccess, onError, options);
+	}
+
+	clearWatch(id: number): void {
+		navigator.geolocation.clearWatch(id);
+	}
+}
+
+/**
+ * GnssWebSocketPositionSource - extern mottagare via WebSocket-brygga
+ *
+ * Anslutningen återupprättas automatiskt om den bryts. Felanropet görs en
+ * gång per avbrott, inte vid varje nytt anslutningsförsök.
+ */
+class GnssWebSocketPositionSource implements PositionSource {
+	readonly kind = 'gnss-websocket';
+	private watches = new Map<number, { socket: WebSocket | null; reconnectTimer: number | null }>();
+	private nextWatchId = 1;
+
+	constructor(private url: string) {}
+
+	isSupported(): boolean {
+		return typeof WebSocket === 'function' && isValidGnssWebSocketUrl(this.url);
+	}
+
+	watchPosition(onSuccess: PositionCallback, onError: PositionErrorCallback): number {
+		const id = this.nextWatchId++;
+		this.watches.set(id, { socket: null, reconnectTimer: null });
+		this.connect(id, onSuccess, onError, true);
+		return id;
+	}
+
+	clearWatch(id: number): void {
+		const watch = this.watches.get(id);
+		if (!watch) {
+			return;
+		}
+		this.watches.delete(id);
+		if (watch.reconnectTimer !== null) {
+			clearTimeout(watch.reconnectTimer);
+		}
+		watch.socket?.close();
+	}
+
+	private connect(id: number, onSuccess: PositionCallback, onError: PositionErrorCallback, reportFailure: boolean): void {
+		const watch = this.watches.get(id);
+		if (!watch) {
+			return;
+		}
+
+		const parser = new GnssStreamParser();
+		const decoder = new TextDecoder();
+		const socket = new WebSocket(this.url);
+		socket.binaryType = 'arraybuffer';
+		watch.socket = socket;
+		watch.reconnectTimer = null;
+
+		socket.onmessage = (event: MessageEvent<string | ArrayBuffer>) => {
+			const text = typeof event.data === 'string' ? event.data : decoder.decode(event.data, { stream: true });
+			for (const fix of parser.push(text)) {
+				reportFailure = true;
+				onSuccess(createGeolocationPosition(fix));
+			}
+		};
+		socket.onclose = () => {
+			if (this.watches.get(id) !== watch) {
+				return;
+			}
+			if (reportFailure) {
+				reportFailure = false;
+				onError(createPositionError(POSITION_ERROR_CODE.POSITION_UNAVAILABLE, `Ingen anslutning till ${this.url}`));
+			}
+			watch.socket = null;
+			watch.reconnectTimer = setTimeout(() => {
+				this.connect(id, onSuccess, onError, reportFailure);
+			}, GNSS_RECONNECT_DELAY_MS);
+		};
+	}
+}
+
+/**
+ * Creates the position source for a kind, falling back to the browser
+ * when the external source cannot be used
+ */
+function createPositionSource(kind: PositionSourceKind, url: string): PositionSource {
+	if (kind === 'gnss-websocket') {
+		const source = new GnssWebSocketPositionSource(url);
+		if (source.isSupported()) {
+			return source;
+		}
+	}
+	return new BrowserPositionSource();
+}
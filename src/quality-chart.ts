@@ -0,0 +1,200 @@
+// ============================================================================
+// QUALITY CHART (accuracy, speed and fix interval over time)
+// ============================================================================
+//
+// Ritar noggrannhet, hastighet och tid mellan positioner för spåret i tre
+// paneler med gemensam tidsaxel, så att datakvaliteten under hela sessionen
+// syns och inte bara det senaste värdet. Varje serie lagras i en
+// TimeSeriesBuffer och minskas med LTTB till panelens bredd i pixlar, så
+// en ritning kostar lika mycket efter en minut som efter ett dygn.
+//
+// Nya positioner läggs bara till i serierna; när diagrammet ritas om
+// bestäms av anroparen.
+
+/**
+ * Line colours of the accuracy, speed and interval series
+ */
+const QUALITY_CHART_COLORS = ['rgb(200, 90, 40)', 'rgb(30, 120, 220)', 'rgb(110, 110, 110)'] as const;
+const QUALITY_CHART_UNITS = ['m', 'm/s', 's'] as const;
+const QUALITY_CHART_FRAME_SAMPLES = 60;
+/** Gap between the panels and around the text, CSS pixels */
+const QUALITY_CHART_PADDING = 4;
+
+interface QualityChartStats extends ReplayTimingStats {
+	/** Rendered frames */
+	count: number;
+	/** Points drawn in the latest frame, all series */
+	drawnCount: number;
+}
+
+/**
+ * Formats a value with one decimal and a decimal comma
+ */
+function formatQualityValue(value: number): string {
+	return value.toFixed(1).replace('.', ',');
+}
+
+class QualityChart {
+	/** Accuracy in metres, speed in m/s and time since the previous fix in seconds */
+	readonly series = [new TimeSeriesBuffer(), new TimeSeriesBuffer(), new TimeSeriesBuffer()] as const;
+	private context: CanvasRenderingContext2D | null = null;
+	private firstTimestamp: number = Number.NaN;
+	private lastTimestamp: number = Number.NaN;
+	private readonly bucketTime: Float64Array;
+	private readonly bucketValue: Float64Array;
+	private drawnTime = new Float64Array(0);
+	private drawnValue = new Float64Array(0);
+	private drawnCount: number = 0;
+	private readonly frameTimes = new Float64Array(QUALITY_CHART_FRAME_SAMPLES);
+	private frameCount: number = 0;
+
+	/**
+	 * @param labels - Names of the accuracy, speed and interval series
+	 */
+	constructor(private readonly canvas: HTMLCanvasElement, private readonly labels: readonly [string, string, string]) {
+		this.bucketTime = new Float64Array(this.series[0].capacity);
+		this.bucketValue = new Float64Array(this.series[0].capacity);
+	}
+
+	/**
+	 * Number of fixes added
+	 */
+	get fixCount(): number {
+		return this.series[0].length;
+	}
+
+	clear(): void {
+		for (const series of this.series) {
+			series.clear();
+		}
+		this.firstTimestamp = Number.NaN;
+		this.lastTimestamp = Number.NaN;
+	}
+
+	/**
+	 * Adds a fix; the speed is NaN when the device reported none
+	 */
+	append(timestamp: number, accuracy: number, speed: number): void {
+		const [accuracySeries, speedSeries, intervalSeries] = this.series;
+		accuracySeries.push(timestamp, accuracy);
+		speedSeries.push(timestamp, speed);
+		if (Number.isFinite(this.lastTimestamp)) {
+			intervalSeries.push(timestamp, (timestamp - this.lastTimestamp) / 1000);
+		} else {
+			this.firstTimestamp = timestamp;
+		}
+		this.lastTimestamp = timestamp;
+	}
+
+	/**
+	 * Adds a chunk of stored fixes
+	 */
+	load(columns: TrackColumns): void {
+		for (let i = 0; i < columns.count; i++) {
+			this.append(columns.timestamp[i], columns.accuracy[i], columns.speed[i]);
+		}
+	}
+
+	/**
+	 * Drawing times of the most recent frames, milliseconds
+	 */
+	frameStats(): QualityChartStats {
+		return {
+			count: this.frameCount,
+			drawnCount: this.drawnCount,
+			...summarizeTimings(this.frameTimes, Math.min(this.frameCount, QUALITY_CHART_FRAME_SAMPLES))
+		};
+	}
+
+	/**
+	 * Draws the three series, each downsampled to the width of the chart
+	 */
+	render(): void {
+		this.context ??= this.canvas.getContext('2d');
+		const context = this.context;
+		// Utan layout, t.ex. i en stängd details, finns inget att rita på
+		if (context === null || this.canvas.clientWidth === 0 || this.canvas.clientHeight === 0) {
+			return;
+		}
+		const start = performance.now();
+		const ratio = Math.min(window.devicePixelRatio || 1, MAP_MAX_PIXEL_RATIO);
+		const width = Math.round(this.canvas.clientWidth * ratio);
+		const height = Math.round(this.canvas.clientHeight * ratio);
+		if (this.canvas.width !== width || this.canvas.height !== height) {
+			this.canvas.width = width;
+			this.canvas.height = height;
+		}
+		context.setTransform(1, 0, 0, 1, 0, 0);
+		context.clearRect(0, 0, width, height);
+		this.drawnCount = 0;
+
+		const foreground = getComputedStyle(this.canvas).color;
+		const padding = QUALITY_CHART_PADDING * ratio;
+		const fontSize = 11 * ratio;
+		context.font = `${fontSize}px system-ui, sans-serif`;
+		context.textBaseline = 'top';
+		const axisHeight = fontSize + padding;
+		const panelHeight = (height - axisHeight) / this.series.length;
+		const threshold = Math.max(3, Math.floor(this.canvas.clientWidth));
+		if (this.drawnTime.length < threshold) {
+			this.drawnTime = new Float64Array(threshold);
+			this.drawnValue = new Float64Array(threshold);
+		}
+		const first = this.firstTimestamp;
+		const duration = this.lastTimestamp - first;
+		const toX = (time: number) => duration > 0 ? (time - first) / duration * width : width / 2;
+
+		this.series.forEach((series, index) => {
+			const top = index * panelHeight;
+			const bottom = top + panelHeight - padding;
+			const plotTop = top + fontSize + padding;
+			context.globalAlpha = 0.25;
+			context.fillStyle = foreground;
+			context.fillRect(0, Math.round(bottom), width, ratio);
+			context.globalAlpha = 1;
+
+			const label = series.length === 0
+				? this.labels[index]
+				: `${this.labels[index]} ${formatQualityValue(series.last)}\u00A0${QUALITY_CHART_UNITS[index]} (max ${formatQualityValue(series.max)}\u00A0${QUALITY_CHART_UNITS[index]})`;
+			context.fillText(label, padding, top + padding / 2);
+			if (series.length === 0) {
+				return;
+			}
+
+			const bucketCount = series.toArrays(this.bucketTime, this.bucketValue);
+			const count = downsampleLttb(this.bucketTime, this.bucketValue, bucketCount, threshold, this.drawnTime, this.drawnValue);
+			const scale = series.max > 0 ? (bottom - plotTop) / series.max : 0;
+			context.strokeStyle = QUALITY_CHART_COLORS[index];
+			context.lineWidth = 1.5 * ratio;
+			context.lineJoin = 'round';
+			context.beginPath();
+			for (let i = 0; i < count; i++) {
+				const x = toX(this.drawnTime[i]);
+				const y = bottom - this.drawnValue[i] * scale;
+				if (i === 0) {
+					context.moveTo(x, y);
+				} else {
+					context.lineTo(x, y);
+				}
+			}
+			context.stroke();
+			this.drawnCount += count;
+		});
+
+		if (Number.isFinite(first)) {
+			const formatTime = (time: number) => new Date(time).toLocaleTimeString('sv-SE', { hour: '2-digit', minute: '2-digit' });
+			const axisTop = height - axisHeight + padding / 2;
+			context.fillStyle = foreground;
+			context.textAlign = 'left';
+			context.fillText(formatTime(first), padding, axisTop);
+			context.textAlign = 'right';
+			context.fillText(formatTime(this.lastTimestamp), width - padding, axisTop);
+			context.textAlign = 'left';
+		}
+
+		const milliseconds = performance.now() - start;
+		this.frameTimes[this.frameCount % QUALITY_CHART_FRAME_SAMPLES] = milliseconds;
+		this.frameCount++;
+	}
+}
+
@@ -0,0 +1,130 @@
+// ============================================================================
+// REPLAY HARNESS
+// ============================================================================
+//
+// Mäter positionsflödet medan ett spår spelas upp: fördröjning från att en
+// position är schemalagd tills handlePositionSuccess har renderat den,
+// antal DOM-ändringar och heap-tillväxt per position. Fungerar i webbläsaren
+// och under jsdom; heap mäts via performance.memory eller en inskickad
+// funktion (t.ex. process.memoryUsage i Node).
+
+interface ReplayTimingStats {
+	mean: number;
+	p95: number;
+	max: number;
+}
+
+interface ReplayReport {
+	trace: string;
+	fixCount: number;
+	speedFactor: number;
+	wallMs: number;
+	/** Time from a fix being due until it has been handled */
+	latencyMs: ReplayTimingStats;
+	/** Time spent inside the position callback */
+	processingMs: ReplayTimingStats;
+	domWritesPerFix: number;
+	/** Heap growth divided by fix count, null where heap size cannot be read */
+	heapBytesPerFix: number | null;
+}
+
+/**
+ * Heap size in Chromium-based browsers, null elsewhere
+ */
+function readBrowserHeapBytes(): number | null {
+	const memory = (performance as Performance & { memory?: { usedJSHeapSize: number } }).memory;
+	return memory ? memory.usedJSHeapSize : null;
+}
+
+function summarizeTimings(samples: Float64Array, count: number): ReplayTimingStats {
+	if (count === 0) {
+		return { mean: 0, p95: 0, max: 0 };
+	}
+	const sorted = samples.slice(0, count).sort();
+	let sum = 0;
+	for (let i = 0; i < count; i++) {
+		sum += sorted[i];
+	}
+	return {
+		mean: sum / count,
+		p95: sorted[Math.min(count - 1, Math.floor(count * 0.95))],
+		max: sorted[count - 1]
+	};
+}
+
+/**
+ * ReplayMeasurement - samlar mätvärden via ReplayInstrumentation
+ *
+ * DOM-ändringar räknas med en MutationObserver vars poster hämtas
+ * synkront efter varje position, så att de kan knytas till rätt position.
+ */
+class ReplayMeasurement implements ReplayInstrumentation {
+	private latencies: Float64Array;
+	private processing: Float64Array;
+	private count: number = 0;
+	private domWrites: number = 0;
+	private callStart: number = 0;
+	private startTime: number;
+	private startHeap: number | null;
+	private observer: MutationObserver;
+
+	constructor(root: Node, capacity: number, private readHeapBytes: () => number | null = readBrowserHeapBytes) {
+		this.latencies = new Float64Array(capacity);
+		this.processing = new Float64Array(capacity);
+		this.observer = new MutationObserver(() => {});
+		this.observer.observe(root, { subtree: true, childList: true, characterData: true, attributes: true });
+		this.startTime = performance.now();
+		this.startHeap = readHeapBytes();
+	}
+
+	beforeFix(): void {
+		this.observer.takeRecords();
+		this.callStart = performance.now();
+	}
+
+	afterFix(dueTime: number): void {
+		const end = performance.now();
+		if (this.count < this.latencies.length) {
+			this.latencies[this.count] = end - dueTime;
+			this.processing[this.count] = end - this.callStart;
+		}
+		this.count++;
+		this.domWrites += this.observer.takeRecords().length;
+	}
+
+	finish(trace: string, speedFactor: number): ReplayReport {
+		this.observer.disconnect();
+		const recorded = Math.min(this.count, this.latencies.length);
+		const endHeap = this.readHeapBytes();
+		return {
+			trace,
+			fixCount: this.count,
+			speedFactor,
+			wallMs: performance.now() - this.startTime,
+			latencyMs: summarizeTimings(this.latencies, recorded),
+			processingMs: summarizeTimings(this.processing, recorded),
+			domWritesPerFix: this.count > 0 ? this.domWrites / this.count : 0,
+			heapBytesPerFix: this.startHeap !== null && endHeap !== null && this.count > 0
+				? (endHeap - this.startHeap) / this.count
+				: null
+		};
+	}
+}
+
+/**
+ * Measures a replay until the source has delivered every fix
+ * The caller starts the watch, so fixes go through the normal pipeline.
+ *
+ * @param root - DOM subtree whose changes are counted
+ */
+async function measureReplay(
+	source: ReplayPositionSource,
+	root: Node,
+	readHeapBytes: () => number | null = readBrowserHeapBytes
+): Promise<ReplayReport> {
+	const measurement = new ReplayMeasurement(root, source.trace.fixes.length, readHeapBytes);
+	source.setInstrumentation(measurement);
+	await source.whenComplete();
+	source.setInstrumentation(null);
+	return measurement.finish(source.trace.name, source.speedFactor);
+}
@@ -0,0 +1,304 @@
+// ============================================================================
+// REPLAY POSITION SOURCE
+// ============================================================================
+//
+// Spelar upp inspelade eller syntetiska positionsspår genom samma
+// PositionSource-gränssnitt som enhetens platstjänst, i realtid eller
+// accelererat. Uppspelningen är deterministisk: samma spår ger samma
+// positioner i samma ordning. Filen innehåller ingen DOM-kod och fungerar
+// därför både i webbläsaren och under Node/jsdom.
+
+type SyntheticTraceKind = 'walking' | 'driving' | 'stationary';
+
+/**
+ * True position behind a synthetic fix, for verifying filters
+ */
+interface ReplayTruthPoint {
+	latitude: number;
+	longitude: number;
+	speed: number;
+}
+
+interface ReplayTrace {
+	name: string;
+	fixes: GnssFix[];
+	/** Ground truth, one point per fix, for synthetic traces */
+	truth?: ReplayTruthPoint[];
+}
+
+/**
+ * Hooks called around every delivered fix, e.g. by the replay harness
+ * @param dueTime - performance.now() time when the fix was due
+ */
+interface ReplayInstrumentation {
+	beforeFix(dueTime: number): void;
+	afterFix(dueTime: number): void;
+}
+
+const SYNTHETIC_TRACE_KINDS: SyntheticTraceKind[] = ['walking', 'driving', 'stationary'];
+
+/**
+ * Accuracy assumed for trace formats that carry no accuracy estimate
+ */
+const REPLAY_DEFAULT_ACCURACY_METERS = 5;
+
+/**
+ * Most fixes delivered in one task when replay runs behind schedule
+ * Keeps accelerated replay from blocking the event loop.
+ */
+const REPLAY_MAX_BATCH = 256;
+
+const METERS_PER_DEGREE_LATITUDE = 111320;
+const SYNTHETIC_TRACE_START = Date.UTC(2025, 5, 1, 10, 0, 0);
+const SYNTHETIC_TRACE_ORIGIN = { latitude: 59.3293, longitude: 18.0686 } as const;
+
+function isSyntheticTraceKind(value: string): value is SyntheticTraceKind {
+	return SYNTHETIC_TRACE_KINDS.includes(value as SyntheticTraceKind);
+}
+
+/**
+ * Deterministic pseudo-random generator (mulberry32)
+ */
+function createSeededRandom(seed: number): () => number {
+	let state = seed >>> 0;
+	return () => {
+		state = (state + 0x6D2B79F5) >>> 0;
+		let t = state;
+		t = Math.imul(t ^ (t >>> 15), t | 1);
+		t ^= t + Math.imul(t ^ (t >>> 7), t | 61);
+		return ((t ^ (t >>> 14)) >>> 0) / 4294967296;
+	};
+}
+
+/**
+ * Standard normal sample from a uniform generator (Box–Muller)
+ */
+function sampleGaussian(random: () => number): number {
+	const u = 1 - random();
+	const v = random();
+	return Math.sqrt(-2 * Math.log(u)) * Math.cos(2 * Math.PI * v);
+}
+
+/**
+ * Profile of a synthetic trace
+ * noise is white measurement noise, bias a slowly wandering offset
+ * (multipath, atmosphere), both as standard deviations in metres.
+ */
+const SYNTHETIC_TRACE_PROFILES: Record<SyntheticTraceKind, { speed: number; turnRate: number; noise: number; bias: number; accuracy: number }> = {
+	walking: { speed: 1.4, turnRate: 0.02, noise: 2.0, bias: 0.15, accuracy: 5 },
+	driving: { speed: 14, turnRate: 0.01, noise: 3.0, bias: 0.2, accuracy: 8 },
+	stationary: { speed: 0, turnRate: 0, noise: 2.0, bias: 0.15, accuracy: 5 }
+};
+
+/**
+ * Creates a reproducible synthetic trace with ground truth
+ *
+ * @param kind - Movement profile
+ * @param durationSeconds - Trace length
+ * @param rateHz - Fixes per second
+ */
+function createSyntheticTrace(kind: SyntheticTraceKind, durationSeconds: number = 600, rateHz: number = 1): ReplayTrace {
+	const profile = SYNTHETIC_TRACE_PROFILES[kind];
+	const random = createSeededRandom(SYNTHETIC_TRACE_KINDS.indexOf(kind) + 1);
+	const count = Math.max(1, Math.round(durationSeconds * rateHz));
+	const dt = 1 / rateHz;
+	const fixes: GnssFix[] = [];
+	const truth: ReplayTruthPoint[] = [];
+	const cosLatitude = Math.cos(SYNTHETIC_TRACE_ORIGIN.latitude * Math.PI / 180);
+
+	let north = 0;
+	let east = 0;
+	let heading = random() * 2 * Math.PI;
+	let biasNorth = 0;
+	let biasEast = 0;
+
+	for (let i = 0; i < count; i++) {
+		heading += profile.turnRate * sampleGaussian(random) * Math.sqrt(dt) * 10;
+		north += Math.cos(heading) * profile.speed * dt;
+		east += Math.sin(heading) * profile.speed * dt;
+		biasNorth = biasNorth * 0.98 + profile.bias * sampleGaussian(random);
+		biasEast = biasEast * 0.98 + profile.bias * sampleGaussian(random);
+
+		const trueLatitude = SYNTHETIC_TRACE_ORIGIN.latitude + north / METERS_PER_DEGREE_LATITUDE;
+		const trueLongitude = SYNTHETIC_TRACE_ORIGIN.longitude + east / (METERS_PER_DEGREE_LATITUDE * cosLatitude);
+		const measuredNorth = north + biasNorth + profile.noise * sampleGaussian(random);
+		const measuredEast = east + biasEast + profile.noise * sampleGaussian(random);
+		const measuredSpeed = Math.abs(profile.speed + 0.3 * sampleGaussian(random));
+
+		truth.push({ latitude: trueLatitude, longitude: trueLongitude, speed: profile.speed });
+		fixes.push({
+			timestamp: SYNTHETIC_TRACE_START + Math.round(i * dt * 1000),
+			latitude: SYNTHETIC_TRACE_ORIGIN.latitude + measuredNorth / METERS_PER_DEGREE_LATITUDE,
+			longitude: SYNTHETIC_TRACE_ORIGIN.longitude + measuredEast / (METERS_PER_DEGREE_LATITUDE * cosLatitude),
+			accuracy: profile.accuracy,
+			altitude: null,
+			speed: measuredSpeed,
+			heading: profile.speed > 0 ? ((heading * 180 / Math.PI) % 360 + 360) % 360 : null
+		});
+	}
+
+	return { name: kind, fixes, truth };
+}
+
+function readXmlElement(xml: string, name: string): string | null {
+	const match = new RegExp(`<${name}>([^<]*)</${name}>`).exec(xml);
+	return match ? match[1] : null;
+}
+
+/**
+ * Parses track points from GPX, including this app's SWEREF extensions
+ */
+function parseReplayGpx(text: string): GnssFix[] {
+	const fixes: GnssFix[] = [];
+	const pointPattern = /<trkpt\b([^>]*?)(?:\/>|>([\s\S]*?)<\/trkpt>)/g;
+	let match: RegExpExecArray | null;
+	while ((match = pointPattern.exec(text)) !== null) {
+		const attributes = match[1];
+		const body = match[2] ?? '';
+		const latitude = Number.parseFloat(/\blat="([^"]*)"/.exec(attributes)?.[1] ?? '');
+		const longitude = Number.parseFloat(/\blon="([^"]*)"/.exec(attributes)?.[1] ?? '');
+		if (!Number.isFinite(latitude) || !Number.isFinite(longitude)) {
+			continue;
+		}
+		const time = Date.parse(readXmlElement(body, 'time') ?? '');
+		const hdop = parseOptionalNumber(readXmlElement(body, 'hdop') ?? undefined);
+		const accuracy = parseOptionalNumber(readXmlElement(body, 'sweref:accuracy') ?? undefined)
+			?? (hdop !== null ? hdop * NMEA_HDOP_ACCURACY_METERS : REPLAY_DEFAULT_ACCURACY_METERS);
+		fixes.push({
+			timestamp: Number.isFinite(time) ? time : fixes.length * 1000,
+			latitude,
+			longitude,
+			accuracy,
+			altitude: parseOptionalNumber(readXmlElement(body, 'ele') ?? undefined),
+			speed: parseOptionalNumber(readXmlElement(body, 'sweref:speed') ?? undefined),
+			heading: null
+		});
+	}
+	return fixes;
+}
+
+/**
+ * Parses this app's CSV track export
+ */
+function parseReplayTrackCsv(text: string): GnssFix[] {
+	const fixes: GnssFix[] = [];
+	const lines = text.split('\n');
+	for (let i = 1; i < lines.length; i++) {
+		const [time, , , latitude, longitude, accuracy, speed] = lines[i].split(',');
+		const fix: GnssFix = {
+			timestamp: Date.parse(time),
+			latitude: Number.parseFloat(latitude),
+			longitude: Number.parseFloat(longitude),
+			accuracy: parseOptionalNumber(accuracy) ?? REPLAY_DEFAULT_ACCURACY_METERS,
+			altitude: null,
+			speed: parseOptionalNumber(speed?.trim()),
+			heading: null
+		};
+		if (Number.isFinite(fix.timestamp) && Number.isFinite(fix.latitude) && Number.isFinite(fix.longitude)) {
+			fixes.push(fix);
+		}
+	}
+	return fixes;
+}
+
+/**
+ * Parses a recorded trace, detecting GPX, the app's CSV export, NMEA 0183 or gpsd JSON
+ */
+function parseReplayTrace(name: string, text: string): ReplayTrace {
+	const trimmed = text.trimStart();
+	let fixes: GnssFix[];
+	if (trimmed.startsWith('<')) {
+		fixes = parseReplayGpx(trimmed);
+	} else if (trimmed.startsWith('tid,')) {
+		fixes = parseReplayTrackCsv(trimmed);
+	} else {
+		const parser = new GnssStreamParser(() => Date.now());
+		fixes = parser.push(text.endsWith('\n') ? text : `${text}\n`);
+	}
+	return { name, fixes };
+}
+
+/**
+ * ReplayPositionSource - levererar ett spår via PositionSource-gränssnittet
+ *
+ * Tiden mellan positionerna i spåret delas med speedFactor; Infinity spelar
+ * upp så fort som möjligt, i omgångar om högst REPLAY_MAX_BATCH positioner
+ * per uppgift.
+ */
+class ReplayPositionSource implements PositionSource {
+	readonly kind = 'replay';
+	private instrumentation: ReplayInstrumentation | null = null;
+	private timer: number | null = null;
+	private nextIndex: number = 0;
+	private watchId: number = 0;
+	private completion: Promise<void>;
+	private resolveCompletion: () => void = () => {};
+
+	constructor(readonly trace: ReplayTrace, readonly speedFactor: number = 1) {
+		this.completion = new Promise((resolve) => {
+			this.resolveCompletion = resolve;
+		});
+	}
+
+	isSupported(): boolean {
+		return this.trace.fixes.length > 0;
+	}
+
+	setInstrumentation(instrumentation: ReplayInstrumentation | null): void {
+		this.instrumentation = instrumentation;
+	}
+
+	/**
+	 * Resolves when every fix has been delivered
+	 */
+	whenComplete(): Promise<void> {
+		return this.completion;
+	}
+
+	watchPosition(onSuccess: PositionCallback): number {
+		this.clearWatch(this.watchId);
+		const fixes = this.trace.fixes;
+		const startTime = performance.now();
+		const firstTimestamp = fixes.length > 0 ? fixes[0].timestamp : 0;
+		const dueTime = (index: number) => startTime + (fixes[index].timestamp - firstTimestamp) / this.speedFactor;
+
+		const tick = () => {
+			this.timer = null;
+			let delivered = 0;
+			while (this.nextIndex < fixes.length && delivered < REPLAY_MAX_BATCH && dueTime(this.nextIndex) <= performance.now()) {
+				// Vid obegränsad hastighet räknas fördröjningen från när positionen plockas upp
+				const due = Number.isFinite(this.speedFactor) ? dueTime(this.nextIndex) : performance.now();
+				const position = createGeolocationPosition(fixes[this.nextIndex++]);
+				this.instrumentation?.beforeFix(due);
+				onSuccess(position);
+				this.instrumentation?.afterFix(due);
+				delivered++;
+				// Positionsanropet kan ha stoppat uppspelningen
+				if (this.watchId !== id) {
+					return;
+				}
+			}
+			if (this.nextIndex >= fixes.length) {
+				this.resolveCompletion();
+				return;
+			}
+			this.timer = setTimeout(tick, Math.max(0, dueTime(this.nextIndex) - performance.now()));
+		};
+
+		const id = ++this.watchId;
+		this.nextIndex = 0;
+		this.timer = setTimeout(tick, 0);
+		return id;
+	}
+
+	clearWatch(id: number): void {
+		if (id !== this.watchId) {
+			return;
+		}
+		this.watchId++;
+		if (this.timer !== null) {
+			clearTimeout(this.timer);
+			this.timer = null;
+		}
+	}
+}
@@ -2,8 +2,6 @@
 // TYPE DEFINITIONS AND INTERFACES
 // ============================================================================
 
-declare const proj4: any;
-
 /**
  * Represents coordinates in the SWEREF 99 TM coordinate system
  */
@@ -12,6 +10,35 @@ interface SwerefCoordinates {
 	easting: number;
 }
 
+/**
+ * Represents geographic coordinates in WGS84
+ */
+interface Wgs84Coordinates {
+	latitude: number;
+	longitude: number;
+}
+
+/**
+ * A position fix after transformation, as rendered and shared between tabs
+ * Plain data so it can be sent over BroadcastChannel.
+ */
+interface PositionFix {
+	timestamp: number;
+	latitude: number;
+	longitude: number;
+	accuracy: number;
+	speed: number | null;
+	/** Course reported by the device, degrees from true north */
+	heading: number | null;
+	/** Includes meridian convergence and point scale factor */
+	sweref: SwerefProjection;
+	inSweden: boolean;
+	/** Kalman-filtered estimate, null when the fix could not be projected */
+	filtered: FilteredPosition | null;
+	/** Speed and course derived from recent fixes, null until enough fixes have arrived */
+	motion: MotionEstimate | null;
+}
+
 /**
  * Represents the correction needed for ITRF to ETRS89 continental drift
  */
@@ -29,17 +56,6 @@ type SpeedUnit = 'm/s' | 'km/h' | 'mph';
 // CONFIGURATION CONSTANTS
 // ============================================================================
 
-/**
- * Geographic bounds for Sweden
- * Used to validate if coordinates are within Swedish territory
- */
-const SWEDEN_BOUNDS = {
-	MIN_LATITUDE: 55,
-	MAX_LATITUDE: 69,
-	MIN_LONGITUDE: 10,
-	MAX_LONGITUDE: 24
-} as const;
-
 /**
  * Position accuracy threshold (meters)
  * Smartphone GPS typically achieves 3-5m accuracy in optimal conditions and 10-20m in real-world
@@ -122,6 +138,48 @@ const UI_TEXT = {
 	NOT_AVAILABLE: 'Ej\u00A0tillgängligt',
 	WARNING_NOT_IN_SWEDEN: "Varning: SWEREF 99 är bara användbart i Sverige.",
 	WARNING_NOT_IN_SWEDEN_TITLE: "Position utanför Sverige",
+	TRACK_EMPTY: "Inget spår har spelats in ännu.",
+	TRACK_EXPORT_FAILED: "Fel: Spåret kunde inte exporteras.",
+	TRACK_EXPORT_TITLE: "Export av spår",
+	TRACK_FIXES_SUFFIX: "punkter",
+	FIX_LIST_DROPPED_SUFFIX: "äldre visas inte",
+	TRACK_PLOT_DRAWN: "Ritade",
+	TRACK_PLOT_OF: "av",
+	TRACK_PLOT_PER_FIX: "per ny punkt",
+	QUALITY_ACCURACY: "Noggrannhet",
+	QUALITY_SPEED: "Hastighet",
+	QUALITY_INTERVAL: "Intervall",
+	MEASUREMENT_DISTANCE: "Sträcka",
+	MEASUREMENT_PERIMETER: "Omkrets",
+	MEASUREMENT_AREA: "Yta",
+	WAYPOINT_NONE: "Inga punkter",
+	WAYPOINT_COUNT_SUFFIX: "punkter",
+	WAYPOINT_DEFAULT_NAME: "Punkt",
+	WAYPOINT_IMPORTING: "Importerar…",
+	WAYPOINT_NO_POSITION: "Det finns ingen position att spara ännu.",
+	WAYPOINT_FAILED: "Fel: Punkterna kunde inte sparas eller läsas.",
+	WAYPOINT_TITLE: "Punkter",
+	STAKEOUT_NONE: "Inget mål",
+	STAKEOUT_TARGET: "Mål",
+	STAKEOUT_DISTANCE: "Avstånd",
+	STAKEOUT_BEARING: "Riktning i rutnät",
+	STAKEOUT_INVALID: "Ange målet som N och E i SWEREF 99 TM, t.ex. 6580822 674032, eller som namnet på en sparad punkt.",
+	STAKEOUT_TITLE: "Utsättning",
+	GEOFENCE_ENTERED: "Inne i",
+	GEOFENCE_EXITED: "Lämnat",
+	GEOFENCE_OUTSIDE: "Utanför alla områden",
+	GEOFENCE_COUNT_SUFFIX: "områden",
+	GEOFENCE_FAILED: "Fel: Områdena kunde inte importeras eller läsas.",
+	GEOFENCE_TITLE: "Områden",
+	ADMIN_AREA_OUTSIDE: "Utanför kommunerna",
+	MAP_SHEET_PREFIX: "Ruta",
+	MAP_TILES_SUFFIX: "rutor",
+	MAP_FRAME_TIME: "ritning",
+	PLACE_AT: "Vid",
+	PLACE_FROM: "om",
+	TRACK_SIMPLIFY_FAILED: "Spåret kunde inte förenklas och exporteras oförenklat.",
+	POSITION_SOURCE_INVALID_URL: "Ogiltig adress. Ange en WebSocket-adress, t.ex. ws://localhost:2947.",
+	POSITION_SOURCE_TITLE: "Positionskälla",
 	HELP_URL: "https://sweref99.nu/om.html"
 } as const;
 
@@ -151,12 +209,44 @@ const SPEED_UNIT_ORDER: SpeedUnit[] = ['m/s', 'km/h', 'mph'];
  * LocalStorage key for speed unit preference
  */
 const SPEED_UNIT_STORAGE_KEY = 'sweref99-speed-unit';
+
+/**
+ * LocalStorage keys for the selected position source and bridge address
+ */
+const POSITION_SOURCE_STORAGE_KEY = 'sweref99-position-source';
+const POSITION_SOURCE_URL_STORAGE_KEY = 'sweref99-position-source-url';
+
+/**
+ * LocalStorage key for showing the filtered instead of the raw position
+ */
+const POSITION_FILTER_STORAGE_KEY = 'sweref99-position-filter';
+
+/**
+ * LocalStorage key for the stake-out target
+ */
+const STAKEOUT_TARGET_STORAGE_KEY = 'sweref99-stakeout-target';
+
+/**
+ * LocalStorage key for the map zoom level
+ */
+const MAP_ZOOM_STORAGE_KEY = 'sweref99-map-zoom';
+
+/**
+ * URL parameters that start a measured replay, e.g. ?replay=walking&speed=10
+ * replay is a synthetic trace name, "latest" for the latest recorded track,
+ * or a same-origin URL to a GPX, NMEA, gpsd JSON or CSV trace. speed=max
+ * replays as fast as possible.
+ */
+const REPLAY_PARAMETER = 'replay';
+const REPLAY_SPEED_PARAMETER = 'speed';
+
+/**
+ * Web Lock and BroadcastChannel name for the tab that owns the geolocation watch
+ */
+const POSITION_LEADER_LOCK = 'sweref99-position';
 const NON_BREAKING_SPACE = '\u00A0';
 const DECIMAL_SEPARATOR_PATTERN = /\./g;
 const SPEED_UNIT_PATTERN = /(m\/s|km\/h|mph)$/u;
-const WGS84_PROJECTION = 'EPSG:4326';
-const SWEREF99_PROJECTION = 'EPSG:3006';
-const SWEREF99_TM_PROJ_DEFINITION = '+proj=utm +zone=33 +ellps=GRS80 +towgs84=0,0,0,0,0,0,0 +units=m +no_defs +type=crs';
 
 // ============================================================================
 // UTILITY FUNCTIONS
@@ -179,18 +269,16 @@ function formatCoordinateValue(value: number): number | string {
 	return Number.isFinite(value) ? value : 'ogiltigt';
 }
 
-function isInSweden(pos: GeolocationPosition): boolean {
+/**
+ * Tests whether a position is on Swedish land or territorial waters
+ * Uses the precomputed territory grid, see sweden-territory.ts.
+ */
+function isInSweden(pos: GeolocationPosition, sweref: SwerefCoordinates): boolean {
 	const { latitude, longitude } = pos.coords;
 	if (!isValidLatitude(latitude) || !isValidLongitude(longitude)) {
 		return false;
 	}
-
-	return (
-		latitude >= SWEDEN_BOUNDS.MIN_LATITUDE &&
-		latitude <= SWEDEN_BOUNDS.MAX_LATITUDE &&
-		longitude >= SWEDEN_BOUNDS.MIN_LONGITUDE &&
-		longitude <= SWEDEN_BOUNDS.MAX_LONGITUDE
-	);
+	return isInSwedishTerritory(sweref.northing, sweref.easting);
 }
 
 /**
@@ -221,6 +309,46 @@ function formatWgs84Coordinate(prefix: 'N' | 'E', value: number): string {
 	return `${prefix}${NON_BREAKING_SPACE}${value.toString().replace(DECIMAL_SEPARATOR_PATTERN, ",")}°`;
 }
 
+/**
+ * Formats a length in metres, or in kilometres from 1 km
+ */
+function formatMeasurementLength(meters: number): string {
+	if (meters < 1000) {
+		return `${Math.round(meters)}${NON_BREAKING_SPACE}m`;
+	}
+	return `${(meters / 1000).toFixed(2).replace(DECIMAL_SEPARATOR_PATTERN, ",")}${NON_BREAKING_SPACE}km`;
+}
+
+/**
+ * Formats an area in square metres, or in hectares from 1 ha
+ */
+function formatMeasurementArea(squareMeters: number): string {
+	if (squareMeters < 10000) {
+		return `${Math.round(squareMeters)}${NON_BREAKING_SPACE}m²`;
+	}
+	return `${(squareMeters / 10000).toFixed(2).replace(DECIMAL_SEPARATOR_PATTERN, ",")}${NON_BREAKING_SPACE}ha`;
+}
+
+/**
+ * Formats a signed grid offset with decimetres below 100 m
+ */
+function formatStakeoutDelta(meters: number): string {
+	const magnitude = Math.abs(meters);
+	const value = magnitude < 100 ? magnitude.toFixed(1).replace(DECIMAL_SEPARATOR_PATTERN, ",") : `${Math.round(magnitude)}`;
+	// Minustecken (U+2212) som är lika brett som plustecknet
+	return `${meters < 0 && value !== '0,0' ? '\u2212' : '+'}${value}${NON_BREAKING_SPACE}m`;
+}
+
+/**
+ * Formats the distance to the target with decimetres below 10 m
+ */
+function formatStakeoutDistance(meters: number): string {
+	if (meters < 10) {
+		return `${meters.toFixed(1).replace(DECIMAL_SEPARATOR_PATTERN, ",")}${NON_BREAKING_SPACE}m`;
+	}
+	return formatMeasurementLength(meters);
+}
+
 function isShareSupported(): boolean {
 	return typeof navigator !== 'undefined' && typeof navigator.share === 'function';
 }
@@ -263,6 +391,17 @@ function setStoredItem(key: string, value: string): void {
 	}
 }
 
+function removeStoredItem(key: string): void {
+	try {
+		if (typeof localStorage === 'undefined') {
+			return;
+		}
+		localStorage.removeItem(key);
+	} catch (error) {
+		console.warn(`Failed to remove storage item ${key}:`, error);
+	}
+}
+
 function getSavedSpeedUnit(): SpeedUnit {
 	const saved = getStoredItem(SPEED_UNIT_STORAGE_KEY);
 	if (saved && SPEED_UNIT_ORDER.includes(saved as SpeedUnit)) {
@@ -316,52 +455,27 @@ function calculateItrf2Etrs89Correction(): Itrf2Etrs89Correction {
 
 // Beräkna korrigeringen en gång vid appstart
 const itrf2Etrs89Correction: Itrf2Etrs89Correction = calculateItrf2Etrs89Correction();
-let isSwerefProjectionDefined = false;
-
-/**
- * Ensures the SWEREF 99 projection definition is registered before transforms run.
- * @returns true when proj4 is ready to transform coordinates
- */
-function ensureSwerefProjection(): boolean {
-	if (typeof proj4 === 'undefined') {
-		console.warn("SWEREF 99 transformation not available - ensure proj4.js loads before script.js");
-		return false;
-	}
-
-	if (isSwerefProjectionDefined) {
-		return true;
-	}
-
-	try {
-		const definitionExists = proj4.defs(SWEREF99_PROJECTION);
-		if (!definitionExists) {
-			proj4.defs(SWEREF99_PROJECTION, SWEREF99_TM_PROJ_DEFINITION);
-		}
-
-		isSwerefProjectionDefined = true;
-		return true;
-	} catch (error) {
-		console.warn('SWEREF 99-projektion kunde inte registreras:', error);
-		return false;
-	}
-}
 
 /**
- * Transforms WGS84 coordinates to SWEREF 99 TM using PROJ4JS
+ * Transforms WGS84 coordinates to SWEREF 99 TM
  * 
  * SWEREF 99 TM (EPSG:3006) is the Swedish national coordinate reference system
  * based on ETRS89 at epoch 1999.5. It uses a Transverse Mercator projection
  * covering all of Sweden with a single zone (UTM zone 33, central meridian 15°E).
+ * The projection is Lantmäteriet's Gauss–Krüger series (see
+ * sweref-projection.ts), which also yields the grid factors without extra
+ * transforms.
  * 
  * @param lat - Latitude in WGS84 decimal degrees
  * @param lon - Longitude in WGS84 decimal degrees
+ * @param withGridFactors - Also return meridian convergence and point scale factor
  * @returns SWEREF 99 TM coordinates with ITRF/ETRS89 drift correction applied
  * 
  * @see SWEREF99-DEFINITION.md for complete verification and references
  * @see https://epsg.io/3006 - Official EPSG registry entry
  * @see https://www.lantmateriet.se - Lantmäteriet (Swedish mapping authority)
  */
-function wgs84_to_sweref99tm(lat: number, lon: number): SwerefCoordinates {
+function wgs84_to_sweref99tm(lat: number, lon: number, withGridFactors: boolean = false): SwerefProjection {
 	try {
 		if (!isValidLatitude(lat) || !isValidLongitude(lon)) {
 			const displayLatitude = formatCoordinateValue(lat);
@@ -370,56 +484,48 @@ function wgs84_to_sweref99tm(lat: number, lon: number): SwerefCoordinates {
 			return { northing: Number.NaN, easting: Number.NaN };
 		}
 
-		if (!ensureSwerefProjection()) {
-			return { northing: Number.NaN, easting: Number.NaN };
-		}
-
-		// WGS84 is built-in as 'EPSG:4326'
-		// 
-		// SWEREF 99 TM (EPSG:3006) PROJ Definition
-		// =========================================
-		// This definition has been verified against official sources:
-		// - EPSG Registry (https://epsg.io/3006)
-		// - Lantmäteriet official documentation
-		// - SpatialReference.org (https://spatialreference.org/ref/epsg/3006/)
-		// 
-		// Parameter breakdown:
-		// +proj=utm          : Universal Transverse Mercator projection
-		// +zone=33           : UTM zone 33 (central meridian 15°E, covers Sweden)
-		// +ellps=GRS80       : Geodetic Reference System 1980 ellipsoid
-		// +towgs84=0,0,0,... : Zero transformation (ETRS89 ≈ WGS84 at epoch level)
-		// +units=m           : Coordinates in meters
-		// +no_defs           : Don't use proj_def.dat defaults
-		// +type=crs          : Modern PROJ convention for CRS definition
-		// 
-		// See SWEREF99-DEFINITION.md for complete verification documentation
-		// Transform coordinates using proj4
-		// Input: [longitude, latitude] in WGS84 (EPSG:4326)
-		// Output: [easting, northing] in SWEREF 99 TM (EPSG:3006)
-		const result = proj4(WGS84_PROJECTION, SWEREF99_PROJECTION, [lon, lat]);
-
-		let easting: number = result[0];
-		let northing: number = result[1];
+		const result = projectToSweref99tm(lat, lon, withGridFactors);
 
 		// Applicera tidskorrigering för ITRF->ETRS89 drift
 		// Detta kompenserar för att WGS84 (ITRF-realisering) och SWEREF 99 (ETRS89)
 		// skiljer sig åt och att skillnaden ökar med tiden
-		northing += itrf2Etrs89Correction.dn;
-		easting += itrf2Etrs89Correction.de;
+		result.northing += itrf2Etrs89Correction.dn;
+		result.easting += itrf2Etrs89Correction.de;
 
 		// Validate the result
-		if (!Number.isFinite(northing) || !Number.isFinite(easting)) {
-			console.warn(`Invalid coordinate transformation result for lat=${lat}, lon=${lon}:`, { northing, easting });
+		if (!Number.isFinite(result.northing) || !Number.isFinite(result.easting)) {
+			console.warn(`Invalid coordinate transformation result for lat=${lat}, lon=${lon}:`, result);
 			return { northing: 0, easting: 0 };
 		}
 
-		return { northing, easting };
+		return result;
 	} catch (error) {
 		console.error("Error in coordinate transformation:", error);
 		return { northing: 0, easting: 0 };
 	}
 }
 
+/**
+ * Transforms SWEREF 99 TM coordinates back to WGS84
+ *
+ * Inverse of wgs84_to_sweref99tm: the ITRF/ETRS89 drift correction is removed
+ * before the inverse projection in sweref-projection.ts. Used for the filtered
+ * position and recorded tracks, which only store SWEREF 99 TM coordinates.
+ *
+ * @param northing - SWEREF 99 TM northing in meters
+ * @param easting - SWEREF 99 TM easting in meters
+ * @returns WGS84 coordinates, or NaN values for non-finite input
+ */
+function sweref99tm_to_wgs84(northing: number, easting: number): Wgs84Coordinates {
+	if (!Number.isFinite(northing) || !Number.isFinite(easting)) {
+		return { latitude: Number.NaN, longitude: Number.NaN };
+	}
+
+	const out = swerefProjectionScratch;
+	unprojectSweref99tmInto(northing - itrf2Etrs89Correction.dn, easting - itrf2Etrs89Correction.de, out);
+	return { latitude: out[0], longitude: out[1] };
+}
+
 // ============================================================================
 // DOM ELEMENTS AND UI REFERENCES
 // ============================================================================
@@ -433,6 +539,26 @@ const notificationContent = document.getElementById("notification-content") as H
 const notificationHeader = document.getElementById("notification-header") as HTMLElement | null;
 const notificationTitle = document.getElementById("notification-title") as HTMLElement | null;
 const notificationCountdown = document.getElementById("notification-countdown") as SVGCircleElement | null;
+const trackRecordToggle = document.getElementById("track-record") as HTMLInputElement | null;
+const trackFormatSelect = document.getElementById("track-format") as HTMLSelectElement | null;
+const trackGzipToggle = document.getElementById("track-gzip") as HTMLInputElement | null;
+const trackToleranceInput = document.getElementById("track-tolerance") as HTMLInputElement | null;
+const trackExportBtn = document.getElementById("track-export-btn") as HTMLButtonElement | null;
+const positionSourceSelect = document.getElementById("position-source") as HTMLSelectElement | null;
+const positionSourceUrlInput = document.getElementById("position-source-url") as HTMLInputElement | null;
+const positionFilterToggle = document.getElementById("position-filter") as HTMLInputElement | null;
+const measurementToggle = document.getElementById("measure-toggle") as HTMLInputElement | null;
+const measurementResetBtn = document.getElementById("measure-reset-btn") as HTMLButtonElement | null;
+const waypointNameInput = document.getElementById("waypoint-name") as HTMLInputElement | null;
+const waypointSaveBtn = document.getElementById("waypoint-save-btn") as HTMLButtonElement | null;
+const waypointImportInput = document.getElementById("waypoint-import") as HTMLInputElement | null;
+const waypointClearBtn = document.getElementById("waypoint-clear-btn") as HTMLButtonElement | null;
+const stakeoutTargetInput = document.getElementById("stakeout-target") as HTMLInputElement | null;
+const stakeoutWaypointList = document.getElementById("stakeout-waypoints") as HTMLDataListElement | null;
+const stakeoutSetBtn = document.getElementById("stakeout-set-btn") as HTMLButtonElement | null;
+const stakeoutClearBtn = document.getElementById("stakeout-clear-btn") as HTMLButtonElement | null;
+const geofenceImportInput = document.getElementById("geofence-import") as HTMLInputElement | null;
+const geofenceClearBtn = document.getElementById("geofence-clear-btn") as HTMLButtonElement | null;
 // Only one notification timer should be active at a time.
 let notificationTimeout: number | null = null;
 
@@ -545,6 +671,8 @@ class UIHelper {
 	private elements: {
 		uncert: HTMLElement | null;
 		speed: HTMLElement | null;
+		course: HTMLElement | null;
+		gridfactors: HTMLElement | null;
 		timestamp: HTMLElement | null;
 		swerefn: HTMLElement | null;
 		swerefe: HTMLElement | null;
@@ -553,13 +681,32 @@ class UIHelper {
 		posbtn: HTMLElement | null;
 		sharebtn: HTMLElement | null;
 		stopbtn: HTMLElement | null;
+		trackstatus: HTMLElement | null;
+		tracksimplify: HTMLElement | null;
+		trackexport: HTMLElement | null;
+		measurestatus: HTMLElement | null;
+		waypointnearest: HTMLElement | null;
+		waypointstatus: HTMLElement | null;
+		stakeoutstatus: HTMLElement | null;
+		geofenceinside: HTMLElement | null;
+		geofencestatus: HTMLElement | null;
+		adminarea: HTMLElement | null;
+		mapsheet: HTMLElement | null;
+		placename: HTMLElement | null;
+		mapstatus: HTMLElement | null;
+		trackplotstatus: HTMLElement | null;
+		qualitystatus: HTMLElement | null;
+		fixliststatus: HTMLElement | null;
 	};
 	private currentSpeedUnit: SpeedUnit;
+	private isSpeedDerived: boolean = false;
 
 	constructor() {
 		this.elements = {
 			uncert: document.getElementById("uncert"),
 			speed: document.getElementById("speed"),
+			course: document.getElementById("course"),
+			gridfactors: document.getElementById("grid-factors"),
 			timestamp: document.getElementById("timestamp"),
 			swerefn: document.getElementById("sweref-n"),
 			swerefe: document.getElementById("sweref-e"),
@@ -567,7 +714,23 @@ class UIHelper {
 			wgs84e: document.getElementById("wgs84-e"),
 			posbtn: document.getElementById("pos-btn"),
 			sharebtn: document.getElementById("share-btn"),
-			stopbtn: document.getElementById("stop-btn")
+			stopbtn: document.getElementById("stop-btn"),
+			trackstatus: document.getElementById("track-status"),
+			tracksimplify: document.getElementById("track-simplify-status"),
+			trackexport: document.getElementById("track-export-status"),
+			measurestatus: document.getElementById("measure-status"),
+			waypointnearest: document.getElementById("waypoint-nearest"),
+			waypointstatus: document.getElementById("waypoint-status"),
+			stakeoutstatus: document.getElementById("stakeout-status"),
+			geofenceinside: document.getElementById("geofence-inside"),
+			geofencestatus: document.getElementById("geofence-status"),
+			adminarea: document.getElementById("admin-area"),
+			mapsheet: document.getElementById("map-sheet"),
+			placename: document.getElementById("place-name"),
+			mapstatus: document.getElementById("map-status"),
+			trackplotstatus: document.getElementById("track-plot-status"),
+			qualitystatus: document.getElementById("quality-status"),
+			fixliststatus: document.getElementById("fix-list-status")
 		};
 		this.currentSpeedUnit = getSavedSpeedUnit();
 	}
@@ -589,15 +752,17 @@ class UIHelper {
 
 	/**
 	 * Updates the speed display and applies styling based on threshold
+	 * @param isDerived - Speed was computed from positions, not reported by the device
 	 */
-	updateSpeed(speed: number | null, threshold: number): void {
+	updateSpeed(speed: number | null, threshold: number, isDerived: boolean = false): void {
 		const { speed: speedEl } = this.elements;
 		if (!speedEl) return;
 
+		this.isSpeedDerived = isDerived;
 		if (speed !== null) {
 			const convertedSpeed = convertSpeed(speed, this.currentSpeedUnit);
 			const speedValue = Math.round(convertedSpeed);
-			setElementText(speedEl, formatValueWithUnit(speedValue, this.currentSpeedUnit));
+			setElementText(speedEl, formatValueWithUnit(isDerived ? `≈${speedValue}` : speedValue, this.currentSpeedUnit));
 		} else {
 			setElementText(speedEl, formatValueWithUnit('?', this.currentSpeedUnit));
 		}
@@ -615,7 +780,7 @@ class UIHelper {
 	cycleSpeedUnit(speed: number | null, threshold: number): void {
 		this.currentSpeedUnit = getNextSpeedUnit(this.currentSpeedUnit);
 		saveSpeedUnit(this.currentSpeedUnit);
-		this.updateSpeed(speed, threshold);
+		this.updateSpeed(speed, threshold, this.isSpeedDerived);
 	}
 
 	/**
@@ -625,6 +790,28 @@ class UIHelper {
 		return this.currentSpeedUnit;
 	}
 
+	/**
+	 * Updates the course display, in whole degrees from true north
+	 */
+	updateCourse(course: number | null): void {
+		const { course: courseEl } = this.elements;
+		if (!courseEl) return;
+
+		setElementText(courseEl, course !== null ? `${Math.round(course) % 360}°` : '–°');
+	}
+
+	/**
+	 * Updates meridian convergence (degrees) and point scale factor at the position
+	 */
+	updateGridFactors(convergence: number | null, scaleFactor: number | null): void {
+		const { gridfactors } = this.elements;
+		if (!gridfactors) return;
+
+		const convergenceText = convergence !== null ? convergence.toFixed(2).replace(DECIMAL_SEPARATOR_PATTERN, ",") : '–';
+		const scaleText = scaleFactor !== null ? scaleFactor.toFixed(6).replace(DECIMAL_SEPARATOR_PATTERN, ",") : '–';
+		setElementText(gridfactors, `γ${NON_BREAKING_SPACE}${convergenceText}° k${NON_BREAKING_SPACE}${scaleText}`);
+	}
+
 	/**
 	 * Updates the timestamp display
 	 */
@@ -655,6 +842,134 @@ class UIHelper {
 		setElementText(wgs84e, formatWgs84Coordinate('E', lon));
 	}
 
+	/**
+	 * Updates the number of recorded track fixes
+	 */
+	updateTrackStatus(fixCount: number): void {
+		setElementText(this.elements.trackstatus, `${fixCount}${NON_BREAKING_SPACE}${UI_TEXT.TRACK_FIXES_SUFFIX}`);
+	}
+
+	/**
+	 * Shows the outcome of the latest track simplification
+	 */
+	updateSimplifyStatus(stats: TrackSimplifyStats): void {
+		setElementText(
+			this.elements.tracksimplify,
+			`Förenklat: ${stats.removedCount} av ${stats.inputCount} punkter borttagna på ${Math.round(stats.durationMs)}${NON_BREAKING_SPACE}ms`
+		);
+	}
+
+	/**
+	 * Shows size and speed of the latest FlatGeobuf export
+	 */
+	updateExportStatus(stats: FlatGeobufStats): void {
+		setElementText(this.elements.trackexport, formatFlatGeobufStatus(stats));
+	}
+
+	/**
+	 * Shows running distance, perimeter and area
+	 */
+	updateMeasurement(totals: MeasurementTotals): void {
+		setElementText(
+			this.elements.measurestatus,
+			`${UI_TEXT.MEASUREMENT_DISTANCE} ${formatMeasurementLength(totals.distance)}\n` +
+			`${UI_TEXT.MEASUREMENT_PERIMETER} ${formatMeasurementLength(totals.perimeter)}\n` +
+			`${UI_TEXT.MEASUREMENT_AREA} ${formatMeasurementArea(totals.area)}`
+		);
+	}
+
+	/**
+	 * Shows the nearest stored waypoints with ground distance and bearing from true north
+	 */
+	updateNearestWaypoints(neighbors: { name: string; distance: number; bearing: number }[]): void {
+		// Riktningen saknar mening när man står på punkten
+		const lines = neighbors.map((neighbor) => neighbor.distance < 1
+			? `${neighbor.name} ${formatMeasurementLength(neighbor.distance)}`
+			: `${neighbor.name} ${formatMeasurementLength(neighbor.distance)} ${Math.round(neighbor.bearing) % 360}°`
+		);
+		setElementText(this.elements.waypointnearest, lines.length > 0 ? lines.join('\n') : UI_TEXT.WAYPOINT_NONE);
+	}
+
+	updateWaypointStatus(text: string): void {
+		setElementText(this.elements.waypointstatus, text);
+	}
+
+	/**
+	 * Shows the target and, once there is a position, the offsets to it
+	 */
+	updateStakeout(target: StakeoutTarget | null, offset: StakeoutOffset | null): void {
+		if (target === null) {
+			setElementText(this.elements.stakeoutstatus, UI_TEXT.STAKEOUT_NONE);
+			return;
+		}
+
+		const targetText = target.name ?? `${formatProjectedCoordinate('N', target.northing, 1)} ${formatProjectedCoordinate('E', target.easting, 1)}`;
+		let text = `${UI_TEXT.STAKEOUT_TARGET} ${targetText}`;
+		if (offset !== null) {
+			text += `\nΔN ${formatStakeoutDelta(offset.deltaNorth)} ΔE ${formatStakeoutDelta(offset.deltaEast)}` +
+				`\n${UI_TEXT.STAKEOUT_DISTANCE} ${formatStakeoutDistance(offset.distance)}` +
+				`\n${UI_TEXT.STAKEOUT_BEARING} ${Math.round(offset.gridBearing) % 360}°`;
+		}
+		setElementText(this.elements.stakeoutstatus, text);
+	}
+
+	/**
+	 * Lists the areas the position is inside
+	 */
+	updateGeofenceInside(names: string[]): void {
+		setElementText(
+			this.elements.geofenceinside,
+			names.length > 0 ? `${UI_TEXT.GEOFENCE_ENTERED} ${names.join(', ')}` : UI_TEXT.GEOFENCE_OUTSIDE
+		);
+	}
+
+	updateGeofenceStatus(text: string): void {
+		setElementText(this.elements.geofencestatus, text);
+	}
+
+	/**
+	 * Shows the municipality and county of the position
+	 * The line stays hidden until municipality boundaries have been loaded.
+	 */
+	updateAdminArea(area: AdminArea | null): void {
+		const { adminarea } = this.elements;
+		if (!adminarea) return;
+
+		adminarea.removeAttribute("hidden");
+		setElementText(adminarea, area !== null ? formatAdminArea(area) : UI_TEXT.ADMIN_AREA_OUTSIDE);
+	}
+
+	updateMapSheet(text: string): void {
+		setElementText(this.elements.mapsheet, text);
+	}
+
+	updateMapStatus(text: string): void {
+		setElementText(this.elements.mapstatus, text);
+	}
+
+	updateTrackPlotStatus(text: string): void {
+		setElementText(this.elements.trackplotstatus, text);
+	}
+
+	updateQualityStatus(text: string): void {
+		setElementText(this.elements.qualitystatus, text);
+	}
+
+	updateFixListStatus(text: string): void {
+		setElementText(this.elements.fixliststatus, text);
+	}
+
+	/**
+	 * Shows the nearest place name, or hides the line when none is near
+	 */
+	updateNearestPlace(text: string | null): void {
+		const { placename } = this.elements;
+		if (!placename) return;
+
+		placename.hidden = text === null;
+		setElementText(placename, text ?? '');
+	}
+
 	/**
 	 * Sets loading state (shows/hides spinner)
 	 */
@@ -713,6 +1028,7 @@ class UIHelper {
 
 		setElementText(speed, formatValueWithUnit('–', this.currentSpeedUnit));
 		speed.classList.remove("outofrange");
+		this.updateCourse(null);
 	}
 
 	/**
@@ -739,7 +1055,8 @@ class UIHelper {
 		const eText = swerefe?.textContent ?? '';
 		// Remove the extra space after "E" that's used for alignment
 		const eTextNormalized = eText.replace(/^E[\s\u00A0]{2}/u, 'E ');
-		return `${nText} ${eTextNormalized} (SWEREF 99 TM)`;
+		const areaText = currentAdminArea ? `, ${formatAdminArea(currentAdminArea)}` : '';
+		return `${nText} ${eTextNormalized} (SWEREF 99 TM)${areaText}`;
 	}
 
 	/**
@@ -760,6 +1077,7 @@ class UIHelper {
 }
 
 const uiHelper = new UIHelper();
+const trackRecorder = new TrackRecorder();
 
 // ============================================================================
 // GEOLOCATION STATE MANAGEMENT
@@ -769,6 +1087,31 @@ let watchID: number | null = null;
 let spinnerTimeout: number | null = null;
 let hasReceivedPosition: boolean = false;
 let currentSpeed: number | null = null;
+let lastPositionFix: PositionFix | null = null;
+let watchErrorHandler: PositionErrorCallback = handlePositionError;
+let positionSourceUrl: string = getSavedGnssWebSocketUrl();
+let positionSource: PositionSource = createPositionSource(getSavedPositionSourceKind(), positionSourceUrl);
+let isPositionFilterEnabled: boolean = getStoredItem(POSITION_FILTER_STORAGE_KEY) === 'true';
+const positionFilter = new SwerefKalmanFilter();
+const motionEstimator = new SwerefMotionEstimator();
+const measurement = new SwerefMeasurement();
+
+/**
+ * Only the leader tab watches the position; followers render its fixes
+ * Null when Web Locks or BroadcastChannel are unavailable, in which case
+ * every tab watches on its own as before.
+ */
+const positionLeader: TabLeaderElection<PositionFix> | null = isTabLeaderElectionSupported()
+	? new TabLeaderElection<PositionFix>(POSITION_LEADER_LOCK, {
+		onLeader: () => startGeolocationWatch(watchErrorHandler),
+		onMessage: showLeaderPositionFix,
+		onFollowerJoined: () => {
+			if (lastPositionFix !== null) {
+				positionLeader?.broadcast(lastPositionFix);
+			}
+		}
+	})
+	: null;
 
 /**
  * Clears the spinner timeout if it exists
@@ -798,7 +1141,7 @@ function startGeolocationWatch(onError: PositionErrorCallback): void {
 		return;
 	}
 
-	watchID = navigator.geolocation.watchPosition(
+	watchID = positionSource.watchPosition(
 		handlePositionSuccess,
 		onError,
 		GEOLOCATION_OPTIONS
@@ -807,13 +1150,41 @@ function startGeolocationWatch(onError: PositionErrorCallback): void {
 }
 
 /**
- * Clears geolocation watch and resets state
+ * Starts positioning in this tab, as leader or as follower of another tab
  */
-function stopGeolocationWatch(): void {
+function requestPositioning(onError: PositionErrorCallback): void {
+	watchErrorHandler = onError;
+	if (positionLeader === null) {
+		startGeolocationWatch(onError);
+		return;
+	}
+	positionLeader.join();
+	startSpinnerTimeout();
+}
+
+/**
+ * Checks if this tab is positioning, either with its own watch or as follower
+ */
+function isPositioningRequested(): boolean {
+	return watchID !== null || positionLeader?.isJoined() === true;
+}
+
+function clearGeolocationWatch(): void {
 	if (watchID !== null) {
-		navigator.geolocation.clearWatch(watchID);
+		positionSource.clearWatch(watchID);
 		watchID = null;
 	}
+}
+
+/**
+ * Clears geolocation watch and resets state
+ */
+function stopGeolocationWatch(): void {
+	positionLeader?.leave();
+	clearGeolocationWatch();
+	lastPositionFix = null;
+	positionFilter.reset();
+	motionEstimator.reset();
 	clearSpinnerTimeout();
 	uiHelper.setLoadingState(false);
 }
@@ -830,25 +1201,115 @@ function handlePositionSuccess(position: GeolocationPosition): void {
 	if (watchID === null) {
 		return;
 	}
-	
+
+	const fix = createPositionFix(position);
+	lastPositionFix = fix;
+	positionLeader?.broadcast(fix);
+	showPositionFix(fix);
+	actOnPositionFix(fix);
+}
+
+/**
+ * Renders a fix broadcast by the leader tab
+ * Followers only render; the leader notifies, checks geofences and records.
+ */
+function showLeaderPositionFix(fix: PositionFix): void {
+	lastPositionFix = fix;
+	showPositionFix(fix);
+}
+
+/**
+ * Transforms a Geolocation API position into a position fix
+ */
+function createPositionFix(position: GeolocationPosition): PositionFix {
+	const { latitude, longitude, accuracy, speed, heading } = position.coords;
+	const sweref = wgs84_to_sweref99tm(latitude, longitude, true);
+	let filtered: FilteredPosition | null = null;
+	let motion: MotionEstimate | null = null;
+	if (Number.isFinite(sweref.northing) && Number.isFinite(sweref.easting)) {
+		// Positioner i fel ordning ger ingen ny skattning; behåll den förra
+		filtered = positionFilter.update(position.timestamp, sweref.northing, sweref.easting, accuracy)
+			?? lastPositionFix?.filtered ?? null;
+		motion = motionEstimator.update(position.timestamp, sweref.northing, sweref.easting, accuracy, sweref.convergence ?? 0, sweref.scaleFactor ?? SWEREF_CENTRAL_SCALE_FACTOR)
+			?? lastPositionFix?.motion ?? null;
+	}
+	return {
+		timestamp: position.timestamp,
+		latitude,
+		longitude,
+		accuracy,
+		speed,
+		// Kursen är NaN när enheten står still
+		heading: heading !== null && Number.isFinite(heading) ? heading : null,
+		sweref,
+		inSweden: isInSweden(position, sweref),
+		filtered,
+		motion
+	};
+}
+
+/**
+ * Position the display follows: the filtered one when the filter is on
+ */
+function getDisplayedPosition(fix: PositionFix): SwerefCoordinates {
+	return isPositionFilterEnabled && fix.filtered !== null ? fix.filtered : fix.sweref;
+}
+
+/**
+ * Renders a position fix from this tab's watch or from the leader tab
+ * Only updates this tab's display and per-tab state, so that it can run in
+ * every tab.
+ */
+function showPositionFix(fix: PositionFix): void {
 	clearSpinnerTimeout();
 	uiHelper.setLoadingState(false);
-	
-	if (!isInSweden(position)) {
-		showNotification(UI_TEXT.WARNING_NOT_IN_SWEDEN, NOTIFICATION_DURATION.DEFAULT, UI_TEXT.WARNING_NOT_IN_SWEDEN_TITLE);
-	}
-	
-	uiHelper.updateAccuracy(position.coords.accuracy, ACCURACY_THRESHOLD_METERS);
-	currentSpeed = position.coords.speed;
-	uiHelper.updateSpeed(currentSpeed, SPEED_THRESHOLD_MS);
-	uiHelper.updateTimestamp(position.timestamp);
 
-	const sweref = wgs84_to_sweref99tm(position.coords.latitude, position.coords.longitude);
-	uiHelper.updateCoordinates(sweref, position.coords.latitude, position.coords.longitude);
+	let isSpeedDerived = false;
+	if (isPositionFilterEnabled && fix.filtered !== null) {
+		const { filtered } = fix;
+		const wgs84 = sweref99tm_to_wgs84(filtered.northing, filtered.easting);
+		uiHelper.updateAccuracy(filtered.sigma / GEOLOCATION_ACCURACY_TO_SIGMA, ACCURACY_THRESHOLD_METERS);
+		currentSpeed = Math.hypot(filtered.velocityNorth, filtered.velocityEast);
+		uiHelper.updateCoordinates(filtered, wgs84.latitude, wgs84.longitude);
+	} else {
+		uiHelper.updateAccuracy(fix.accuracy, ACCURACY_THRESHOLD_METERS);
+		// Enhetens egen fart används i första hand
+		currentSpeed = fix.speed ?? fix.motion?.speed ?? null;
+		isSpeedDerived = fix.speed === null && currentSpeed !== null;
+		uiHelper.updateCoordinates(fix.sweref, fix.latitude, fix.longitude);
+	}
+	uiHelper.updateSpeed(currentSpeed, SPEED_THRESHOLD_MS, isSpeedDerived);
+	uiHelper.updateCourse(fix.heading ?? fix.motion?.course ?? null);
+	uiHelper.updateGridFactors(fix.sweref.convergence ?? null, fix.sweref.scaleFactor ?? null);
+	uiHelper.updateTimestamp(fix.timestamp);
+	measureFix(fix);
+	showNearestWaypoints(fix);
+	// Utsättningen följer den visade positionen, filtrerad eller inte
+	const displayed = getDisplayedPosition(fix);
+	const displayedAccuracy = isPositionFilterEnabled && fix.filtered !== null ? fix.filtered.sigma / GEOLOCATION_ACCURACY_TO_SIGMA : fix.accuracy;
+	updateStakeoutPosition(displayed.northing, displayed.easting, fix.sweref.scaleFactor ?? SWEREF_CENTRAL_SCALE_FACTOR);
+	showAdminArea(displayed.northing, displayed.easting);
+	showMapSheet(displayed.northing, displayed.easting);
+	updateMapPosition(displayed.northing, displayed.easting, displayedAccuracy, fix.heading ?? fix.motion?.course ?? null, currentSpeed, fix.sweref.convergence ?? 0);
+	showNearestPlace(displayed.northing, displayed.easting, fix.sweref.scaleFactor ?? SWEREF_CENTRAL_SCALE_FACTOR, fix.sweref.convergence ?? 0);
 	hasReceivedPosition = true;
 	uiHelper.setButtonState('active');
 }
 
+/**
+ * Notifies, checks geofences and records a fix from this tab's own watch
+ * Runs only in the tab that watches the position, so that N open tabs give
+ * one notification and one recorded track rather than N.
+ */
+function actOnPositionFix(fix: PositionFix): void {
+	if (!fix.inSweden) {
+		showNotification(UI_TEXT.WARNING_NOT_IN_SWEDEN, NOTIFICATION_DURATION.DEFAULT, UI_TEXT.WARNING_NOT_IN_SWEDEN_TITLE);
+	}
+	const displayed = getDisplayedPosition(fix);
+	checkGeofences(displayed.northing, displayed.easting);
+	recordTrackFix(fix);
+}
+
 /**
  * Position error handler
  * Called when geolocation fails (user denied permission or technical error)
@@ -882,22 +1343,27 @@ function posInit(event: Event): void {
 
 	// Handle restore events differently - test geolocation availability first
 	if (event.type === "restore") {
-		if (!("geolocation" in navigator)) {
+		if (!positionSource.isSupported()) {
 			handlePositionRestoreError();
 			return;
 		}
+		// Externa källor har ingen behörighetsdialog att testa
+		if (positionSource.kind !== 'browser') {
+			requestPositioning(handlePositionRestoreError);
+			return;
+		}
 		// Test geolocation with a quick position request before starting watch
 		navigator.geolocation.getCurrentPosition(
 			() => {
 				// Geolocation is available, proceed with watch
-				startGeolocationWatch(handlePositionRestoreError);
+				requestPositioning(handlePositionRestoreError);
 			},
 			handlePositionRestoreError,
 			GEOLOCATION_TEST_OPTIONS
 		);
 	} else {
 		// Regular positioning start
-		startGeolocationWatch(handlePositionError);
+		requestPositioning(handlePositionError);
 	}
 }
 
@@ -909,6 +1375,17 @@ function posInit(event: Event): void {
  * Handle page visibility changes and back navigation to restore positioning state
  */
 function handleVisibilityChange(): void {
+	// Spara buffrade spårpunkter innan sidan eventuellt stängs
+	if (document.hidden) {
+		void trackRecorder.flush();
+		// Dolda flikar får ofta inga positioner, så låt en väntande flik ta över
+		void positionLeader?.yieldToWaitingTab().then((yielded) => {
+			if (yielded) {
+				clearGeolocationWatch();
+			}
+		});
+	}
+
 	// Only restore if page becomes visible and UI indicates positioning should be active
 	if (!document.hidden && uiHelper.isUIInconsistent()) {
 		// UI state is inconsistent - reset to stopped state
@@ -916,8 +1393,8 @@ function handleVisibilityChange(): void {
 		stopGeolocationWatch();
 		uiHelper.resetUI();
 	} else if (!document.hidden && uiHelper.isPositioningUIActive()) {
-		// UI indicates positioning should be active, check if watchID is valid
-		if (watchID === null) {
+		// UI indicates positioning should be active, check if the watch or leader follow is valid
+		if (!isPositioningRequested()) {
 			console.log("Positioning was active but watch was lost, restarting...");
 			posInit(new Event("restore"));
 		}
@@ -925,103 +1402,1727 @@ function handleVisibilityChange(): void {
 }
 
 // ============================================================================
-// DETAILS STATE PERSISTENCE
+// POSITION SOURCE SETTINGS
 // ============================================================================
 
+function getSavedPositionSourceKind(): PositionSourceKind {
+	const saved = getStoredItem(POSITION_SOURCE_STORAGE_KEY) ?? '';
+	return isPositionSourceKind(saved) ? saved : 'browser';
+}
+
+function getSavedGnssWebSocketUrl(): string {
+	return getStoredItem(POSITION_SOURCE_URL_STORAGE_KEY) ?? DEFAULT_GNSS_WEBSOCKET_URL;
+}
+
 /**
- * LocalStorage key for storing details state
+ * Switches position source from the settings, restarting an active watch
  */
-const DETAILS_STATE_STORAGE_KEY = 'sweref99-details-state';
+function handlePositionSourceChange(): void {
+	const selected = positionSourceSelect?.value ?? '';
+	const kind: PositionSourceKind = isPositionSourceKind(selected) ? selected : 'browser';
+	const url = positionSourceUrlInput?.value.trim() ?? DEFAULT_GNSS_WEBSOCKET_URL;
+	const isUrlValid = isValidGnssWebSocketUrl(url);
+
+	positionSourceUrlInput?.setAttribute("aria-invalid", String(kind === 'gnss-websocket' && !isUrlValid));
+	if (kind === 'gnss-websocket' && !isUrlValid) {
+		showNotification(UI_TEXT.POSITION_SOURCE_INVALID_URL, NOTIFICATION_DURATION.ERROR, UI_TEXT.POSITION_SOURCE_TITLE);
+		return;
+	}
+
+	setStoredItem(POSITION_SOURCE_STORAGE_KEY, kind);
+	setStoredItem(POSITION_SOURCE_URL_STORAGE_KEY, url);
+	switchPositionSource(kind, url);
+}
 
 /**
- * Maximum number of details elements to track (as per requirements)
+ * Replaces the position source, restarting the watch if this tab has one
  */
-const MAX_DETAILS_TO_TRACK = 3;
+function switchPositionSource(kind: PositionSourceKind, url: string): void {
+	const wasWatching = watchID !== null;
+	clearGeolocationWatch();
+	positionFilter.reset();
+	motionEstimator.reset();
+	positionSource = createPositionSource(kind, url);
+	positionSourceUrl = url;
+	if (wasWatching) {
+		startGeolocationWatch(watchErrorHandler);
+	}
+	if (positionSource.isSupported() && !isPositioningRequested()) {
+		posbtn?.removeAttribute("disabled");
+	}
+}
 
 /**
- * Interface for details state data
+ * Applies a position source chosen in another tab
+ * Only the leader watches, so a choice made in a follower would otherwise
+ * not take effect until the leader tab is closed.
  */
-interface DetailsState {
-	[id: string]: boolean;
+function handlePositionSourceStorage(event: StorageEvent): void {
+	if (event.key !== POSITION_SOURCE_STORAGE_KEY && event.key !== POSITION_SOURCE_URL_STORAGE_KEY) {
+		return;
+	}
+	const kind = getSavedPositionSourceKind();
+	const url = getSavedGnssWebSocketUrl();
+	if (positionSourceSelect) {
+		positionSourceSelect.value = kind;
+	}
+	if (positionSourceUrlInput) {
+		positionSourceUrlInput.value = url;
+	}
+	// Källan och adressen sparas var för sig och ger två händelser
+	if (kind !== positionSource.kind || url !== positionSourceUrl) {
+		switchPositionSource(kind, url);
+	}
+}
+
+function handlePositionFilterToggle(): void {
+	isPositionFilterEnabled = positionFilterToggle?.checked === true;
+	setStoredItem(POSITION_FILTER_STORAGE_KEY, String(isPositionFilterEnabled));
+}
+
+function initializePositionSourceControls(): void {
+	if (positionSourceSelect) {
+		positionSourceSelect.value = positionSource.kind;
+	}
+	if (positionSourceUrlInput) {
+		positionSourceUrlInput.value = getSavedGnssWebSocketUrl();
+	}
+	positionSourceSelect?.addEventListener("change", handlePositionSourceChange);
+	positionSourceUrlInput?.addEventListener("change", handlePositionSourceChange);
+	window.addEventListener("storage", handlePositionSourceStorage);
+	if (positionFilterToggle) {
+		positionFilterToggle.checked = isPositionFilterEnabled;
+	}
+	positionFilterToggle?.addEventListener("change", handlePositionFilterToggle);
 }
 
+// ============================================================================
+// TRACE REPLAY
+// ============================================================================
+
 /**
- * Save the open state of all tracked details elements to localStorage
+ * Reads the latest recorded track as a replay trace
+ */
+async function loadLatestTrackTrace(): Promise<ReplayTrace> {
+	const db = await openTrackDatabase();
+	const track = await getLatestTrack(db);
+	const fixes: GnssFix[] = [];
+	for (let seq = 0; track !== null && seq < track.chunkCount; seq++) {
+		const columns = await readTrackChunk(db, track.id, seq);
+		for (let i = 0; columns !== null && i < columns.count; i++) {
+			const wgs84 = sweref99tm_to_wgs84(columns.northing[i], columns.easting[i]);
+			const speed = columns.speed[i];
+			fixes.push({
+				timestamp: columns.timestamp[i],
+				latitude: wgs84.latitude,
+				longitude: wgs84.longitude,
+				accuracy: columns.accuracy[i],
+				altitude: null,
+				speed: Number.isNaN(speed) ? null : speed,
+				heading: null
+			});
+		}
+	}
+	return { name: 'latest', fixes };
+}
+
+async function loadReplayTrace(name: string): Promise<ReplayTrace> {
+	if (isSyntheticTraceKind(name)) {
+		return createSyntheticTrace(name);
+	}
+	if (name === 'latest') {
+		return loadLatestTrackTrace();
+	}
+	const response = await fetch(name);
+	if (!response.ok) {
+		throw new Error(`HTTP ${response.status}`);
+	}
+	return parseReplayTrace(name, await response.text());
+}
+
+/**
+ * Replays a trace through the position pipeline when requested in the URL
+ * and logs the measurements for the trace.
+ */
+async function startReplayFromUrl(): Promise<void> {
+	const params = new URLSearchParams(window.location.search);
+	const name = params.get(REPLAY_PARAMETER);
+	if (name === null) {
+		return;
+	}
+	const speedParameter = params.get(REPLAY_SPEED_PARAMETER) ?? '1';
+	const speedFactor = speedParameter === 'max' ? Number.POSITIVE_INFINITY : Number.parseFloat(speedParameter);
+
+	try {
+		const trace = await loadReplayTrace(name);
+		const source = new ReplayPositionSource(trace, speedFactor > 0 ? speedFactor : 1);
+		if (!source.isSupported()) {
+			throw new Error('Spåret innehåller inga positioner');
+		}
+		stopGeolocationWatch();
+		positionSource = source;
+		const report = measureReplay(source, document.body);
+		hasReceivedPosition = false;
+		startGeolocationWatch(handlePositionError);
+		console.log('Uppspelning klar:', JSON.stringify(await report, null, 2));
+		if (mapView !== null && detailsMap?.open) {
+			console.log('Kartans ritning (ms):', JSON.stringify(mapView.frameStats()));
+		}
+	} catch (error) {
+		console.warn('Kunde inte spela upp spår:', error);
+	}
+}
+
+// ============================================================================
+// DETAILS STATE PERSISTENCE
+// ============================================================================
+
+/**
+ * LocalStorage key for storing details state
+ */
+const DETAILS_STATE_STORAGE_KEY = 'sweref99-details-state';
+
+/**
+ * Maximum number of details elements to track (as per requirements)
+ */
+const MAX_DETAILS_TO_TRACK = 3;
+
+/**
+ * Interface for details state data
+ */
+interface DetailsState {
+	[id: string]: boolean;
+}
+
+/**
+ * Save the open state of all tracked details elements to localStorage
  * 
  * This function reads the current open state of up to three <details> elements
  * and stores them in localStorage for persistence across page loads.
  */
-function saveDetailsState(): void {
+function saveDetailsState(): void {
+	try {
+		// Find all details elements with IDs
+		const detailsElements = document.querySelectorAll('details[id]');
+		const state: DetailsState = {};
+		
+		// Track up to MAX_DETAILS_TO_TRACK elements
+		let count = 0;
+		detailsElements.forEach((element) => {
+			if (count >= MAX_DETAILS_TO_TRACK) {
+				return;
+			}
+			
+			const detailsElement = element as HTMLDetailsElement;
+			if (detailsElement.id) {
+				state[detailsElement.id] = detailsElement.open;
+				count++;
+			}
+		});
+
+		setStoredItem(DETAILS_STATE_STORAGE_KEY, JSON.stringify(state));
+	} catch (error) {
+		// Silently fail if localStorage is not available or quota exceeded
+		console.warn('Failed to save details state:', error);
+	}
+}
+
+/**
+ * Restore the open state of all tracked details elements from localStorage
+ * 
+ * This function reads the saved state from localStorage and applies it to
+ * the <details> elements on the page. Called on page load.
+ */
+function restoreDetailsState(): void {
+	try {
+		const savedStateJson = getStoredItem(DETAILS_STATE_STORAGE_KEY);
+		if (!savedStateJson) {
+			return;
+		}
+
+		const savedState: DetailsState = JSON.parse(savedStateJson);
+
+		// Apply saved state to details elements
+		Object.keys(savedState).forEach((id) => {
+			const element = document.getElementById(id);
+			if (element && element.tagName === 'DETAILS') {
+				const detailsElement = element as HTMLDetailsElement;
+				detailsElement.open = savedState[id];
+			}
+		});
+	} catch (error) {
+		// Silently fail if localStorage is not available or data is corrupted
+		console.warn('Failed to restore details state:', error);
+	}
+}
+
+/**
+ * Initialize details state persistence
+ * 
+ * Sets up event listeners on all <details> elements to save their state
+ * when they are opened or closed.
+ */
+function initializeDetailsStatePersistence(): void {
+	// Restore state on page load
+	restoreDetailsState();
+
+	// Add event listeners to all details elements
+	const detailsElements = document.querySelectorAll('details[id]');
+	detailsElements.forEach((element) => {
+		element.addEventListener('toggle', saveDetailsState);
+	});
+}
+
+// ============================================================================
+// TRACK RECORDING AND EXPORT
+// ============================================================================
+
+/**
+ * Appends a processed fix to the current track if recording is active
+ */
+function recordTrackFix(fix: PositionFix): void {
+	const { sweref } = fix;
+	if (!trackRecorder.isRecording()) {
+		return;
+	}
+
+	const trackFix: TrackFix = {
+		timestamp: fix.timestamp,
+		northing: sweref.northing,
+		easting: sweref.easting,
+		accuracy: fix.accuracy,
+		speed: fix.speed
+	};
+	if (!trackRecorder.append(trackFix)) {
+		return;
+	}
+	uiHelper.updateTrackStatus(trackRecorder.getFixCount());
+	plotTrackFix(sweref.northing, sweref.easting);
+	chartTrackFix(trackFix);
+	listTrackFix(trackFix);
+}
+
+function handleTrackRecordToggle(): void {
+	if (trackRecordToggle?.checked) {
+		trackRecorder.start(Date.now());
+		uiHelper.updateTrackStatus(0);
+		reloadTrackViews();
+	} else {
+		void trackRecorder.stop();
+	}
+}
+
+/**
+ * Reloads the open track views after the current track has changed
+ */
+function reloadTrackViews(): void {
+	if (trackPlotActive) {
+		void loadTrackPlot();
+	}
+	if (qualityChartActive) {
+		void loadQualityChart();
+	}
+	if (fixListActive) {
+		void loadFixList();
+	}
+}
+
+/**
+ * Reads the track being recorded, or else the latest track, chunk by chunk
+ * Fixes recorded while reading are not in the chunks; callers hold them
+ * back and add them afterwards.
+ * @param isCurrent - Reading stops when this returns false
+ * @returns Whether the read finished while still current
+ */
+async function readCurrentTrack(isCurrent: () => boolean, onChunk: (columns: TrackColumns) => void): Promise<boolean> {
+	try {
+		await trackRecorder.flush();
+		const recording = trackRecorder.isRecording() ? trackRecorder.getTrack() : null;
+		// Antalet block läses direkt efter flush, innan nästa block hinner skrivas
+		const recordedChunks = recording?.chunkCount ?? 0;
+		const db = await openTrackDatabase();
+		const track = recording ?? await getLatestTrack(db);
+		const chunkCount = recording !== null ? recordedChunks : track?.chunkCount ?? 0;
+		for (let seq = 0; track !== null && seq < chunkCount; seq++) {
+			const columns = await readTrackChunk(db, track.id, seq);
+			if (!isCurrent()) {
+				return false;
+			}
+			if (columns) {
+				onChunk(columns);
+			}
+		}
+	} catch (error) {
+		console.warn("Kunde inte läsa spår:", error);
+	}
+	return isCurrent();
+}
+
+/**
+ * Hands a file to the share flow, falling back to a download link
+ */
+async function shareOrDownloadFile(file: File): Promise<void> {
+	const shareData: ShareData = { title: file.name, files: [file] };
+	if (isShareSupported() && typeof navigator.canShare === 'function' && navigator.canShare(shareData)) {
+		try {
+			await navigator.share(shareData);
+			return;
+		} catch (error) {
+			if (error instanceof DOMException && error.name === 'AbortError') {
+				return;
+			}
+			// Delning kräver ofta en färsk användarinteraktion; ladda ner istället
+			console.warn("Kunde inte dela fil:", error);
+		}
+	}
+
+	const url = URL.createObjectURL(file);
+	const link = document.createElement('a');
+	link.href = url;
+	link.download = file.name;
+	link.click();
+	window.setTimeout(() => URL.revokeObjectURL(url), 60000);
+}
+
+let trackWorker: Worker | null = null;
+let trackWorkerRequestId = 0;
+
+/**
+ * Sends a request to the track worker and resolves with its response
+ * The worker is created on first use and shared by all requests.
+ */
+function runTrackWorker<T extends TrackWorkerResponse>(request: TrackWorkerRequest): Promise<T> {
+	if (trackWorker === null) {
+		trackWorker = new Worker('/track-worker.js');
+	}
+	const worker = trackWorker;
+
+	return new Promise((resolve, reject) => {
+		const handleMessage = (event: MessageEvent<TrackWorkerResponse>) => {
+			const response = event.data;
+			if (response.id !== request.id) {
+				return;
+			}
+			worker.removeEventListener('message', handleMessage);
+			if (response.type === 'error') {
+				reject(new Error(response.message));
+			} else {
+				resolve(response as T);
+			}
+		};
+		worker.addEventListener('message', handleMessage);
+		worker.postMessage(request);
+	});
+}
+
+function getTrackTolerance(): number {
+	const tolerance = Number.parseFloat(trackToleranceInput?.value ?? '');
+	return Number.isFinite(tolerance) && tolerance > 0 ? tolerance : 0;
+}
+
+/**
+ * Simplifies a track in the worker if a tolerance is set
+ * @returns The simplified derived track, or the original track
+ */
+async function simplifyTrackForExport(track: TrackRecord): Promise<TrackRecord> {
+	const tolerance = getTrackTolerance();
+	if (tolerance === 0 || typeof Worker === 'undefined') {
+		return track;
+	}
+
+	try {
+		const response = await runTrackWorker<TrackWorkerSimplifyResponse>({
+			type: 'simplify',
+			id: ++trackWorkerRequestId,
+			trackId: track.id,
+			tolerance
+		});
+		uiHelper.updateSimplifyStatus(response.stats);
+		return response.track;
+	} catch (error) {
+		console.warn("Kunde inte förenkla spår:", error);
+		showNotification(UI_TEXT.TRACK_SIMPLIFY_FAILED, NOTIFICATION_DURATION.DEFAULT, UI_TEXT.TRACK_EXPORT_TITLE);
+		return track;
+	}
+}
+
+/**
+ * Describes a FlatGeobuf export, e.g. "FlatGeobuf: 35000 objekt, 6,7 MB på
+ * 812 ms, 43103 objekt/s"
+ */
+function formatFlatGeobufStatus(stats: FlatGeobufStats): string {
+	const rate = stats.durationMs > 0 ? Math.round(stats.featureCount / (stats.durationMs / 1000)) : stats.featureCount;
+	const megabytes = (stats.byteCount / (1024 * 1024)).toFixed(1).replace('.', ',');
+	return `FlatGeobuf: ${stats.featureCount}${NON_BREAKING_SPACE}objekt, ${megabytes}${NON_BREAKING_SPACE}MB ` +
+		`på ${Math.round(stats.durationMs)}${NON_BREAKING_SPACE}ms, ${rate}${NON_BREAKING_SPACE}objekt/s`;
+}
+
+/**
+ * Exports a track and the stored waypoints as FlatGeobuf
+ * The R-tree is built in the track worker, or here without worker support.
+ * The file is never gzipped, since a GIS then could no longer read parts of
+ * it.
+ */
+async function exportTrackToFlatGeobuf(db: IDBDatabase, track: TrackRecord): Promise<File> {
+	let result: { file: File; stats: FlatGeobufStats };
+	if (typeof Worker === 'undefined') {
+		result = await exportFlatGeobufFile(db, track);
+	} else {
+		result = await runTrackWorker<TrackWorkerExportResponse>({
+			type: 'export',
+			id: ++trackWorkerRequestId,
+			trackId: track.id
+		});
+	}
+	uiHelper.updateExportStatus(result.stats);
+	return result.file;
+}
+
+/**
+ * Save dialog of the File System Access API, which is missing from the DOM
+ * typings and from most browsers
+ */
+type SaveFilePicker = (options: { suggestedName: string }) => Promise<FileSystemFileHandle>;
+
+/**
+ * Asks where to save an export when the browser can write files directly
+ * @returns A writable for the chosen file, or null without a save dialog
+ * @throws DOMException AbortError if the user closes the dialog
+ */
+async function pickTrackExportFile(suggestedName: string): Promise<WritableStream<Uint8Array> | null> {
+	const picker = (window as unknown as { showSaveFilePicker?: SaveFilePicker }).showSaveFilePicker;
+	if (typeof picker !== 'function') {
+		return null;
+	}
+	try {
+		const handle = await picker.call(window, { suggestedName });
+		return await handle.createWritable();
+	} catch (error) {
+		if (error instanceof DOMException && error.name === 'AbortError') {
+			throw error;
+		}
+		// Dialogen kräver en färsk användarinteraktion; exportera via Blob istället
+		console.warn("Kunde inte öppna fil för export:", error);
+		return null;
+	}
+}
+
+/**
+ * Exports the most recent track in the selected format
+ * Text formats are streamed straight to a file where the browser has a save
+ * dialog, so memory stays bounded by one chunk; elsewhere they are shared or
+ * downloaded as a File.
+ */
+async function exportLatestTrack(): Promise<void> {
+	trackExportBtn?.setAttribute("disabled", "disabled");
+	try {
+		await trackRecorder.flush();
+		const db = await openTrackDatabase();
+		const track = await getLatestTrack(db);
+		if (!track || track.fixCount === 0) {
+			showNotification(UI_TEXT.TRACK_EMPTY, NOTIFICATION_DURATION.DEFAULT, UI_TEXT.TRACK_EXPORT_TITLE);
+			return;
+		}
+
+		const selectedFormat = trackFormatSelect?.value ?? '';
+		const format: TrackExportFormat = isTrackExportFormat(selectedFormat) ? selectedFormat : 'gpx';
+		const compressed = trackGzipToggle?.checked === true && isCompressionSupported();
+		const writable = format === 'flatgeobuf'
+			? null
+			: await pickTrackExportFile(getTrackExportFileName(track, format, compressed));
+		const exportTrack = await simplifyTrackForExport(track);
+		if (writable !== null && format !== 'flatgeobuf') {
+			await exportTrackToWritable(db, exportTrack, format, compressed, itrf2Etrs89Correction, writable);
+			return;
+		}
+		const file = format === 'flatgeobuf'
+			? await exportTrackToFlatGeobuf(db, exportTrack)
+			: await exportTrackToFile(db, exportTrack, format, compressed, itrf2Etrs89Correction);
+		await shareOrDownloadFile(file);
+	} catch (error) {
+		if (error instanceof DOMException && error.name === 'AbortError') {
+			return;
+		}
+		console.warn("Kunde inte exportera spår:", error);
+		showNotification(UI_TEXT.TRACK_EXPORT_FAILED, NOTIFICATION_DURATION.ERROR, UI_TEXT.TRACK_EXPORT_TITLE);
+	} finally {
+		trackExportBtn?.removeAttribute("disabled");
+	}
+}
+
+function initializeTrackControls(): void {
+	if (!isTrackStorageSupported()) {
+		return;
+	}
+
+	trackRecordToggle?.removeAttribute("disabled");
+	trackExportBtn?.removeAttribute("disabled");
+	if (!isCompressionSupported()) {
+		trackGzipToggle?.setAttribute("disabled", "disabled");
+	} else {
+		trackGzipToggle?.removeAttribute("disabled");
+	}
+	trackRecordToggle?.addEventListener("change", handleTrackRecordToggle);
+	trackExportBtn?.addEventListener("click", () => {
+		void exportLatestTrack();
+	});
+}
+
+// ============================================================================
+// TRACK PLOT
+// ============================================================================
+
+/**
+ * Shortest time between two updates of the drawn point count and timings
+ */
+const TRACK_PLOT_STATUS_INTERVAL_MS = 1000;
+const TRACK_PLOT_ZOOM_FACTOR = 2;
+
+const detailsTrack = document.getElementById("details-track") as HTMLDetailsElement | null;
+const trackPlotCanvas = document.getElementById("track-plot-canvas") as HTMLCanvasElement | null;
+const trackPlotZoomInBtn = document.getElementById("track-plot-zoom-in-btn") as HTMLButtonElement | null;
+const trackPlotZoomOutBtn = document.getElementById("track-plot-zoom-out-btn") as HTMLButtonElement | null;
+const trackPlotFitBtn = document.getElementById("track-plot-fit-btn") as HTMLButtonElement | null;
+
+let trackPlotWorker: Worker | null = null;
+/** Plot on the main thread when the canvas cannot be handed to a worker */
+let trackPlotLocal: TrackPlot | null = null;
+let trackPlotLocalQueue: Promise<void> = Promise.resolve();
+/** Whether new fixes are sent to the plot, i.e. the track section is open */
+let trackPlotActive = false;
+/** Fixes held back while the stored track is read; null when not loading */
+let trackPlotPending: TrackPlotRequest[] | null = null;
+let trackPlotGeneration = 0;
+let trackPlotPanX = 0;
+let trackPlotPanY = 0;
+let isTrackPlotPanPending = false;
+const trackPlotStatusThrottle = new RenderThrottle(TRACK_PLOT_STATUS_INTERVAL_MS, () => postTrackPlot({ type: 'stats' }));
+
+/**
+ * Formats e.g. "Ritade 412 av 100000 punkter · 0,012 ms per ny punkt"
+ */
+function formatTrackPlotStats(stats: TrackPlotStats): string {
+	const drawn = `${UI_TEXT.TRACK_PLOT_DRAWN} ${stats.drawnCount} ${UI_TEXT.TRACK_PLOT_OF} ${stats.fixCount}${NON_BREAKING_SPACE}${UI_TEXT.TRACK_FIXES_SUFFIX}`;
+	if (stats.append.max === 0) {
+		return drawn;
+	}
+	const perFix = stats.append.mean.toFixed(3).replace(DECIMAL_SEPARATOR_PATTERN, ",");
+	return `${drawn} · ${perFix}${NON_BREAKING_SPACE}ms ${UI_TEXT.TRACK_PLOT_PER_FIX}`;
+}
+
+function handleTrackPlotResponse(response: TrackPlotStatsResponse): void {
+	uiHelper.updateTrackPlotStatus(formatTrackPlotStats(response.stats));
+}
+
+/**
+ * Creates the plot on first use, in a worker when the canvas can be handed over
+ * @returns Whether there is a plot to draw on
+ */
+function createTrackPlot(): boolean {
+	if (trackPlotWorker !== null || trackPlotLocal !== null) {
+		return true;
+	}
+	if (!trackPlotCanvas) {
+		return false;
+	}
+	if (typeof Worker !== 'undefined' && typeof trackPlotCanvas.transferControlToOffscreen === 'function') {
+		const canvas = trackPlotCanvas.transferControlToOffscreen();
+		const worker = new Worker('/track-plot-worker.js');
+		worker.addEventListener('message', (event: MessageEvent<TrackPlotStatsResponse>) => handleTrackPlotResponse(event.data));
+		const request: TrackPlotInitRequest = { type: 'init', canvas };
+		worker.postMessage(request, [canvas]);
+		trackPlotWorker = worker;
+		return true;
+	}
+	const context = trackPlotCanvas.getContext('2d');
+	if (context === null) {
+		return false;
+	}
+	trackPlotLocal = new TrackPlot(trackPlotCanvas, context);
+	return true;
+}
+
+/**
+ * Sends a message to the plot; the local plot handles them in order, like the worker
+ */
+function postTrackPlot(request: TrackPlotRequest): void {
+	if (trackPlotWorker !== null) {
+		trackPlotWorker.postMessage(request);
+		return;
+	}
+	const plot = trackPlotLocal;
+	if (plot === null) {
+		return;
+	}
+	trackPlotLocalQueue = trackPlotLocalQueue
+		.then(() => handleTrackPlotRequest(plot, request))
+		.then((response) => {
+			if (response !== null) {
+				handleTrackPlotResponse(response);
+			}
+		})
+		.catch((error) => {
+			console.warn("Kunde inte rita spår:", error);
+		});
+}
+
+function resizeTrackPlot(): void {
+	if (!trackPlotCanvas || trackPlotCanvas.clientWidth === 0 || trackPlotCanvas.clientHeight === 0) {
+		return;
+	}
+	postTrackPlot({
+		type: 'resize',
+		width: trackPlotCanvas.clientWidth,
+		height: trackPlotCanvas.clientHeight,
+		pixelRatio: Math.min(window.devicePixelRatio || 1, MAP_MAX_PIXEL_RATIO),
+		color: getComputedStyle(trackPlotCanvas).color
+	});
+}
+
+/**
+ * Shows the track being recorded, or else the latest track
+ * Fixes recorded while the stored part is read are held back and sent after
+ * it, so that none is missed or drawn twice.
+ */
+async function loadTrackPlot(): Promise<void> {
+	const generation = ++trackPlotGeneration;
+	trackPlotPending = [];
+	let track: TrackRecord | null = null;
+	try {
+		await trackRecorder.flush();
+		track = trackRecorder.isRecording() ? trackRecorder.getTrack() : await getLatestTrack(await openTrackDatabase());
+	} catch (error) {
+		console.warn("Kunde inte läsa spår:", error);
+	}
+	if (generation !== trackPlotGeneration) {
+		return;
+	}
+	const pending = trackPlotPending ?? [];
+	trackPlotPending = null;
+	// Antalet block läses här, innan nästa block hinner skrivas
+	postTrackPlot({ type: 'load', trackId: track?.id ?? null, chunkCount: track?.chunkCount ?? 0 });
+	for (const request of pending) {
+		postTrackPlot(request);
+	}
+	trackPlotStatusThrottle.request();
+}
+
+/**
+ * Sends a recorded fix to the plot, which draws only the new segment
+ */
+function plotTrackFix(northing: number, easting: number): void {
+	if (!trackPlotActive) {
+		return;
+	}
+	const request: TrackPlotRequest = { type: 'append', northing, easting };
+	if (trackPlotPending !== null) {
+		trackPlotPending.push(request);
+	} else {
+		postTrackPlot(request);
+	}
+	trackPlotStatusThrottle.request();
+}
+
+/**
+ * Starts the plot when the track section opens and stops it when it closes
+ * The stored track is read again on every opening.
+ */
+function handleTrackPlotToggle(): void {
+	if (detailsTrack?.open && createTrackPlot()) {
+		trackPlotActive = true;
+		resizeTrackPlot();
+		void loadTrackPlot();
+	} else {
+		trackPlotActive = false;
+		trackPlotPending = null;
+		trackPlotGeneration++;
+		trackPlotStatusThrottle.cancel();
+	}
+}
+
+/**
+ * Sends the distance dragged since the last frame as one pan
+ */
+function queueTrackPlotPan(dx: number, dy: number): void {
+	trackPlotPanX += dx;
+	trackPlotPanY += dy;
+	if (isTrackPlotPanPending) {
+		return;
+	}
+	isTrackPlotPanPending = true;
+	requestAnimationFrame(() => {
+		isTrackPlotPanPending = false;
+		postTrackPlot({ type: 'pan', dx: trackPlotPanX, dy: trackPlotPanY });
+		trackPlotPanX = 0;
+		trackPlotPanY = 0;
+		trackPlotStatusThrottle.request();
+	});
+}
+
+function postTrackPlotView(request: TrackPlotRequest): void {
+	if (trackPlotActive) {
+		postTrackPlot(request);
+		trackPlotStatusThrottle.request();
+	}
+}
+
+function initializeTrackPlot(): void {
+	if (!trackPlotCanvas || !isTrackStorageSupported()) {
+		return;
+	}
+	detailsTrack?.addEventListener("toggle", handleTrackPlotToggle);
+	trackPlotZoomInBtn?.addEventListener("click", () => postTrackPlotView({ type: 'zoom', factor: 1 / TRACK_PLOT_ZOOM_FACTOR }));
+	trackPlotZoomOutBtn?.addEventListener("click", () => postTrackPlotView({ type: 'zoom', factor: TRACK_PLOT_ZOOM_FACTOR }));
+	trackPlotFitBtn?.addEventListener("click", () => postTrackPlotView({ type: 'fit' }));
+
+	let dragX: number | null = null;
+	let dragY = 0;
+	trackPlotCanvas.addEventListener("pointerdown", (event) => {
+		dragX = event.clientX;
+		dragY = event.clientY;
+		trackPlotCanvas.setPointerCapture(event.pointerId);
+	});
+	trackPlotCanvas.addEventListener("pointermove", (event) => {
+		if (dragX === null || !trackPlotActive) {
+			return;
+		}
+		queueTrackPlotPan(event.clientX - dragX, event.clientY - dragY);
+		dragX = event.clientX;
+		dragY = event.clientY;
+	});
+	const endDrag = () => {
+		dragX = null;
+	};
+	trackPlotCanvas.addEventListener("pointerup", endDrag);
+	trackPlotCanvas.addEventListener("pointercancel", endDrag);
+	window.addEventListener("resize", () => {
+		if (trackPlotActive) {
+			resizeTrackPlot();
+		}
+	});
+
+	if (detailsTrack?.open) {
+		handleTrackPlotToggle();
+	}
+}
+
+// ============================================================================
+// QUALITY CHART
+// ============================================================================
+
+/**
+ * Shortest time between two redraws of the chart while fixes arrive
+ */
+const QUALITY_CHART_INTERVAL_MS = 1000;
+
+const detailsQuality = document.getElementById("details-quality") as HTMLDetailsElement | null;
+const qualityCanvas = document.getElementById("quality-canvas") as HTMLCanvasElement | null;
+
+let qualityChart: QualityChart | null = null;
+/** Whether new fixes are added to the chart, i.e. its section is open */
+let qualityChartActive = false;
+/** Fixes held back while the stored track is read; null when not loading */
+let qualityChartPending: TrackFix[] | null = null;
+let qualityChartGeneration = 0;
+const qualityChartThrottle = new RenderThrottle(QUALITY_CHART_INTERVAL_MS, renderQualityChart);
+
+/**
+ * Formats e.g. "3600 punkter · ritning 0,4 ms"
+ */
+function formatQualityChartStatus(fixCount: number, frames: QualityChartStats): string {
+	const fixes = `${fixCount}${NON_BREAKING_SPACE}${UI_TEXT.TRACK_FIXES_SUFFIX}`;
+	if (frames.count === 0) {
+		return fixes;
+	}
+	return `${fixes} · ${UI_TEXT.MAP_FRAME_TIME} ${frames.mean.toFixed(1).replace(DECIMAL_SEPARATOR_PATTERN, ",")}${NON_BREAKING_SPACE}ms`;
+}
+
+function renderQualityChart(): void {
+	if (qualityChart === null || !qualityChartActive) {
+		return;
+	}
+	qualityChart.render();
+	uiHelper.updateQualityStatus(formatQualityChartStatus(qualityChart.fixCount, qualityChart.frameStats()));
+}
+
+/**
+ * Reads the track being recorded, or else the latest track, into the chart
+ * Fixes recorded meanwhile are held back and added after it.
+ */
+async function loadQualityChart(): Promise<void> {
+	const chart = qualityChart;
+	if (chart === null) {
+		return;
+	}
+	const generation = ++qualityChartGeneration;
+	qualityChartPending = [];
+	chart.clear();
+	if (!await readCurrentTrack(() => generation === qualityChartGeneration, (columns) => chart.load(columns))) {
+		return;
+	}
+	for (const fix of qualityChartPending ?? []) {
+		chart.append(fix.timestamp, fix.accuracy, fix.speed ?? Number.NaN);
+	}
+	qualityChartPending = null;
+	renderQualityChart();
+}
+
+/**
+ * Adds a recorded fix to the chart, which is redrawn at most once per interval
+ */
+function chartTrackFix(fix: TrackFix): void {
+	if (!qualityChartActive || qualityChart === null) {
+		return;
+	}
+	if (qualityChartPending !== null) {
+		qualityChartPending.push(fix);
+		return;
+	}
+	qualityChart.append(fix.timestamp, fix.accuracy, fix.speed ?? Number.NaN);
+	qualityChartThrottle.request();
+}
+
+function handleQualityChartToggle(): void {
+	if (detailsQuality?.open && qualityCanvas) {
+		qualityChart ??= new QualityChart(qualityCanvas, [UI_TEXT.QUALITY_ACCURACY, UI_TEXT.QUALITY_SPEED, UI_TEXT.QUALITY_INTERVAL]);
+		qualityChartActive = true;
+		void loadQualityChart();
+	} else {
+		qualityChartActive = false;
+		qualityChartPending = null;
+		qualityChartGeneration++;
+		qualityChartThrottle.cancel();
+	}
+}
+
+function initializeQualityChart(): void {
+	if (!qualityCanvas || !isTrackStorageSupported()) {
+		return;
+	}
+	detailsQuality?.addEventListener("toggle", handleQualityChartToggle);
+	window.addEventListener("resize", () => {
+		if (qualityChartActive) {
+			qualityChartThrottle.request();
+		}
+	});
+	if (detailsQuality?.open) {
+		handleQualityChartToggle();
+	}
+}
+
+// ============================================================================
+// FIX LIST
+// ============================================================================
+
+const FIX_LIST_TIME_FORMAT = new Intl.DateTimeFormat('sv-SE', { hour: '2-digit', minute: '2-digit', second: '2-digit' });
+
+const detailsFixes = document.getElementById("details-fixes") as HTMLDetailsElement | null;
+const fixListViewport = document.getElementById("fix-list");
+const fixListTimeInput = document.getElementById("fix-list-time") as HTMLInputElement | null;
+
+const fixListBuffer = new TrackFixBuffer();
+let fixList: VirtualList | null = null;
+/** Whether new fixes are added to the list, i.e. its section is open */
+let fixListActive = false;
+/** Fixes held back while the stored track is read; null when not loading */
+let fixListPending: TrackFix[] | null = null;
+let fixListGeneration = 0;
+
+/**
+ * Formats e.g. "14:03:22  N 6580123  E 670123  ±4 m  1,2 m/s"
+ */
+function formatFixRow(columns: TrackColumns, index: number): string {
+	const speed = columns.speed[index];
+	const speedText = Number.isFinite(speed)
+		? `${speed.toFixed(1).replace(DECIMAL_SEPARATOR_PATTERN, ",")}${NON_BREAKING_SPACE}m/s`
+		: "–";
+	return [
+		FIX_LIST_TIME_FORMAT.format(columns.timestamp[index]),
+		formatProjectedCoordinate('N', columns.northing[index], 1),
+		formatProjectedCoordinate('E', columns.easting[index], 1),
+		`±${Math.round(columns.accuracy[index])}${NON_BREAKING_SPACE}m`,
+		speedText
+	].join("  ");
+}
+
+/**
+ * Formats e.g. "1201–1230 av 60000 punkter, 16384 äldre visas inte"
+ * @param dropped - Older fixes left out of the list
+ */
+function formatFixListStatus(first: number, last: number, count: number, dropped: number = 0): string {
+	const fixes = `${count}${NON_BREAKING_SPACE}${UI_TEXT.TRACK_FIXES_SUFFIX}`;
+	const range = last < first ? fixes : `${first + 1}–${last + 1} ${UI_TEXT.TRACK_PLOT_OF} ${fixes}`;
+	return dropped > 0 ? `${range}, ${dropped} ${UI_TEXT.FIX_LIST_DROPPED_SUFFIX}` : range;
+}
+
+/**
+ * Reads the track being recorded, or else the latest track, into the list
+ * Fixes recorded meanwhile are held back and added after it.
+ */
+async function loadFixList(): Promise<void> {
+	const list = fixList;
+	if (list === null) {
+		return;
+	}
+	const generation = ++fixListGeneration;
+	fixListPending = [];
+	fixListBuffer.clear();
+	if (!await readCurrentTrack(() => generation === fixListGeneration, (columns) => fixListBuffer.load(columns))) {
+		return;
+	}
+	for (const fix of fixListPending ?? []) {
+		fixListBuffer.append(fix);
+	}
+	fixListPending = null;
+	list.setCount(fixListBuffer.count, trackRecorder.isRecording());
+}
+
+/**
+ * Adds a recorded fix to the list, which follows it when scrolled to the end
+ */
+function listTrackFix(fix: TrackFix): void {
+	if (!fixListActive || fixList === null) {
+		return;
+	}
+	if (fixListPending !== null) {
+		fixListPending.push(fix);
+		return;
+	}
+	const dropped = fixListBuffer.dropped;
+	fixListBuffer.append(fix);
+	if (fixListBuffer.dropped === dropped) {
+		fixList.grow(fixListBuffer.count, fixList.isAtEnd());
+		return;
+	}
+	// De äldsta positionerna släpptes, så alla rader har fått nya index
+	if (fixList.selectedIndex >= 0) {
+		fixList.select(-1);
+	}
+	fixList.setCount(fixListBuffer.count, fixList.isAtEnd());
+}
+
+/**
+ * Scrolls to the fix closest to the time of day in the input
+ */
+function goToFixListTime(): void {
+	const count = fixListBuffer.count;
+	if (fixList === null || count === 0 || !fixListTimeInput?.value) {
+		return;
+	}
+	const [hours, minutes, seconds = 0] = fixListTimeInput.value.split(":").map(Number);
+	const { timestamp } = fixListBuffer.columns;
+	const time = resolveTrackTimeOfDay(timestamp[0], timestamp[count - 1], hours * 3600 + minutes * 60 + seconds);
+	fixList.select(findFixIndexAtTime(timestamp, count, time));
+}
+
+function handleFixListToggle(): void {
+	if (detailsFixes?.open && fixListViewport) {
+		fixList ??= new VirtualList(
+			fixListViewport,
+			(row, index) => setElementText(row, formatFixRow(fixListBuffer.columns, index)),
+			(first, last, count) => uiHelper.updateFixListStatus(formatFixListStatus(first, last, count, fixListBuffer.dropped))
+		);
+		fixListActive = true;
+		void loadFixList();
+	} else {
+		fixListActive = false;
+		fixListPending = null;
+		fixListGeneration++;
+	}
+}
+
+function initializeFixList(): void {
+	if (!fixListViewport || !isTrackStorageSupported()) {
+		return;
+	}
+	detailsFixes?.addEventListener("toggle", handleFixListToggle);
+	fixListTimeInput?.addEventListener("change", goToFixListTime);
+	window.addEventListener("resize", () => fixList?.requestRender());
+	if (detailsFixes?.open) {
+		handleFixListToggle();
+	}
+}
+
+// ============================================================================
+// DISTANCE AND AREA MEASUREMENT
+// ============================================================================
+
+/**
+ * Adds a rendered fix to the running measurement if it is switched on
+ */
+function measureFix(fix: PositionFix): void {
+	const { sweref } = fix;
+	if (measurementToggle?.checked !== true || !Number.isFinite(sweref.northing) || !Number.isFinite(sweref.easting)) {
+		return;
+	}
+
+	uiHelper.updateMeasurement(measurement.update(
+		sweref.northing,
+		sweref.easting,
+		fix.accuracy,
+		sweref.scaleFactor ?? SWEREF_CENTRAL_SCALE_FACTOR
+	));
+}
+
+function resetMeasurement(): void {
+	measurement.reset();
+	uiHelper.updateMeasurement(measurement.totals());
+}
+
+function initializeMeasurementControls(): void {
+	// Varje ny mätning börjar från noll
+	measurementToggle?.addEventListener("change", () => {
+		if (measurementToggle?.checked === true) {
+			resetMeasurement();
+		}
+	});
+	measurementResetBtn?.addEventListener("click", resetMeasurement);
+}
+
+// ============================================================================
+// WAYPOINTS
+// ============================================================================
+
+/**
+ * Number of nearest waypoints shown for each fix
+ */
+const WAYPOINT_NEAREST_COUNT = 3;
+
+let waypointIndex: WaypointGridIndex | null = null;
+
+/**
+ * Shows the stored waypoints nearest to a rendered fix
+ * Grid distances become ground distances through the scale factor, and grid
+ * bearings become bearings from true north through the meridian convergence.
+ */
+function showNearestWaypoints(fix: PositionFix): void {
+	const { sweref } = fix;
+	if (waypointIndex === null || !Number.isFinite(sweref.northing) || !Number.isFinite(sweref.easting)) {
+		return;
+	}
+
+	const scaleFactor = sweref.scaleFactor ?? SWEREF_CENTRAL_SCALE_FACTOR;
+	const convergence = sweref.convergence ?? 0;
+	const neighbors = waypointIndex.nearest(sweref.northing, sweref.easting, WAYPOINT_NEAREST_COUNT).map((neighbor) => {
+		const gridBearing = Math.atan2(neighbor.easting - sweref.easting, neighbor.northing - sweref.northing) / SWEREF_DEGREES_TO_RADIANS;
+		return {
+			name: neighbor.name,
+			distance: neighbor.gridDistance / scaleFactor,
+			bearing: (gridBearing + convergence + 360) % 360
+		};
+	});
+	uiHelper.updateNearestWaypoints(neighbors);
+}
+
+/**
+ * Imports CSV text, if given, and rebuilds the waypoint index
+ * The index is built in the track worker so that large imports do not block
+ * the page.
+ */
+async function loadWaypoints(csvText?: string): Promise<void> {
+	try {
+		let result: { index: WaypointIndexData; imported: number };
+		if (typeof Worker === 'undefined') {
+			result = await loadStoredWaypointIndex(csvText);
+		} else {
+			result = await runTrackWorker<TrackWorkerWaypointResponse>({
+				type: 'waypoints',
+				id: ++trackWorkerRequestId,
+				csvText
+			});
+		}
+		showWaypointIndex(result.index, csvText !== undefined ? `${result.imported} importerade` : null);
+	} catch (error) {
+		console.warn("Kunde inte läsa punkter:", error);
+		showNotification(UI_TEXT.WAYPOINT_FAILED, NOTIFICATION_DURATION.ERROR, UI_TEXT.WAYPOINT_TITLE);
+	}
+}
+
+/**
+ * Replaces the waypoint index and shows the number of points
+ * @param imported - Description of an import, shown before the total
+ */
+function showWaypointIndex(index: WaypointIndexData, imported: string | null): void {
+	waypointIndex = new WaypointGridIndex(index);
+	const total = `${waypointIndex.size}${NON_BREAKING_SPACE}${UI_TEXT.WAYPOINT_COUNT_SUFFIX}`;
+	uiHelper.updateWaypointStatus(imported !== null ? `${imported}, ${total} totalt` : total);
+	if (lastPositionFix !== null) {
+		showNearestWaypoints(lastPositionFix);
+	} else if (waypointIndex.size === 0) {
+		uiHelper.updateNearestWaypoints([]);
+	}
+}
+
+/**
+ * Describes a GPX or KML import, e.g. "12 punkter och 1 spår (35000
+ * positioner) importerade, 52000 punkter/s"
+ */
+function formatGeoImportStatus(stats: GeoImportStats): string {
+	const pointCount = stats.waypointCount + stats.trackPointCount;
+	const rate = stats.durationMs > 0 ? Math.round(pointCount / (stats.durationMs / 1000)) : pointCount;
+	return `${stats.waypointCount} punkter och ${stats.trackCount} spår ` +
+		`(${stats.trackPointCount}${NON_BREAKING_SPACE}positioner) importerade, ${rate}${NON_BREAKING_SPACE}punkter/s`;
+}
+
+/**
+ * Imports the waypoints and tracks of a GPX or KML file
+ * The file is read as a stream in the track worker. An imported track
+ * becomes the latest track, so the open track views show it unless a track
+ * is being recorded.
+ */
+async function importGeoXmlWaypointFile(file: File): Promise<void> {
+	uiHelper.updateWaypointStatus(UI_TEXT.WAYPOINT_IMPORTING);
+	try {
+		let result: { index: WaypointIndexData; stats: GeoImportStats };
+		if (typeof Worker === 'undefined') {
+			const stats = await importGeoXmlFile(file);
+			result = { index: (await loadStoredWaypointIndex()).index, stats };
+		} else {
+			result = await runTrackWorker<TrackWorkerImportResponse>({
+				type: 'import',
+				id: ++trackWorkerRequestId,
+				file
+			});
+		}
+		showWaypointIndex(result.index, formatGeoImportStatus(result.stats));
+		if (result.stats.trackCount > 0 && !trackRecorder.isRecording()) {
+			reloadTrackViews();
+		}
+	} catch (error) {
+		console.warn("Kunde inte importera fil:", error);
+		showNotification(UI_TEXT.WAYPOINT_FAILED, NOTIFICATION_DURATION.ERROR, UI_TEXT.WAYPOINT_TITLE);
+	}
+}
+
+/**
+ * Stores the latest position under the given name
+ */
+async function saveCurrentWaypoint(): Promise<void> {
+	if (lastPositionFix === null) {
+		showNotification(UI_TEXT.WAYPOINT_NO_POSITION, NOTIFICATION_DURATION.DEFAULT, UI_TEXT.WAYPOINT_TITLE);
+		return;
+	}
+
+	const { sweref } = lastPositionFix;
+	const name = waypointNameInput?.value.trim() || `${UI_TEXT.WAYPOINT_DEFAULT_NAME} ${(waypointIndex?.size ?? 0) + 1}`;
+	try {
+		const db = await openWaypointDatabase();
+		await addWaypoints(db, [{ name, northing: sweref.northing, easting: sweref.easting }]);
+	} catch (error) {
+		console.warn("Kunde inte spara punkt:", error);
+		showNotification(UI_TEXT.WAYPOINT_FAILED, NOTIFICATION_DURATION.ERROR, UI_TEXT.WAYPOINT_TITLE);
+		return;
+	}
+	if (waypointNameInput) {
+		waypointNameInput.value = '';
+	}
+	await loadWaypoints();
+}
+
+async function importWaypointFile(file: File): Promise<void> {
+	if (isGeoXmlFileName(file.name)) {
+		await importGeoXmlWaypointFile(file);
+	} else {
+		await loadWaypoints(await file.text());
+	}
+}
+
+async function clearAllWaypoints(): Promise<void> {
+	try {
+		await clearWaypoints(await openWaypointDatabase());
+	} catch (error) {
+		console.warn("Kunde inte radera punkter:", error);
+		showNotification(UI_TEXT.WAYPOINT_FAILED, NOTIFICATION_DURATION.ERROR, UI_TEXT.WAYPOINT_TITLE);
+		return;
+	}
+	await loadWaypoints();
+}
+
+function initializeWaypointControls(): void {
+	if (!isTrackStorageSupported()) {
+		return;
+	}
+
+	waypointNameInput?.removeAttribute("disabled");
+	waypointSaveBtn?.removeAttribute("disabled");
+	waypointImportInput?.removeAttribute("disabled");
+	waypointClearBtn?.removeAttribute("disabled");
+	waypointSaveBtn?.addEventListener("click", () => {
+		void saveCurrentWaypoint();
+	});
+	waypointImportInput?.addEventListener("change", () => {
+		const file = waypointImportInput?.files?.[0];
+		if (file) {
+			void importWaypointFile(file).finally(() => {
+				waypointImportInput.value = '';
+			});
+		}
+	});
+	waypointClearBtn?.addEventListener("click", () => {
+		void clearAllWaypoints();
+	});
+	void loadWaypoints();
+}
+
+// ============================================================================
+// STAKE-OUT
+// ============================================================================
+
+/**
+ * Shortest time between two stake-out renders; 5 per second stays readable
+ * and keeps 10 Hz receivers from redrawing on every fix
+ */
+const STAKEOUT_RENDER_INTERVAL_MS = 200;
+
+/**
+ * Number of nearby waypoints offered as targets
+ */
+const STAKEOUT_WAYPOINT_SUGGESTIONS = 10;
+
+let stakeoutTarget: StakeoutTarget | null = getSavedStakeoutTarget();
+// Senaste visade position i rutnätet; utsättningen ritas med fördröjning
+const stakeoutPosition = { northing: Number.NaN, easting: Number.NaN, scaleFactor: SWEREF_CENTRAL_SCALE_FACTOR };
+const stakeoutRenderThrottle = new RenderThrottle(STAKEOUT_RENDER_INTERVAL_MS, renderStakeout);
+
+function getSavedStakeoutTarget(): StakeoutTarget | null {
 	try {
-		// Find all details elements with IDs
-		const detailsElements = document.querySelectorAll('details[id]');
-		const state: DetailsState = {};
-		
-		// Track up to MAX_DETAILS_TO_TRACK elements
-		let count = 0;
-		detailsElements.forEach((element) => {
-			if (count >= MAX_DETAILS_TO_TRACK) {
-				return;
-			}
-			
-			const detailsElement = element as HTMLDetailsElement;
-			if (detailsElement.id) {
-				state[detailsElement.id] = detailsElement.open;
-				count++;
-			}
-		});
+		const saved = JSON.parse(getStoredItem(STAKEOUT_TARGET_STORAGE_KEY) ?? 'null') as StakeoutTarget | null;
+		if (saved !== null && Number.isFinite(saved.northing) && Number.isFinite(saved.easting)) {
+			return { name: typeof saved.name === 'string' ? saved.name : null, northing: saved.northing, easting: saved.easting };
+		}
+	} catch {
+		// Ogiltigt sparat mål ignoreras
+	}
+	return null;
+}
 
-		setStoredItem(DETAILS_STATE_STORAGE_KEY, JSON.stringify(state));
+function renderStakeout(): void {
+	if (stakeoutTarget === null || !Number.isFinite(stakeoutPosition.northing) || !Number.isFinite(stakeoutPosition.easting)) {
+		uiHelper.updateStakeout(stakeoutTarget, null);
+		return;
+	}
+	uiHelper.updateStakeout(stakeoutTarget, computeStakeoutOffset(
+		stakeoutTarget,
+		stakeoutPosition.northing,
+		stakeoutPosition.easting,
+		stakeoutPosition.scaleFactor
+	));
+}
+
+/**
+ * Notes the displayed position; the offsets are rendered at a limited rate
+ */
+function updateStakeoutPosition(northing: number, easting: number, scaleFactor: number): void {
+	stakeoutPosition.northing = northing;
+	stakeoutPosition.easting = easting;
+	stakeoutPosition.scaleFactor = scaleFactor;
+	if (stakeoutTarget !== null) {
+		stakeoutRenderThrottle.request();
+	}
+}
+
+function setStakeoutTarget(target: StakeoutTarget | null): void {
+	stakeoutTarget = target;
+	if (target === null) {
+		removeStoredItem(STAKEOUT_TARGET_STORAGE_KEY);
+	} else {
+		setStoredItem(STAKEOUT_TARGET_STORAGE_KEY, JSON.stringify(target));
+	}
+	stakeoutRenderThrottle.cancel();
+	renderStakeout();
+}
+
+/**
+ * Sets the target from the input: a coordinate or the name of a stored waypoint
+ */
+function applyStakeoutInput(): void {
+	const text = stakeoutTargetInput?.value.trim() ?? '';
+	const waypoint = waypointIndex?.findByName(text) ?? null;
+	const target = waypoint !== null
+		? { name: waypoint.name, northing: waypoint.northing, easting: waypoint.easting }
+		: parseStakeoutCoordinate(text);
+	if (target === null) {
+		showNotification(UI_TEXT.STAKEOUT_INVALID, NOTIFICATION_DURATION.DEFAULT, UI_TEXT.STAKEOUT_TITLE);
+		return;
+	}
+	setStakeoutTarget(target);
+}
+
+/**
+ * Offers the waypoints nearest to the latest position as targets
+ */
+function updateStakeoutSuggestions(): void {
+	if (!stakeoutWaypointList || waypointIndex === null || lastPositionFix === null) {
+		return;
+	}
+	const { sweref } = lastPositionFix;
+	const options = waypointIndex.nearest(sweref.northing, sweref.easting, STAKEOUT_WAYPOINT_SUGGESTIONS).map((neighbor) => {
+		const option = document.createElement('option');
+		option.value = neighbor.name;
+		return option;
+	});
+	stakeoutWaypointList.replaceChildren(...options);
+}
+
+function initializeStakeoutControls(): void {
+	if (stakeoutTarget !== null && stakeoutTargetInput) {
+		stakeoutTargetInput.value = stakeoutTarget.name
+			?? `${Math.round(stakeoutTarget.northing)} ${Math.round(stakeoutTarget.easting)}`;
+	}
+	renderStakeout();
+	stakeoutSetBtn?.addEventListener("click", applyStakeoutInput);
+	stakeoutTargetInput?.addEventListener("keydown", (event: KeyboardEvent) => {
+		if (event.key === 'Enter') {
+			applyStakeoutInput();
+		}
+	});
+	stakeoutTargetInput?.addEventListener("focus", updateStakeoutSuggestions);
+	stakeoutClearBtn?.addEventListener("click", () => {
+		if (stakeoutTargetInput) {
+			stakeoutTargetInput.value = '';
+		}
+		setStakeoutTarget(null);
+	});
+}
+
+// ============================================================================
+// GEOFENCES
+// ============================================================================
+
+let geofenceEngine: GeofenceEngine | null = null;
+
+/**
+ * Tests the displayed position against the areas and notifies about entries and exits
+ */
+function checkGeofences(northing: number, easting: number): void {
+	if (geofenceEngine === null || geofenceEngine.size === 0 || !Number.isFinite(northing) || !Number.isFinite(easting)) {
+		return;
+	}
+
+	const { entered, exited, changed } = geofenceEngine.update(northing, easting);
+	if (!changed) {
+		return;
+	}
+	uiHelper.updateGeofenceInside(geofenceEngine.insideNames());
+	const lines = [
+		...entered.map((name) => `${UI_TEXT.GEOFENCE_ENTERED} ${name}`),
+		...exited.map((name) => `${UI_TEXT.GEOFENCE_EXITED} ${name}`)
+	];
+	if (lines.length > 0) {
+		showNotification(lines.join('\n'), NOTIFICATION_DURATION.DEFAULT, UI_TEXT.GEOFENCE_TITLE);
+	}
+}
+
+/**
+ * Imports GeoJSON text, if given, and rebuilds the area index from storage
+ */
+async function loadGeofences(geoJsonText?: string): Promise<void> {
+	try {
+		const db = await openGeofenceDatabase();
+		let imported = 0;
+		if (geoJsonText !== undefined) {
+			const polygons = parseGeofenceGeoJson(geoJsonText);
+			await addGeofences(db, polygons);
+			imported = polygons.length;
+		}
+		geofenceEngine = new GeofenceEngine(await readAllGeofences(db));
+		const total = `${geofenceEngine.size}${NON_BREAKING_SPACE}${UI_TEXT.GEOFENCE_COUNT_SUFFIX}`;
+		uiHelper.updateGeofenceStatus(geoJsonText !== undefined ? `${imported} importerade, ${total} totalt` : total);
+		// Nästa position sätter läget utan larm
+		if (lastPositionFix !== null) {
+			const { sweref } = lastPositionFix;
+			geofenceEngine.update(sweref.northing, sweref.easting);
+		}
+		uiHelper.updateGeofenceInside(geofenceEngine.insideNames());
 	} catch (error) {
-		// Silently fail if localStorage is not available or quota exceeded
-		console.warn('Failed to save details state:', error);
+		console.warn("Kunde inte läsa områden:", error);
+		showNotification(UI_TEXT.GEOFENCE_FAILED, NOTIFICATION_DURATION.ERROR, UI_TEXT.GEOFENCE_TITLE);
+	}
+}
+
+async function clearAllGeofences(): Promise<void> {
+	try {
+		await clearGeofences(await openGeofenceDatabase());
+	} catch (error) {
+		console.warn("Kunde inte radera områden:", error);
+		showNotification(UI_TEXT.GEOFENCE_FAILED, NOTIFICATION_DURATION.ERROR, UI_TEXT.GEOFENCE_TITLE);
+		return;
+	}
+	await loadGeofences();
+}
+
+function initializeGeofenceControls(): void {
+	if (!isTrackStorageSupported()) {
+		return;
 	}
+
+	geofenceImportInput?.removeAttribute("disabled");
+	geofenceClearBtn?.removeAttribute("disabled");
+	geofenceImportInput?.addEventListener("change", () => {
+		const file = geofenceImportInput?.files?.[0];
+		if (file) {
+			void file.text().then(loadGeofences).finally(() => {
+				geofenceImportInput.value = '';
+			});
+		}
+	});
+	geofenceClearBtn?.addEventListener("click", () => {
+		void clearAllGeofences();
+	});
+	void loadGeofences();
 }
 
+// ============================================================================
+// MUNICIPALITY AND COUNTY
+// ============================================================================
+
 /**
- * Restore the open state of all tracked details elements from localStorage
- * 
- * This function reads the saved state from localStorage and applies it to
- * the <details> elements on the page. Called on page load.
+ * Simplified municipality boundaries, built by scripts/generate-admin-areas.mjs
+ * The file is optional; without it the municipality line stays hidden.
  */
-function restoreDetailsState(): void {
+const ADMIN_AREAS_URL = 'admin-areas.bin';
+
+let adminAreaIndex: AdminAreaIndex | null = null;
+/** Municipality on display; undefined before the first lookup */
+let currentAdminArea: AdminArea | null | undefined;
+
+function formatAdminArea(area: AdminArea): string {
+	return area.countyName !== '' ? `${area.municipalityName}, ${area.countyName}` : area.municipalityName;
+}
+
+/**
+ * Looks up the municipality of the displayed position
+ * The display is only touched when the municipality changes.
+ */
+function showAdminArea(northing: number, easting: number): void {
+	if (adminAreaIndex === null || !Number.isFinite(northing) || !Number.isFinite(easting)) {
+		return;
+	}
+
+	const area = adminAreaIndex.lookup(northing, easting);
+	if (area !== currentAdminArea) {
+		currentAdminArea = area;
+		uiHelper.updateAdminArea(area);
+	}
+}
+
+/**
+ * Loads the municipality boundaries and builds their grid index
+ */
+async function loadAdminAreas(): Promise<void> {
+	if (typeof fetch !== 'function') {
+		return;
+	}
+
 	try {
-		const savedStateJson = getStoredItem(DETAILS_STATE_STORAGE_KEY);
-		if (!savedStateJson) {
+		const response = await fetch(ADMIN_AREAS_URL);
+		if (!response.ok) {
+			// Kommungränserna ingår inte i alla byggen
 			return;
 		}
+		adminAreaIndex = new AdminAreaIndex(decodeAdminAreas(new Uint8Array(await response.arrayBuffer())));
+		currentAdminArea = undefined;
+		const fix = lastPositionFix;
+		if (fix !== null) {
+			const displayed = isPositionFilterEnabled && fix.filtered !== null ? fix.filtered : fix.sweref;
+			showAdminArea(displayed.northing, displayed.easting);
+		}
+	} catch (error) {
+		console.warn("Kunde inte läsa kommungränser:", error);
+	}
+}
 
-		const savedState: DetailsState = JSON.parse(savedStateJson);
+// ============================================================================
+// MAP SHEETS
+// ============================================================================
 
-		// Apply saved state to details elements
-		Object.keys(savedState).forEach((id) => {
-			const element = document.getElementById(id);
-			if (element && element.tagName === 'DETAILS') {
-				const detailsElement = element as HTMLDetailsElement;
-				detailsElement.open = savedState[id];
-			}
-		});
-	} catch (error) {
-		// Silently fail if localStorage is not available or data is corrupted
-		console.warn('Failed to restore details state:', error);
+/** Index of the smallest map sheet on display; NaN before the first fix */
+let currentMapSheetIndex = Number.NaN;
+
+/**
+ * Formats the map sheet names as e.g. "Ruta 5 km 6580_670, 10 km 6580_670, 50 km 6550_650"
+ */
+function formatMapSheetLine(names: readonly string[]): string {
+	const parts = names.map((name, i) => `${MAP_SHEET_SIZES[i] / 1000}${NON_BREAKING_SPACE}km${NON_BREAKING_SPACE}${name}`);
+	return `${UI_TEXT.MAP_SHEET_PREFIX} ${parts.join(', ')}`;
+}
+
+/**
+ * Shows the map sheets of the displayed position
+ * The larger sheets contain the smallest one, so the display is only touched
+ * when the smallest sheet changes.
+ */
+function showMapSheet(northing: number, easting: number): void {
+	if (!Number.isFinite(northing) || !Number.isFinite(easting)) {
+		return;
+	}
+
+	const index = mapSheetIndex(northing, easting, MAP_SHEET_SIZES[0]);
+	if (index !== currentMapSheetIndex) {
+		currentMapSheetIndex = index;
+		uiHelper.updateMapSheet(formatMapSheetLine(formatMapSheets(northing, easting)));
 	}
 }
 
+// ============================================================================
+// MAP
+// ============================================================================
+
 /**
- * Initialize details state persistence
- * 
- * Sets up event listeners on all <details> elements to save their state
- * when they are opened or closed.
+ * Shortest time between two updates of the tile count and frame times
  */
-function initializeDetailsStatePersistence(): void {
-	// Restore state on page load
-	restoreDetailsState();
+const MAP_STATUS_INTERVAL_MS = 1000;
 
-	// Add event listeners to all details elements
-	const detailsElements = document.querySelectorAll('details[id]');
-	detailsElements.forEach((element) => {
-		element.addEventListener('toggle', saveDetailsState);
+const detailsMap = document.getElementById("details-map") as HTMLDetailsElement | null;
+const mapCanvas = document.getElementById("map-canvas") as HTMLCanvasElement | null;
+const mapZoomInBtn = document.getElementById("map-zoom-in-btn") as HTMLButtonElement | null;
+const mapZoomOutBtn = document.getElementById("map-zoom-out-btn") as HTMLButtonElement | null;
+
+let mapView: MapView | null = null;
+const mapStatusThrottle = new RenderThrottle(MAP_STATUS_INTERVAL_MS, renderMapStatus);
+
+function getSavedMapZoom(): number {
+	const saved = Number.parseInt(getStoredItem(MAP_ZOOM_STORAGE_KEY) ?? '', 10);
+	return Number.isFinite(saved) ? saved : MAP_DEFAULT_ZOOM_INDEX;
+}
+
+/**
+ * Formats e.g. "9 rutor · ritning 1,2 ms (p95 2,0 ms)"
+ */
+function formatMapStatus(tileCount: number, frames: MapFrameStats): string {
+	const tiles = `${tileCount}${NON_BREAKING_SPACE}${UI_TEXT.MAP_TILES_SUFFIX}`;
+	if (frames.count === 0) {
+		return tiles;
+	}
+	const milliseconds = (value: number) => `${value.toFixed(1).replace(DECIMAL_SEPARATOR_PATTERN, ",")}${NON_BREAKING_SPACE}ms`;
+	return `${tiles} · ${UI_TEXT.MAP_FRAME_TIME} ${milliseconds(frames.mean)} (p95 ${milliseconds(frames.p95)})`;
+}
+
+function renderMapStatus(): void {
+	if (mapView !== null) {
+		uiHelper.updateMapStatus(formatMapStatus(mapView.tileCount, mapView.frameStats()));
+	}
+}
+
+/**
+ * Centres the map on the displayed position
+ * The true course is turned into a grid bearing, so that the tiles ahead
+ * in the grid are prefetched.
+ */
+function updateMapPosition(northing: number, easting: number, accuracy: number, course: number | null, speed: number | null, convergence: number): void {
+	if (mapView === null || !Number.isFinite(northing) || !Number.isFinite(easting)) {
+		return;
+	}
+	const gridBearing = course !== null ? (course - convergence + 360) % 360 : null;
+	mapView.setPosition(northing, easting, accuracy, gridBearing, speed);
+	if (detailsMap?.open) {
+		mapStatusThrottle.request();
+	}
+}
+
+function setMapZoom(zoomIndex: number): void {
+	if (mapView === null) {
+		return;
+	}
+	mapView.setZoom(zoomIndex);
+	setStoredItem(MAP_ZOOM_STORAGE_KEY, String(mapView.zoom));
+}
+
+/**
+ * Creates the map; it loads and draws only while its section is open
+ */
+function initializeMapControls(): void {
+	if (!mapCanvas) {
+		return;
+	}
+	const view = new MapView(mapCanvas, fetchMapTile, getSavedMapZoom());
+	mapView = view;
+	view.setVisible(detailsMap?.open ?? false);
+	detailsMap?.addEventListener("toggle", () => {
+		view.setVisible(detailsMap.open);
+		if (!detailsMap.open) {
+			mapStatusThrottle.cancel();
+		}
 	});
+	mapZoomInBtn?.addEventListener("click", () => setMapZoom(view.zoom - 1));
+	mapZoomOutBtn?.addEventListener("click", () => setMapZoom(view.zoom + 1));
+}
+
+// ============================================================================
+// NEAREST PLACE NAME
+// ============================================================================
+
+/**
+ * Place names, built by scripts/generate-gazetteer.mjs
+ */
+const GAZETTEER_URL = 'places.bin';
+
+/**
+ * Compass points from north, clockwise
+ */
+const COMPASS_POINTS = ['N', 'NO', 'O', 'SO', 'S', 'SV', 'V', 'NV'] as const;
+
+let gazetteer: Gazetteer | null = null;
+let isGazetteerRequested = false;
+
+/**
+ * Describes a position relative to a place, e.g. "4,2 km NO om Uppsala"
+ * @param bearing - Direction from the place to the position, degrees from true north
+ */
+function formatNearestPlace(name: string, distance: number, bearing: number): string {
+	if (distance < 1000) {
+		return `${UI_TEXT.PLACE_AT} ${name}`;
+	}
+	const kilometres = distance / 1000;
+	const distanceText = kilometres < 10 ? kilometres.toFixed(1).replace(DECIMAL_SEPARATOR_PATTERN, ",") : String(Math.round(kilometres));
+	const compass = COMPASS_POINTS[Math.round(((bearing % 360) + 360) % 360 / 45) % COMPASS_POINTS.length];
+	return `${distanceText}${NON_BREAKING_SPACE}km ${compass} ${UI_TEXT.PLACE_FROM} ${name}`;
+}
+
+/**
+ * Shows the nearest place to the displayed position
+ * The place names are loaded in the background on the first position.
+ */
+function showNearestPlace(northing: number, easting: number, scaleFactor: number, convergence: number): void {
+	if (gazetteer === null) {
+		if (!isGazetteerRequested) {
+			isGazetteerRequested = true;
+			void loadGazetteer();
+		}
+		return;
+	}
+	if (!Number.isFinite(northing) || !Number.isFinite(easting)) {
+		return;
+	}
+
+	const place = gazetteer.nearest(northing, easting);
+	if (place === null) {
+		uiHelper.updateNearestPlace(null);
+		return;
+	}
+	const gridBearing = Math.atan2(easting - place.easting, northing - place.northing) / SWEREF_DEGREES_TO_RADIANS;
+	uiHelper.updateNearestPlace(formatNearestPlace(place.name, place.gridDistance / scaleFactor, gridBearing + convergence));
+}
+
+async function loadGazetteer(): Promise<void> {
+	if (typeof fetch !== 'function') {
+		return;
+	}
+
+	try {
+		const response = await fetch(GAZETTEER_URL);
+		if (!response.ok) {
+			throw new Error(`HTTP ${response.status}`);
+		}
+		gazetteer = new Gazetteer(await response.arrayBuffer());
+		const fix = lastPositionFix;
+		if (fix !== null) {
+			const displayed = isPositionFilterEnabled && fix.filtered !== null ? fix.filtered : fix.sweref;
+			showNearestPlace(displayed.northing, displayed.easting, fix.sweref.scaleFactor ?? SWEREF_CENTRAL_SCALE_FACTOR, fix.sweref.convergence ?? 0);
+		}
+	} catch (error) {
+		console.warn("Kunde inte läsa ortnamn:", error);
+	}
 }
 
 // ============================================================================
@@ -1114,8 +3215,8 @@ function initializeEventListeners(): void {
 
 	notificationDialog?.addEventListener('click', handleNotificationBackdropClick);
 
-	// Check geolocation availability
-	if (!("geolocation" in navigator)) {
+	// Check position source availability
+	if (!positionSource.isSupported()) {
 		showNotification(UI_TEXT.ERROR_NO_POSITION, NOTIFICATION_DURATION.ERROR, UI_TEXT.ERROR_NO_POSITION_TITLE);
 	} else {
 		posbtn?.removeAttribute("disabled");
@@ -1125,8 +3226,38 @@ function initializeEventListeners(): void {
 // Initialize the application
 initializeEventListeners();
 
+// Initialize position source settings
+initializePositionSourceControls();
+
 // Initialize details state persistence
 initializeDetailsStatePersistence();
 
+// Initialize track recording and export
+initializeTrackControls();
+initializeTrackPlot();
+initializeQualityChart();
+initializeFixList();
+
+// Initialize distance and area measurement
+initializeMeasurementControls();
+
+// Load stored waypoints and their index
+initializeWaypointControls();
+
+// Initialize stake-out to a target coordinate
+initializeStakeoutControls();
+
+// Load stored areas for entry and exit alerts
+initializeGeofenceControls();
+
+// Load municipality boundaries for the municipality and county display
+void loadAdminAreas();
+
+// Initialize the map around the position
+initializeMapControls();
+
 // Update speed display to show saved unit preference
 uiHelper.updateSpeedDisplayUnit();
+
+// Start a measured trace replay if requested in the URL
+void startReplayFromUrl();
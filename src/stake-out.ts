@@ -0,0 +1,118 @@
+// ============================================================================
+// STAKE-OUT (offsets to a target SWEREF 99 TM coordinate)
+// ============================================================================
+//
+// Utsättning: hitta en given punkt i fält. Varje position ger skillnaden i
+// nord och öst mot målet, avståndet och riktningen i rutnätet. Allt räknas
+// direkt i SWEREF 99 TM-planet med några få operationer per position.
+//
+// Positioner kan komma med 10 Hz eller mer från en extern mottagare. Siffror
+// som byts så ofta går inte att läsa och kostar omritningar, så visningen
+// begränsas till ett fast antal gånger per sekund. Det sista värdet visas
+// alltid.
+//
+// Filen innehåller ingen DOM-kod och kan därför även laddas i Web Workers.
+
+interface StakeoutTarget {
+	/** Waypoint name, or null for an entered coordinate */
+	name: string | null;
+	northing: number;
+	easting: number;
+}
+
+interface StakeoutOffset {
+	/** Target minus position in the grid, metres */
+	deltaNorth: number;
+	deltaEast: number;
+	/** Ground distance, the grid distance divided by the scale factor, metres */
+	distance: number;
+	/** Grid bearing from the position to the target, degrees 0–360 */
+	gridBearing: number;
+}
+
+/**
+ * Smallest plausible SWEREF 99 TM northing and easting for an entered
+ * target; smaller numbers are more likely WGS84 degrees or typos
+ */
+const STAKEOUT_MIN_NORTHING = 6000000;
+const STAKEOUT_MIN_EASTING = 100000;
+
+/**
+ * Computes the offsets from a position to the target
+ */
+function computeStakeoutOffset(target: StakeoutTarget, northing: number, easting: number, scaleFactor: number): StakeoutOffset {
+	const deltaNorth = target.northing - northing;
+	const deltaEast = target.easting - easting;
+	const gridBearing = Math.atan2(deltaEast, deltaNorth) * 180 / Math.PI;
+	return {
+		deltaNorth,
+		deltaEast,
+		distance: Math.hypot(deltaNorth, deltaEast) / scaleFactor,
+		gridBearing: gridBearing < 0 ? gridBearing + 360 : gridBearing
+	};
+}
+
+/**
+ * Parses an entered target coordinate such as "6580822 674032",
+ * "N 6580822,5 E 674032,25" or "6580822.5, 674032.25"
+ * @returns The target, or null if the text is not a SWEREF 99 TM coordinate
+ */
+function parseStakeoutCoordinate(text: string): StakeoutTarget | null {
+	// Ett kommatecken följt av högst fyra siffror är ett decimalkomma; annars skiljer det talen åt
+	const numbers = text.replace(/(\d),(\d{1,4})(?!\d)/g, '$1.$2').match(/-?\d+(\.\d+)?/g);
+	if (numbers === null || numbers.length !== 2) {
+		return null;
+	}
+	const northing = Number(numbers[0]);
+	const easting = Number(numbers[1]);
+	if (northing < STAKEOUT_MIN_NORTHING || easting < STAKEOUT_MIN_EASTING) {
+		return null;
+	}
+	return { name: null, northing, easting };
+}
+
+/**
+ * RenderThrottle - kör en omritning högst en gång per intervall
+ *
+ * Den första begäran ritas direkt. Begäran inom intervallet samlas till en
+ * omritning när intervallet gått ut, så att det senaste värdet alltid visas.
+ */
+class RenderThrottle {
+	private intervalMs: number;
+	private render: () => void;
+	private lastRenderTime: number = Number.NEGATIVE_INFINITY;
+	private pendingTimeout: ReturnType<typeof setTimeout> | null = null;
+
+	constructor(intervalMs: number, render: () => void) {
+		this.intervalMs = intervalMs;
+		this.render = render;
+	}
+
+	request(): void {
+		if (this.pendingTimeout !== null) {
+			return;
+		}
+		const wait = this.lastRenderTime + this.intervalMs - performance.now();
+		if (wait <= 0) {
+			this.run();
+		} else {
+			this.pendingTimeout = setTimeout(() => this.run(), wait);
+		}
+	}
+
+	/**
+	 * Drops a scheduled render
+	 */
+	cancel(): void {
+		if (this.pendingTimeout !== null) {
+			clearTimeout(this.pendingTimeout);
+			this.pendingTimeout = null;
+		}
+	}
+
+	private run(): void {
+		this.pendingTimeout = null;
+		this.lastRenderTime = performance.now();
+		this.render();
+	}
+}
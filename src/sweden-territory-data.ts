@@ -0,0 +1,405 @@
+// ============================================================================
+// SWEDISH TERRITORY DATA (generated)
+// ============================================================================
+//
+// Genererad av scripts/generate-territory.mjs från data/sweden-territory.geojson.
+// Ändra inte för hand; kör make src/sweden-territory-data.ts.
+//
+// 128 punkter förenklade med toleransen 50 m till 126 kanter,
+// 324 × 164 rutor à 5 km, varav 1104 gränsrutor.
+
+const TERRITORY_GRID = {
+	MIN_NORTHING: 6080000,
+	MIN_EASTING: 160000,
+	CELL_SIZE: 5000,
+	COLUMNS: 164,
+	ROWS: 324
+} as const;
+
+/**
+ * Two bits per cell, four cells per byte, lowest bits first:
+ * 0 outside, 1 inside, 2 border cell with its centre outside, 3 border cell with its centre inside
+ */
+const TERRITORY_CELL_STATES =
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAACgqgoAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAoH9V/S8AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAB+VVVVtQIAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAA4FdVVVVVCwAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAB4VVVVVVUJAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAHBVVVVVVQ0AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAYFVV' +
+	'VVVVLQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAADgVVVVVVU1AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAIBXVVVVVbUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAFdVVVVVlQAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAXlVVVVXVAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABWVVVVVdUCAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAFZVVVVVVQMAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAVlVV' +
+	'VVVVCwCoCgAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAIBXVVVVVVWp/18tAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAgFVVVVVVVVVVVfUCAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAADgVVVVVVVVVVVVVSsAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAGBVVVVVVVVVVVVVtQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAYFVVVVVVVVVVVVXVAgAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABgVVVVVVVVVVVVVVULAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAGBVVVVV' +
+	'VVVVVVVVVS0AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAcFVVVVVVVVVVVVVVtQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAB4VVVVVVVVVVVVVVWVAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAF5VVVVVVVVVVVVVVdUCAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAACAV1VVVVVVVVVVVVVVVQsAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAOBVVVVVVVVVVVVVVVVVLQAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAelVVVVVVVVVVVVVVVVU1AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABXVVVVVVVV' +
+	'VVVVVVVVVbUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAFdVVVVVVVVVVVVVVVVV1QIAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AACAV1VVVVVVVVVVVVVVVVVVAgAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAIBVVVVVVVVVVVVVVVVVVVUDAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAgFVVVVVVVVVVVVVVVVVVVQMAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAACAVVVVVVVVVVVVVVVVVVVVCwAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAIBVVVVVVVVVVVVVVVVVVVUJAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAwFVVVVVVVVVV' +
+	'VVVVVVVVVQ0AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAADAVVVVVVVVVVVVVVVVVVVVDQAAAAgAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AOBVVVVVVVVVVVVVVVVVVVUtAACgLwAAAAAAAAAAAAAAAAAAAAAAAAAAYFVVVVVVVVVVVVVVVVVVVSUAgH61AAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAABwVVVVVVVVVVVVVVVVVVVVNQCAVdUCAAAAAAAAAAAAAAAAAAAAAAAAAHhVVVVVVVVVVVVVVVVVVVU1AIBV' +
+	'VQsAAAAAAAAAAAAAAAAAAAAAAAAAWFVVVVVVVVVVVVVVVVVVVbUAwFVVLQAAAAAAAAAAAAAAAAAAAAAAAABcVVVVVVVVVVVV' +
+	'VVVVVVVVlQDgVVW1AAAAAAAAAAAAAAAAAAAAAAAAAF5VVVVVVVVVVVVVVVVVVVWVAGBVVdUCAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'VlVVVVVVVVVVVVVVVVVVVZUAYFVVVQsAAAAAAAAAAAAAAAAAAAAAAIBXVVVVVVVVVVVVVVVVVVVV1QBwVVVVLQAAAAAAAAAA' +
+	'AAAAAAAAAAAAgFVVVVVVVVVVVVVVVVVVVVXVAHhVVVUlAAAAAAAAAAAAAAAAAAAAAADgVVVVVVVVVVVVVVVVVVVVVdUCWFVV' +
+	'VbUAAAAAAAAAAAAAAAAAAAAAAGBVVVVVVVVVVVVVVVVVVVVVVQJcVVVV1QIAAAAAAAAAAAAAAAAAAAAAeFVVVVVVVVVVVVVV' +
+	'VVVVVVVVAlxVVVVVAwAAAAAAAAAAAAAAAAAAAABYVVVVVVVVVVVVVVVVVVVVVVUDXFVVVVULAAAAAAAAAAAAAAAAAAAAAFxV' +
+	'VVVVVVVVVVVVVVVVVVVVVQNYVVVVVS0AAAAAAAAAAAAAAAAAAAAAXlVVVVVVVVVVVVVVVVVVVVVVA1hVVVVVtQAAAAAAAAAA' +
+	'AAAAAAAAAABXVVVVVVVVVVVVVVVVVVVVVVUDeFVVVVWVAAAAAAAAAAAAAAAAAAAAgFdVVVVVVVVVVVVVVVVVVVVVVQJwVVVV' +
+	'VZUAAAAAAAAAAAAAAAAAAACAVVVVVVVVVVVVVVVVVVVVVVVVAnBVVVVVlQAAAAAAAAAAAAAAAAAAAMBVVVVVVVVVVVVVVVVV' +
+	'VVVVVdUCYFVVVVWVAAAAAAAAAAAAAAAAAAAA4FVVVVVVVVVVVVVVVVVVVVVV1QBgVVVVVZUAAAAAAAAAAAAAAAAAAABwVVVV' +
+	'VVVVVVVVVVVVVVVVVVXVAOBVVVVVlQAAAAAAAAAAAAAAAAAAAHhVVVVVVVVVVVVVVVVVVVVVVdUAwFVVVVWVAAAAAAAAAAAA' +
+	'AAAAAAAAWFVVVVVVVVVVVVVVVVVVVVVVlQCAVVVVVZUAAAAAAAAAAAAAAAAAAABcVVVVVVVVVVVVVVVVVVVVVVWVAIBXVVVV' +
+	'lQAAAAAAAAAAAAAAAAAAAF5VVVVVVVVVVVVVVVVVVVVVVZUAAF5VVVXVAAAAAAAAAAAAAAAAAAAAV1VVVVVVVVVVVVVVVVVV' +
+	'VVVV1QAAXFVVVdUAAAAAAAAAAAAAAAAAAIBXVVVVVVVVVVVVVVVVVVVVVVXVAAB4VVVV1QAAAAAAAAAAAAAAAAAAgFVVVVVV' +
+	'VVVVVVVVVVVVVVVVVdUAAOBVVVXVAAAAAAAAAAAAAAAAAADAVVVVVVVVVVVVVVVVVVVVVVVV1QAAgFVVVZUAAAAAAAAAAAAA' +
+	'AAAAAOBVVVVVVVVVVVVVVVVVVVVVVVXVAACAV1VVlQAAAAAAAAAAAAAAAAAAYFVVVVVVVVVVVVVVVVVVVVVVVdUAAABeVVWV' +
+	'AAAAAAAAAAAAAAAAAABgVVVVVVVVVVVVVVVVVVVVVVVV1QAAAHhVVbUAAAAAAAAAAAAAAAAAAGBVVVVVVVVVVVVVVVVVVVVV' +
+	'VVXVAgAAcFVVNQAAAAAAAAAAAAAAAAAAYFVVVVVVVVVVVVVVVVVVVVVVVVUCAADgVVU1AAAAAAAAAAAAAAAAAABgVVVVVVVV' +
+	'VVVVVVVVVVVVVVVVVQsAAMBVVSUAAAAAAAAAAAAAAAAAAHBVVVVVVVVVVVVVVVVVVVVVVVVVLQAAgFVVJQAAAAAAAAAAAAAA' +
+	'AAAAcFVVVVVVVVVVVVVVVVVVVVVVVVW1AACAV1UlAAAAAAAAAAAAAAAAAABwVVVVVVVVVVVVVVVVVVVVVVVVVdUCAABWVS0A' +
+	'AAAAAAAAAAAAAAAAAHBVVVVVVVVVVVVVVVVVVVVVVVVVVQsAAF5VDQAAAAAAAAAAAAAAAAAAeFVVVVVVVVVVVVVVVVVVVVVV' +
+	'VVVVLQAAWFUPAAAAAAAAAAAAAAAAAABYVVVVVVVVVVVVVVVVVVVVVVVVVVX1AgB4rwIAAAAAAAAAAAAAAAAAAFhVVVVVVVVV' +
+	'VVVVVVVVVVVVVVVVVVUCAKACAAAAAAAAAAAAAAAAAAAAWFVVVVVVVVVVVVVVVVVVVVVVVVVVVQsAAAAAAAAAAAAAAAAAAAAA' +
+	'AABcVVVVVVVVVVVVVVVVVVVVVVVVVVVVLQAAAAAAAAAAAAAAAAAAAAAAAFxVVVVVVVVVVVVVVVVVVVVVVVVVVVW1AAAAAAAA' +
+	'AAAAAAAAAAAAAAAAXlVVVVVVVVVVVVVVVVVVVVVVVVVVVdUAAAAAAAAAAAAAAAAAAAAAAABWVVVVVVVVVVVVVVVVVVVVVVVV' +
+	'VVVV1QIAAAAAAAAAAAAAAAAAAAAAAF5VVVVVVVVVVVVVVVVVVVVVVVVVVVVVCwAAAAAAAAAAAAAAAAAAAAAA+FVVVVVVVVVV' +
+	'VVVVVVVVVVVVVVVVVVW9AAAAAAAAAAAAAAAAAAAAAACAXlVVVVVVVVVVVVVVVVVVVVVVVVVVVdUKAAAAAAAAAAAAAAAAAAAA' +
+	'AADo1V5VVVVVVVVVVVVVVVVVVVVVVVVVVa0AAAAAAAAAAAAAAAAAAAAAAIC3eFVVVVVVVVVVVVVVVVVVVVVVVVVV1QIAAAAA' +
+	'AAAAAAAAAAAAAAAAACpwVVVVVVVVVVVVVVVVVVVVVVVVVVVVCwAAAAAAAAAAAAAAAAAAAAAAAGBVVVVVVVVVVVVVVVVVVVVV' +
+	'VVVVVVUNAAAAAAAAAAAAAAAAAAAAAAAA4FVVVVVVVVVVVVVVVVVVVVVVVVVVVS0AAAAAAAAAAAAAAAAAAAAAAADAVVVVVVVV' +
+	'VVVVVVVVVVVVVVVVVVVVtQAAAAAAAAAAAAAAAAAAAAAAAMBVVVVVVVVVVVVVVVVVVVVVVVVVVVXVAgAAAAAAAAAAAAAAAAAA' +
+	'AAAAwFVVVVVVVVVVVVVVVVVVVVVVVVVVVVUCAAAAAAAAAAAAAAAAAAAAAADAVVVVVVVVVVVVVVVVVVVVVVVVVVVVVQsAAAAA' +
+	'AAAAAAAAAAAAAAAAAMBVVVVVVVVVVVVVVVVVVVVVVVVVVVVVLQAAAAAAAAAAAAAAAAAAAAAAwFVVVVVVVVVVVVVVVVVVVVVV' +
+	'VVVVVVU1AAAAAAAAAAAAAAAAAAAAAADAVVVVVVVVVVVVVVVVVVVVVVVVVVVVVTUAAAAAAAAAAAAAAAAAAAAAAIBVVVVVVVVV' +
+	'VVVVVVVVVVVVVVVVVVVVLQAAAAAAAAAAAAAAAAAAAAAAgFVVVVVVVVVVVVVVVVVVVVVVVVVVVVUJAAAAAAAAAAAAAAAAAAAA' +
+	'AACAV1VVVVVVVVVVVVVVVVVVVVVVVVVVVQsAAAAAAAAAAAAAAAAAAAAAAABeVVVVVVVVVVVVVVVVVVVVVVVVVVXVAgAAAAAA' +
+	'AAAAAAAAAAAAAAAAAHhVVVVVVVVVVVVVVVVVVVVVVVVVVdUAAAAAAAAAAAAAAAAAAAAAAAAA4FVVVVVVVVVVVVVVVVVVVVVV' +
+	'VVVVtQAAAAAAAAAAAAAAAAAAAAAAAACAV1VVVVVVVVVVVVVVVVVVVVVVVVU1AAAAAAAAAAAAAAAAAAAAAAAAAABeVVVVVVVV' +
+	'VVVVVVVVVVVVVVVVVS0AAAAAAAAAAAAAAAAAAAAAAAAAAHhVVVVVVVVVVVVVVVVVVVVVVVVVCQAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAA4FVVVVVVVVVVVVVVVVVVVVVVVVULAAAAAAAAAAAAAAAAAAAAAAAAAADAVVVVVVVVVVVVVVVVVVVVVVVV1QIAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAIBVVVVVVVVVVVVVVVVVVVVVVVXVAAAAAAAAAAAAAAAAAAAAAAAAAAAAgFdVVVVVVVVVVVVVVVVVVVVV' +
+	'VZUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAV1VVVVVVVVVVVVVVVVVVVVVVtQAAAAAAAAAAAAAAAAAAAAAAAAAAAABXVVVVVVVV' +
+	'VVVVVVVVVVVVVVU1AAAAAAAAAAAAAAAAAAAAAAAAAAAAAFZVVVVVVVVVVVVVVVVVVVVVVSUAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAVlVVVVVVVVVVVVVVVVVVVVVVLQAAAAAAAAAAAAAAAAAAAAAAAAAAAABWVVVVVVVVVVVVVVVVVVVVVVUNAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAFZVVVVVVVVVVVVVVVVVVVVVVQkAAAAAAAAAAAAAAAAAAAAAAAAAAAAAVlVVVVVVVVVVVVVVVVVVVVVV' +
+	'CwAAAAAAAAAAAAAAAAAAAAAAAAAAAABWVVVVVVVVVVVVVVVVVVVVVVUDAAAAAAAAAAAAAAAAAAAAAAAAAAAAAFZVVVVVVVVV' +
+	'VVVVVVVVVVVVVQIAAAAAAAAAAAAAAAAAAAAAAAAAAAAAVlVVVVVVVVVVVVVVVVVVVVVVAgAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AABWVVVVVVVVVVVVVVVVVVVVVdUCAAAAAAAAAAAAAAAAAAAAAAAAAAAAAFZVVVVVVVVVVVVVVVVVVVVVvQAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAXlVVVVVVVVVVVVVVVVVVVdUKAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABcVVVVVVVVVVVVVVVVVVVVrQAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAFxVVVVVVVVVVVVVVVVVVfUKAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAXFVVVVVVVVVV' +
+	'VVVVVVVVLwAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABYVVVVVVVVVVVVVVVVVVUCAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AFhVVVVVVVVVVVVVVVVV1QIAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAeFVVVVVVVVVVVVVVVVXVAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAABwVVVVVVVVVVVVVVVVVZUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAHBVVVVVVVVVVVVVVVVVtQAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAcFVVVVVVVVVVVVVVVVU1AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABwVVVVVVVVVVVV' +
+	'VVVVVS0AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAGBVVVVVVVVVVVVVVVVVDQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'YFVVVVVVVVVVVVVVVVUJAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABgVVVVVVVVVVVVVVVVVQsAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAGBVVVVVVVVVVVVVVVVVAwAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAYFVVVVVVVVVVVVVVVVUDAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAABwVVVVVVVVVVVVVVVVVQMAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAHBVVVVVVVVVVVVV' +
+	'VVVVAwAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAcFVVVVVVVVVVVVVVVVUDAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAB4' +
+	'VVVVVVVVVVVVVVVVVQMAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAFxVVVVVVVVVVVVVVVVVCwAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAXlVVVVVVVVVVVVVVVVUJAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABWVVVVVVVVVVVVVVVVVQkAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAgFdVVVVVVVVVVVVVVVVVCQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAACAVVVVVVVVVVVVVVVV' +
+	'VVUJAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAMBVVVVVVVVVVVVVVVVVVQkAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA4FVV' +
+	'VVVVVVVVVVVVVVVVCQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABgVVVVVVVVVVVVVVVVVVUJAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAHBVVVVVVVVVVVVVVVVVVQkAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAcFVVVVVVVVVVVVVVVVVVCQAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAABwVVVVVVVVVVVVVVVVVVUJAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAGBVVVVVVVVVVVVVVVVV' +
+	'VQ0AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAYFVVVVVVVVVVVVVVVVVVDQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAADgVVVV' +
+	'VVVVVVVVVVVVVVUNAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAMBVVVVVVVVVVVVVVVVVVS0AAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAwFVVVVVVVVVVVVVVVVVVJQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAADAVVVVVVVVVVVVVVVVVVU1AAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAMBVVVVVVVVVVVVVVVVVVbUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA4FVVVVVVVVVVVVVVVVVV' +
+	'1QAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABgVVVVVVVVVVVVVVVVVVXVAgAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAGBVVVVV' +
+	'VVVVVVVVVVVVVVUCAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAcFVVVVVVVVVVVVVVVVVVVQMAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAABwVVVVVVVVVVVVVVVVVVVVCwAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAHBVVVVVVVVVVVVVVVVVVVUtAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAcFVVVVVVVVVVVVVVVVVVVTUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABwVVVVVVVVVVVVVVVVVVVV' +
+	'tQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAHBVVVVVVVVVVVVVVVVVVVXVAgAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAcFVVVVVV' +
+	'VVVVVVVVVVVVVVUDAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABwVVVVVVVVVVVVVVVVVVVVVQsAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAHBVVVVVVVVVVVVVVVVVVVVVLQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAcFVVVVVVVVVVVVVVVVVVVVU1AAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAABwVVVVVVVVVVVVVVVVVVVVVbUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAGBVVVVVVVVVVVVVVVVVVVVV' +
+	'1QAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAYFVVVVVVVVVVVVVVVVVVVVXVAgAAAAAAAAAAAAAAAAAAAAAAAAAAAADgVVVVVVVV' +
+	'VVVVVVVVVVVVVVUDAAAAAAAAAAAAAAAAAAAAAAAAAAAAAMBVVVVVVVVVVVVVVVVVVVVVVQsAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAwFVVVVVVVVVVVVVVVVVVVVVVDQAAAAAAAAAAAAAAAAAAAAAAAAAAAADgVVVVVVVVVVVVVVVVVVVVVVUtAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAGBVVVVVVVVVVVVVVVVVVVVVVTUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAcFVVVVVVVVVVVVVVVVVVVVVV' +
+	'9QIAAAAAAAAAAAAAAAAAAAAAAAAAAABwVVVVVVVVVVVVVVVVVVVVVVVVLwAAAAAAAAAAAAAAAAAAAAAAAAAAAHBVVVVVVVVV' +
+	'VVVVVVVVVVVVVVX1CgAAAAAAAAAAAAAAAAAAAAAAAAAAcFVVVVVVVVVVVVVVVVVVVVVVVVWtAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AABwVVVVVVVVVVVVVVVVVVVVVVVVVdUrAAAAAAAAAAAAAAAAAAAAAAAAAOBVVVVVVVVVVVVVVVVVVVVVVVVVVfWrAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAgFVVVVVVVVVVVVVVVVVVVVVVVVVVVZUAAAAAAAAAAAAAAAAAAAAAAACAV1VVVVVVVVVVVVVVVVVVVVVV' +
+	'VVVVlQAAAAAAAAAAAAAAAAAAAAAAAABeVVVVVVVVVVVVVVVVVVVVVVVVVVXVAAAAAAAAAAAAAAAAAAAAAAAAAFhVVVVVVVVV' +
+	'VVVVVVVVVVVVVVVVVdUCAAAAAAAAAAAAAAAAAAAAAAAAeFVVVVVVVVVVVVVVVVVVVVVVVVVVVQIAAAAAAAAAAAAAAAAAAAAA' +
+	'AADgVVVVVVVVVVVVVVVVVVVVVVVVVVVVAgAAAAAAAAAAAAAAAAAAAAAAAMBXVVVVVVVVVVVVVVVVVVVVVVVVVVUDAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAF5VVVVVVVVVVVVVVVVVVVVVVVVVVQMAAAAAAAAAAAAAAAAAAAAAAAAA6FVVVVVVVVVVVVVVVVVVVVVV' +
+	'VVVVCwAAAAAAAAAAAAAAAAAAAAAAAACAX1VVVVVVVVVVVVVVVVVVVVVVVVUJAAAAAAAAAAAAAAAAAAAAAAAAAAB4VVVVVVVV' +
+	'VVVVVVVVVVVVVVVVVQkAAAAAAAAAAAAAAAAAAAAAAAAAAOBVVVVVVVVVVVVVVVVVVVVVVVVVCQAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAgFdVVVVVVVVVVVVVVVVVVVVVVVUNAAAAAAAAAAAAAAAAAAAAAAAAAAAAXlVVVVVVVVVVVVVVVVVVVVVVVQ0AAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAB4VVVVVVVVVVVVVVVVVVVVVVVVLQAAAAAAAAAAAAAAAAAAAAAAAAAAAOBVVVVVVVVVVVVVVVVVVVVV' +
+	'VVUlAAAAAAAAAAAAAAAAAAAAAAAAAAAAgFdVVVVVVVVVVVVVVVVVVVVVVSUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAXlVVVVVV' +
+	'VVVVVVVVVVVVVVVVNQAAAAAAAAAAAAAAAAAAAAAAAAAAAABYVVVVVVVVVVVVVVVVVVVVVVW1AAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAHhVVVVVVVVVVVVVVVVVVVVVVZUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAcFVVVVVVVVVVVVVVVVVVVVVVlQAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAABwVVVVVVVVVVVVVVVVVVVVVVXVAAAAAAAAAAAAAAAAAAAAAAAAAAAAAGBVVVVVVVVVVVVVVVVVVVVV' +
+	'VdUCAAAAAAAAAAAAAAAAAAAAAAAAAAAAYFVVVVVVVVVVVVVVVVVVVVVVVQIAAAAAAAAAAAAAAAAAAAAAAAAAAADgVVVVVVVV' +
+	'VVVVVVVVVVVVVVVVAwAAAAAAAAAAAAAAAAAAAAAAAAAAAMBVVVVVVVVVVVVVVVVVVVVVVVULAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAgFVVVVVVVVVVVVVVVVVVVVVVVQkAAAAAAAAAAAAAAAAAAAAAAAAAAACAVVVVVVVVVVVVVVVVVVVVVVVVDQAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAIBXVVVVVVVVVVVVVVVVVVVVVVUtAAAAAAAAAAAAAAAAAAAAAAAAAAAAAFdVVVVVVVVVVVVVVVVVVVVV' +
+	'VSUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAVlVVVVVVVVVVVVVVVVVVVVVVJQAAAAAAAAAAAAAAAAAAAAAAAAAAAABeVVVVVVVV' +
+	'VVVVVVVVVVVVVVUlAAAAAAAAAAAAAAAAAAAAAAAAAAAAAFxVVVVVVVVVVVVVVVVVVVVVVS0AAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAWFVVVVVVVVVVVVVVVVVVVVVVDQAAAAAAAAAAAAAAAAAAAAAAAAAAAAB4VVVVVVVVVVVVVVVVVVVVVVUNAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAHBVVVVVVVVVVVVVVVVVVVVVVQ0AAAAAAAAAAAAAAAAAAAAAAAAAAAAAcFVVVVVVVVVVVVVVVVVVVVVV' +
+	'DQAAAAAAAAAAAAAAAAAAAAAAAAAAAABgVVVVVVVVVVVVVVVVVVVVVVUNAAAAAAAAAAAAAAAAAAAAAAAAAAAAAOBVVVVVVVVV' +
+	'VVVVVVVVVVVVVS0AAAAAAAAAAAAAAAAAAAAAAAAAAAAAwFVVVVVVVVVVVVVVVVVVVVVVtQIAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AADAVVVVVVVVVVVVVVVVVVVVVVVVCwAAAAAAAAAAAAAAAAAAAAAAAAAAAMBVVVVVVVVVVVVVVVVVVVVVVVW9AAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAwFVVVVVVVVVVVVVVVVVVVVVVVdULAAAAAAAAAAAAAAAAAAAAAAAAAADAVVVVVVVVVVVVVVVVVVVVVVVV' +
+	'Vb0AAAAAAAAAAAAAAAAAAAAAAAAAAMBVVVVVVVVVVVVVVVVVVVVVVVVV1QsAAAAAAAAAAAAAAAAAAAAAAAAAwFVVVVVVVVVV' +
+	'VVVVVVVVVVVVVVVVrQAAAAAAAAAAAAAAAAAAAAAAAADAVVVVVVVVVVVVVVVVVVVVVVVVVVXVAgAAAAAAAAAAAAAAAAAAAAAA' +
+	'AMBVVVVVVVVVVVVVVVVVVVVVVVVVVVUrAAAAAAAAAAAAAAAAAAAAAAAAgFVVVVVVVVVVVVVVVVVVVVVVVVVVVbUAAAAAAAAA' +
+	'AAAAAAAAAAAAAACAVVVVVVVVVVVVVVVVVVVVVVVVVVVV1QAAAAAAAAAAAAAAAAAAAAAAAIBVVVVVVVVVVVVVVVVVVVVVVVVV' +
+	'VVXVAAAAAAAAAAAAAAAAAAAAAAAAgFVVVVVVVVVVVVVVVVVVVVVVVVVVVdUAAAAAAAAAAAAAAAAAAAAAAACAV1VVVVVVVVVV' +
+	'VVVVVVVVVVVVVVVV1QAAAAAAAAAAAAAAAAAAAAAAAABXVVVVVVVVVVVVVVVVVVVVVVVVVVXVAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AFdVVVVVVVVVVVVVVVVVVVVVVVVVVdUAAAAAAAAAAAAAAAAAAAAAAAAAVlVVVVVVVVVVVVVVVVVVVVVVVVVVtQAAAAAAAAAA' +
+	'AAAAAAAAAAAAAABeVVVVVVVVVVVVVVVVVVVVVVVVVVU1AAAAAAAAAAAAAAAAAAAAAAAAAFhVVVVVVVVVVVVVVVVVVVVVVVVV' +
+	'VS0AAAAAAAAAAAAAAAAAAAAAAAAAeFVVVVVVVVVVVVVVVVVVVVVVVVVVDQAAAAAAAAAAAAAAAAAAAAAAAADgVVVVVVVVVVVV' +
+	'VVVVVVVVVVVVVVULAAAAAAAAAAAAAAAAAAAAAAAAAMBVVVVVVVVVVVVVVVVVVVVVVVVVVQMAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'gFdVVVVVVVVVVVVVVVVVVVVVVVVVAgAAAAAAAAAAAAAAAAAAAAAAAAAAVlVVVVVVVVVVVVVVVVVVVVVVVdUCAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAABeVVVVVVVVVVVVVVVVVVVVVVVVlQAAAAAAAAAAAAAAAAAAAAAAAAAAAHhVVVVVVVVVVVVVVVVVVVVVVVW1' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAA4FVVVVVVVVVVVVVVVVVVVVVVVS0AAAAAAAAAAAAAAAAAAAAAAAAAAACAV1VVVVVVVVVV' +
+	'VVVVVVVVVVVVDQAAAAAAAAAAAAAAAAAAAAAAAAAAAABXVVVVVVVVVVVVVVVVVVVVVVUJAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AF5VVVVVVVVVVVVVVVVVVVVVVQkAAAAAAAAAAAAAAAAAAAAAAAAAAAAAeFVVVVVVVVVVVVVVVVVVVVVVCQAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAABwVVVVVVVVVVVVVVVVVVVVVVUJAAAAAAAAAAAAAAAAAAAAAAAAAAAAAOBVVVVVVVVVVVVVVVVVVVVVVQ0A' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAgFdVVVVVVVVVVVVVVVVVVVVVLQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAV1VVVVVVVVVV' +
+	'VVVVVVVVVVUlAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABeVVVVVVVVVVVVVVVVVVVVVSUAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AFhVVVVVVVVVVVVVVVVVVVVVNQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAeFVVVVVVVVVVVVVVVVVVVVUlAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAADgVVVVVVVVVVVVVVVVVVVVVS0AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAMBVVVVVVVVVVVVVVVVVVVVVCwAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAgFdVVVVVVVVVVVVVVVVVVVUDAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAV1VVVVVVVVVV' +
+	'VVVVVVVV1QIAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAABXVVVVVVVVVVVVVVVVVVWVAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AFZVVVVVVVVVVVVVVVVVVbUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAXlVVVVVVVVVVVVVVVVVVJQAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAABcVVVVVVVVVVVVVVVVVVUtAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAFxVVVVVVVVVVVVVVVVVVQ0AAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAWFVVVVVVVVVVVVVVVVVVCwAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAB4VVVVVVVVVVVV' +
+	'VVVVVVUDAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAGBVVVVVVVVVVVVVVVVVVQMAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'4FVVVVVVVVVVVVVVVVVVAwAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAACAV1VVVVVVVVVVVVVVVVUDAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAABXVVVVVVVVVVVVVVVVVQMAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAF5VVVVVVVVVVVVVVVVVAwAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAXFVVVVVVVVVVVVVVVVUDAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAB4VVVVVVVVVVVV' +
+	'VVVVVQIAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAGBVVVVVVVVVVVVVVVVVAgAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'4FVVVVVVVVVVVVVVVVUCAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAACAV1VVVVVVVVVVVVVVVQIAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAABWVVVVVVVVVVVVVVVVAgAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAF5VVVVVVVVVVVVVVdUCAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAeFVVVVVVVVVVVVVV1QAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAADgVVVVVVVVVVVV' +
+	'VVXVAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAIBXVVVVVVVVVVVVVbUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AFdVVVVVVVVVVVVVLQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAVlVVVVVVVVVVVVUNAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAABeVVVVVVVVVVVVVQsAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAFxVVVVVVVVVVVXVAgAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAWFVVVVVVVVVVVbUAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAB4VVVVVVVVVVVV' +
+	'KwAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAOBVVVVVVVVVVdUCAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'gF9VVVVVVVVVrQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAqH9VVVVVVdUKAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAA4FVVVVVVrwAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAACAV1VVVfUCAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAABeVVVVLwAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAHhVVfUCAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAYFVVLQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AADgVVUJAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAIBXVQsAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAF7VAgAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAeLUAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAADgLQAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAIALAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAIAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA' +
+	'AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA';
+
+/**
+ * Boundary edges as northing, easting of the start and end point, metres
+ */
+const TERRITORY_EDGES: readonly number[] = [
+	6557156, 286396, 6553318, 295374, 6553318, 295374, 6545168, 301846, 6545168, 301846, 6553691, 309751, 6553691, 309751, 6572354, 315823,
+	6572354, 315823, 6594691, 315203, 6594691, 315203, 6616781, 319675, 6616781, 319675, 6634924, 337401, 6634924, 337401, 6643400, 347855,
+	6643400, 347855, 6659718, 358005, 6659718, 358005, 6687337, 364605, 6687337, 364605, 6720837, 363111, 6720837, 363111, 6765165, 370214,
+	6765165, 370214, 6798468, 374118, 6798468, 374118, 6826499, 369809, 6826499, 369809, 6854856, 357684, 6854856, 357684, 6877458, 350759,
+	6877458, 350759, 6910632, 357412, 6910632, 357412, 6944369, 351138, 6944369, 351138, 6977884, 350103, 6977884, 350103, 7011056, 356664,
+	7011056, 356664, 7024643, 352252, 7024643, 352252, 7044799, 350688, 7044799, 350688, 7088275, 377307, 7088275, 377307, 7109397, 412282,
+	7109397, 412282, 7147578, 449472, 7147578, 449472, 7186469, 457243, 7186469, 457243, 7219782, 467114, 7219782, 467114, 7253127, 476775,
+	7253127, 476775, 7292136, 477085, 7292136, 477085, 7331114, 481917, 7331114, 481917, 7370073, 504459, 7370073, 504459, 7398065, 526483,
+	7398065, 526483, 7431804, 547961, 7431804, 547961, 7454358, 560537, 7454358, 560537, 7488002, 568322, 7488002, 568322, 7510652, 580446,
+	7510652, 580446, 7544813, 600310, 7544813, 600310, 7567987, 620150, 7567987, 620150, 7594069, 628370, 7594069, 628370, 7609360, 642708,
+	7609360, 642708, 7615878, 674975, 7615878, 674975, 7645666, 699136, 7645666, 699136, 7671064, 721105, 7671064, 721105, 7654596, 736727,
+	7654596, 736727, 7633991, 755015, 7633991, 755015, 7620193, 783123, 7620193, 783123, 7610539, 806116, 7610539, 806116, 7597452, 827275,
+	7597452, 827275, 7582757, 843859, 7582757, 843859, 7562345, 859324, 7562345, 859324, 7523345, 862633, 7523345, 862633, 7489750, 864249,
+	7489750, 864249, 7458008, 879191, 7458008, 879191, 7435241, 893531, 7435241, 893531, 7402594, 886100, 7402594, 886100, 7390305, 886920,
+	7390305, 886920, 7365154, 900477, 7365154, 900477, 7349218, 907352, 7349218, 907352, 7331350, 916412, 7331350, 916412, 7324852, 918293,
+	7324852, 918293, 7300137, 919117, 7300137, 919117, 7278427, 884655, 7278427, 884655, 7249174, 829426, 7249174, 829426, 7198741, 830282,
+	7198741, 830282, 7140726, 812250, 7140726, 812250, 7095109, 804516, 7095109, 804516, 7055067, 795896, 7055067, 795896, 7046257, 759117,
+	7046257, 759117, 7026242, 715447, 7026242, 715447, 6985864, 695260, 6985864, 695260, 6939532, 664529, 6939532, 664529, 6899723, 648261,
+	6899723, 648261, 6849400, 645186, 6849400, 645186, 6799193, 644624, 6799193, 644624, 6749808, 662983, 6749808, 662983, 6724898, 718966,
+	6724898, 718966, 6691970, 728172, 6691970, 728172, 6659207, 739731, 6659207, 739731, 6632343, 755568, 6632343, 755568, 6600188, 774840,
+	6600188, 774840, 6553195, 740848, 6553195, 740848, 6534498, 707364, 6534498, 707364, 6499674, 680123, 6499674, 680123, 6464618, 640655,
+	6464618, 640655, 6408766, 636693, 6408766, 636693, 6364459, 644209, 6364459, 644209, 6308410, 633990, 6308410, 633990, 6252306, 620349,
+	6252306, 620349, 6201278, 581180, 6201278, 581180, 6178478, 543938, 6178478, 543938, 6183839, 487462, 6183839, 487462, 6128314, 465080,
+	6128314, 465080, 6117340, 449081, 6117340, 449081, 6112510, 404409, 6112510, 404409, 6118872, 372709, 6118872, 372709, 6130757, 348908,
+	6130757, 348908, 6147232, 355802, 6147232, 355802, 6163640, 365169, 6163640, 365169, 6177070, 363069, 6177070, 363069, 6197446, 353073,
+	6197446, 353073, 6213012, 353914, 6213012, 353914, 6222030, 350798, 6222030, 350798, 6232494, 338745, 6232494, 338745, 6248811, 320801,
+	6248811, 320801, 6288013, 316326, 6288013, 316326, 6327645, 302877, 6327645, 302877, 6361921, 286431, 6361921, 286431, 6407561, 267947,
+	6407561, 267947, 6441807, 255133, 6441807, 255133, 6481094, 251696, 6481094, 251696, 6520576, 245495, 6520576, 245495, 6534110, 243494,
+	6534110, 243494, 6540032, 255437, 6540032, 255437, 6543766, 267207, 6543766, 267207, 6548815, 276147, 6548815, 276147, 6557156, 286396,
+	6354128, 665684, 6299005, 680135, 6299005, 680135, 6289157, 708153, 6289157, 708153, 6324502, 742911, 6324502, 742911, 6371266, 776311,
+	6371266, 776311, 6432819, 778064, 6432819, 778064, 6493558, 767971, 6493558, 767971, 6502441, 732383, 6502441, 732383, 6456628, 711543,
+	6456628, 711543, 6410395, 678280, 6410395, 678280, 6354128, 665684
+];
+
+/**
+ * Edges crossing each border cell, border cells in cell order
+ * Border cell b has the edges TERRITORY_BORDER_EDGES[TERRITORY_BORDER_EDGE_STARTS[b]] up to
+ * TERRITORY_BORDER_EDGES[TERRITORY_BORDER_EDGE_STARTS[b + 1] - 1].
+ */
+const TERRITORY_BORDER_EDGE_STARTS: readonly number[] = [
+	0, 1, 2, 4, 5, 6, 7, 8, 9, 11, 12, 13, 14, 15, 16, 17,
+	18, 19, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 34, 36,
+	38, 39, 40, 41, 42, 43, 44, 45, 47, 48, 49, 50, 51, 52, 53, 54,
+	56, 58, 59, 60, 61, 62, 63, 64, 66, 67, 68, 69, 70, 71, 73, 74,
+	75, 76, 78, 79, 80, 81, 82, 83, 84, 85, 86, 87, 88, 89, 90, 91,
+	92, 93, 94, 95, 96, 97, 99, 100, 101, 102, 103, 105, 106, 107, 108, 110,
+	111, 112, 113, 114, 115, 116, 118, 119, 120, 121, 122, 123, 125, 126, 127, 128,
+	129, 130, 131, 132, 133, 134, 135, 136, 138, 139, 140, 141, 142, 144, 145, 146,
+	147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 160, 161, 163, 164,
+	165, 166, 167, 168, 169, 170, 172, 173, 174, 175, 176, 178, 179, 180, 181, 182,
+	183, 184, 185, 186, 187, 188, 189, 191, 192, 193, 194, 195, 196, 197, 198, 199,
+	200, 201, 202, 203, 204, 205, 206, 207, 208, 209, 210, 211, 213, 215, 216, 217,
+	218, 219, 220, 221, 222, 223, 224, 225, 226, 227, 228, 229, 230, 231, 232, 233,
+	234, 235, 236, 237, 238, 239, 240, 241, 242, 243, 244, 245, 247, 248, 249, 250,
+	251, 252, 253, 255, 257, 258, 259, 260, 261, 262, 263, 264, 265, 266, 267, 268,
+	269, 270, 272, 273, 274, 275, 276, 277, 278, 279, 280, 281, 282, 283, 284, 285,
+	286, 287, 288, 289, 290, 291, 292, 293, 294, 295, 296, 297, 298, 299, 300, 301,
+	303, 305, 306, 307, 308, 309, 311, 312, 313, 314, 315, 316, 317, 318, 319, 320,
+	321, 322, 323, 324, 325, 326, 327, 328, 329, 330, 331, 332, 333, 335, 336, 337,
+	338, 339, 340, 342, 343, 344, 345, 346, 347, 348, 349, 350, 351, 352, 353, 354,
+	355, 356, 357, 358, 359, 360, 362, 363, 364, 366, 367, 368, 369, 370, 371, 372,
+	373, 374, 375, 376, 377, 378, 379, 380, 381, 382, 383, 384, 385, 387, 388, 389,
+	390, 391, 392, 393, 394, 395, 396, 397, 398, 399, 400, 401, 402, 403, 404, 406,
+	407, 408, 409, 411, 412, 413, 414, 415, 416, 417, 418, 419, 420, 422, 423, 424,
+	425, 426, 427, 428, 429, 430, 431, 432, 433, 434, 436, 437, 438, 439, 440, 442,
+	443, 444, 446, 447, 448, 449, 450, 451, 452, 454, 455, 457, 458, 459, 460, 461,
+	462, 464, 465, 467, 468, 469, 470, 471, 472, 473, 474, 476, 478, 479, 480, 482,
+	483, 485, 486, 487, 488, 489, 490, 491, 492, 493, 494, 495, 497, 498, 499, 500,
+	501, 502, 503, 504, 505, 506, 507, 509, 510, 511, 512, 513, 514, 516, 517, 518,
+	519, 520, 521, 523, 524, 525, 526, 527, 528, 529, 530, 531, 532, 533, 534, 536,
+	537, 539, 540, 541, 542, 543, 545, 546, 547, 548, 549, 550, 551, 552, 553, 554,
+	556, 558, 559, 560, 561, 562, 563, 564, 565, 566, 567, 568, 569, 570, 571, 573,
+	574, 575, 576, 578, 579, 580, 581, 582, 583, 584, 585, 586, 587, 588, 589, 591,
+	593, 594, 595, 596, 597, 598, 599, 600, 601, 602, 603, 604, 605, 606, 607, 608,
+	609, 610, 611, 612, 613, 615, 616, 617, 618, 619, 620, 621, 622, 623, 624, 625,
+	627, 628, 629, 630, 631, 632, 633, 634, 635, 636, 637, 638, 639, 640, 642, 644,
+	645, 646, 647, 648, 649, 650, 651, 652, 653, 654, 655, 657, 658, 659, 660, 661,
+	662, 663, 664, 665, 666, 667, 668, 669, 671, 673, 674, 675, 676, 677, 678, 679,
+	680, 681, 682, 683, 685, 686, 687, 688, 689, 690, 691, 692, 693, 694, 696, 697,
+	698, 699, 700, 701, 703, 704, 705, 706, 707, 708, 709, 710, 711, 712, 713, 714,
+	715, 716, 718, 720, 721, 722, 723, 724, 725, 726, 727, 728, 729, 730, 731, 732,
+	733, 734, 735, 736, 737, 738, 740, 741, 742, 743, 744, 745, 746, 748, 749, 750,
+	751, 752, 753, 754, 755, 756, 757, 758, 759, 761, 762, 763, 764, 765, 766, 768,
+	769, 770, 771, 773, 774, 775, 776, 777, 778, 779, 780, 781, 782, 783, 785, 786,
+	787, 788, 789, 791, 792, 793, 794, 795, 796, 797, 798, 799, 800, 801, 802, 803,
+	805, 806, 807, 808, 809, 810, 811, 812, 813, 814, 815, 816, 817, 818, 819, 820,
+	822, 823, 824, 825, 826, 827, 828, 829, 830, 832, 833, 834, 835, 836, 837, 838,
+	840, 841, 842, 843, 844, 845, 846, 847, 848, 849, 850, 851, 852, 853, 854, 855,
+	856, 857, 858, 859, 860, 861, 862, 864, 866, 867, 868, 869, 870, 871, 872, 873,
+	874, 875, 876, 877, 878, 879, 880, 881, 882, 883, 884, 885, 886, 888, 889, 890,
+	891, 892, 893, 894, 896, 897, 898, 899, 900, 901, 902, 903, 905, 906, 907, 908,
+	909, 910, 911, 912, 913, 914, 915, 916, 917, 918, 919, 920, 922, 923, 925, 926,
+	927, 928, 929, 930, 931, 932, 933, 934, 935, 936, 937, 938, 939, 940, 941, 942,
+	943, 944, 945, 947, 948, 949, 950, 951, 952, 953, 954, 955, 957, 958, 959, 960,
+	961, 962, 963, 964, 966, 967, 968, 969, 970, 971, 972, 973, 974, 976, 977, 978,
+	980, 981, 983, 984, 985, 986, 987, 988, 989, 990, 991, 993, 994, 995, 996, 997,
+	998, 999, 1000, 1001, 1002, 1003, 1004, 1006, 1008, 1009, 1010, 1011, 1012, 1013, 1014, 1015,
+	1016, 1017, 1018, 1019, 1020, 1021, 1022, 1024, 1025, 1027, 1028, 1029, 1030, 1032, 1033, 1034,
+	1035, 1036, 1037, 1038, 1039, 1040, 1041, 1042, 1043, 1044, 1045, 1046, 1048, 1049, 1050, 1051,
+	1053, 1054, 1055, 1056, 1057, 1058, 1059, 1060, 1061, 1063, 1064, 1065, 1067, 1068, 1069, 1070,
+	1071, 1072, 1073, 1074, 1075, 1076, 1077, 1078, 1079, 1080, 1081, 1083, 1085, 1086, 1087, 1088,
+	1089, 1090, 1091, 1092, 1093, 1094, 1095, 1096, 1097, 1099, 1100, 1101, 1102, 1103, 1104, 1106,
+	1107, 1108, 1109, 1110, 1111, 1112, 1113, 1114, 1115, 1117, 1118, 1119, 1120, 1121, 1122, 1123,
+	1124, 1125, 1126, 1127, 1128, 1129, 1131, 1132, 1134, 1135, 1136, 1137, 1138, 1139, 1140, 1141,
+	1142, 1143, 1145, 1146, 1147, 1148, 1149, 1151, 1152, 1153, 1154, 1155, 1156, 1158, 1159, 1160,
+	1161, 1162, 1163, 1164, 1166, 1167, 1168, 1169, 1170, 1171, 1172, 1173, 1174, 1175, 1176, 1177,
+	1178, 1180, 1182, 1183, 1184, 1185, 1186, 1187, 1188, 1189, 1190, 1191, 1193, 1194, 1195, 1196,
+	1197, 1198, 1199, 1200, 1201, 1203, 1204, 1205, 1206, 1207, 1208, 1209, 1210, 1212, 1213, 1214,
+	1215, 1216, 1217, 1219, 1220, 1221, 1222, 1223, 1224, 1225, 1226, 1227, 1228, 1229, 1231, 1232,
+	1234
+];
+
+const TERRITORY_BORDER_EDGES: readonly number[] = [
+	94, 94, 93, 94, 93, 93, 93, 93, 93, 94, 95, 94, 94, 94, 94, 93,
+	93, 93, 93, 92, 93, 92, 95, 95, 95, 92, 92, 92, 95, 95, 95, 92,
+	91, 92, 95, 96, 95, 96, 91, 96, 91, 96, 91, 91, 96, 96, 97, 91,
+	97, 97, 91, 91, 97, 91, 97, 98, 97, 98, 91, 98, 91, 91, 98, 91,
+	98, 99, 91, 91, 90, 90, 90, 89, 90, 89, 99, 99, 90, 91, 90, 90,
+	90, 90, 90, 90, 90, 90, 89, 89, 99, 89, 89, 89, 99, 99, 89, 89,
+	89, 99, 100, 89, 89, 100, 89, 88, 89, 100, 88, 88, 100, 101, 88, 88,
+	101, 88, 88, 102, 101, 102, 88, 102, 102, 88, 88, 102, 103, 102, 88, 88,
+	103, 103, 88, 88, 103, 103, 103, 88, 103, 104, 88, 88, 104, 88, 87, 88,
+	104, 104, 87, 104, 87, 104, 87, 104, 87, 87, 104, 87, 104, 87, 104, 105,
+	87, 117, 118, 105, 105, 87, 87, 117, 117, 117, 117, 118, 118, 105, 87, 116,
+	116, 117, 117, 117, 118, 118, 105, 87, 116, 118, 118, 105, 105, 86, 87, 116,
+	118, 118, 105, 86, 86, 116, 118, 118, 105, 86, 116, 116, 118, 118, 105, 105,
+	86, 116, 118, 118, 119, 105, 106, 86, 116, 119, 119, 106, 106, 86, 116, 119,
+	119, 106, 86, 116, 116, 119, 106, 106, 86, 86, 116, 119, 119, 106, 86, 116,
+	119, 119, 106, 106, 86, 116, 125, 119, 106, 86, 125, 119, 119, 106, 107, 85,
+	86, 125, 119, 119, 107, 107, 85, 125, 119, 119, 107, 85, 125, 125, 119, 120,
+	107, 107, 85, 125, 120, 107, 85, 125, 120, 107, 85, 85, 125, 120, 107, 107,
+	85, 125, 120, 107, 85, 125, 125, 120, 107, 107, 85, 125, 120, 107, 108, 84,
+	85, 125, 120, 108, 84, 124, 125, 124, 120, 108, 108, 84, 124, 124, 120, 108,
+	84, 124, 120, 108, 108, 84, 124, 124, 120, 108, 84, 124, 124, 120, 121, 108,
+	84, 124, 121, 109, 108, 109, 84, 124, 124, 121, 109, 84, 124, 124, 121, 109,
+	84, 124, 124, 121, 121, 109, 84, 84, 123, 124, 121, 109, 83, 84, 123, 123,
+	121, 109, 83, 83, 123, 121, 109, 83, 83, 123, 121, 109, 83, 83, 123, 123,
+	121, 109, 110, 83, 83, 123, 121, 121, 110, 83, 83, 123, 123, 121, 110, 110,
+	83, 83, 123, 122, 121, 122, 110, 83, 83, 82, 83, 123, 123, 122, 122, 122,
+	122, 122, 110, 82, 122, 123, 122, 122, 110, 82, 82, 110, 82, 82, 110, 82,
+	82, 111, 110, 111, 82, 111, 82, 82, 111, 112, 112, 82, 81, 82, 112, 112,
+	112, 81, 81, 81, 112, 113, 113, 113, 114, 81, 81, 81, 114, 114, 114, 115,
+	1, 1, 2, 2, 81, 81, 81, 115, 115, 0, 0, 1, 2, 3, 3, 81,
+	80, 81, 115, 0, 115, 0, 3, 80, 80, 3, 80, 3, 3, 80, 80, 3,
+	4, 80, 80, 4, 80, 80, 4, 80, 4, 80, 80, 4, 5, 80, 80, 5,
+	80, 5, 79, 80, 5, 79, 79, 5, 79, 5, 6, 6, 79, 79, 6, 6,
+	79, 79, 6, 6, 79, 6, 6, 7, 78, 78, 79, 7, 7, 78, 7, 7,
+	8, 78, 78, 8, 8, 78, 8, 8, 78, 78, 8, 9, 77, 78, 78, 9,
+	77, 9, 9, 77, 9, 77, 77, 9, 77, 9, 77, 9, 10, 77, 77, 10,
+	76, 77, 10, 76, 10, 76, 76, 10, 76, 10, 76, 10, 76, 10, 11, 75,
+	76, 76, 11, 75, 75, 75, 11, 11, 75, 75, 75, 11, 75, 75, 75, 11,
+	75, 75, 75, 75, 11, 74, 75, 75, 75, 11, 74, 11, 74, 74, 11, 11,
+	74, 11, 12, 74, 12, 74, 74, 12, 74, 12, 74, 74, 12, 74, 12, 74,
+	12, 13, 73, 74, 74, 13, 73, 13, 73, 13, 73, 13, 73, 13, 73, 13,
+	14, 13, 73, 14, 73, 73, 14, 14, 73, 14, 73, 14, 14, 72, 73, 14,
+	15, 72, 15, 72, 15, 15, 72, 15, 72, 15, 72, 15, 16, 72, 16, 72,
+	16, 72, 16, 72, 16, 16, 71, 72, 16, 71, 71, 16, 71, 16, 17, 71,
+	17, 71, 71, 17, 17, 71, 17, 71, 71, 17, 71, 17, 70, 71, 17, 18,
+	70, 70, 18, 70, 70, 18, 70, 18, 70, 70, 18, 70, 70, 18, 70, 18,
+	70, 70, 18, 19, 70, 70, 19, 70, 19, 70, 69, 70, 19, 69, 19, 69,
+	69, 19, 19, 69, 19, 69, 69, 19, 20, 69, 20, 20, 69, 69, 20, 21,
+	69, 21, 69, 68, 69, 68, 21, 68, 68, 68, 21, 68, 68, 68, 68, 21,
+	22, 68, 68, 68, 22, 67, 68, 67, 67, 67, 22, 22, 67, 67, 67, 67,
+	67, 67, 22, 66, 67, 22, 22, 66, 22, 22, 66, 22, 66, 66, 22, 22,
+	66, 22, 22, 66, 22, 23, 23, 66, 23, 23, 66, 23, 23, 23, 65, 66,
+	65, 23, 23, 23, 65, 23, 23, 24, 65, 24, 24, 65, 24, 24, 65, 24,
+	24, 65, 24, 24, 65, 65, 24, 24, 65, 24, 24, 65, 24, 24, 64, 65,
+	24, 25, 64, 64, 25, 25, 64, 25, 64, 25, 64, 25, 64, 64, 25, 64,
+	25, 25, 64, 25, 64, 64, 25, 26, 64, 26, 64, 26, 26, 64, 63, 64,
+	26, 63, 26, 63, 26, 26, 63, 26, 27, 63, 63, 27, 63, 27, 27, 63,
+	27, 63, 27, 63, 27, 63, 27, 27, 62, 63, 62, 27, 28, 62, 62, 62,
+	28, 62, 62, 28, 62, 62, 62, 28, 62, 62, 62, 28, 62, 62, 62, 28,
+	62, 61, 62, 61, 28, 61, 61, 61, 28, 61, 61, 28, 29, 61, 61, 61,
+	29, 61, 61, 29, 60, 61, 29, 60, 29, 60, 29, 29, 60, 29, 59, 60,
+	29, 59, 29, 30, 58, 58, 59, 30, 30, 58, 30, 58, 58, 30, 30, 57,
+	58, 30, 30, 57, 57, 30, 57, 30, 30, 57, 30, 56, 56, 57, 30, 31,
+	31, 56, 31, 31, 56, 56, 31, 31, 56, 56, 31, 31, 56, 31, 55, 56,
+	31, 31, 32, 55, 32, 32, 54, 55, 32, 54, 32, 32, 54, 32, 32, 54,
+	54, 32, 54, 32, 32, 54, 32, 33, 54, 33, 33, 53, 54, 33, 33, 53,
+	53, 33, 53, 53, 33, 33, 34, 53, 34, 52, 53, 53, 34, 52, 34, 52,
+	52, 34, 34, 52, 34, 52, 52, 34, 52, 34, 35, 51, 52, 52, 35, 35,
+	51, 35, 51, 35, 35, 51, 35, 35, 51, 35, 36, 51, 36, 36, 51, 36,
+	50, 51, 36, 36, 50, 36, 50, 36, 36, 50, 36, 36, 37, 50, 37, 50,
+	37, 37, 50, 50, 37, 37, 50, 37, 37, 49, 50, 37, 37, 38, 49, 49,
+	38, 49, 49, 38, 49, 38, 38, 48, 49, 49, 38, 48, 48, 38, 39, 48,
+	48, 39, 39, 47, 47, 48, 48, 39, 39, 47, 47, 39, 39, 40, 40, 47,
+	47, 47, 40, 40, 40, 40, 40, 40, 46, 46, 46, 47, 40, 41, 41, 46,
+	46, 46, 46, 41, 41, 45, 45, 45, 46, 41, 41, 45, 45, 45, 41, 41,
+	44, 44, 45, 45, 41, 44, 44, 41, 41, 44, 41, 42, 42, 44, 44, 42,
+	42, 43, 44, 44, 42, 42, 43, 43, 42, 42, 43, 43, 42, 42, 43, 43,
+	42, 43
+];
@@ -0,0 +1,97 @@
+// ============================================================================
+// SWEDISH TERRITORY TEST
+// ============================================================================
+//
+// Avgör om en SWEREF 99 TM-koordinat ligger på svenskt territorium (land och
+// territorialhav). Rutnätet i sweden-territory-data.ts ger svaret direkt för
+// alla rutor utom gränsrutorna, och där prövas bara de få kanter som skär
+// rutan. Kostnaden per position är därför konstant.
+//
+// Filen innehåller ingen DOM-kod och kan därför även laddas i Web Workers.
+
+const TERRITORY_STATE_OUTSIDE = 0;
+const TERRITORY_STATE_INSIDE = 1;
+const TERRITORY_STATE_BORDER_INSIDE = 3;
+
+interface TerritoryGrid {
+	states: Uint8Array;
+	/** Border cell number per cell, -1 for other cells */
+	borderSlots: Int32Array;
+	edges: Float64Array;
+	edgeStarts: Int32Array;
+	cellEdges: Int32Array;
+}
+
+let territoryGrid: TerritoryGrid | null = null;
+
+/**
+ * Decodes the generated tables on first use
+ */
+function getTerritoryGrid(): TerritoryGrid {
+	if (territoryGrid === null) {
+		const binary = atob(TERRITORY_CELL_STATES);
+		const states = new Uint8Array(binary.length);
+		for (let i = 0; i < binary.length; i++) {
+			states[i] = binary.charCodeAt(i);
+		}
+		const cellCount = TERRITORY_GRID.ROWS * TERRITORY_GRID.COLUMNS;
+		const borderSlots = new Int32Array(cellCount);
+		let border = 0;
+		for (let cell = 0; cell < cellCount; cell++) {
+			const state = (states[cell >> 2] >> ((cell & 3) * 2)) & 3;
+			borderSlots[cell] = state > TERRITORY_STATE_INSIDE ? border++ : -1;
+		}
+		territoryGrid = {
+			states,
+			borderSlots,
+			edges: Float64Array.from(TERRITORY_EDGES),
+			edgeStarts: Int32Array.from(TERRITORY_BORDER_EDGE_STARTS),
+			cellEdges: Int32Array.from(TERRITORY_BORDER_EDGES)
+		};
+	}
+	return territoryGrid;
+}
+
+function orientation(aN: number, aE: number, bN: number, bE: number, pN: number, pE: number): boolean {
+	return (bE - aE) * (pN - aN) - (bN - aN) * (pE - aE) > 0;
+}
+
+/**
+ * Tests whether a SWEREF 99 TM coordinate is on Swedish land or territorial waters
+ *
+ * In a border cell the segment from the cell centre, whose side is known,
+ * to the point is tested against the edges crossing that cell; each
+ * crossing flips the side. Zero orientations count as negative on both
+ * edges meeting at a vertex, so a segment through a vertex is counted once.
+ */
+function isInSwedishTerritory(northing: number, easting: number): boolean {
+	const row = Math.floor((northing - TERRITORY_GRID.MIN_NORTHING) / TERRITORY_GRID.CELL_SIZE);
+	const column = Math.floor((easting - TERRITORY_GRID.MIN_EASTING) / TERRITORY_GRID.CELL_SIZE);
+	if (!(row >= 0 && row < TERRITORY_GRID.ROWS && column >= 0 && column < TERRITORY_GRID.COLUMNS)) {
+		return false;
+	}
+	const grid = getTerritoryGrid();
+	const cell = row * TERRITORY_GRID.COLUMNS + column;
+	const state = (grid.states[cell >> 2] >> ((cell & 3) * 2)) & 3;
+	if (state === TERRITORY_STATE_OUTSIDE || state === TERRITORY_STATE_INSIDE) {
+		return state === TERRITORY_STATE_INSIDE;
+	}
+
+	const centerN = TERRITORY_GRID.MIN_NORTHING + (row + 0.5) * TERRITORY_GRID.CELL_SIZE;
+	const centerE = TERRITORY_GRID.MIN_EASTING + (column + 0.5) * TERRITORY_GRID.CELL_SIZE;
+	let inside = state === TERRITORY_STATE_BORDER_INSIDE;
+	const slot = grid.borderSlots[cell];
+	const { edges, cellEdges } = grid;
+	for (let i = grid.edgeStarts[slot]; i < grid.edgeStarts[slot + 1]; i++) {
+		const e = cellEdges[i] * 4;
+		const aN = edges[e];
+		const aE = edges[e + 1];
+		const bN = edges[e + 2];
+		const bE = edges[e + 3];
+		if (orientation(aN, aE, bN, bE, centerN, centerE) !== orientation(aN, aE, bN, bE, northing, easting) &&
+			orientation(centerN, centerE, northing, easting, aN, aE) !== orientation(centerN, centerE, northing, easting, bN, bE)) {
+			inside = !inside;
+		}
+	}
+	return inside;
+}
@@ -0,0 +1,243 @@
+// ============================================================================
+// SWEREF 99 TM PROJECTION (Gauss–Krüger series with grid convergence and scale)
+// ============================================================================
+//
+// Framåtprojektion GRS80 → SWEREF 99 TM enligt Lantmäteriets formler för
+// Gauss-Krügers projektion. Meridiankonvergens och skalfaktor är derivator av
+// samma serie, så de beräknas av samma sinus-, cosinus- och hyperboliska
+// termer som koordinaterna och kostar bara några multiplikationer extra.
+// Flerfaldiga vinklar tas fram med additionsformler i stället för nya
+// anrop till Math.sin och Math.cosh.
+//
+// Den omvända projektionen, SWEREF 99 TM → GRS80, används både i appen och
+// vid massomvandling av koordinatfiler i en Web Worker, så att båda
+// riktningarna bygger på samma serie.
+
+interface SwerefProjection {
+	northing: number;
+	easting: number;
+	/** Meridian convergence, degrees; grid north lies this far east of true north */
+	convergence?: number;
+	/** Point scale factor; grid distance divided by ellipsoid distance */
+	scaleFactor?: number;
+}
+
+/**
+ * SWEREF 99 TM parameters (EPSG:3006) on the GRS80 ellipsoid
+ */
+const SWEREF_GRS80_SEMI_MAJOR_AXIS = 6378137;
+const SWEREF_GRS80_FLATTENING = 1 / 298.257222101;
+const SWEREF_CENTRAL_MERIDIAN_DEGREES = 15;
+const SWEREF_CENTRAL_SCALE_FACTOR = 0.9996;
+const SWEREF_FALSE_NORTHING_METERS = 0;
+const SWEREF_FALSE_EASTING_METERS = 500000;
+
+/**
+ * Series constants derived once from the ellipsoid
+ * See Lantmäteriet, "Gauss Conformal Projection (Transverse Mercator),
+ * Krüger's Formulas", forward and inverse cases.
+ */
+const SWEREF_SERIES = (() => {
+	const f = SWEREF_GRS80_FLATTENING;
+	const e2 = f * (2 - f);
+	const n = f / (2 - f);
+	const n2 = n * n;
+	const n3 = n2 * n;
+	const n4 = n3 * n;
+	return {
+		e2,
+		// Rektifierande radie gånger skalfaktorn på medelmeridianen
+		kA: SWEREF_CENTRAL_SCALE_FACTOR * SWEREF_GRS80_SEMI_MAJOR_AXIS / (1 + n) * (1 + n2 / 4 + n4 / 64),
+		// Konform latitud
+		a: e2,
+		b: (5 * e2 * e2 - e2 * e2 * e2) / 6,
+		c: (104 * e2 * e2 * e2 - 45 * e2 * e2 * e2 * e2) / 120,
+		d: 1237 * e2 * e2 * e2 * e2 / 1260,
+		beta1: n / 2 - 2 * n2 / 3 + 5 * n3 / 16 + 41 * n4 / 180,
+		beta2: 13 * n2 / 48 - 3 * n3 / 5 + 557 * n4 / 1440,
+		beta3: 61 * n3 / 240 - 103 * n4 / 140,
+		beta4: 49561 * n4 / 161280,
+		// Omvänd serie och latitud ur konform latitud
+		delta1: n / 2 - 2 * n2 / 3 + 37 * n3 / 96 - n4 / 360,
+		delta2: n2 / 48 + n3 / 15 - 437 * n4 / 1440,
+		delta3: 17 * n3 / 480 - 37 * n4 / 840,
+		delta4: 4397 * n4 / 161280,
+		aStar: e2 + e2 * e2 + e2 * e2 * e2 + e2 * e2 * e2 * e2,
+		bStar: -(7 * e2 * e2 + 17 * e2 * e2 * e2 + 30 * e2 * e2 * e2 * e2) / 6,
+		cStar: (224 * e2 * e2 * e2 + 889 * e2 * e2 * e2 * e2) / 120,
+		dStar: -4279 * e2 * e2 * e2 * e2 / 1260
+	};
+})();
+
+const SWEREF_DEGREES_TO_RADIANS = Math.PI / 180;
+
+/**
+ * Result slots written by projectSweref99tmInto: northing, easting,
+ * convergence (degrees) and scale factor
+ */
+const SWEREF_PROJECTION_SLOTS = 4;
+
+/**
+ * Projects one point into out[offset..offset+3] without allocating
+ *
+ * @param withGridFactors - Also compute convergence and scale factor;
+ * otherwise those slots are left untouched
+ */
+function projectSweref99tmInto(latitude: number, longitude: number, withGridFactors: boolean, out: Float64Array, offset: number = 0): void {
+	const { e2, kA, a, b, c, d, beta1, beta2, beta3, beta4 } = SWEREF_SERIES;
+	const phi = latitude * SWEREF_DEGREES_TO_RADIANS;
+	const deltaLambda = (longitude - SWEREF_CENTRAL_MERIDIAN_DEGREES) * SWEREF_DEGREES_TO_RADIANS;
+
+	const sinPhi = Math.sin(phi);
+	const cosPhi = Math.cos(phi);
+	const sin2Phi = sinPhi * sinPhi;
+	const conformalLatitude = phi - sinPhi * cosPhi * (a + sin2Phi * (b + sin2Phi * (c + sin2Phi * d)));
+	const sinConformal = Math.sin(conformalLatitude);
+	const cosConformal = Math.cos(conformalLatitude);
+	const sinLambda = Math.sin(deltaLambda);
+	const cosLambda = Math.cos(deltaLambda);
+
+	const xiPrime = Math.atan2(sinConformal, cosConformal * cosLambda);
+	const etaPrime = Math.atanh(cosConformal * sinLambda);
+
+	// sin/cos(2jξ') och sinh/cosh(2jη') för j = 1…4 ur additionsformlerna
+	const s1 = Math.sin(2 * xiPrime);
+	const c1 = Math.cos(2 * xiPrime);
+	const exp2Eta = Math.exp(2 * etaPrime);
+	const sh1 = (exp2Eta - 1 / exp2Eta) / 2;
+	const ch1 = (exp2Eta + 1 / exp2Eta) / 2;
+	const s2 = 2 * s1 * c1;
+	const c2 = 2 * c1 * c1 - 1;
+	const sh2 = 2 * sh1 * ch1;
+	const ch2 = 2 * ch1 * ch1 - 1;
+	const s3 = s2 * c1 + c2 * s1;
+	const c3 = c2 * c1 - s2 * s1;
+	const sh3 = sh2 * ch1 + ch2 * sh1;
+	const ch3 = ch2 * ch1 + sh2 * sh1;
+	const s4 = 2 * s2 * c2;
+	const c4 = 2 * c2 * c2 - 1;
+	const sh4 = 2 * sh2 * ch2;
+	const ch4 = 2 * ch2 * ch2 - 1;
+
+	out[offset] = SWEREF_FALSE_NORTHING_METERS + kA * (xiPrime
+		+ beta1 * s1 * ch1 + beta2 * s2 * ch2 + beta3 * s3 * ch3 + beta4 * s4 * ch4);
+	out[offset + 1] = SWEREF_FALSE_EASTING_METERS + kA * (etaPrime
+		+ beta1 * c1 * sh1 + beta2 * c2 * sh2 + beta3 * c3 * sh3 + beta4 * c4 * sh4);
+
+	if (!withGridFactors) {
+		return;
+	}
+
+	// Seriens derivata dζ/dw = p − iq ger serietermens vridning och skala
+	const p = 1 + 2 * beta1 * c1 * ch1 + 4 * beta2 * c2 * ch2 + 6 * beta3 * c3 * ch3 + 8 * beta4 * c4 * ch4;
+	const q = 2 * beta1 * s1 * sh1 + 4 * beta2 * s2 * sh2 + 6 * beta3 * s3 * sh3 + 8 * beta4 * s4 * sh4;
+	const sphereConvergence = Math.atan2(sinConformal * sinLambda, cosLambda);
+	out[offset + 2] = (sphereConvergence + Math.atan2(q, p)) / SWEREF_DEGREES_TO_RADIANS;
+	// cosh η' = 1 / √(1 − cos²φ* sin²Δλ); ν cos φ är parallellcirkelns radie
+	const coshEta = (exp2Eta + 1) / (2 * Math.sqrt(exp2Eta));
+	const primeVerticalRadius = SWEREF_GRS80_SEMI_MAJOR_AXIS / Math.sqrt(1 - e2 * sin2Phi);
+	out[offset + 3] = kA * cosConformal * coshEta * Math.hypot(p, q) / (primeVerticalRadius * cosPhi);
+}
+
+const swerefProjectionScratch = new Float64Array(SWEREF_PROJECTION_SLOTS);
+
+/**
+ * Projects WGS84/ETRS89 latitude and longitude to SWEREF 99 TM
+ *
+ * @param withGridFactors - Also return meridian convergence and point scale
+ * factor, computed in the same pass
+ */
+function projectToSweref99tm(latitude: number, longitude: number, withGridFactors: boolean = false): SwerefProjection {
+	const out = swerefProjectionScratch;
+	projectSweref99tmInto(latitude, longitude, withGridFactors, out);
+	if (!withGridFactors) {
+		return { northing: out[0], easting: out[1] };
+	}
+	return { northing: out[0], easting: out[1], convergence: out[2], scaleFactor: out[3] };
+}
+
+/**
+ * Projects many points into caller-provided columns
+ *
+ * Convergence and scale factor are computed only when both of their columns
+ * are given. All columns must be at least as long as latitudes.
+ */
+function projectToSweref99tmBatch(
+	latitudes: Float64Array,
+	longitudes: Float64Array,
+	northings: Float64Array,
+	eastings: Float64Array,
+	convergences?: Float64Array,
+	scaleFactors?: Float64Array
+): void {
+	const withGridFactors = convergences !== undefined && scaleFactors !== undefined;
+	const out = swerefProjectionScratch;
+	for (let i = 0; i < latitudes.length; i++) {
+		projectSweref99tmInto(latitudes[i], longitudes[i], withGridFactors, out);
+		northings[i] = out[0];
+		eastings[i] = out[1];
+		if (convergences !== undefined && scaleFactors !== undefined) {
+			convergences[i] = out[2];
+			scaleFactors[i] = out[3];
+		}
+	}
+}
+
+/**
+ * Projects one SWEREF 99 TM point back to latitude and longitude in
+ * out[offset] and out[offset + 1], degrees, without allocating
+ */
+function unprojectSweref99tmInto(northing: number, easting: number, out: Float64Array, offset: number = 0): void {
+	const { kA, delta1, delta2, delta3, delta4, aStar, bStar, cStar, dStar } = SWEREF_SERIES;
+	const xi = (northing - SWEREF_FALSE_NORTHING_METERS) / kA;
+	const eta = (easting - SWEREF_FALSE_EASTING_METERS) / kA;
+
+	const s1 = Math.sin(2 * xi);
+	const c1 = Math.cos(2 * xi);
+	const exp2Eta = Math.exp(2 * eta);
+	const sh1 = (exp2Eta - 1 / exp2Eta) / 2;
+	const ch1 = (exp2Eta + 1 / exp2Eta) / 2;
+	const s2 = 2 * s1 * c1;
+	const c2 = 2 * c1 * c1 - 1;
+	const sh2 = 2 * sh1 * ch1;
+	const ch2 = 2 * ch1 * ch1 - 1;
+	const s3 = s2 * c1 + c2 * s1;
+	const c3 = c2 * c1 - s2 * s1;
+	const sh3 = sh2 * ch1 + ch2 * sh1;
+	const ch3 = ch2 * ch1 + sh2 * sh1;
+	const s4 = 2 * s2 * c2;
+	const c4 = 2 * c2 * c2 - 1;
+	const sh4 = 2 * sh2 * ch2;
+	const ch4 = 2 * ch2 * ch2 - 1;
+
+	const xiPrime = xi - delta1 * s1 * ch1 - delta2 * s2 * ch2 - delta3 * s3 * ch3 - delta4 * s4 * ch4;
+	const etaPrime = eta - delta1 * c1 * sh1 - delta2 * c2 * sh2 - delta3 * c3 * sh3 - delta4 * c4 * sh4;
+	const conformalLatitude = Math.asin(Math.sin(xiPrime) / Math.cosh(etaPrime));
+	const deltaLambda = Math.atan2(Math.sinh(etaPrime), Math.cos(xiPrime));
+
+	const sinConformal = Math.sin(conformalLatitude);
+	const sin2Conformal = sinConformal * sinConformal;
+	const phi = conformalLatitude + sinConformal * Math.cos(conformalLatitude)
+		* (aStar + sin2Conformal * (bStar + sin2Conformal * (cStar + sin2Conformal * dStar)));
+	out[offset] = phi / SWEREF_DEGREES_TO_RADIANS;
+	out[offset + 1] = SWEREF_CENTRAL_MERIDIAN_DEGREES + deltaLambda / SWEREF_DEGREES_TO_RADIANS;
+}
+
+/**
+ * Projects many SWEREF 99 TM points back to latitude and longitude
+ *
+ * All columns must be at least as long as northings.
+ */
+function unprojectSweref99tmBatch(
+	northings: Float64Array,
+	eastings: Float64Array,
+	latitudes: Float64Array,
+	longitudes: Float64Array
+): void {
+	const out = swerefProjectionScratch;
+	for (let i = 0; i < northings.length; i++) {
+		unprojectSweref99tmInto(northings[i], eastings[i], out);
+		latitudes[i] = out[0];
+		longitudes[i] = out[1];
+	}
+}
@@ -0,0 +1,153 @@
+// ============================================================================
+// TAB LEADER ELECTION (Web Locks + BroadcastChannel)
+// ============================================================================
+//
+// När appen är öppen i flera flikar eller fönster (t.ex. installerad PWA och
+// en webbläsarflik) väljs en ledare med Web Locks API. Bara ledaren gör det
+// tunga arbetet och sänder resultatet via BroadcastChannel till övriga flikar
+// (följare), som bara visar det. Webbläsaren släpper låset automatiskt när
+// ledarfliken stängs, och nästa flik i kön blir då ledare.
+
+interface TabLeaderCallbacks<T> {
+	/** Called when this tab has become leader */
+	onLeader(): void;
+	/** Called in followers for each message broadcast by the leader */
+	onMessage(message: T): void;
+	/** Called in the leader when a follower joins, e.g. to resend the latest state */
+	onFollowerJoined?(): void;
+}
+
+/**
+ * Messages on the channel: leader data, or a follower announcing itself
+ */
+type TabLeaderChannelMessage<T> =
+	| { kind: 'data'; payload: T }
+	| { kind: 'join' };
+
+function isTabLeaderElectionSupported(): boolean {
+	return typeof navigator !== 'undefined' && 'locks' in navigator && typeof BroadcastChannel === 'function';
+}
+
+/**
+ * TabLeaderElection - väljer en ledarflik bland de flikar som deltar
+ *
+ * Flikar deltar från join() till leave(). Ledarskapet hålls så länge låset
+ * är taget; det lämnas bara vid leave(), yieldToWaitingTab() eller när
+ * fliken stängs.
+ */
+class TabLeaderElection<T> {
+	private channel: BroadcastChannel;
+	private joined: boolean = false;
+	private leader: boolean = false;
+	private abortController: AbortController | null = null;
+	private releaseLock: (() => void) | null = null;
+
+	constructor(private name: string, private callbacks: TabLeaderCallbacks<T>) {
+		this.channel = new BroadcastChannel(name);
+		this.channel.onmessage = (event: MessageEvent<TabLeaderChannelMessage<T>>) => {
+			const message = event.data;
+			if (message.kind === 'join') {
+				if (this.leader) {
+					this.callbacks.onFollowerJoined?.();
+				}
+			} else if (this.joined && !this.leader) {
+				this.callbacks.onMessage(message.payload);
+			}
+		};
+	}
+
+	isJoined(): boolean {
+		return this.joined;
+	}
+
+	isLeader(): boolean {
+		return this.leader;
+	}
+
+	/**
+	 * Starts taking part in the election
+	 * The tab is a follower until the lock is granted.
+	 */
+	join(): void {
+		if (this.joined) {
+			return;
+		}
+		this.joined = true;
+		this.requestLock();
+		this.post({ kind: 'join' });
+	}
+
+	/**
+	 * Stops taking part, releasing leadership or leaving the queue
+	 */
+	leave(): void {
+		if (!this.joined) {
+			return;
+		}
+		this.joined = false;
+		this.dropLock();
+	}
+
+	/**
+	 * Sends data from the leader to all followers
+	 */
+	broadcast(payload: T): void {
+		if (this.leader) {
+			this.post({ kind: 'data', payload });
+		}
+	}
+
+	/**
+	 * Hands leadership to the next waiting tab, if there is one, and queues up again
+	 * @returns true if leadership was given up
+	 */
+	async yieldToWaitingTab(): Promise<boolean> {
+		if (!this.leader) {
+			return false;
+		}
+		const state = await navigator.locks.query();
+		const hasWaitingTab = state.pending?.some((lock) => lock.name === this.name) ?? false;
+		if (!hasWaitingTab || !this.leader) {
+			return false;
+		}
+		this.dropLock();
+		this.requestLock();
+		return true;
+	}
+
+	private post(message: TabLeaderChannelMessage<T>): void {
+		this.channel.postMessage(message);
+	}
+
+	private requestLock(): void {
+		const abortController = new AbortController();
+		this.abortController = abortController;
+
+		navigator.locks.request(this.name, { signal: abortController.signal }, () => {
+			// Begäran kan ha beviljats precis efter att fliken lämnade kön
+			if (abortController.signal.aborted) {
+				return;
+			}
+			this.abortController = null;
+			this.leader = true;
+			this.callbacks.onLeader();
+			return new Promise<void>((resolve) => {
+				this.releaseLock = resolve;
+			});
+		}).catch((error) => {
+			if (!(error instanceof DOMException && error.name === 'AbortError')) {
+				console.warn('Kunde inte begära ledarlås:', error);
+			}
+		});
+	}
+
+	private dropLock(): void {
+		if (this.leader) {
+			this.leader = false;
+			this.releaseLock?.();
+			this.releaseLock = null;
+		}
+		this.abortController?.abort();
+		this.abortController = null;
+	}
+}
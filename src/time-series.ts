@@ -0,0 +1,252 @@
+// ============================================================================
+// TIME SERIES (bounded min/max buckets and LTTB downsampling)
+// ============================================================================
+//
+// En tidsserie för ett diagram lagras inte punkt för punkt. Punkterna samlas
+// i ett begränsat antal hinkar där varje hink bara behåller sitt minsta och
+// största värde. När hinkarna tar slut slås de ihop parvis och varje hink
+// täcker dubbelt så många punkter. Minnet och tiden för att rita är därmed
+// begränsade oavsett hur lång sessionen är, och toppar försvinner aldrig.
+//
+// Vid ritning minskas hinkarnas punkter till diagrammets bredd i pixlar med
+// Largest-Triangle-Three-Buckets (Steinarsson 2013), som behåller formen på
+// kurvan bättre än medelvärden eller var n:te punkt.
+//
+// Filen innehåller ingen DOM-kod.
+
+/**
+ * Buckets per series; each keeps at most two points
+ */
+const TIME_SERIES_MAX_BUCKETS = 2048;
+
+/**
+ * Downsamples a series to at most threshold points with
+ * Largest-Triangle-Three-Buckets; the first and last points are always kept
+ * @param time - X values in increasing order
+ * @returns Number of points written to the output arrays
+ */
+function downsampleLttb(
+	time: Float64Array,
+	value: Float64Array,
+	count: number,
+	threshold: number,
+	outTime: Float64Array,
+	outValue: Float64Array
+): number {
+	if (threshold >= count || threshold < 3) {
+		const kept = threshold < 3 ? Math.min(count, threshold) : count;
+		outTime.set(time.subarray(0, kept));
+		outValue.set(value.subarray(0, kept));
+		return kept;
+	}
+
+	// Första och sista punkten får egna hinkar, resten delas jämnt
+	const bucketSize = (count - 2) / (threshold - 2);
+	let selected = 0;
+	outTime[0] = time[0];
+	outValue[0] = value[0];
+	let previousTime = time[0];
+	let previousValue = value[0];
+
+	for (let bucket = 0; bucket < threshold - 2; bucket++) {
+		// Nästa hinks medelpunkt är den tredje hörnan i triangeln
+		const nextStart = Math.floor((bucket + 1) * bucketSize) + 1;
+		const nextEnd = Math.min(Math.floor((bucket + 2) * bucketSize) + 1, count);
+		let averageTime = 0;
+		let averageValue = 0;
+		for (let i = nextStart; i < nextEnd; i++) {
+			averageTime += time[i];
+			averageValue += value[i];
+		}
+		const nextCount = nextEnd - nextStart;
+		averageTime /= nextCount;
+		averageValue /= nextCount;
+
+		const start = Math.floor(bucket * bucketSize) + 1;
+		const end = Math.floor((bucket + 1) * bucketSize) + 1;
+		let largestArea = -1;
+		for (let i = start; i < end; i++) {
+			const area = Math.abs(
+				(previousTime - averageTime) * (value[i] - previousValue) -
+				(previousTime - time[i]) * (averageValue - previousValue)
+			);
+			if (area > largestArea) {
+				largestArea = area;
+				selected = i;
+			}
+		}
+		outTime[bucket + 1] = time[selected];
+		outValue[bucket + 1] = value[selected];
+		previousTime = time[selected];
+		previousValue = value[selected];
+	}
+
+	outTime[threshold - 1] = time[count - 1];
+	outValue[threshold - 1] = value[count - 1];
+	return threshold;
+}
+
+/**
+ * TimeSeriesBuffer - a series of unbounded length in bounded memory
+ *
+ * Each closed bucket holds the smallest and largest value of the points it
+ * covers, in time order. The open bucket collects points until it covers as
+ * many as the closed ones.
+ */
+class TimeSeriesBuffer {
+	private readonly minTime: Float64Array;
+	private readonly minValue: Float64Array;
+	private readonly maxTime: Float64Array;
+	private readonly maxValue: Float64Array;
+	private bucketCount: number = 0;
+	/** Points per closed bucket, doubled whenever the buckets are merged */
+	private span: number = 1;
+	private openCount: number = 0;
+	private openMinTime: number = 0;
+	private openMinValue: number = 0;
+	private openMaxTime: number = 0;
+	private openMaxValue: number = 0;
+	private pointCount: number = 0;
+	private largest: number = -Infinity;
+	private newest: number = Number.NaN;
+
+	constructor(private readonly maxBuckets: number = TIME_SERIES_MAX_BUCKETS) {
+		this.minTime = new Float64Array(maxBuckets);
+		this.minValue = new Float64Array(maxBuckets);
+		this.maxTime = new Float64Array(maxBuckets);
+		this.maxValue = new Float64Array(maxBuckets);
+	}
+
+	/**
+	 * Number of points added
+	 */
+	get length(): number {
+		return this.pointCount;
+	}
+
+	/**
+	 * Largest value added, -Infinity when empty
+	 */
+	get max(): number {
+		return this.largest;
+	}
+
+	/**
+	 * Latest value added, NaN when empty
+	 */
+	get last(): number {
+		return this.newest;
+	}
+
+	/**
+	 * Most points toArrays() can write
+	 */
+	get capacity(): number {
+		return 2 * (this.maxBuckets + 1);
+	}
+
+	/**
+	 * Adds a point; values that are not finite, e.g. a missing speed, are skipped
+	 * @param time - Must not be earlier than the previous point
+	 */
+	push(time: number, value: number): void {
+		if (!Number.isFinite(value)) {
+			return;
+		}
+		this.pointCount++;
+		this.largest = Math.max(this.largest, value);
+		this.newest = value;
+
+		if (this.openCount === 0) {
+			this.openMinTime = time;
+			this.openMinValue = value;
+			this.openMaxTime = time;
+			this.openMaxValue = value;
+		} else if (value < this.openMinValue) {
+			this.openMinTime = time;
+			this.openMinValue = value;
+		} else if (value > this.openMaxValue) {
+			this.openMaxTime = time;
+			this.openMaxValue = value;
+		}
+		this.openCount++;
+		if (this.openCount < this.span) {
+			return;
+		}
+
+		if (this.bucketCount === this.maxBuckets) {
+			this.mergeBuckets();
+			// Den öppna hinken är nu halvfull och fortsätter samla punkter
+			if (this.openCount < this.span) {
+				return;
+			}
+		}
+		const i = this.bucketCount++;
+		this.minTime[i] = this.openMinTime;
+		this.minValue[i] = this.openMinValue;
+		this.maxTime[i] = this.openMaxTime;
+		this.maxValue[i] = this.openMaxValue;
+		this.openCount = 0;
+	}
+
+	clear(): void {
+		this.bucketCount = 0;
+		this.span = 1;
+		this.openCount = 0;
+		this.pointCount = 0;
+		this.largest = -Infinity;
+		this.newest = Number.NaN;
+	}
+
+	/**
+	 * Writes the kept points in time order
+	 * @returns Number of points written, at most capacity
+	 */
+	toArrays(time: Float64Array, value: Float64Array): number {
+		let count = 0;
+		const write = (minTime: number, minValue: number, maxTime: number, maxValue: number) => {
+			const minFirst = minTime <= maxTime;
+			time[count] = minFirst ? minTime : maxTime;
+			value[count] = minFirst ? minValue : maxValue;
+			count++;
+			if (minTime !== maxTime) {
+				time[count] = minFirst ? maxTime : minTime;
+				value[count] = minFirst ? maxValue : minValue;
+				count++;
+			}
+		};
+		for (let i = 0; i < this.bucketCount; i++) {
+			write(this.minTime[i], this.minValue[i], this.maxTime[i], this.maxValue[i]);
+		}
+		if (this.openCount > 0) {
+			write(this.openMinTime, this.openMinValue, this.openMaxTime, this.openMaxValue);
+		}
+		return count;
+	}
+
+	/**
+	 * Merges the buckets pairwise, so that each covers twice as many points
+	 */
+	private mergeBuckets(): void {
+		let merged = 0;
+		for (let i = 0; i + 1 < this.bucketCount; i += 2) {
+			const lower = this.minValue[i + 1] < this.minValue[i] ? i + 1 : i;
+			const upper = this.maxValue[i + 1] > this.maxValue[i] ? i + 1 : i;
+			this.minTime[merged] = this.minTime[lower];
+			this.minValue[merged] = this.minValue[lower];
+			this.maxTime[merged] = this.maxTime[upper];
+			this.maxValue[merged] = this.maxValue[upper];
+			merged++;
+		}
+		if (this.bucketCount % 2 === 1) {
+			const last = this.bucketCount - 1;
+			this.minTime[merged] = this.minTime[last];
+			this.minValue[merged] = this.minValue[last];
+			this.maxTime[merged] = this.maxTime[last];
+			this.maxValue[merged] = this.maxValue[last];
+			merged++;
+		}
+		this.bucketCount = merged;
+		this.span *= 2;
+	}
+}
@@ -0,0 +1,277 @@
+// ============================================================================
+// TRACK EXPORT (GPX, GeoJSON, CSV, FlatGeobuf)
+// ============================================================================
+//
+// Exporten byggs som en ReadableStream som hämtar ett block i taget från
+// IndexedDB och serialiserar det direkt. Strömmen har högvattenmärke 1, så
+// som mest ett serialiserat block ligger i minnet åt gången. Där webbläsaren
+// kan skriva filer direkt går strömmen till filen; annars samlas den i en
+// Blob. FlatGeobuf är binärt och skrivs av flatgeobuf-export.ts i
+// spårarbetaren.
+
+type TrackTextExportFormat = 'gpx' | 'geojson' | 'csv';
+type TrackExportFormat = TrackTextExportFormat | 'flatgeobuf';
+
+/**
+ * WGS 84 coordinates derived for one chunk
+ */
+interface Wgs84Columns {
+	latitude: Float64Array;
+	longitude: Float64Array;
+}
+
+/**
+ * Incremental serializer for one export format
+ * header() and footer() are called once, chunk() once per stored chunk.
+ */
+interface TrackSerializer {
+	mimeType: string;
+	extension: string;
+	header(track: TrackRecord): string;
+	chunk(columns: TrackColumns, wgs84: Wgs84Columns): string;
+	footer(): string;
+}
+
+const TRACK_EXPORT_FORMATS: TrackExportFormat[] = ['gpx', 'geojson', 'csv', 'flatgeobuf'];
+const GPX_SWEREF_NAMESPACE = 'https://sweref99.nu/gpx/1';
+/** Export field for each map sheet size, e.g. ruta_5km */
+const MAP_SHEET_FIELDS = MAP_SHEET_SIZES.map((size) => `ruta_${size / 1000}km`);
+const CSV_HEADER = `tid,sweref99tm_n,sweref99tm_e,wgs84_lat,wgs84_lon,noggrannhet_m,fart_ms,${MAP_SHEET_FIELDS.join(',')}\n`;
+
+function isTrackExportFormat(value: string): value is TrackExportFormat {
+	return TRACK_EXPORT_FORMATS.includes(value as TrackExportFormat);
+}
+
+function isCompressionSupported(): boolean {
+	return typeof CompressionStream === 'function';
+}
+
+function formatExportTime(timestamp: number): string {
+	return new Date(timestamp).toISOString();
+}
+
+/**
+ * Returns a function that formats consecutive times like formatExportTime
+ * The date, hour and minute are only rebuilt when the minute changes, which
+ * saves most of the cost of toISOString() for a track.
+ */
+function createExportTimeFormatter(): (timestamp: number) => string {
+	let minuteStart = Number.NaN;
+	let prefix = '';
+	return (timestamp) => {
+		const offset = Math.floor(timestamp) - minuteStart;
+		if (!(offset >= 0 && offset < 60000)) {
+			const iso = formatExportTime(timestamp);
+			// År utanför 0–9999 skrivs med sex siffror och cachas inte
+			if (iso.length !== 24) {
+				return iso;
+			}
+			minuteStart = Math.floor(timestamp / 60000) * 60000;
+			prefix = iso.slice(0, 17);
+			return iso;
+		}
+		const seconds = Math.floor(offset / 1000);
+		const millis = offset % 1000;
+		return `${prefix}${seconds < 10 ? '0' : ''}${seconds}.${millis < 100 ? (millis < 10 ? '00' : '0') : ''}${millis}Z`;
+	};
+}
+
+function formatExportSpeed(speed: number): string {
+	return Number.isNaN(speed) ? '' : speed.toFixed(2);
+}
+
+/**
+ * Derives WGS 84 coordinates for a chunk from the stored SWEREF 99 TM values
+ *
+ * Same inverse as sweref99tm_to_wgs84(), with the drift correction passed in
+ * since it is computed in script.ts.
+ */
+function computeWgs84Columns(columns: TrackColumns, drift: Itrf2Etrs89Correction): Wgs84Columns {
+	const latitude = new Float64Array(columns.count);
+	const longitude = new Float64Array(columns.count);
+	for (let i = 0; i < columns.count; i++) {
+		latitude[i] = columns.northing[i] - drift.dn;
+		longitude[i] = columns.easting[i] - drift.de;
+	}
+	// Varje punkt läses innan den skrivs, så kolumnerna kan omvandlas på plats
+	unprojectSweref99tmBatch(latitude, longitude, latitude, longitude);
+	return { latitude, longitude };
+}
+
+function createGpxSerializer(): TrackSerializer {
+	const nameSheets = createMapSheetNamer();
+	return {
+		mimeType: 'application/gpx+xml',
+		extension: 'gpx',
+		header: (track) => (
+			'<?xml version="1.0" encoding="UTF-8"?>\n' +
+			`<gpx version="1.1" creator="sweref99.nu" xmlns="http://www.topografix.com/GPX/1/1" xmlns:sweref="${GPX_SWEREF_NAMESPACE}">\n` +
+			`<trk><name>${formatExportTime(track.startTime)}</name><trkseg>\n`
+		),
+		chunk: (columns, wgs84) => {
+			let out = '';
+			for (let i = 0; i < columns.count; i++) {
+				const speed = formatExportSpeed(columns.speed[i]);
+				const sheets = nameSheets(columns.northing[i], columns.easting[i]);
+				out += `<trkpt lat="${wgs84.latitude[i].toFixed(8)}" lon="${wgs84.longitude[i].toFixed(8)}">` +
+					`<time>${formatExportTime(columns.timestamp[i])}</time>` +
+					`<extensions><sweref:n>${columns.northing[i].toFixed(3)}</sweref:n><sweref:e>${columns.easting[i].toFixed(3)}</sweref:e>` +
+					`<sweref:accuracy>${columns.accuracy[i].toFixed(1)}</sweref:accuracy>` +
+					(speed ? `<sweref:speed>${speed}</sweref:speed>` : '') +
+					sheets.map((sheet, k) => `<sweref:sheet km="${MAP_SHEET_SIZES[k] / 1000}">${sheet}</sweref:sheet>`).join('') +
+					'</extensions></trkpt>\n';
+			}
+			return out;
+		},
+		footer: () => '</trkseg></trk>\n</gpx>\n'
+	};
+}
+
+/**
+ * GeoJSON enligt RFC 7946 kräver WGS 84 i geometrin, därför läggs
+ * SWEREF 99 TM-koordinaterna i egenskaperna för varje punkt.
+ */
+function createGeoJsonSerializer(): TrackSerializer {
+	let hasWrittenFeature = false;
+	const nameSheets = createMapSheetNamer();
+	return {
+		mimeType: 'application/geo+json',
+		extension: 'geojson',
+		header: () => '{"type":"FeatureCollection","features":[\n',
+		chunk: (columns, wgs84) => {
+			let out = '';
+			for (let i = 0; i < columns.count; i++) {
+				const speed = formatExportSpeed(columns.speed[i]);
+				const sheets = nameSheets(columns.northing[i], columns.easting[i]);
+				out += (hasWrittenFeature ? ',\n' : '') +
+					`{"type":"Feature","geometry":{"type":"Point","coordinates":[${wgs84.longitude[i].toFixed(8)},${wgs84.latitude[i].toFixed(8)}]},` +
+					`"properties":{"tid":"${formatExportTime(columns.timestamp[i])}","sweref99tm_n":${columns.northing[i].toFixed(3)},"sweref99tm_e":${columns.easting[i].toFixed(3)},` +
+					`"noggrannhet_m":${columns.accuracy[i].toFixed(1)},"fart_ms":${speed || 'null'}` +
+					sheets.map((sheet, k) => `,"${MAP_SHEET_FIELDS[k]}":"${sheet}"`).join('') + '}}';
+				hasWrittenFeature = true;
+			}
+			return out;
+		},
+		footer: () => '\n]}\n'
+	};
+}
+
+function createCsvSerializer(): TrackSerializer {
+	const nameSheets = createMapSheetNamer();
+	return {
+		mimeType: 'text/csv',
+		extension: 'csv',
+		header: () => CSV_HEADER,
+		chunk: (columns, wgs84) => {
+			let out = '';
+			for (let i = 0; i < columns.count; i++) {
+				out += `${formatExportTime(columns.timestamp[i])},${columns.northing[i].toFixed(3)},${columns.easting[i].toFixed(3)},` +
+					`${wgs84.latitude[i].toFixed(8)},${wgs84.longitude[i].toFixed(8)},` +
+					`${columns.accuracy[i].toFixed(1)},${formatExportSpeed(columns.speed[i])},` +
+					`${nameSheets(columns.northing[i], columns.easting[i]).join(',')}\n`;
+			}
+			return out;
+		},
+		footer: () => ''
+	};
+}
+
+function createTrackSerializer(format: TrackTextExportFormat): TrackSerializer {
+	switch (format) {
+		case 'gpx':
+			return createGpxSerializer();
+		case 'geojson':
+			return createGeoJsonSerializer();
+		case 'csv':
+			return createCsvSerializer();
+	}
+}
+
+/**
+ * Creates a byte stream of the serialized track
+ *
+ * Chunks are read from IndexedDB on demand (pull), so only one chunk is held
+ * in memory regardless of track length. The stream is optionally gzipped.
+ */
+function createTrackExportStream(
+	db: IDBDatabase,
+	track: TrackRecord,
+	serializer: TrackSerializer,
+	compress: boolean,
+	drift: Itrf2Etrs89Correction
+): ReadableStream<Uint8Array> {
+	const encoder = new TextEncoder();
+	const chunkCount = track.chunkCount;
+	let seq = 0;
+
+	const source = new ReadableStream<Uint8Array>({
+		start(controller) {
+			controller.enqueue(encoder.encode(serializer.header(track)));
+		},
+		async pull(controller) {
+			if (seq >= chunkCount) {
+				const footer = serializer.footer();
+				if (footer) {
+					controller.enqueue(encoder.encode(footer));
+				}
+				controller.close();
+				return;
+			}
+
+			const columns = await readTrackChunk(db, track.id, seq);
+			seq++;
+			if (columns) {
+				controller.enqueue(encoder.encode(serializer.chunk(columns, computeWgs84Columns(columns, drift))));
+			}
+		}
+	}, { highWaterMark: 1 });
+
+	if (compress && isCompressionSupported()) {
+		return source.pipeThrough(new CompressionStream('gzip'));
+	}
+	return source;
+}
+
+function getTrackExportFileName(track: TrackRecord, extension: string, compressed: boolean): string {
+	const date = formatExportTime(track.startTime).slice(0, 19).replace(/[:T]/g, '-');
+	return `spar-${date}.${extension}${compressed ? '.gz' : ''}`;
+}
+
+/**
+ * Writes a track export to a file chosen by the user
+ *
+ * Only one serialized chunk is in memory at a time, however long the track.
+ */
+async function exportTrackToWritable(
+	db: IDBDatabase,
+	track: TrackRecord,
+	format: TrackTextExportFormat,
+	compressed: boolean,
+	drift: Itrf2Etrs89Correction,
+	writable: WritableStream<Uint8Array>
+): Promise<void> {
+	await createTrackExportStream(db, track, createTrackSerializer(format), compressed, drift).pipeTo(writable);
+}
+
+/**
+ * Exports a track to a File
+ *
+ * The whole export is collected into a Blob before it is returned, so memory
+ * grows with the length of the track unless the browser keeps large Blobs on
+ * disk. Prefer exportTrackToWritable() where a file can be written directly.
+ */
+async function exportTrackToFile(
+	db: IDBDatabase,
+	track: TrackRecord,
+	format: TrackTextExportFormat,
+	compress: boolean,
+	drift: Itrf2Etrs89Correction
+): Promise<File> {
+	const serializer = createTrackSerializer(format);
+	const compressed = compress && isCompressionSupported();
+	const stream = createTrackExportStream(db, track, serializer, compressed, drift);
+	const blob = await new Response(stream).blob();
+	return new File([blob], getTrackExportFileName(track, serializer.extension, compressed), {
+		type: compressed ? 'application/gzip' : serializer.mimeType
+	});
+}
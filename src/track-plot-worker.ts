@@ -0,0 +1,57 @@
+// ============================================================================
+// TRACK PLOT WORKER
+// ============================================================================
+//
+// Web Worker som ritar spåret på en OffscreenCanvas, så att varken nya
+// positioner eller omritningar vid zoom och panorering tar tid från
+// huvudtråden. Arbetaren läser det sparade spåret direkt från IndexedDB.
+//
+// Meddelanden hanteras ett i taget i ordning, så att positioner som kommer
+// medan spåret läses in ritas efter det.
+
+declare function importScripts(...urls: string[]): void;
+
+/**
+ * Hands the canvas to the worker; must be the first message
+ */
+interface TrackPlotInitRequest {
+	type: 'init';
+	canvas: OffscreenCanvas;
+}
+
+type TrackPlotWorkerRequest = TrackPlotInitRequest | TrackPlotRequest;
+
+importScripts(
+	'track-codec.js',
+	'track-store.js',
+	'track-simplify.js',
+	'replay-harness.js',
+	'track-plot.js'
+);
+
+let workerTrackPlot: TrackPlot | null = null;
+let workerTrackPlotQueue: Promise<void> = Promise.resolve();
+
+self.onmessage = (event: MessageEvent<TrackPlotWorkerRequest>) => {
+	const request = event.data;
+	if (request.type === 'init') {
+		const context = request.canvas.getContext('2d');
+		if (context) {
+			workerTrackPlot = new TrackPlot(request.canvas, context);
+		}
+		return;
+	}
+	workerTrackPlotQueue = workerTrackPlotQueue
+		.then(async () => {
+			if (workerTrackPlot === null) {
+				return;
+			}
+			const response = await handleTrackPlotRequest(workerTrackPlot, request);
+			if (response !== null) {
+				self.postMessage(response);
+			}
+		})
+		.catch((error) => {
+			console.warn('Kunde inte rita spår:', error);
+		});
+};
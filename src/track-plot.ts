@@ -0,0 +1,484 @@
+// ============================================================================
+// TRACK PLOT (incremental track drawing with levels of detail)
+// ============================================================================
+//
+// Ritar det inspelade spåret med rutnätsnorr uppåt i SWEREF 99 TM-planet.
+// Canvasen behåller det som redan ritats, så en ny position ritar bara en
+// sträcka från föregående punkt. Kostnaden per position är därför konstant
+// oavsett hur långt spåret är.
+//
+// När vyn zoomas eller panoreras ritas hela spåret om. Då används en av
+// flera detaljnivåer som byggs samtidigt som punkterna läggs till: varje nivå
+// förenklar spåret med Douglas–Peucker (track-simplify.ts) i fönster av fast
+// storlek, med fyra gånger större tolerans per nivå. Den grövsta nivå vars
+// fel är under en halv pixel väljs, så en omritning av 100 000 punkter
+// utzoomad kostar bara några hundra linjesegment.
+//
+// Spåret ritas normalt i en Web Worker via OffscreenCanvas
+// (track-plot-worker.ts), men samma kod används på huvudtråden när
+// webbläsaren saknar OffscreenCanvas. Filen innehåller ingen DOM-kod.
+
+/**
+ * Simplification tolerance per level of detail in metres; level 0 holds every point
+ */
+const TRACK_PLOT_TOLERANCES = [0, 1, 4, 16, 64, 256] as const;
+
+/**
+ * Points per Douglas–Peucker window in the simplified levels
+ * Also the most points drawn unsimplified at the end of a level.
+ */
+const TRACK_PLOT_WINDOW_SIZE = 1024;
+
+const TRACK_PLOT_MIN_METRES_PER_PIXEL = 0.25;
+const TRACK_PLOT_MAX_METRES_PER_PIXEL = 2000;
+const TRACK_PLOT_DEFAULT_METRES_PER_PIXEL = 5;
+/** Margin around the track when fitting the view, as a share of the view */
+const TRACK_PLOT_FIT_MARGIN = 0.1;
+/** The view follows the track once the newest point is this close to an edge */
+const TRACK_PLOT_FOLLOW_MARGIN = 0.1;
+const TRACK_PLOT_LINE_WIDTH = 2;
+const TRACK_PLOT_TIMING_SAMPLES = 240;
+
+/**
+ * Messages to the plot, from the page to the worker or the local fallback
+ */
+type TrackPlotRequest =
+	| { type: 'resize'; width: number; height: number; pixelRatio: number; color: string }
+	| { type: 'load'; trackId: number | null; chunkCount: number }
+	| { type: 'append'; northing: number; easting: number }
+	| { type: 'zoom'; factor: number }
+	| { type: 'pan'; dx: number; dy: number }
+	| { type: 'fit' }
+	| { type: 'stats' };
+
+interface TrackPlotStats {
+	fixCount: number;
+	/** Points drawn in the latest full redraw */
+	drawnCount: number;
+	/** Tolerance of the level used in the latest full redraw, metres */
+	tolerance: number;
+	/** Time per point drawn incrementally, including the levels; moving the view counts as a redraw */
+	append: ReplayTimingStats;
+	redraw: ReplayTimingStats;
+}
+
+interface TrackPlotStatsResponse {
+	type: 'stats';
+	stats: TrackPlotStats;
+}
+
+/**
+ * The parts of a 2D context the plot uses, shared by canvas and OffscreenCanvas
+ */
+type TrackPlotContext = Pick<CanvasRenderingContext2D,
+	'setTransform' | 'clearRect' | 'beginPath' | 'moveTo' | 'lineTo' | 'stroke' |
+	'strokeStyle' | 'lineWidth' | 'lineCap' | 'lineJoin'>;
+
+interface TrackPlotCanvas {
+	width: number;
+	height: number;
+}
+
+/**
+ * Growable northing and easting columns
+ */
+class TrackPlotPoints {
+	count: number = 0;
+	northing: Float64Array;
+	easting: Float64Array;
+
+	constructor(capacity: number = 256) {
+		this.northing = new Float64Array(capacity);
+		this.easting = new Float64Array(capacity);
+	}
+
+	push(northing: number, easting: number): void {
+		if (this.count === this.northing.length) {
+			const northingColumn = new Float64Array(this.count * 2);
+			const eastingColumn = new Float64Array(this.count * 2);
+			northingColumn.set(this.northing);
+			eastingColumn.set(this.easting);
+			this.northing = northingColumn;
+			this.easting = eastingColumn;
+		}
+		this.northing[this.count] = northing;
+		this.easting[this.count] = easting;
+		this.count++;
+	}
+
+	clear(): void {
+		this.count = 0;
+	}
+}
+
+/**
+ * TrackPlotLevel - one level of detail, simplified while points are added
+ *
+ * Points wait in a window until it is full; then the points Douglas–Peucker
+ * keeps are moved to the level, except the last, which starts the next
+ * window. The level is drawn as its points followed by the window.
+ */
+class TrackPlotLevel {
+	readonly points = new TrackPlotPoints();
+	readonly window: TrackPlotPoints;
+	private readonly keep: Uint8Array;
+	private readonly stack: Int32Array;
+
+	constructor(readonly tolerance: number, private readonly windowSize: number = TRACK_PLOT_WINDOW_SIZE) {
+		this.window = new TrackPlotPoints(tolerance === 0 ? 0 : windowSize);
+		this.keep = new Uint8Array(tolerance === 0 ? 0 : windowSize);
+		this.stack = new Int32Array(tolerance === 0 ? 0 : windowSize * 2);
+	}
+
+	push(northing: number, easting: number): void {
+		if (this.tolerance === 0) {
+			this.points.push(northing, easting);
+			return;
+		}
+		const window = this.window;
+		window.northing[window.count] = northing;
+		window.easting[window.count] = easting;
+		window.count++;
+		if (window.count === this.windowSize) {
+			this.simplifyWindow();
+		}
+	}
+
+	/**
+	 * Points drawn for this level: the simplified points and the window
+	 */
+	get drawnCount(): number {
+		return this.points.count + this.window.count;
+	}
+
+	clear(): void {
+		this.points.clear();
+		this.window.clear();
+	}
+
+	private simplifyWindow(): void {
+		const window = this.window;
+		const count = window.count;
+		douglasPeuckerMark(window.northing, window.easting, count, this.tolerance, this.keep, this.stack);
+		for (let i = 0; i < count - 1; i++) {
+			if (this.keep[i]) {
+				this.points.push(window.northing[i], window.easting[i]);
+			}
+		}
+		window.northing[0] = window.northing[count - 1];
+		window.easting[0] = window.easting[count - 1];
+		window.count = 1;
+	}
+}
+
+/**
+ * Picks the coarsest level whose error stays under half a pixel
+ * @param metresPerPixel - Scale in metres per CSS pixel
+ */
+function chooseTrackPlotLevel(metresPerPixel: number): number {
+	let level = 0;
+	for (let i = 1; i < TRACK_PLOT_TOLERANCES.length; i++) {
+		if (TRACK_PLOT_TOLERANCES[i] <= metresPerPixel / 2) {
+			level = i;
+		}
+	}
+	return level;
+}
+
+/**
+ * TrackPlot - draws a growing track on a canvas that keeps its content
+ *
+ * The view is a centre in SWEREF 99 TM and a scale in metres per CSS pixel.
+ * The view follows the newest point until it is panned, and again after fit().
+ */
+class TrackPlot {
+	private readonly levels = TRACK_PLOT_TOLERANCES.map((tolerance) => new TrackPlotLevel(tolerance));
+	private widthCss: number = 0;
+	private heightCss: number = 0;
+	private pixelRatio: number = 1;
+	private color: string = '#000';
+	private centerNorthing: number = Number.NaN;
+	private centerEasting: number = Number.NaN;
+	private metresPerPixel: number = TRACK_PLOT_DEFAULT_METRES_PER_PIXEL;
+	private following: boolean = true;
+	private minNorthing: number = Infinity;
+	private minEasting: number = Infinity;
+	private maxNorthing: number = -Infinity;
+	private maxEasting: number = -Infinity;
+	private drawnCount: number = 0;
+	private drawnTolerance: number = 0;
+	private readonly appendTimes = new Float64Array(TRACK_PLOT_TIMING_SAMPLES);
+	private appendCount: number = 0;
+	private readonly redrawTimes = new Float64Array(TRACK_PLOT_TIMING_SAMPLES);
+	private redrawCount: number = 0;
+
+	constructor(private readonly canvas: TrackPlotCanvas, private readonly context: TrackPlotContext) {}
+
+	get fixCount(): number {
+		return this.levels[0].points.count;
+	}
+
+	get scale(): number {
+		return this.metresPerPixel;
+	}
+
+	/**
+	 * Sets the size of the view in CSS pixels and the colour of the track
+	 */
+	resize(width: number, height: number, pixelRatio: number, color: string): void {
+		this.widthCss = width;
+		this.heightCss = height;
+		this.pixelRatio = pixelRatio;
+		this.color = color;
+		const canvasWidth = Math.round(width * pixelRatio);
+		const canvasHeight = Math.round(height * pixelRatio);
+		if (this.canvas.width !== canvasWidth || this.canvas.height !== canvasHeight) {
+			// Canvasen töms när storleken sätts
+			this.canvas.width = canvasWidth;
+			this.canvas.height = canvasHeight;
+		}
+		this.redraw();
+	}
+
+	clear(): void {
+		for (const level of this.levels) {
+			level.clear();
+		}
+		this.minNorthing = Infinity;
+		this.minEasting = Infinity;
+		this.maxNorthing = -Infinity;
+		this.maxEasting = -Infinity;
+		this.centerNorthing = Number.NaN;
+		this.centerEasting = Number.NaN;
+		this.following = true;
+		this.redraw();
+	}
+
+	/**
+	 * Adds stored points without drawing; call fit() or redraw() afterwards
+	 */
+	load(columns: TrackColumns): void {
+		for (let i = 0; i < columns.count; i++) {
+			this.addPoint(columns.northing[i], columns.easting[i]);
+		}
+	}
+
+	/**
+	 * Adds a point and draws only the new segment, unless the view has to
+	 * move to keep following the track
+	 */
+	append(northing: number, easting: number): void {
+		const start = performance.now();
+		const previous = this.levels[0].points;
+		const hasPrevious = previous.count > 0;
+		const previousNorthing = hasPrevious ? previous.northing[previous.count - 1] : northing;
+		const previousEasting = hasPrevious ? previous.easting[previous.count - 1] : easting;
+		this.addPoint(northing, easting);
+
+		if (!Number.isFinite(this.centerNorthing) || (this.following && !this.isInsideFollowMargin(northing, easting))) {
+			this.centerNorthing = northing;
+			this.centerEasting = easting;
+			this.redraw();
+			return;
+		}
+		if (this.widthCss > 0) {
+			const context = this.context;
+			this.applyStyle(context);
+			context.beginPath();
+			context.moveTo(this.toX(previousEasting), this.toY(previousNorthing));
+			context.lineTo(this.toX(easting), this.toY(northing));
+			context.stroke();
+			this.drawnCount++;
+		}
+		this.appendTimes[this.appendCount % TRACK_PLOT_TIMING_SAMPLES] = performance.now() - start;
+		this.appendCount++;
+	}
+
+	/**
+	 * Zooms around the centre; factor > 1 zooms out
+	 */
+	zoom(factor: number): void {
+		this.metresPerPixel = Math.min(Math.max(this.metresPerPixel * factor, TRACK_PLOT_MIN_METRES_PER_PIXEL), TRACK_PLOT_MAX_METRES_PER_PIXEL);
+		this.redraw();
+	}
+
+	/**
+	 * Moves the view by CSS pixels and stops following the track
+	 */
+	pan(dx: number, dy: number): void {
+		if (!Number.isFinite(this.centerNorthing)) {
+			return;
+		}
+		this.centerEasting -= dx * this.metresPerPixel;
+		this.centerNorthing += dy * this.metresPerPixel;
+		this.following = false;
+		this.redraw();
+	}
+
+	/**
+	 * Shows the whole track and follows it again
+	 */
+	fit(): void {
+		this.following = true;
+		if (this.fixCount === 0) {
+			this.redraw();
+			return;
+		}
+		this.centerNorthing = (this.minNorthing + this.maxNorthing) / 2;
+		this.centerEasting = (this.minEasting + this.maxEasting) / 2;
+		if (this.widthCss > 0 && this.heightCss > 0) {
+			const usable = 1 - 2 * TRACK_PLOT_FIT_MARGIN;
+			const fitted = Math.max(
+				(this.maxEasting - this.minEasting) / (this.widthCss * usable),
+				(this.maxNorthing - this.minNorthing) / (this.heightCss * usable)
+			);
+			this.metresPerPixel = Math.min(Math.max(fitted, TRACK_PLOT_MIN_METRES_PER_PIXEL), TRACK_PLOT_MAX_METRES_PER_PIXEL);
+		}
+		this.redraw();
+	}
+
+	stats(): TrackPlotStats {
+		return {
+			fixCount: this.fixCount,
+			drawnCount: this.drawnCount,
+			tolerance: this.drawnTolerance,
+			append: summarizeTimings(this.appendTimes, Math.min(this.appendCount, TRACK_PLOT_TIMING_SAMPLES)),
+			redraw: summarizeTimings(this.redrawTimes, Math.min(this.redrawCount, TRACK_PLOT_TIMING_SAMPLES))
+		};
+	}
+
+	/**
+	 * Draws the whole track from the level of detail that suits the scale
+	 */
+	redraw(): void {
+		const context = this.context;
+		const start = performance.now();
+		context.setTransform(1, 0, 0, 1, 0, 0);
+		context.clearRect(0, 0, this.canvas.width, this.canvas.height);
+		this.drawnCount = 0;
+		if (this.widthCss === 0 || !Number.isFinite(this.centerNorthing)) {
+			return;
+		}
+
+		const level = this.levels[chooseTrackPlotLevel(this.metresPerPixel)];
+		this.drawnTolerance = level.tolerance;
+		this.applyStyle(context);
+		context.beginPath();
+		const cursor = { x: 0, y: 0, inside: false, started: false };
+		this.tracePoints(context, level.points, cursor);
+		this.tracePoints(context, level.window, cursor);
+		context.stroke();
+
+		this.redrawTimes[this.redrawCount % TRACK_PLOT_TIMING_SAMPLES] = performance.now() - start;
+		this.redrawCount++;
+	}
+
+	/**
+	 * Adds points to the path, skipping segments that lie wholly outside
+	 * one edge of the canvas
+	 */
+	private tracePoints(context: TrackPlotContext, points: TrackPlotPoints, cursor: { x: number; y: number; inside: boolean; started: boolean }): void {
+		const width = this.canvas.width;
+		const height = this.canvas.height;
+		let { x: previousX, y: previousY, started } = cursor;
+		let penDown = cursor.inside;
+		for (let i = 0; i < points.count; i++) {
+			const x = this.toX(points.easting[i]);
+			const y = this.toY(points.northing[i]);
+			const outside = started && (
+				(x < 0 && previousX < 0) || (x > width && previousX > width) ||
+				(y < 0 && previousY < 0) || (y > height && previousY > height));
+			if (outside) {
+				penDown = false;
+			} else {
+				if (!penDown) {
+					context.moveTo(started ? previousX : x, started ? previousY : y);
+					penDown = true;
+				}
+				context.lineTo(x, y);
+				this.drawnCount++;
+			}
+			previousX = x;
+			previousY = y;
+			started = true;
+		}
+		cursor.x = previousX;
+		cursor.y = previousY;
+		cursor.inside = penDown;
+		cursor.started = started;
+	}
+
+	private addPoint(northing: number, easting: number): void {
+		for (const level of this.levels) {
+			level.push(northing, easting);
+		}
+		this.minNorthing = Math.min(this.minNorthing, northing);
+		this.minEasting = Math.min(this.minEasting, easting);
+		this.maxNorthing = Math.max(this.maxNorthing, northing);
+		this.maxEasting = Math.max(this.maxEasting, easting);
+	}
+
+	private isInsideFollowMargin(northing: number, easting: number): boolean {
+		const x = (easting - this.centerEasting) / this.metresPerPixel;
+		const y = (this.centerNorthing - northing) / this.metresPerPixel;
+		const halfWidth = this.widthCss * (0.5 - TRACK_PLOT_FOLLOW_MARGIN);
+		const halfHeight = this.heightCss * (0.5 - TRACK_PLOT_FOLLOW_MARGIN);
+		return Math.abs(x) <= halfWidth && Math.abs(y) <= halfHeight;
+	}
+
+	private applyStyle(context: TrackPlotContext): void {
+		context.strokeStyle = this.color;
+		context.lineWidth = TRACK_PLOT_LINE_WIDTH * this.pixelRatio;
+		context.lineCap = 'round';
+		context.lineJoin = 'round';
+	}
+
+	private toX(easting: number): number {
+		return this.canvas.width / 2 + (easting - this.centerEasting) / this.metresPerPixel * this.pixelRatio;
+	}
+
+	private toY(northing: number): number {
+		return this.canvas.height / 2 - (northing - this.centerNorthing) / this.metresPerPixel * this.pixelRatio;
+	}
+}
+
+/**
+ * Handles one message to the plot; used by the worker and the local fallback
+ * Messages must be handled one at a time, in order, since loading is asynchronous.
+ * @returns A response to send back, or null
+ */
+async function handleTrackPlotRequest(plot: TrackPlot, request: TrackPlotRequest): Promise<TrackPlotStatsResponse | null> {
+	switch (request.type) {
+		case 'resize':
+			plot.resize(request.width, request.height, request.pixelRatio, request.color);
+			return null;
+		case 'load': {
+			plot.clear();
+			if (request.trackId !== null) {
+				const db = await openTrackDatabase();
+				for (let seq = 0; seq < request.chunkCount; seq++) {
+					const columns = await readTrackChunk(db, request.trackId, seq);
+					if (columns) {
+						plot.load(columns);
+					}
+				}
+			}
+			plot.fit();
+			return null;
+		}
+		case 'append':
+			plot.append(request.northing, request.easting);
+			return null;
+		case 'zoom':
+			plot.zoom(request.factor);
+			return null;
+		case 'pan':
+			plot.pan(request.dx, request.dy);
+			return null;
+		case 'fit':
+			plot.fit();
+			return null;
+		case 'stats':
+			return { type: 'stats', stats: plot.stats() };
+	}
+}
@@ -0,0 +1,185 @@
+// ============================================================================
+// TRACK SIMPLIFICATION (Douglas–Peucker)
+// ============================================================================
+//
+// Förenklingen görs direkt i SWEREF 99 TM-planet där avstånd är euklidiska
+// i meter. Punkterna behandlas i ett glidande fönster av fast storlek: när
+// fönstret är fullt körs Douglas–Peucker på det, alla behållna punkter utom
+// den sista skickas vidare och den sista blir början på nästa fönster. Varje
+// borttagen punkt ligger därmed inom toleransen från det förenklade spåret,
+// medan minnesanvändningen är konstant oavsett spårets längd.
+
+/**
+ * Result statistics for one simplification run
+ */
+interface TrackSimplifyStats {
+	inputCount: number;
+	outputCount: number;
+	removedCount: number;
+	durationMs: number;
+}
+
+/**
+ * Number of points per Douglas–Peucker window
+ * Large enough that window boundaries rarely keep extra points, small enough
+ * that the quadratic worst case stays cheap.
+ */
+const SIMPLIFY_WINDOW_SIZE = 4096;
+
+/**
+ * Squared distance from point P to segment AB in the projected plane
+ */
+function squaredSegmentDistance(px: number, py: number, ax: number, ay: number, bx: number, by: number): number {
+	let dx = bx - ax;
+	let dy = by - ay;
+	const lengthSq = dx * dx + dy * dy;
+	if (lengthSq > 0) {
+		const t = ((px - ax) * dx + (py - ay) * dy) / lengthSq;
+		if (t > 1) {
+			ax = bx;
+			ay = by;
+		} else if (t > 0) {
+			ax += dx * t;
+			ay += dy * t;
+		}
+	}
+	dx = px - ax;
+	dy = py - ay;
+	return dx * dx + dy * dy;
+}
+
+/**
+ * Marks the points Douglas–Peucker keeps between index 0 and count - 1
+ * Iterative with an explicit stack, so long windows cannot overflow the call stack.
+ *
+ * @param keep - Output flags, 1 for kept points
+ * @param stack - Scratch space of at least 2 * count entries
+ */
+function douglasPeuckerMark(
+	northing: Float64Array,
+	easting: Float64Array,
+	count: number,
+	tolerance: number,
+	keep: Uint8Array,
+	stack: Int32Array
+): void {
+	keep.fill(0, 0, count);
+	if (count === 0) {
+		return;
+	}
+	keep[0] = 1;
+	keep[count - 1] = 1;
+
+	const toleranceSq = tolerance * tolerance;
+	let top = 0;
+	stack[top++] = 0;
+	stack[top++] = count - 1;
+
+	while (top > 0) {
+		const last = stack[--top];
+		const first = stack[--top];
+		let maxDistanceSq = toleranceSq;
+		let index = -1;
+
+		for (let i = first + 1; i < last; i++) {
+			const distanceSq = squaredSegmentDistance(
+				easting[i], northing[i],
+				easting[first], northing[first],
+				easting[last], northing[last]
+			);
+			if (distanceSq > maxDistanceSq) {
+				maxDistanceSq = distanceSq;
+				index = i;
+			}
+		}
+
+		if (index !== -1) {
+			keep[index] = 1;
+			stack[top++] = first;
+			stack[top++] = index;
+			stack[top++] = index;
+			stack[top++] = last;
+		}
+	}
+}
+
+function copyTrackFix(source: TrackColumns, sourceIndex: number, target: TrackColumns, targetIndex: number): void {
+	target.timestamp[targetIndex] = source.timestamp[sourceIndex];
+	target.northing[targetIndex] = source.northing[sourceIndex];
+	target.easting[targetIndex] = source.easting[sourceIndex];
+	target.accuracy[targetIndex] = source.accuracy[sourceIndex];
+	target.speed[targetIndex] = source.speed[sourceIndex];
+}
+
+/**
+ * StreamingSimplifier - Douglas–Peucker över ett glidande fönster
+ *
+ * push() tar emot block i tidsordning och emit() anropas för varje behållen
+ * punkt i samma ordning. finish() måste anropas efter sista blocket.
+ */
+class StreamingSimplifier {
+	private points: TrackColumns;
+	private keep: Uint8Array;
+	private stack: Int32Array;
+	private inputCount: number = 0;
+	private outputCount: number = 0;
+
+	constructor(
+		private tolerance: number,
+		private emit: (columns: TrackColumns, index: number) => void,
+		private windowSize: number = SIMPLIFY_WINDOW_SIZE
+	) {
+		this.points = createTrackColumns(windowSize);
+		this.keep = new Uint8Array(windowSize);
+		this.stack = new Int32Array(windowSize * 2);
+	}
+
+	push(columns: TrackColumns): void {
+		for (let i = 0; i < columns.count; i++) {
+			copyTrackFix(columns, i, this.points, this.points.count++);
+			this.inputCount++;
+			if (this.points.count === this.windowSize) {
+				this.process(false);
+			}
+		}
+	}
+
+	finish(): void {
+		this.process(true);
+	}
+
+	getStats(durationMs: number): TrackSimplifyStats {
+		return {
+			inputCount: this.inputCount,
+			outputCount: this.outputCount,
+			removedCount: this.inputCount - this.outputCount,
+			durationMs
+		};
+	}
+
+	private process(isFinal: boolean): void {
+		const points = this.points;
+		const count = points.count;
+		if (count === 0) {
+			return;
+		}
+
+		douglasPeuckerMark(points.northing, points.easting, count, this.tolerance, this.keep, this.stack);
+
+		// Sista punkten skickas först när fönstret avslutar spåret
+		const emitEnd = isFinal ? count : count - 1;
+		for (let i = 0; i < emitEnd; i++) {
+			if (this.keep[i]) {
+				this.emit(points, i);
+				this.outputCount++;
+			}
+		}
+
+		if (isFinal) {
+			points.count = 0;
+		} else {
+			copyTrackFix(points, count - 1, points, 0);
+			points.count = 1;
+		}
+	}
+}
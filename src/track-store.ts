@@ -0,0 +1,368 @@
+// ============================================================================
+// TRACK STORAGE (IndexedDB)
+// ============================================================================
+//
+// Inspelade spår lagras i IndexedDB som numrerade block (chunks) med ett
+// begränsat antal positioner per block, kodade med track-codec.ts. Läsning
+// sker alltid ett block i taget så att export och andra konsumenter håller
+// minnesanvändningen konstant oavsett spårets längd.
+//
+// Filen innehåller ingen DOM-kod och kan därför även laddas i Web Workers.
+
+/**
+ * A single recorded position fix
+ */
+interface TrackFix {
+	timestamp: number;
+	northing: number;
+	easting: number;
+	accuracy: number;
+	speed: number | null;
+}
+
+/**
+ * Columnar representation of a chunk of fixes
+ * Only SWEREF 99 TM is stored; WGS 84 is derived when needed.
+ * Speed is NaN when the device reported null.
+ */
+interface TrackColumns {
+	count: number;
+	timestamp: Float64Array;
+	northing: Float64Array;
+	easting: Float64Array;
+	accuracy: Float64Array;
+	speed: Float64Array;
+}
+
+/**
+ * Metadata for a recorded track
+ * Derived tracks (e.g. simplified copies) reference their source track.
+ */
+interface TrackRecord {
+	id: number;
+	startTime: number;
+	endTime: number;
+	fixCount: number;
+	chunkCount: number;
+	simplifiedFrom?: number;
+}
+
+/**
+ * Chunk as stored in the chunk object store
+ * Chunks written before the binary format have columns instead of data.
+ */
+interface StoredTrackChunk {
+	trackId: number;
+	seq: number;
+	data?: Uint8Array;
+	columns?: TrackColumns;
+}
+
+/**
+ * Largest absolute value accepted in a column, before scaling to integers
+ * A scaled value this large still leaves room for the zigzag-coded delta
+ * between two such values in a safe integer (see writeDeltaColumn).
+ */
+const TRACK_MAX_STORED_VALUE = Number.MAX_SAFE_INTEGER / 4 / TRACK_CODEC_SCALE.COORDINATE;
+
+const TRACK_DB_NAME = 'sweref99-spar';
+const TRACK_DB_VERSION = 1;
+const TRACK_STORE = 'tracks';
+const TRACK_CHUNK_STORE = 'chunks';
+
+/**
+ * Number of fixes per stored chunk
+ * 256 fixes is about four minutes at 1 Hz, which bounds both the amount of
+ * data lost if the page is killed and the memory needed to read one chunk.
+ */
+const TRACK_CHUNK_SIZE = 256;
+
+function isTrackStorageSupported(): boolean {
+	return typeof indexedDB !== 'undefined';
+}
+
+function createTrackColumns(capacity: number): TrackColumns {
+	return {
+		count: 0,
+		timestamp: new Float64Array(capacity),
+		northing: new Float64Array(capacity),
+		easting: new Float64Array(capacity),
+		accuracy: new Float64Array(capacity),
+		speed: new Float64Array(capacity)
+	};
+}
+
+function requestToPromise<T>(request: IDBRequest<T>): Promise<T> {
+	return new Promise((resolve, reject) => {
+		request.onsuccess = () => resolve(request.result);
+		request.onerror = () => reject(request.error);
+	});
+}
+
+function transactionDone(transaction: IDBTransaction): Promise<void> {
+	return new Promise((resolve, reject) => {
+		transaction.oncomplete = () => resolve();
+		transaction.onerror = () => reject(transaction.error);
+		transaction.onabort = () => reject(transaction.error);
+	});
+}
+
+let trackDatabasePromise: Promise<IDBDatabase> | null = null;
+
+/**
+ * Opens (and if needed creates) the track database
+ * The connection is shared by all callers.
+ */
+function openTrackDatabase(): Promise<IDBDatabase> {
+	if (trackDatabasePromise === null) {
+		trackDatabasePromise = new Promise<IDBDatabase>((resolve, reject) => {
+			const request = indexedDB.open(TRACK_DB_NAME, TRACK_DB_VERSION);
+			request.onupgradeneeded = () => {
+				const db = request.result;
+				if (!db.objectStoreNames.contains(TRACK_STORE)) {
+					db.createObjectStore(TRACK_STORE, { keyPath: 'id', autoIncrement: true });
+				}
+				if (!db.objectStoreNames.contains(TRACK_CHUNK_STORE)) {
+					db.createObjectStore(TRACK_CHUNK_STORE, { keyPath: ['trackId', 'seq'] });
+				}
+			};
+			request.onsuccess = () => resolve(request.result);
+			request.onerror = () => reject(request.error);
+		});
+		// Tillåt nytt försök om öppningen misslyckades
+		trackDatabasePromise.catch(() => {
+			trackDatabasePromise = null;
+		});
+	}
+	return trackDatabasePromise;
+}
+
+async function createTrack(db: IDBDatabase, startTime: number, simplifiedFrom?: number): Promise<TrackRecord> {
+	const transaction = db.transaction(TRACK_STORE, 'readwrite');
+	const record: Omit<TrackRecord, 'id'> = {
+		startTime,
+		endTime: startTime,
+		fixCount: 0,
+		chunkCount: 0
+	};
+	if (simplifiedFrom !== undefined) {
+		record.simplifiedFrom = simplifiedFrom;
+	}
+	const id = await requestToPromise(transaction.objectStore(TRACK_STORE).add(record));
+	await transactionDone(transaction);
+	return { id: id as number, ...record };
+}
+
+/**
+ * Appends an encoded chunk to a track and updates the track metadata atomically
+ */
+async function appendTrackChunk(db: IDBDatabase, track: TrackRecord, data: Uint8Array): Promise<void> {
+	const header = readTrackChunkHeader(data);
+	if (header.count === 0) {
+		return;
+	}
+
+	const transaction = db.transaction([TRACK_STORE, TRACK_CHUNK_STORE], 'readwrite');
+	const chunk: StoredTrackChunk = { trackId: track.id, seq: track.chunkCount, data };
+	transaction.objectStore(TRACK_CHUNK_STORE).put(chunk);
+
+	track.chunkCount++;
+	track.fixCount += header.count;
+	track.endTime = header.endTime;
+	transaction.objectStore(TRACK_STORE).put(track);
+	await transactionDone(transaction);
+}
+
+function decodeStoredTrackChunk(chunk: StoredTrackChunk): TrackColumns | null {
+	if (chunk.data) {
+		return decodeTrackChunk(chunk.data);
+	}
+	// Äldre block har okodade kolumner som redan har rätt form
+	return chunk.columns ?? null;
+}
+
+async function readTrackChunk(db: IDBDatabase, trackId: number, seq: number): Promise<TrackColumns | null> {
+	const transaction = db.transaction(TRACK_CHUNK_STORE, 'readonly');
+	const chunk = await requestToPromise(transaction.objectStore(TRACK_CHUNK_STORE).get([trackId, seq])) as StoredTrackChunk | undefined;
+	return chunk ? decodeStoredTrackChunk(chunk) : null;
+}
+
+async function getTrack(db: IDBDatabase, trackId: number): Promise<TrackRecord | null> {
+	const transaction = db.transaction(TRACK_STORE, 'readonly');
+	const track = await requestToPromise(transaction.objectStore(TRACK_STORE).get(trackId)) as TrackRecord | undefined;
+	return track ?? null;
+}
+
+/**
+ * Returns the most recently started recorded track, skipping derived tracks
+ */
+function getLatestTrack(db: IDBDatabase): Promise<TrackRecord | null> {
+	const transaction = db.transaction(TRACK_STORE, 'readonly');
+	const request = transaction.objectStore(TRACK_STORE).openCursor(null, 'prev');
+	return new Promise((resolve, reject) => {
+		request.onsuccess = () => {
+			const cursor = request.result;
+			if (!cursor) {
+				resolve(null);
+				return;
+			}
+			const track = cursor.value as TrackRecord;
+			if (track.simplifiedFrom === undefined) {
+				resolve(track);
+				return;
+			}
+			cursor.continue();
+		};
+		request.onerror = () => reject(request.error);
+	});
+}
+
+/**
+ * Deletes all derived tracks created from the given source track
+ */
+function deleteSimplifiedTracks(db: IDBDatabase, sourceTrackId: number): Promise<void> {
+	const transaction = db.transaction([TRACK_STORE, TRACK_CHUNK_STORE], 'readwrite');
+	const chunkStore = transaction.objectStore(TRACK_CHUNK_STORE);
+	const request = transaction.objectStore(TRACK_STORE).openCursor();
+	request.onsuccess = () => {
+		const cursor = request.result;
+		if (!cursor) {
+			return;
+		}
+		const track = cursor.value as TrackRecord;
+		if (track.simplifiedFrom === sourceTrackId) {
+			chunkStore.delete(IDBKeyRange.bound([track.id, 0], [track.id, Infinity]));
+			cursor.delete();
+		}
+		cursor.continue();
+	};
+	return transactionDone(transaction);
+}
+
+function isStorableTrackValue(value: number): boolean {
+	return Math.abs(value) <= TRACK_MAX_STORED_VALUE;
+}
+
+/**
+ * TrackRecorder - buffrar positioner och skriver dem blockvis till IndexedDB
+ *
+ * Skrivningar köas i en promise-kedja så att block alltid hamnar i rätt
+ * ordning, även om append() anropas innan spåret hunnit skapas.
+ */
+class TrackRecorder {
+	private track: TrackRecord | null = null;
+	private buffer: TrackColumns = createTrackColumns(TRACK_CHUNK_SIZE);
+	private pending: Promise<void> = Promise.resolve();
+	private recording: boolean = false;
+	private recordedFixes: number = 0;
+
+	isRecording(): boolean {
+		return this.recording;
+	}
+
+	/**
+	 * Number of fixes recorded in the current track, including buffered ones
+	 */
+	getFixCount(): number {
+		return this.recordedFixes;
+	}
+
+	/**
+	 * Starts a new track
+	 * @param simplifiedFrom - Source track id when writing a derived track
+	 */
+	start(startTime: number, simplifiedFrom?: number): void {
+		if (this.recording) {
+			return;
+		}
+		this.recording = true;
+		this.recordedFixes = 0;
+		this.buffer.count = 0;
+		this.enqueue(async (db) => {
+			this.track = await createTrack(db, startTime, simplifiedFrom);
+		});
+	}
+
+	/**
+	 * Metadata of the current track, once it has been created
+	 */
+	getTrack(): TrackRecord | null {
+		return this.track;
+	}
+
+	/**
+	 * Buffers a fix and writes a chunk when the buffer is full
+	 * Fixes with a time, position or accuracy that the chunk format cannot
+	 * store are skipped; an unusable speed is stored as unknown.
+	 * @returns true if the fix was recorded
+	 */
+	append(fix: TrackFix): boolean {
+		if (!this.recording || !isStorableTrackValue(fix.timestamp) || !isStorableTrackValue(fix.northing)
+			|| !isStorableTrackValue(fix.easting) || !isStorableTrackValue(fix.accuracy)) {
+			return false;
+		}
+
+		const buffer = this.buffer;
+		const i = buffer.count;
+		buffer.timestamp[i] = fix.timestamp;
+		buffer.northing[i] = fix.northing;
+		buffer.easting[i] = fix.easting;
+		buffer.accuracy[i] = fix.accuracy;
+		buffer.speed[i] = fix.speed !== null && isStorableTrackValue(fix.speed) ? fix.speed : Number.NaN;
+		buffer.count = i + 1;
+		this.recordedFixes++;
+
+		if (buffer.count >= TRACK_CHUNK_SIZE) {
+			void this.flush();
+		}
+		return true;
+	}
+
+	/**
+	 * Writes buffered fixes to storage
+	 * The buffer is emptied even if encoding fails, so that a chunk that
+	 * cannot be stored is dropped instead of stopping the recording.
+	 * @returns Promise that resolves when all queued writes are done
+	 */
+	flush(): Promise<void> {
+		if (this.buffer.count > 0) {
+			let data: Uint8Array;
+			try {
+				data = encodeTrackChunk(this.buffer);
+			} catch (error) {
+				console.warn('Kunde inte spara spår:', error);
+				return this.pending;
+			} finally {
+				this.buffer.count = 0;
+			}
+			this.enqueue(async (db) => {
+				if (this.track) {
+					await appendTrackChunk(db, this.track, data);
+				}
+			});
+		}
+		return this.pending;
+	}
+
+	/**
+	 * Resolves when all queued writes are done, without flushing the buffer
+	 */
+	waitForWrites(): Promise<void> {
+		return this.pending;
+	}
+
+	stop(): Promise<void> {
+		const done = this.flush();
+		this.recording = false;
+		return done;
+	}
+
+	private enqueue(task: (db: IDBDatabase) => Promise<void>): void {
+		this.pending = this.pending
+			.then(() => openTrackDatabase())
+			.then(task)
+			.catch((error) => {
+				console.warn('Kunde inte spara spår:', error);
+			});
+	}
+}
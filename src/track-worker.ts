@@ -0,0 +1,202 @@
+// ============================================================================
+// TRACK WORKER
+// ============================================================================
+//
+// Web Worker för tunga spåroperationer. Arbetaren läser block direkt från
+// IndexedDB så att huvudtråden bara skickar ett spår-id och får tillbaka
+// ett resultat, och gränssnittet förblir responsivt även för långa spår.
+//
+// Arbetaren importerar också punkter och spår och bygger punktindexet, så
+// att en import av tusentals punkter eller en stor GPX-fil inte låser
+// gränssnittet. Export till FlatGeobuf, där R-trädet byggs över hela
+// spåret, körs här av samma skäl.
+
+declare function importScripts(...urls: string[]): void;
+
+/**
+ * Simplifies a stored track into a new derived track
+ */
+interface TrackWorkerSimplifyRequest {
+	type: 'simplify';
+	id: number;
+	trackId: number;
+	tolerance: number;
+}
+
+interface TrackWorkerSimplifyResponse {
+	type: 'simplified';
+	id: number;
+	track: TrackRecord;
+	stats: TrackSimplifyStats;
+}
+
+/**
+ * Imports waypoints from CSV text (if any) and builds the index over all stored points
+ */
+interface TrackWorkerWaypointRequest {
+	type: 'waypoints';
+	id: number;
+	csvText?: string;
+}
+
+interface TrackWorkerWaypointResponse {
+	type: 'waypoints';
+	id: number;
+	index: WaypointIndexData;
+	imported: number;
+}
+
+/**
+ * Imports the waypoints and tracks of a GPX or KML file and rebuilds the
+ * waypoint index
+ */
+interface TrackWorkerImportRequest {
+	type: 'import';
+	id: number;
+	file: Blob;
+}
+
+interface TrackWorkerImportResponse {
+	type: 'imported';
+	id: number;
+	index: WaypointIndexData;
+	stats: GeoImportStats;
+}
+
+/**
+ * Exports a stored track and all stored waypoints as FlatGeobuf
+ */
+interface TrackWorkerExportRequest {
+	type: 'export';
+	id: number;
+	trackId: number;
+}
+
+interface TrackWorkerExportResponse {
+	type: 'exported';
+	id: number;
+	file: File;
+	stats: FlatGeobufStats;
+}
+
+interface TrackWorkerErrorResponse {
+	type: 'error';
+	id: number;
+	message: string;
+}
+
+type TrackWorkerRequest = TrackWorkerSimplifyRequest | TrackWorkerWaypointRequest | TrackWorkerImportRequest | TrackWorkerExportRequest;
+type TrackWorkerResponse =
+	| TrackWorkerSimplifyResponse
+	| TrackWorkerWaypointResponse
+	| TrackWorkerImportResponse
+	| TrackWorkerExportResponse
+	| TrackWorkerErrorResponse;
+
+/**
+ * Simplifies a track chunk by chunk and stores the result as a derived track
+ * Any earlier simplification of the same track is replaced.
+ */
+async function simplifyStoredTrack(request: TrackWorkerSimplifyRequest): Promise<TrackWorkerSimplifyResponse> {
+	const startTime = performance.now();
+	const db = await openTrackDatabase();
+	const source = await getTrack(db, request.trackId);
+	if (!source) {
+		throw new Error(`Spår ${request.trackId} finns inte`);
+	}
+
+	await deleteSimplifiedTracks(db, source.id);
+	const recorder = new TrackRecorder();
+	recorder.start(source.startTime, source.id);
+	const simplifier = new StreamingSimplifier(request.tolerance, (columns, index) => {
+		const speed = columns.speed[index];
+		recorder.append({
+			timestamp: columns.timestamp[index],
+			northing: columns.northing[index],
+			easting: columns.easting[index],
+			accuracy: columns.accuracy[index],
+			speed: Number.isNaN(speed) ? null : speed
+		});
+	});
+
+	for (let seq = 0; seq < source.chunkCount; seq++) {
+		const columns = await readTrackChunk(db, source.id, seq);
+		if (columns) {
+			simplifier.push(columns);
+		}
+		// Vänta in skrivningar så att köade block inte växer obegränsat
+		await recorder.waitForWrites();
+	}
+	simplifier.finish();
+	await recorder.stop();
+
+	const track = recorder.getTrack();
+	if (!track) {
+		throw new Error('Förenklat spår kunde inte sparas');
+	}
+	return {
+		type: 'simplified',
+		id: request.id,
+		track,
+		stats: simplifier.getStats(performance.now() - startTime)
+	};
+}
+
+async function loadWaypointIndex(request: TrackWorkerWaypointRequest): Promise<TrackWorkerWaypointResponse> {
+	const { index, imported } = await loadStoredWaypointIndex(request.csvText);
+	return { type: 'waypoints', id: request.id, index, imported };
+}
+
+async function importGeoXml(request: TrackWorkerImportRequest): Promise<TrackWorkerImportResponse> {
+	const stats = await importGeoXmlFile(request.file);
+	const { index } = await loadStoredWaypointIndex();
+	return { type: 'imported', id: request.id, index, stats };
+}
+
+async function exportFlatGeobuf(request: TrackWorkerExportRequest): Promise<TrackWorkerExportResponse> {
+	const db = await openTrackDatabase();
+	const track = await getTrack(db, request.trackId);
+	if (!track) {
+		throw new Error(`Spår ${request.trackId} finns inte`);
+	}
+	const { file, stats } = await exportFlatGeobufFile(db, track);
+	return { type: 'exported', id: request.id, file, stats };
+}
+
+function handleTrackWorkerRequest(request: TrackWorkerRequest): Promise<TrackWorkerResponse> {
+	switch (request.type) {
+		case 'simplify':
+			return simplifyStoredTrack(request);
+		case 'waypoints':
+			return loadWaypointIndex(request);
+		case 'import':
+			return importGeoXml(request);
+		case 'export':
+			return exportFlatGeobuf(request);
+	}
+}
+
+importScripts(
+	'track-codec.js',
+	'track-store.js',
+	'track-simplify.js',
+	'sweref-projection.js',
+	'waypoint-index.js',
+	'waypoint-store.js',
+	'gnss-parser.js',
+	'geo-xml-import.js',
+	'map-sheet.js',
+	'track-export.js',
+	'geofence-index.js',
+	'flatgeobuf-export.js'
+);
+
+self.onmessage = (event: MessageEvent<TrackWorkerRequest>) => {
+	const request = event.data;
+	handleTrackWorkerRequest(request)
+		.then((response) => self.postMessage(response))
+		.catch((error) => {
+			const response: TrackWorkerErrorResponse = { type: 'error', id: request.id, message: String(error) };
+			self.postMessage(response);
+		});
+};
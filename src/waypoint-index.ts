@@ -0,0 +1,268 @@
+// ============================================================================
+// WAYPOINT INDEX (uniform grid over SWEREF 99 TM)
+// ============================================================================
+//
+// Rutnätsindex för närmaste-punkt-sökning bland sparade punkter. Punkterna
+// sorteras efter ruta (räknesortering) så att varje ruta är ett
+// sammanhängande intervall i kolumnerna, och rutstorleken väljs så att en
+// ruta i medel rymmer ett fåtal punkter. En sökning går i ringar utåt från
+// positionens ruta och slutar när nästa ring inte kan innehålla något
+// närmare, så kostnaden beror på punkttätheten och inte på antalet punkter.
+//
+// Indexet består bara av typade arrayer och namn och kan därför byggas i
+// en Web Worker och skickas till huvudtråden.
+//
+// Filen innehåller ingen DOM-kod och kan därför även laddas i Web Workers.
+
+/**
+ * Serializable index data; points are ordered by cell
+ * Points of cell c are the indices cellStart[c] to cellStart[c + 1] - 1.
+ */
+interface WaypointIndexData {
+	names: string[];
+	northing: Float64Array;
+	easting: Float64Array;
+	minNorthing: number;
+	minEasting: number;
+	cellSize: number;
+	columns: number;
+	rows: number;
+	cellStart: Int32Array;
+}
+
+interface WaypointNeighbor {
+	name: string;
+	northing: number;
+	easting: number;
+	/** Distance in the SWEREF 99 TM plane, metres */
+	gridDistance: number;
+}
+
+/**
+ * Average number of points per occupied grid cell the cell size aims for
+ */
+const WAYPOINT_POINTS_PER_CELL = 4;
+
+/**
+ * Cell size limits, metres
+ */
+const WAYPOINT_MIN_CELL_SIZE = 1;
+const WAYPOINT_MAX_CELL_SIZE = 100000;
+
+/**
+ * Upper bound on the number of cells, whatever the spread of the points
+ */
+const WAYPOINT_MAX_CELLS = 1 << 20;
+
+/**
+ * Builds the grid index from points in any order
+ */
+function buildWaypointIndex(names: string[], northing: ArrayLike<number>, easting: ArrayLike<number>): WaypointIndexData {
+	const count = names.length;
+	let minNorthing = Number.POSITIVE_INFINITY;
+	let minEasting = Number.POSITIVE_INFINITY;
+	let maxNorthing = Number.NEGATIVE_INFINITY;
+	let maxEasting = Number.NEGATIVE_INFINITY;
+	for (let i = 0; i < count; i++) {
+		minNorthing = Math.min(minNorthing, northing[i]);
+		minEasting = Math.min(minEasting, easting[i]);
+		maxNorthing = Math.max(maxNorthing, northing[i]);
+		maxEasting = Math.max(maxEasting, easting[i]);
+	}
+	if (count === 0) {
+		minNorthing = minEasting = maxNorthing = maxEasting = 0;
+	}
+
+	// Rutstorlek ur medeltätheten över punkternas utbredning
+	const height = maxNorthing - minNorthing;
+	const width = maxEasting - minEasting;
+	const area = Math.max(height * width, Math.max(height, width) * WAYPOINT_MIN_CELL_SIZE);
+	let cellSize = Math.sqrt(area * WAYPOINT_POINTS_PER_CELL / Math.max(count, 1));
+	cellSize = Math.min(Math.max(cellSize, WAYPOINT_MIN_CELL_SIZE), WAYPOINT_MAX_CELL_SIZE);
+	while ((Math.floor(height / cellSize) + 1) * (Math.floor(width / cellSize) + 1) > WAYPOINT_MAX_CELLS) {
+		cellSize *= 2;
+	}
+	const rows = Math.floor(height / cellSize) + 1;
+	const columns = Math.floor(width / cellSize) + 1;
+
+	// Räknesortering efter ruta
+	const cellOf = new Int32Array(count);
+	const cellStart = new Int32Array(rows * columns + 1);
+	for (let i = 0; i < count; i++) {
+		const row = Math.floor((northing[i] - minNorthing) / cellSize);
+		const column = Math.floor((easting[i] - minEasting) / cellSize);
+		cellOf[i] = row * columns + column;
+		cellStart[cellOf[i] + 1]++;
+	}
+	for (let c = 0; c < rows * columns; c++) {
+		cellStart[c + 1] += cellStart[c];
+	}
+	const next = cellStart.slice(0, rows * columns);
+	const sortedNames: string[] = new Array(count);
+	const sortedNorthing = new Float64Array(count);
+	const sortedEasting = new Float64Array(count);
+	for (let i = 0; i < count; i++) {
+		const target = next[cellOf[i]]++;
+		sortedNames[target] = names[i];
+		sortedNorthing[target] = northing[i];
+		sortedEasting[target] = easting[i];
+	}
+
+	return {
+		names: sortedNames,
+		northing: sortedNorthing,
+		easting: sortedEasting,
+		minNorthing,
+		minEasting,
+		cellSize,
+		columns,
+		rows,
+		cellStart
+	};
+}
+
+function squaredSum(gap: number, offset: number): number {
+	const positiveGap = Math.max(gap, 0);
+	return positiveGap * positiveGap + offset * offset;
+}
+
+/**
+ * WaypointGridIndex - närmaste punkter ur ett rutnätsindex
+ */
+class WaypointGridIndex {
+	private data: WaypointIndexData;
+	private bestIndex: Int32Array = new Int32Array(0);
+	private bestDistanceSquared: Float64Array = new Float64Array(0);
+	private bestCount: number = 0;
+
+	constructor(data: WaypointIndexData) {
+		this.data = data;
+	}
+
+	get size(): number {
+		return this.data.names.length;
+	}
+
+	/**
+	 * Finds a point by its exact name
+	 * Scans all points; meant for picking a point, not for every fix.
+	 */
+	findByName(name: string): WaypointNeighbor | null {
+		const { data } = this;
+		const index = data.names.indexOf(name);
+		if (index < 0) {
+			return null;
+		}
+		return { name, northing: data.northing[index], easting: data.easting[index], gridDistance: 0 };
+	}
+
+	/**
+	 * Finds the k points nearest to a position, closest first
+	 */
+	nearest(northing: number, easting: number, k: number): WaypointNeighbor[] {
+		const { data } = this;
+		if (k <= 0 || this.size === 0) {
+			return [];
+		}
+		if (this.bestIndex.length < k) {
+			this.bestIndex = new Int32Array(k);
+			this.bestDistanceSquared = new Float64Array(k);
+		}
+		this.bestCount = 0;
+
+		// Positioner utanför rutnätet börjar i närmaste ruta
+		const centerRow = Math.min(Math.max(Math.floor((northing - data.minNorthing) / data.cellSize), 0), data.rows - 1);
+		const centerColumn = Math.min(Math.max(Math.floor((easting - data.minEasting) / data.cellSize), 0), data.columns - 1);
+		const maxRing = Math.max(centerRow, data.rows - 1 - centerRow, centerColumn, data.columns - 1 - centerColumn);
+
+		for (let ring = 0; ring <= maxRing; ring++) {
+			// Avståndet till ringen växer med ringen, så ingen senare ring kan ge något närmare
+			if (this.bestCount === k && this.ringDistanceSquared(northing, easting, centerRow, centerColumn, ring) >= this.bestDistanceSquared[k - 1]) {
+				break;
+			}
+			const rowLow = centerRow - ring;
+			const rowHigh = centerRow + ring;
+			const columnLow = Math.max(centerColumn - ring, 0);
+			const columnHigh = Math.min(centerColumn + ring, data.columns - 1);
+			for (let row = Math.max(rowLow, 0); row <= Math.min(rowHigh, data.rows - 1); row++) {
+				if (row === rowLow || row === rowHigh) {
+					for (let column = columnLow; column <= columnHigh; column++) {
+						this.scanCell(row * data.columns + column, northing, easting, k);
+					}
+				} else {
+					if (centerColumn - ring >= 0) {
+						this.scanCell(row * data.columns + centerColumn - ring, northing, easting, k);
+					}
+					if (ring > 0 && centerColumn + ring < data.columns) {
+						this.scanCell(row * data.columns + centerColumn + ring, northing, easting, k);
+					}
+				}
+			}
+		}
+
+		const neighbors: WaypointNeighbor[] = [];
+		for (let i = 0; i < this.bestCount; i++) {
+			const index = this.bestIndex[i];
+			neighbors.push({
+				name: data.names[index],
+				northing: data.northing[index],
+				easting: data.easting[index],
+				gridDistance: Math.sqrt(this.bestDistanceSquared[i])
+			});
+		}
+		return neighbors;
+	}
+
+	private scanCell(cell: number, northing: number, easting: number, k: number): void {
+		const { data } = this;
+		for (let i = data.cellStart[cell]; i < data.cellStart[cell + 1]; i++) {
+			const dn = data.northing[i] - northing;
+			const de = data.easting[i] - easting;
+			const distanceSquared = dn * dn + de * de;
+			if (this.bestCount === k && distanceSquared >= this.bestDistanceSquared[k - 1]) {
+				continue;
+			}
+			// Insättningssortering i den korta listan över de bästa
+			let position = this.bestCount < k ? this.bestCount++ : k - 1;
+			while (position > 0 && this.bestDistanceSquared[position - 1] > distanceSquared) {
+				this.bestDistanceSquared[position] = this.bestDistanceSquared[position - 1];
+				this.bestIndex[position] = this.bestIndex[position - 1];
+				position--;
+			}
+			this.bestDistanceSquared[position] = distanceSquared;
+			this.bestIndex[position] = i;
+		}
+	}
+
+	/**
+	 * Lower bound on the squared distance from a position to any cell of a ring
+	 * Every cell of the ring lies on one of its four sides. A side is at least
+	 * ring - 1 whole cells beyond the position's own cell along one axis, and
+	 * within the grid along the other.
+	 */
+	private ringDistanceSquared(northing: number, easting: number, centerRow: number, centerColumn: number, ring: number): number {
+		if (ring === 0) {
+			return 0;
+		}
+		const { data } = this;
+		const cellNorth = data.minNorthing + centerRow * data.cellSize;
+		const cellEast = data.minEasting + centerColumn * data.cellSize;
+		// Hur långt utanför rutnätet positionen ligger längs varje axel
+		const outsideNorth = Math.max(data.minNorthing - northing, northing - (data.minNorthing + data.rows * data.cellSize), 0);
+		const outsideEast = Math.max(data.minEasting - easting, easting - (data.minEasting + data.columns * data.cellSize), 0);
+		let nearest = Number.POSITIVE_INFINITY;
+		if (centerRow + ring < data.rows) {
+			nearest = Math.min(nearest, squaredSum(cellNorth + ring * data.cellSize - northing, outsideEast));
+		}
+		if (centerRow - ring >= 0) {
+			nearest = Math.min(nearest, squaredSum(northing - (cellNorth - (ring - 1) * data.cellSize), outsideEast));
+		}
+		if (centerColumn + ring < data.columns) {
+			nearest = Math.min(nearest, squaredSum(cellEast + ring * data.cellSize - easting, outsideNorth));
+		}
+		if (centerColumn - ring >= 0) {
+			nearest = Math.min(nearest, squaredSum(easting - (cellEast - (ring - 1) * data.cellSize), outsideNorth));
+		}
+		return nearest;
+	}
+}
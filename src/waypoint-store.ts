@@ -0,0 +1,139 @@
+// ============================================================================
+// WAYPOINT STORAGE (IndexedDB)
+// ============================================================================
+//
+// Namngivna punkter, t.ex. tusentals importerade grundpunkter per projekt,
+// lagras i IndexedDB med SWEREF 99 TM-koordinater. Sökningen sker i ett
+// rutnätsindex i minnet (waypoint-index.ts) som byggs om efter import.
+//
+// Filen innehåller ingen DOM-kod och kan därför även laddas i Web Workers.
+
+interface Waypoint {
+	name: string;
+	northing: number;
+	easting: number;
+}
+
+/**
+ * Waypoint as stored in the waypoint object store
+ */
+interface StoredWaypoint extends Waypoint {
+	id?: number;
+}
+
+const WAYPOINT_DB_NAME = 'sweref99-punkter';
+const WAYPOINT_DB_VERSION = 1;
+const WAYPOINT_STORE = 'waypoints';
+
+/**
+ * Coordinates above this are SWEREF 99 TM metres, below it WGS84 degrees
+ */
+const WAYPOINT_PROJECTED_THRESHOLD = 1000;
+
+let waypointDatabasePromise: Promise<IDBDatabase> | null = null;
+
+/**
+ * Opens (and if needed creates) the waypoint database
+ * The connection is shared by all callers.
+ */
+function openWaypointDatabase(): Promise<IDBDatabase> {
+	if (waypointDatabasePromise === null) {
+		waypointDatabasePromise = new Promise<IDBDatabase>((resolve, reject) => {
+			const request = indexedDB.open(WAYPOINT_DB_NAME, WAYPOINT_DB_VERSION);
+			request.onupgradeneeded = () => {
+				const db = request.result;
+				if (!db.objectStoreNames.contains(WAYPOINT_STORE)) {
+					db.createObjectStore(WAYPOINT_STORE, { keyPath: 'id', autoIncrement: true });
+				}
+			};
+			request.onsuccess = () => resolve(request.result);
+			request.onerror = () => reject(request.error);
+		});
+		// Tillåt nytt försök om öppningen misslyckades
+		waypointDatabasePromise.catch(() => {
+			waypointDatabasePromise = null;
+		});
+	}
+	return waypointDatabasePromise;
+}
+
+/**
+ * Adds waypoints in a single transaction
+ */
+async function addWaypoints(db: IDBDatabase, waypoints: Waypoint[]): Promise<void> {
+	const transaction = db.transaction(WAYPOINT_STORE, 'readwrite');
+	const store = transaction.objectStore(WAYPOINT_STORE);
+	for (const waypoint of waypoints) {
+		store.add({ name: waypoint.name, northing: waypoint.northing, easting: waypoint.easting });
+	}
+	await transactionDone(transaction);
+}
+
+async function readAllWaypoints(db: IDBDatabase): Promise<StoredWaypoint[]> {
+	const transaction = db.transaction(WAYPOINT_STORE, 'readonly');
+	return await requestToPromise(transaction.objectStore(WAYPOINT_STORE).getAll()) as StoredWaypoint[];
+}
+
+async function clearWaypoints(db: IDBDatabase): Promise<void> {
+	const transaction = db.transaction(WAYPOINT_STORE, 'readwrite');
+	transaction.objectStore(WAYPOINT_STORE).clear();
+	await transactionDone(transaction);
+}
+
+/**
+ * Parses waypoints from CSV text: name, northing, easting (SWEREF 99 TM)
+ * or name, latitude, longitude (WGS84, projected without drift correction)
+ *
+ * Comma, semicolon and tab separate fields; with semicolons or tabs a
+ * decimal comma is accepted. Lines that do not parse, such as a header,
+ * are skipped.
+ */
+function parseWaypointCsv(text: string): Waypoint[] {
+	const waypoints: Waypoint[] = [];
+	for (const rawLine of text.split('\n')) {
+		const line = rawLine.trim();
+		if (line === '') {
+			continue;
+		}
+		const separator = line.includes('\t') ? '\t' : line.includes(';') ? ';' : ',';
+		const fields = line.split(separator).map((field) => field.trim().replace(/^"(.*)"$/, '$1'));
+		if (fields.length < 3) {
+			continue;
+		}
+		const parseField = (field: string) => Number(separator === ',' ? field : field.replace(',', '.'));
+		const first = parseField(fields[1]);
+		const second = parseField(fields[2]);
+		if (fields[0] === '' || !Number.isFinite(first) || !Number.isFinite(second)) {
+			continue;
+		}
+		if (Math.abs(first) > WAYPOINT_PROJECTED_THRESHOLD) {
+			waypoints.push({ name: fields[0], northing: first, easting: second });
+		} else {
+			const projected = projectToSweref99tm(first, second);
+			waypoints.push({ name: fields[0], northing: projected.northing, easting: projected.easting });
+		}
+	}
+	return waypoints;
+}
+
+/**
+ * Imports waypoints from CSV text, if given, and builds the grid index over
+ * all stored waypoints
+ * Runs in the track worker, or on the main thread where workers are missing.
+ */
+async function loadStoredWaypointIndex(csvText?: string): Promise<{ index: WaypointIndexData; imported: number }> {
+	const db = await openWaypointDatabase();
+	let imported = 0;
+	if (csvText !== undefined) {
+		const waypoints = parseWaypointCsv(csvText);
+		await addWaypoints(db, waypoints);
+		imported = waypoints.length;
+	}
+	const stored = await readAllWaypoints(db);
+	const index = buildWaypointIndex(
+		stored.map((waypoint) => waypoint.name),
+		Float64Array.from(stored, (waypoint) => waypoint.northing),
+		Float64Array.from(stored, (waypoint) => waypoint.easting)
+	);
+	return { index, imported };
+}
@@ -0,0 +1,305 @@
+/**
+ * Tests for the municipality and county lookup
+ *
+ * Tests cover:
+ * - Round trips of the binary boundary format and its size per point
+ * - Grid lookups against a brute-force polygon test for a tiling of
+ *   jagged municipalities with an enclave
+ * - Cost per fix along a trace crossing many boundaries
+ * - The municipality line and share text in the real app
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface AdminArea {
+	municipalityCode: string;
+	municipalityName: string;
+	countyCode: string;
+	countyName: string;
+	coordinates: Int32Array;
+	ringStarts: Int32Array;
+}
+
+interface AdminAreaIndex {
+	readonly size: number;
+	lookup(northing: number, easting: number): AdminArea | null;
+}
+
+interface ReplayTrace {
+	name: string;
+	fixes: { latitude: number; longitude: number }[];
+}
+
+interface ReplaySource {
+	whenComplete(): Promise<void>;
+}
+
+type App = {
+	encodeAdminAreas(areas: AdminArea[]): Uint8Array;
+	decodeAdminAreas(bytes: Uint8Array): AdminArea[];
+	isInsideAdminArea(area: AdminArea, northing: number, easting: number): boolean;
+	AdminAreaIndex: new (areas: AdminArea[], cellSize?: number) => AdminAreaIndex;
+	adminAreaIndex: AdminAreaIndex | null;
+	wgs84_to_sweref99tm(latitude: number, longitude: number): { northing: number; easting: number };
+	createSyntheticTrace(kind: string, durationSeconds?: number, rateHz?: number): ReplayTrace;
+	ReplayPositionSource: new (trace: ReplayTrace, speedFactor?: number) => ReplaySource;
+	startGeolocationWatch(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: unknown;
+	uiHelper: { getShareText(): string };
+};
+
+/**
+ * Deterministic pseudo-random numbers in [0, 1)
+ */
+function createRandom(seed: number): () => number {
+	let state = seed;
+	return () => {
+		state = (state * 1664525 + 1013904223) >>> 0;
+		return state / 4294967296;
+	};
+}
+
+const SIZE = 10000;
+const COUNT = 10;
+const STEPS = 10;
+const ORIGIN_NORTH = 6600000;
+const ORIGIN_EAST = 600000;
+
+/**
+ * Tiles COUNT × COUNT municipalities of about SIZE metres with jittered,
+ * shared corners and wavy sides, plus an enclave inside one of them
+ */
+function createMunicipalities(): AdminArea[] {
+	const random = createRandom(41);
+	const corners: [number, number][][] = [];
+	for (let i = 0; i <= COUNT; i++) {
+		corners.push([]);
+		for (let j = 0; j <= COUNT; j++) {
+			const edge = i === 0 || j === 0 || i === COUNT || j === COUNT;
+			const jitter = () => (edge ? 0 : (random() - 0.5) * 3000);
+			corners[i].push([ORIGIN_NORTH + i * SIZE + jitter(), ORIGIN_EAST + j * SIZE + jitter()]);
+		}
+	}
+	// Sidor mellan två hörn, delade av grannkommunerna
+	const sides = new Map<string, [number, number][]>();
+	const side = (a: [number, number], b: [number, number]): [number, number][] => {
+		const key = `${a}|${b}`;
+		const reverse = sides.get(`${b}|${a}`);
+		if (reverse) {
+			return [...reverse].reverse();
+		}
+		if (!sides.has(key)) {
+			const points: [number, number][] = [];
+			const length = Math.hypot(b[0] - a[0], b[1] - a[1]);
+			for (let k = 1; k < STEPS; k++) {
+				const t = k / STEPS;
+				const offset = (random() - 0.5) * 600;
+				points.push([
+					Math.round(a[0] + t * (b[0] - a[0]) - offset * (b[1] - a[1]) / length),
+					Math.round(a[1] + t * (b[1] - a[1]) + offset * (b[0] - a[0]) / length)
+				]);
+			}
+			sides.set(key, points);
+		}
+		return sides.get(key)!;
+	};
+
+	const areas: AdminArea[] = [];
+	const round = (p: [number, number]): [number, number] => [Math.round(p[0]), Math.round(p[1])];
+	for (let i = 0; i < COUNT; i++) {
+		for (let j = 0; j < COUNT; j++) {
+			const ring = [corners[i][j], corners[i][j + 1], corners[i + 1][j + 1], corners[i + 1][j]].map(round);
+			const points: [number, number][] = [];
+			for (let k = 0; k < 4; k++) {
+				points.push(ring[k], ...side(ring[k], ring[(k + 1) % 4]));
+			}
+			const coordinates = points.flat();
+			const ringStarts = [0, points.length];
+			if (i === 5 && j === 5) {
+				coordinates.push(...ENCLAVE.flat());
+				ringStarts.push(ringStarts[1] + ENCLAVE.length);
+			}
+			const code = String(100 + i * COUNT + j).padStart(4, '0');
+			areas.push({
+				municipalityCode: code,
+				municipalityName: `Kommun ${code}`,
+				countyCode: i < 5 ? '03' : '05',
+				countyName: i < 5 ? 'Uppsala län' : 'Östergötlands län',
+				coordinates: Int32Array.from(coordinates),
+				ringStarts: Int32Array.from(ringStarts)
+			});
+		}
+	}
+	areas.push({
+		municipalityCode: '9999',
+		municipalityName: 'Enklav',
+		countyCode: '03',
+		countyName: 'Uppsala län',
+		coordinates: Int32Array.from(ENCLAVE.flat()),
+		ringStarts: Int32Array.from([0, ENCLAVE.length])
+	});
+	return areas;
+}
+
+const ENCLAVE_CENTER: [number, number] = [ORIGIN_NORTH + 5.5 * SIZE, ORIGIN_EAST + 5.5 * SIZE];
+const ENCLAVE: [number, number][] = [[-1, -1], [-1, 1], [1, 1], [1, -1]]
+	.map(([n, e]) => [ENCLAVE_CENTER[0] + n * 1500, ENCLAVE_CENTER[1] + e * 1500]);
+
+describe('Municipality lookup', () => {
+	let app: App;
+	let areas: AdminArea[];
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'encodeAdminAreas',
+			'decodeAdminAreas',
+			'isInsideAdminArea',
+			'AdminAreaIndex',
+			'adminAreaIndex',
+			'wgs84_to_sweref99tm',
+			'createSyntheticTrace',
+			'ReplayPositionSource',
+			'startGeolocationWatch',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource',
+			'uiHelper'
+		]);
+		areas = createMunicipalities();
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	const bruteForce = (northing: number, easting: number) =>
+		areas.find((area) => app.isInsideAdminArea(area, northing, easting)) ?? null;
+
+	describe('Binary format', () => {
+		it('should round-trip areas with holes and names', () => {
+			const decoded = app.decodeAdminAreas(app.encodeAdminAreas(areas));
+			expect(decoded).toHaveLength(areas.length);
+			decoded.forEach((area, i) => {
+				expect(area.municipalityCode).toBe(areas[i].municipalityCode);
+				expect(area.countyName).toBe(areas[i].countyName);
+				expect(Array.from(area.ringStarts)).toEqual(Array.from(areas[i].ringStarts));
+				expect(Array.from(area.coordinates)).toEqual(Array.from(areas[i].coordinates));
+			});
+		});
+
+		it('should take a few bytes per point', () => {
+			const points = areas.reduce((sum, area) => sum + area.coordinates.length / 2, 0);
+			const bytes = app.encodeAdminAreas(areas).length;
+			console.log(`Municipality file: ${bytes} bytes for ${points} points, ${(bytes / points).toFixed(2)} bytes per point`);
+			expect(bytes / points).toBeLessThan(8);
+		});
+
+		it('should reject other data', () => {
+			expect(() => app.decodeAdminAreas(new Uint8Array([0x53, 0x54, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0]))).toThrow();
+			const bytes = app.encodeAdminAreas(areas);
+			expect(() => app.decodeAdminAreas(bytes.subarray(0, bytes.length - 3))).toThrow();
+		});
+	});
+
+	describe('Grid lookup', () => {
+		it('should agree with the brute-force test', () => {
+			const index = new app.AdminAreaIndex(areas);
+			const random = createRandom(42);
+			let mismatches = 0;
+			for (let i = 0; i < 20000; i++) {
+				const northing = ORIGIN_NORTH - 2000 + random() * (COUNT * SIZE + 4000);
+				const easting = ORIGIN_EAST - 2000 + random() * (COUNT * SIZE + 4000);
+				if (index.lookup(northing, easting) !== bruteForce(northing, easting)) {
+					mismatches++;
+				}
+			}
+			expect(mismatches).toBe(0);
+		});
+
+		it('should agree with the brute-force test along a path crossing boundaries', () => {
+			const index = new app.AdminAreaIndex(areas, 2000);
+			let mismatches = 0;
+			for (let step = 0; step < 20000; step++) {
+				const northing = ORIGIN_NORTH + 100 + step * 4.9;
+				const easting = ORIGIN_EAST + 100 + step * 3.7 + 3000 * Math.sin(step / 500);
+				if (index.lookup(northing, easting) !== bruteForce(northing, easting)) {
+					mismatches++;
+				}
+			}
+			expect(mismatches).toBe(0);
+		});
+
+		it('should find the enclave inside its hole', () => {
+			const index = new app.AdminAreaIndex(areas);
+			expect(index.lookup(ENCLAVE_CENTER[0], ENCLAVE_CENTER[1])?.municipalityName).toBe('Enklav');
+			expect(index.lookup(ENCLAVE_CENTER[0] + 2000, ENCLAVE_CENTER[1])?.municipalityCode).toBe('0155');
+		});
+
+		it('should return null outside all areas', () => {
+			const index = new app.AdminAreaIndex(areas);
+			expect(index.lookup(ORIGIN_NORTH - 500, ORIGIN_EAST + 5000)).toBeNull();
+			expect(index.lookup(0, 0)).toBeNull();
+			expect(new app.AdminAreaIndex([]).lookup(ORIGIN_NORTH, ORIGIN_EAST)).toBeNull();
+		});
+	});
+
+	describe('Performance', () => {
+		it('should look up a fix along a trace in well under 5 µs', () => {
+			const index = new app.AdminAreaIndex(areas);
+			const count = 100000;
+			let found = 0;
+			const start = performance.now();
+			for (let step = 0; step < count; step++) {
+				// 1 m mellan positionerna, diagonalt genom alla kommuner
+				if (index.lookup(ORIGIN_NORTH + 10 + step * 0.7, ORIGIN_EAST + 10 + step * 0.7) !== null) {
+					found++;
+				}
+			}
+			const microseconds = (performance.now() - start) * 1000 / count;
+			console.log(`Municipality lookup: ${microseconds.toFixed(3)} µs per fix`);
+			expect(found).toBe(count);
+			expect(microseconds).toBeLessThan(5);
+		});
+	});
+
+	describe('Display', () => {
+		const line = () => document.getElementById('admin-area')!;
+
+		it('should stay hidden without boundaries', () => {
+			expect(line().hidden).toBe(true);
+		});
+
+		it('should show the municipality of the position and share it', async () => {
+			const trace = app.createSyntheticTrace('walking', 30);
+			const last = trace.fixes[trace.fixes.length - 1];
+			const here = app.wgs84_to_sweref99tm(last.latitude, last.longitude);
+			const ring = [[-1, -1], [-1, 1], [1, 1], [1, -1]].flatMap(([n, e]) => [
+				Math.round(here.northing + n * 5000),
+				Math.round(here.easting + e * 5000)
+			]);
+			app.adminAreaIndex = new app.AdminAreaIndex([{
+				municipalityCode: '0380',
+				municipalityName: 'Uppsala',
+				countyCode: '03',
+				countyName: 'Uppsala län',
+				coordinates: Int32Array.from(ring),
+				ringStarts: Int32Array.from([0, 4])
+			}]);
+
+			const source = new app.ReplayPositionSource(trace, Number.POSITIVE_INFINITY);
+			app.stopGeolocationWatch();
+			app.positionSource = source;
+			app.startGeolocationWatch(app.handlePositionError);
+			await source.whenComplete();
+
+			expect(line().hidden).toBe(false);
+			expect(line().textContent).toBe('Uppsala, Uppsala län');
+			expect(app.uiHelper.getShareText()).toMatch(/\(SWEREF 99 TM\), Uppsala, Uppsala län$/);
+		});
+	});
+});
@@ -0,0 +1,208 @@
+/**
+ * Tests for the bulk conversion of coordinate files
+ *
+ * Tests cover:
+ * - Coordinates in decimal degrees, degrees and minutes, and degrees,
+ *   minutes and seconds, with signs, hemisphere letters and decimal commas
+ * - Splitting fields and lines, with quotes and pieces split anywhere
+ * - Finding the coordinate columns with and without a header
+ * - Streaming conversion of a large file in bounded output pieces
+ * - Progress and result formatting on the conversion page
+ *
+ * Loads the actual conversion page via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+type CsvCoordinateKind = 'wgs84' | 'sweref';
+
+interface CsvLayout {
+	separator: string;
+	kind: CsvCoordinateKind;
+	firstColumn: number;
+	secondColumn: number;
+	hasHeader: boolean;
+	decimalComma: boolean;
+}
+
+interface CsvLineSplitter {
+	push(text: string, onLine: (line: string) => void): void;
+	end(onLine: (line: string) => void): void;
+}
+
+interface CsvStreamConverter {
+	readonly layout: CsvLayout | null;
+	readonly rowCount: number;
+	readonly failedCount: number;
+	push(text: string): void;
+	end(): void;
+}
+
+type App = {
+	CSV_CONVERT_BATCH_SIZE: number;
+	parseCsvCoordinate(text: string): number;
+	splitCsvFields(line: string, separator: string): string[];
+	detectCsvLayout(lines: readonly string[]): CsvLayout | null;
+	CsvLineSplitter: new () => CsvLineSplitter;
+	CsvStreamConverter: new (onOutput: (text: string) => void) => CsvStreamConverter;
+	projectToSweref99tm(latitude: number, longitude: number): { northing: number; easting: number };
+	formatConvertProgress(bytesRead: number, totalBytes: number, rowCount: number): string;
+	formatConvertResult(kind: CsvCoordinateKind, rowCount: number, failedCount: number): string;
+	getConvertedFileName(name: string, kind: CsvCoordinateKind): string;
+};
+
+/**
+ * Feeds text to a converter in pieces of the given size
+ */
+function convert(app: App, text: string, pieceSize: number = text.length): { output: string[]; converter: CsvStreamConverter } {
+	const output: string[] = [];
+	const converter = new app.CsvStreamConverter((piece) => output.push(piece));
+	for (let i = 0; i < text.length; i += pieceSize) {
+		converter.push(text.slice(i, i + pieceSize));
+	}
+	converter.end();
+	return { output, converter };
+}
+
+describe('CSV conversion', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'CSV_CONVERT_BATCH_SIZE',
+			'parseCsvCoordinate',
+			'splitCsvFields',
+			'detectCsvLayout',
+			'CsvLineSplitter',
+			'CsvStreamConverter',
+			'projectToSweref99tm',
+			'formatConvertProgress',
+			'formatConvertResult',
+			'getConvertedFileName'
+		], 'konvertera.html');
+	});
+
+	describe('Coordinates', () => {
+		it.each([
+			['59.3268', 59.3268],
+			['59,3268', 59.3268],
+			[' -18,5 ', -18.5],
+			['6 580 822', 6580822],
+			['6\u00A0580\u00A0822,5', 6580822.5],
+			['59 19,608', 59 + 19.608 / 60],
+			['59°19\'36"N', 59 + 19 / 60 + 36 / 3600],
+			['N 59°19′36,5″', 59 + 19 / 60 + 36.5 / 3600],
+			['18°4\'7.2"Ö', 18 + 4 / 60 + 7.2 / 3600],
+			['33°52\'S', -(33 + 52 / 60)],
+			['W 0,1278', -0.1278],
+			['V 12', -12]
+		])('should parse %s', (text, value) => {
+			expect(app.parseCsvCoordinate(text)).toBeCloseTo(value, 9);
+		});
+
+		it.each(['', 'Slottet', '12:30:00', '59 60', '59,5 30', '1.2.3', '59 19 36 12'])('should reject %p', (text) => {
+			expect(Number.isNaN(app.parseCsvCoordinate(text))).toBe(true);
+		});
+	});
+
+	describe('Fields and lines', () => {
+		it('should split quoted fields with separators and doubled quotes', () => {
+			expect(app.splitCsvFields('a;b;;c', ';')).toEqual(['a', 'b', '', 'c']);
+			expect(app.splitCsvFields('"Sjön, ""Stora""",59.3,"18,07"', ',')).toEqual(['Sjön, "Stora"', '59.3', '18,07']);
+		});
+
+		it('should keep quoted newlines and strip carriage returns across pieces', () => {
+			const text = 'a;b\r\n"rad\nett";2\r\n"x""\n""y";3\nsista';
+			for (const pieceSize of [1, 2, 3, 5, text.length]) {
+				const lines: string[] = [];
+				const splitter = new app.CsvLineSplitter();
+				for (let i = 0; i < text.length; i += pieceSize) {
+					splitter.push(text.slice(i, i + pieceSize), (line) => lines.push(line));
+				}
+				splitter.end((line) => lines.push(line));
+				expect(lines).toEqual(['a;b', '"rad\nett";2', '"x""\n""y";3', 'sista']);
+			}
+		});
+	});
+
+	describe('Layout', () => {
+		it('should find columns by their header names', () => {
+			expect(app.detectCsvLayout(['namn;lat;lon', 'Slottet;59,3268;18,0717'])).toEqual({
+				separator: ';', kind: 'wgs84', firstColumn: 1, secondColumn: 2, hasHeader: true, decimalComma: true
+			});
+			expect(app.detectCsvLayout(['id,Longitude,Latitude', '1,18.0717,59.3268'])).toMatchObject({
+				separator: ',', kind: 'wgs84', firstColumn: 2, secondColumn: 1, hasHeader: true, decimalComma: false
+			});
+		});
+
+		it('should take the kind and order of x and y from the values', () => {
+			expect(app.detectCsvLayout(['x\ty', '6580822\t674032'])).toMatchObject({ kind: 'sweref', firstColumn: 0, secondColumn: 1 });
+			expect(app.detectCsvLayout(['y\tx', '674032\t6580822'])).toMatchObject({ kind: 'sweref', firstColumn: 1, secondColumn: 0 });
+		});
+
+		it('should find an unnamed pair in Sweden rather than an id column', () => {
+			expect(app.detectCsvLayout(['12;59,3268;18,0717;Slottet'])).toMatchObject({ firstColumn: 1, secondColumn: 2, hasHeader: false });
+			expect(app.detectCsvLayout(['punkt;a;b', '12;18,0717;59,3268'])).toMatchObject({ kind: 'wgs84', firstColumn: 2, secondColumn: 1, hasHeader: true });
+			expect(app.detectCsvLayout(['namn;tid', 'Slottet;12:30'])).toBeNull();
+		});
+	});
+
+	describe('Streaming conversion', () => {
+		it('should add projected columns and keep every line as it is', () => {
+			const { output, converter } = convert(app, 'namn;lat;lon\r\nSlottet;59,3268;18,0717\n\n"Torget; norra";fel;18\n');
+			const expected = app.projectToSweref99tm(59.3268, 18.0717);
+			expect(output.join('')).toBe(
+				'namn;lat;lon;sweref99tm_n;sweref99tm_e\n' +
+				`Slottet;59,3268;18,0717;${expected.northing.toFixed(3).replace('.', ',')};${expected.easting.toFixed(3).replace('.', ',')}\n` +
+				'\n' +
+				'"Torget; norra";fel;18;;\n'
+			);
+			expect(converter.rowCount).toBe(2);
+			expect(converter.failedCount).toBe(1);
+		});
+
+		it('should convert SWEREF 99 TM back to latitude and longitude', () => {
+			const { northing, easting } = app.projectToSweref99tm(59.3268, 18.0717);
+			const { output, converter } = convert(app, `${northing.toFixed(3)},${easting.toFixed(3)}`);
+			expect(converter.layout).toMatchObject({ kind: 'sweref', hasHeader: false });
+			const fields = output.join('').trim().split(',');
+			expect(fields[2]).toBe('59.32680000');
+			expect(fields[3]).toBe('18.07170000');
+		});
+
+		it('should convert 100 000 rows read in 64 kB pieces in bounded batches', () => {
+			const rows = ['id,lat,lon'];
+			for (let i = 0; i < 100000; i++) {
+				rows.push(`${i},${(55.5 + i * 1e-4).toFixed(6)},${(13 + i * 5e-5).toFixed(6)}`);
+			}
+			const { output, converter } = convert(app, rows.join('\r\n'), 64 * 1024);
+			expect(converter.rowCount).toBe(100000);
+			expect(converter.failedCount).toBe(0);
+			expect(output.length).toBe(Math.ceil(100001 / app.CSV_CONVERT_BATCH_SIZE));
+			const longest = Math.max(...output.map((piece) => piece.length));
+			expect(longest).toBeLessThan(app.CSV_CONVERT_BATCH_SIZE * 64);
+
+			const last = output[output.length - 1].trim().split('\n').pop()!.split(',');
+			const expected = app.projectToSweref99tm(55.5 + 99999e-4, 13 + 99999 * 5e-5);
+			expect(last[0]).toBe('99999');
+			expect(Number(last[3])).toBeCloseTo(expected.northing, 2);
+			expect(Number(last[4])).toBeCloseTo(expected.easting, 2);
+		});
+
+		it('should fail when the file has no coordinates', () => {
+			expect(() => convert(app, 'namn;anteckning\nSlottet;stängt\n')).toThrow('Hittade inga koordinater i filen');
+		});
+	});
+
+	describe('Page', () => {
+		it('should format progress, result and file name', () => {
+			expect(app.formatConvertProgress(12.5 * 1024 * 1024, 1024 * 1024 * 1024, 150000))
+				.toBe('Omvandlar 12,5 av 1\u00A0024,0\u00A0MB · 150\u00A0000\u00A0rader');
+			expect(app.formatConvertResult('wgs84', 150000, 0)).toBe('150\u00A0000\u00A0rader omvandlade till SWEREF 99 TM.');
+			expect(app.formatConvertResult('sweref', 10, 3)).toBe('10\u00A0rader omvandlade till WGS 84. 3\u00A0rader kunde inte tolkas och har tomma kolumner.');
+			expect(app.getConvertedFileName('punkter.CSV', 'wgs84')).toBe('punkter-sweref99tm.csv');
+			expect(app.getConvertedFileName('export', 'sweref')).toBe('export-wgs84.csv');
+		});
+	});
+});
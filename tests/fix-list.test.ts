@@ -0,0 +1,281 @@
+/**
+ * Tests for the virtualised list of track fixes
+ *
+ * Tests cover:
+ * - Binary search for the fix closest to a time
+ * - Resolving a time of day within a track, also past midnight
+ * - Growing columns fed from stored chunks and live fixes, up to a cap
+ * - A bounded number of row elements for 100 000 fixes while scrolling
+ * - Writing only the new row when a fix is appended
+ * - Row and status formatting
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface TrackColumns {
+	count: number;
+	timestamp: Float64Array;
+	northing: Float64Array;
+	easting: Float64Array;
+	accuracy: Float64Array;
+	speed: Float64Array;
+}
+
+interface TrackFixBuffer {
+	readonly count: number;
+	readonly dropped: number;
+	readonly columns: TrackColumns;
+	clear(): void;
+	append(fix: { timestamp: number; northing: number; easting: number; accuracy: number; speed: number | null }): void;
+	load(columns: TrackColumns): void;
+}
+
+interface VirtualList {
+	readonly count: number;
+	readonly rowCount: number;
+	readonly selectedIndex: number;
+	isAtEnd(): boolean;
+	setCount(count: number, follow?: boolean): void;
+	grow(count: number, follow?: boolean): void;
+	select(index: number): void;
+	render(): void;
+}
+
+type App = {
+	FIX_LIST_OVERSCAN: number;
+	findFixIndexAtTime(timestamp: Float64Array, count: number, time: number): number;
+	resolveTrackTimeOfDay(firstTimestamp: number, lastTimestamp: number, secondsOfDay: number): number;
+	createTrackColumns(capacity: number): TrackColumns;
+	TrackFixBuffer: new (maxFixes?: number) => TrackFixBuffer;
+	VirtualList: new (
+		viewport: HTMLElement,
+		renderRow: (row: HTMLElement, index: number) => void,
+		onRender?: (first: number, last: number, count: number) => void
+	) => VirtualList;
+	formatFixRow(columns: TrackColumns, index: number): string;
+	formatFixListStatus(first: number, last: number, count: number, dropped?: number): string;
+};
+
+/**
+ * A scrolling element with a fixed layout height, which jsdom does not compute
+ */
+function createViewport(height: number): HTMLElement {
+	const viewport = document.createElement('div');
+	let scrollTop = 0;
+	Object.defineProperty(viewport, 'clientHeight', { get: () => height });
+	Object.defineProperty(viewport, 'scrollHeight', { get: () => parseFloat((viewport.firstElementChild as HTMLElement | null)?.style.height || '0') });
+	Object.defineProperty(viewport, 'scrollTop', {
+		get: () => scrollTop,
+		set: (value: number) => { scrollTop = Math.max(0, Math.min(value, viewport.scrollHeight - height)); }
+	});
+	return viewport;
+}
+
+describe('Fix list', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'FIX_LIST_OVERSCAN',
+			'findFixIndexAtTime',
+			'resolveTrackTimeOfDay',
+			'createTrackColumns',
+			'TrackFixBuffer',
+			'VirtualList',
+			'formatFixRow',
+			'formatFixListStatus'
+		]);
+	});
+
+	describe('Time search', () => {
+		const timestamp = Float64Array.from([1000, 2000, 3000, 5000, 9000]);
+
+		it.each([
+			[0, 0],
+			[1000, 0],
+			[1400, 0],
+			[1500, 0],
+			[1600, 1],
+			[4100, 3],
+			[9000, 4],
+			[20000, 4]
+		])('should find the fix closest to %s ms', (time, index) => {
+			expect(app.findFixIndexAtTime(timestamp, 5, time)).toBe(index);
+		});
+
+		it('should return -1 without fixes and only search the given count', () => {
+			expect(app.findFixIndexAtTime(timestamp, 0, 1000)).toBe(-1);
+			expect(app.findFixIndexAtTime(timestamp, 2, 9000)).toBe(1);
+		});
+
+		it('should resolve a time of day on the day the track started, or the next', () => {
+			const start = new Date(2024, 5, 1, 23, 50, 0).getTime();
+			const end = new Date(2024, 5, 2, 0, 20, 0).getTime();
+			expect(app.resolveTrackTimeOfDay(start, end, 23 * 3600 + 55 * 60)).toBe(new Date(2024, 5, 1, 23, 55, 0).getTime());
+			expect(app.resolveTrackTimeOfDay(start, end, 10 * 60)).toBe(new Date(2024, 5, 2, 0, 10, 0).getTime());
+			// Utanför spåret hamnar tiden på startdagen, så sökningen ger närmaste ände
+			expect(app.resolveTrackTimeOfDay(start, end, 12 * 3600)).toBe(new Date(2024, 5, 1, 12, 0, 0).getTime());
+		});
+	});
+
+	describe('Columns', () => {
+		it('should keep stored chunks and live fixes in order while growing', () => {
+			const buffer = new app.TrackFixBuffer();
+			for (let chunk = 0; chunk < 5; chunk++) {
+				const columns = app.createTrackColumns(256);
+				for (let i = 0; i < 256; i++) {
+					const n = chunk * 256 + i;
+					columns.timestamp[i] = n * 1000;
+					columns.northing[i] = 6580000 + n;
+					columns.easting[i] = 670000;
+					columns.accuracy[i] = 5;
+					columns.speed[i] = Number.NaN;
+				}
+				columns.count = 256;
+				buffer.load(columns);
+			}
+			buffer.append({ timestamp: 1280000, northing: 6581280, easting: 670000, accuracy: 3, speed: null });
+			expect(buffer.count).toBe(1281);
+			const { timestamp, northing, speed } = buffer.columns;
+			expect(timestamp[1000]).toBe(1000000);
+			expect(northing[1280]).toBe(6581280);
+			expect(Number.isNaN(speed[1280])).toBe(true);
+			expect(app.findFixIndexAtTime(timestamp, buffer.count, 700400)).toBe(700);
+
+			buffer.clear();
+			expect(buffer.count).toBe(0);
+		});
+
+		it('should drop the oldest fixes at the cap and keep the rest in order', () => {
+			const buffer = new app.TrackFixBuffer(1024);
+			for (let n = 0; n < 1500; n++) {
+				buffer.append({ timestamp: n * 1000, northing: 6580000 + n, easting: 670000, accuracy: 5, speed: null });
+			}
+			expect(buffer.count + buffer.dropped).toBe(1500);
+			expect(buffer.count).toBeLessThanOrEqual(1024);
+			expect(buffer.columns.timestamp.length).toBe(1024);
+			const { timestamp, northing } = buffer.columns;
+			expect(timestamp[0]).toBe(buffer.dropped * 1000);
+			expect(northing[buffer.count - 1]).toBe(6581499);
+			expect(app.findFixIndexAtTime(timestamp, buffer.count, 1400400)).toBe(1400 - buffer.dropped);
+
+			// Ett block större än taket ger bara sina senaste positioner
+			const columns = app.createTrackColumns(2000);
+			for (let i = 0; i < 2000; i++) {
+				columns.timestamp[i] = i;
+			}
+			columns.count = 2000;
+			buffer.clear();
+			buffer.load(columns);
+			expect([buffer.count, buffer.dropped, buffer.columns.timestamp[0]]).toEqual([1024, 976, 976]);
+		});
+	});
+
+	describe('Virtual list', () => {
+		it('should keep the row elements bounded for 100 000 fixes while scrolling', () => {
+			const viewport = createViewport(240);
+			const rendered: number[] = [];
+			let range: number[] = [];
+			const list = new app.VirtualList(viewport, (row, index) => {
+				rendered.push(index);
+				row.textContent = String(index);
+			}, (first, last, count) => { range = [first, last, count]; });
+			list.setCount(100000);
+			list.render();
+			const maxRows = 240 / 24 + 1 + 2 * app.FIX_LIST_OVERSCAN;
+			expect(list.rowCount).toBe(maxRows);
+			expect(viewport.querySelectorAll('[role="listitem"]').length).toBe(maxRows);
+			expect(range).toEqual([0, 9, 100000]);
+
+			// Rullning en rad skriver bara om en rad
+			viewport.scrollTop = 24 * 50;
+			list.render();
+			rendered.length = 0;
+			viewport.scrollTop = 24 * 51;
+			list.render();
+			expect(rendered).toEqual([51 - app.FIX_LIST_OVERSCAN + maxRows - 1]);
+
+			viewport.scrollTop = 24 * 60000;
+			list.render();
+			expect(range).toEqual([60000, 60009, 100000]);
+			const shown = Array.from(viewport.querySelectorAll('[role="listitem"]'), (row) => Number(row.textContent));
+			expect(shown).toContain(60000);
+			expect(shown).toContain(60009);
+			expect(list.rowCount).toBe(maxRows);
+		});
+
+		it('should center a selected row and follow new rows from the end', () => {
+			const viewport = createViewport(240);
+			const list = new app.VirtualList(viewport, (row, index) => { row.textContent = String(index); });
+			list.setCount(100000);
+			list.select(42000);
+			expect(list.selectedIndex).toBe(42000);
+			const selected = viewport.querySelector('.selected');
+			expect(selected?.textContent).toBe('42000');
+			expect(selected?.getAttribute('aria-posinset')).toBe('42001');
+			expect(list.isAtEnd()).toBe(false);
+
+			list.setCount(100001, true);
+			list.render();
+			expect(list.isAtEnd()).toBe(true);
+			expect(Array.from(viewport.querySelectorAll('[role="listitem"]'), (row) => row.textContent)).toContain('100000');
+		});
+
+		it('should write only the new row when a fix is appended at the end', () => {
+			const viewport = createViewport(240);
+			const rendered: number[] = [];
+			const list = new app.VirtualList(viewport, (row, index) => {
+				rendered.push(index);
+				row.textContent = String(index);
+			});
+			list.setCount(1000, true);
+			list.render();
+			rendered.length = 0;
+
+			list.grow(1001, true);
+			list.render();
+			expect(rendered).toEqual([1000]);
+			expect(list.isAtEnd()).toBe(true);
+			const rows = Array.from(viewport.querySelectorAll('[role="listitem"]'));
+			expect(rows.every((row) => row.getAttribute('aria-setsize') === '1001')).toBe(true);
+			expect((viewport.firstElementChild as HTMLElement).style.height).toBe(`${1001 * 24}px`);
+		});
+
+		it('should shrink the rows for a short list', () => {
+			const viewport = createViewport(240);
+			const list = new app.VirtualList(viewport, (row, index) => { row.textContent = String(index); });
+			list.setCount(3);
+			list.render();
+			expect(list.rowCount).toBe(3);
+			expect(list.isAtEnd()).toBe(true);
+			list.setCount(0);
+			list.render();
+			expect(list.rowCount).toBe(0);
+		});
+	});
+
+	describe('Formatting', () => {
+		it('should format a row with time, coordinates, accuracy and speed', () => {
+			const columns = app.createTrackColumns(2);
+			columns.timestamp[0] = new Date(2024, 5, 1, 14, 3, 22).getTime();
+			columns.northing[0] = 6580123.4;
+			columns.easting[0] = 670123.6;
+			columns.accuracy[0] = 4.2;
+			columns.speed[0] = 1.2;
+			columns.timestamp[1] = columns.timestamp[0];
+			columns.speed[1] = Number.NaN;
+			columns.count = 2;
+			expect(app.formatFixRow(columns, 0)).toBe('14:03:22  N\u00A06580123  E\u00A0670124  ±4\u00A0m  1,2\u00A0m/s');
+			expect(app.formatFixRow(columns, 1).endsWith('  –')).toBe(true);
+		});
+
+		it('should describe the visible range', () => {
+			expect(app.formatFixListStatus(0, -1, 0)).toBe('0\u00A0punkter');
+			expect(app.formatFixListStatus(1200, 1229, 100000)).toBe('1201–1230 av 100000\u00A0punkter');
+			expect(app.formatFixListStatus(0, 9, 60000, 16384)).toBe('1–10 av 60000\u00A0punkter, 16384 äldre visas inte');
+		});
+	});
+});
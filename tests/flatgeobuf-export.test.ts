@@ -0,0 +1,484 @@
+/**
+ * Tests for the FlatGeobuf export
+ *
+ * Tests cover:
+ * - Round trip of header, columns, CRS and every feature through an
+ *   independent reader
+ * - The packed Hilbert R-tree: node layout, parent boxes and leaf offsets,
+ *   and a bounding box query against brute force
+ * - Missing speed values, waypoint names and an export without features
+ * - Bounded output pieces, chunk re-reads and throughput for 500 000 fixes
+ * - The export status line
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface TrackColumns {
+	count: number;
+	timestamp: Float64Array;
+	northing: Float64Array;
+	easting: Float64Array;
+	accuracy: Float64Array;
+	speed: Float64Array;
+}
+
+interface Waypoint {
+	name: string;
+	northing: number;
+	easting: number;
+}
+
+interface FlatGeobufSource {
+	chunkCount: number;
+	readChunk(seq: number): Promise<TrackColumns | null>;
+}
+
+interface FlatGeobufStats {
+	featureCount: number;
+	byteCount: number;
+	chunkReads: number;
+	durationMs: number;
+}
+
+type App = {
+	TRACK_CHUNK_SIZE: number;
+	FLATGEOBUF_WINDOW_BYTES: number;
+	createTrackColumns(capacity: number): TrackColumns;
+	formatMapSheets(northing: number, easting: number): string[];
+	writeFlatGeobuf(
+		name: string,
+		source: FlatGeobufSource,
+		waypoints: readonly Waypoint[],
+		onOutput: (bytes: Uint8Array) => void
+	): Promise<FlatGeobufStats>;
+	formatFlatGeobufStatus(stats: FlatGeobufStats): string;
+};
+
+/**
+ * Reads a FlatBuffers table, independently of the builder in the app
+ */
+class FlatTable {
+	constructor(private readonly view: DataView, readonly position: number) {}
+
+	/**
+	 * Reads the size-prefixed root table at offset
+	 */
+	static sizePrefixed(view: DataView, offset: number): FlatTable {
+		return new FlatTable(view, offset + 4 + view.getUint32(offset + 4, true));
+	}
+
+	private field(slot: number): number {
+		const vtable = this.position - this.view.getInt32(this.position, true);
+		const entry = 4 + 2 * slot;
+		if (entry >= this.view.getUint16(vtable, true)) {
+			return 0;
+		}
+		const offset = this.view.getUint16(vtable + entry, true);
+		return offset === 0 ? 0 : this.position + offset;
+	}
+
+	private indirect(slot: number): number {
+		const position = this.field(slot);
+		return position === 0 ? 0 : position + this.view.getUint32(position, true);
+	}
+
+	uint8(slot: number, defaultValue: number): number {
+		const position = this.field(slot);
+		return position === 0 ? defaultValue : this.view.getUint8(position);
+	}
+
+	uint16(slot: number, defaultValue: number): number {
+		const position = this.field(slot);
+		return position === 0 ? defaultValue : this.view.getUint16(position, true);
+	}
+
+	int32(slot: number, defaultValue: number): number {
+		const position = this.field(slot);
+		return position === 0 ? defaultValue : this.view.getInt32(position, true);
+	}
+
+	uint64(slot: number, defaultValue: number): number {
+		const position = this.field(slot);
+		return position === 0 ? defaultValue : this.view.getUint32(position, true) + this.view.getUint32(position + 4, true) * 2 ** 32;
+	}
+
+	table(slot: number): FlatTable | null {
+		const position = this.indirect(slot);
+		return position === 0 ? null : new FlatTable(this.view, position);
+	}
+
+	/**
+	 * Start and length of a vector; elements follow the length
+	 */
+	vector(slot: number): { start: number; length: number } | null {
+		const position = this.indirect(slot);
+		return position === 0 ? null : { start: position + 4, length: this.view.getUint32(position, true) };
+	}
+
+	string(slot: number): string | null {
+		const vector = this.vector(slot);
+		return vector === null ? null : decodeUtf8(this.view, vector.start, vector.length);
+	}
+}
+
+function decodeUtf8(view: DataView, start: number, length: number): string {
+	return new TextDecoder().decode(new Uint8Array(view.buffer, view.byteOffset + start, length));
+}
+
+interface ReadFeature {
+	x: number;
+	y: number;
+	properties: Record<string, string | number>;
+}
+
+interface ReadFile {
+	name: string | null;
+	envelope: number[];
+	geometryType: number;
+	featureCount: number;
+	nodeSize: number;
+	crs: { org: string | null; code: number };
+	columns: { name: string; type: number }[];
+	/** Min x, min y, max x, max y and offset per node, root first */
+	nodes: number[][];
+	levelBounds: Array<[number, number]>;
+	featuresStart: number;
+	view: DataView;
+}
+
+/**
+ * Parses everything up to the first feature
+ */
+function readFlatGeobuf(bytes: Uint8Array): ReadFile {
+	expect(Array.from(bytes.subarray(0, 8))).toEqual([0x66, 0x67, 0x62, 0x03, 0x66, 0x67, 0x62, 0x00]);
+	const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+	const header = FlatTable.sizePrefixed(view, 8);
+	const envelope = header.vector(1);
+	const columns = header.vector(7)!;
+	const crs = header.table(10)!;
+	const featureCount = header.uint64(8, 0);
+	const nodeSize = header.uint16(9, 16);
+
+	const levelBounds: Array<[number, number]> = [];
+	const nodes: number[][] = [];
+	let position = 12 + view.getUint32(8, true);
+	if (featureCount > 0 && nodeSize > 0) {
+		const levelSizes = [featureCount];
+		for (let size = featureCount; size > 1 || levelSizes.length === 1;) {
+			size = Math.ceil(size / nodeSize);
+			levelSizes.push(size);
+		}
+		let end = levelSizes.reduce((sum, size) => sum + size, 0);
+		for (const size of levelSizes) {
+			levelBounds.push([end - size, end]);
+			end -= size;
+		}
+		for (let node = 0; node < levelBounds[0][1]; node++) {
+			const at = position + node * 40;
+			nodes.push([
+				view.getFloat64(at, true),
+				view.getFloat64(at + 8, true),
+				view.getFloat64(at + 16, true),
+				view.getFloat64(at + 24, true),
+				view.getUint32(at + 32, true) + view.getUint32(at + 36, true) * 2 ** 32
+			]);
+		}
+		position += nodes.length * 40;
+	}
+
+	return {
+		name: header.string(0),
+		envelope: envelope ? Array.from({ length: envelope.length }, (_, i) => view.getFloat64(envelope.start + 8 * i, true)) : [],
+		geometryType: header.uint8(2, 0),
+		featureCount,
+		nodeSize,
+		crs: { org: crs.string(0), code: crs.int32(1, 0) },
+		columns: Array.from({ length: columns.length }, (_, i) => {
+			const at = columns.start + 4 * i;
+			const column = new FlatTable(view, at + view.getUint32(at, true));
+			return { name: column.string(0)!, type: column.uint8(1, 0) };
+		}),
+		nodes,
+		levelBounds,
+		featuresStart: position,
+		view
+	};
+}
+
+/**
+ * Reads the feature at a byte offset after the index
+ */
+function readFeature(file: ReadFile, offset: number): { feature: ReadFeature; size: number } {
+	const { view, columns } = file;
+	const start = file.featuresStart + offset;
+	const table = FlatTable.sizePrefixed(view, start);
+	const xy = table.table(0)!.vector(1)!;
+	expect(xy.length).toBe(2);
+	const properties: Record<string, string | number> = {};
+	const bytes = table.vector(1)!;
+	for (let at = bytes.start; at < bytes.start + bytes.length;) {
+		const column = columns[view.getUint16(at, true)];
+		at += 2;
+		if (column.type === 10) {
+			properties[column.name] = view.getFloat64(at, true);
+			at += 8;
+		} else {
+			const length = view.getUint32(at, true);
+			properties[column.name] = decodeUtf8(view, at + 4, length);
+			at += 4 + length;
+		}
+	}
+	return {
+		feature: { x: view.getFloat64(xy.start, true), y: view.getFloat64(xy.start + 8, true), properties },
+		size: 4 + view.getUint32(start, true)
+	};
+}
+
+/**
+ * Offsets of the features whose point lies in a box, found through the index
+ */
+function searchFlatGeobuf(file: ReadFile, minX: number, minY: number, maxX: number, maxY: number): number[] {
+	const { nodes, levelBounds, nodeSize } = file;
+	const leafStart = levelBounds[0][0];
+	const offsets: number[] = [];
+	const stack: Array<[number, number]> = [[0, levelBounds.length - 1]];
+	while (stack.length > 0) {
+		const [first, level] = stack.pop()!;
+		const end = Math.min(first + nodeSize, levelBounds[level][1]);
+		for (let node = first; node < end; node++) {
+			const [nodeMinX, nodeMinY, nodeMaxX, nodeMaxY, offset] = nodes[node];
+			if (maxX < nodeMinX || maxY < nodeMinY || minX > nodeMaxX || minY > nodeMaxY) {
+				continue;
+			}
+			if (node >= leafStart) {
+				offsets.push(offset);
+			} else {
+				stack.push([offset, level - 1]);
+			}
+		}
+	}
+	return offsets.sort((a, b) => a - b);
+}
+
+/**
+ * Laps around a lake north of Stockholm, so that the track returns to the
+ * same places and the curve order mixes chunks
+ */
+function makeTrack(app: App, count: number): TrackColumns[] {
+	const chunks: TrackColumns[] = [];
+	for (let start = 0; start < count; start += app.TRACK_CHUNK_SIZE) {
+		const size = Math.min(app.TRACK_CHUNK_SIZE, count - start);
+		const columns = app.createTrackColumns(size);
+		columns.count = size;
+		for (let i = 0; i < size; i++) {
+			const n = start + i;
+			const angle = n / 500;
+			columns.timestamp[i] = Date.UTC(2025, 5, 1, 12) + n * 1000;
+			columns.northing[i] = 6600000 + 1500 * Math.sin(angle) + (n % 7) * 0.1;
+			columns.easting[i] = 670000 + 2500 * Math.cos(angle);
+			columns.accuracy[i] = 2 + (n % 9) * 0.5;
+			columns.speed[i] = n % 4 === 0 ? Number.NaN : 1.4;
+		}
+		chunks.push(columns);
+	}
+	return chunks;
+}
+
+async function exportTrack(app: App, chunks: TrackColumns[], waypoints: Waypoint[] = []): Promise<{ bytes: Uint8Array; pieces: number[]; stats: FlatGeobufStats }> {
+	const pieces: Uint8Array[] = [];
+	const stats = await app.writeFlatGeobuf(
+		'2025-06-01T12:00:00.000Z',
+		{ chunkCount: chunks.length, readChunk: async (seq) => chunks[seq] },
+		waypoints,
+		(bytes) => pieces.push(bytes.slice())
+	);
+	const bytes = new Uint8Array(pieces.reduce((sum, piece) => sum + piece.length, 0));
+	let offset = 0;
+	for (const piece of pieces) {
+		bytes.set(piece, offset);
+		offset += piece.length;
+	}
+	return { bytes, pieces: pieces.map((piece) => piece.length), stats };
+}
+
+describe('FlatGeobuf export', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'TRACK_CHUNK_SIZE',
+			'FLATGEOBUF_WINDOW_BYTES',
+			'createTrackColumns',
+			'formatMapSheets',
+			'writeFlatGeobuf',
+			'formatFlatGeobufStatus'
+		]);
+	});
+
+	describe('Round trip', () => {
+		const waypoints: Waypoint[] = [
+			{ name: 'Båthuset vid sjön', northing: 6601000.5, easting: 671000.25 },
+			{ name: 'Rast', northing: 6599000, easting: 668000 }
+		];
+
+		it('should write a header with point geometry in EPSG:3006', async () => {
+			const { bytes, stats } = await exportTrack(app, makeTrack(app, 3000), waypoints);
+			const file = readFlatGeobuf(bytes);
+			expect(stats.featureCount).toBe(3002);
+			expect(stats.byteCount).toBe(bytes.length);
+			expect(file.name).toBe('2025-06-01T12:00:00.000Z');
+			expect(file.geometryType).toBe(1);
+			expect(file.featureCount).toBe(3002);
+			expect(file.nodeSize).toBe(16);
+			expect(file.crs).toEqual({ org: 'EPSG', code: 3006 });
+			expect(file.columns).toEqual([
+				{ name: 'tid', type: 13 },
+				{ name: 'noggrannhet_m', type: 10 },
+				{ name: 'fart_ms', type: 10 },
+				{ name: 'ruta_5km', type: 11 },
+				{ name: 'ruta_10km', type: 11 },
+				{ name: 'ruta_50km', type: 11 },
+				{ name: 'namn', type: 11 }
+			]);
+			const [minX, minY, maxX, maxY] = file.envelope;
+			expect(minX).toBeCloseTo(667500, 0);
+			expect(maxX).toBeCloseTo(672500, 0);
+			expect(minY).toBeLessThan(6598600);
+			expect(maxY).toBeGreaterThan(6601400);
+		});
+
+		it('should read back every fix and waypoint in index order', async () => {
+			const chunks = makeTrack(app, 3000);
+			const { bytes } = await exportTrack(app, chunks, waypoints);
+			const file = readFlatGeobuf(bytes);
+
+			const expected = new Map<string, Record<string, string | number>>();
+			for (const columns of chunks) {
+				for (let i = 0; i < columns.count; i++) {
+					const [sheet5, sheet10, sheet50] = app.formatMapSheets(columns.northing[i], columns.easting[i]);
+					const speed = Number.isNaN(columns.speed[i]) ? {} : { fart_ms: columns.speed[i] };
+					expected.set(`${columns.easting[i]} ${columns.northing[i]}`, {
+						tid: new Date(columns.timestamp[i]).toISOString(),
+						noggrannhet_m: columns.accuracy[i],
+						...speed,
+						ruta_5km: sheet5,
+						ruta_10km: sheet10,
+						ruta_50km: sheet50
+					});
+				}
+			}
+			for (const waypoint of waypoints) {
+				const [sheet5, sheet10, sheet50] = app.formatMapSheets(waypoint.northing, waypoint.easting);
+				expected.set(`${waypoint.easting} ${waypoint.northing}`, { ruta_5km: sheet5, ruta_10km: sheet10, ruta_50km: sheet50, namn: waypoint.name });
+			}
+
+			// Objekten ligger i lövens ordning och lövens offset pekar på dem
+			const leafStart = file.levelBounds[0][0];
+			let offset = 0;
+			for (let i = 0; i < file.featureCount; i++) {
+				const leaf = file.nodes[leafStart + i];
+				expect(leaf[4]).toBe(offset);
+				const { feature, size } = readFeature(file, offset);
+				expect([feature.x, feature.y]).toEqual([leaf[0], leaf[1]]);
+				expect([leaf[2], leaf[3]]).toEqual([leaf[0], leaf[1]]);
+				const key = `${feature.x} ${feature.y}`;
+				expect(feature.properties).toEqual(expected.get(key));
+				expected.delete(key);
+				offset += size;
+			}
+			expect(expected.size).toBe(0);
+			expect(file.featuresStart + offset).toBe(bytes.length);
+		});
+
+		it('should pack parents over consecutive children, root first', async () => {
+			const { bytes } = await exportTrack(app, makeTrack(app, 5000));
+			const file = readFlatGeobuf(bytes);
+			expect(file.levelBounds.map(([start, end]) => end - start)).toEqual([5000, 313, 20, 2, 1]);
+			expect(file.nodes[0].slice(0, 4)).toEqual(file.envelope);
+			for (let level = 1; level < file.levelBounds.length; level++) {
+				const [start, end] = file.levelBounds[level];
+				const [childStart, childEnd] = file.levelBounds[level - 1];
+				for (let node = start; node < end; node++) {
+					const [minX, minY, maxX, maxY, first] = file.nodes[node];
+					expect(first).toBe(childStart + (node - start) * 16);
+					const children = file.nodes.slice(first, Math.min(first + 16, childEnd));
+					expect(minX).toBe(Math.min(...children.map((child) => child[0])));
+					expect(minY).toBe(Math.min(...children.map((child) => child[1])));
+					expect(maxX).toBe(Math.max(...children.map((child) => child[2])));
+					expect(maxY).toBe(Math.max(...children.map((child) => child[3])));
+				}
+			}
+		});
+
+		it('should find the same features through the index as by brute force', async () => {
+			const { bytes } = await exportTrack(app, makeTrack(app, 20000), waypoints);
+			const file = readFlatGeobuf(bytes);
+			const all: Array<{ offset: number; x: number; y: number }> = [];
+			for (let i = 0, offset = 0; i < file.featureCount; i++) {
+				const { feature, size } = readFeature(file, offset);
+				all.push({ offset, x: feature.x, y: feature.y });
+				offset += size;
+			}
+			const boxes = [
+				[669000, 6600500, 672000, 6602000],
+				[667000, 6598000, 668500, 6600000],
+				[670000, 6600000, 670001, 6600001],
+				[660000, 6590000, 661000, 6591000]
+			];
+			for (const [minX, minY, maxX, maxY] of boxes) {
+				const expected = all
+					.filter(({ x, y }) => x >= minX && x <= maxX && y >= minY && y <= maxY)
+					.map(({ offset }) => offset);
+				expect(searchFlatGeobuf(file, minX, minY, maxX, maxY)).toEqual(expected);
+			}
+			expect(searchFlatGeobuf(file, 669000, 6600500, 672000, 6602000).length).toBeGreaterThan(1000);
+		});
+
+		it('should write a header without index when there is nothing to export', async () => {
+			const { bytes, stats } = await exportTrack(app, []);
+			const file = readFlatGeobuf(bytes);
+			expect(stats.featureCount).toBe(0);
+			expect(file.featureCount).toBe(0);
+			expect(file.nodeSize).toBe(0);
+			expect(file.envelope).toEqual([]);
+			expect(file.featuresStart).toBe(bytes.length);
+		});
+	});
+
+	describe('Large exports', () => {
+		it('should stream 500 000 fixes in bounded pieces', async () => {
+			const count = 500000;
+			const chunks = makeTrack(app, count);
+			const { bytes, pieces, stats } = await exportTrack(app, chunks);
+			const file = readFlatGeobuf(bytes);
+			expect(file.featureCount).toBe(count);
+
+			// Signatur, huvud och index kommer först, sedan objekten i bitar
+			const indexBytes = file.nodes.length * 40;
+			expect(pieces[2]).toBe(indexBytes);
+			expect(Math.max(...pieces.slice(3))).toBeLessThanOrEqual(app.FLATGEOBUF_WINDOW_BYTES);
+			expect(pieces.slice(3).reduce((sum, piece) => sum + piece, 0)).toBe(bytes.length - file.featuresStart);
+
+			// Varven ligger nära varandra, men de flesta block läses bara två gånger
+			expect(stats.chunkReads).toBeGreaterThanOrEqual(chunks.length);
+			expect(stats.chunkReads).toBeLessThan(chunks.length * 2);
+
+			const seconds = stats.durationMs / 1000;
+			console.log(
+				`FlatGeobuf export, ${count} fixes (${(bytes.length / 1e6).toFixed(1)} MB, index ${(indexBytes / 1e6).toFixed(1)} MB): ` +
+				`${Math.round(count / seconds)} features/s, ${(bytes.length / 1e6 / seconds).toFixed(1)} MB/s, ` +
+				`${stats.chunkReads} chunk reads for ${chunks.length} chunks`
+			);
+		});
+	});
+
+	describe('Status', () => {
+		it('should describe an export with its throughput', () => {
+			expect(app.formatFlatGeobufStatus({ featureCount: 35000, byteCount: 7 * 1024 * 1024, chunkReads: 140, durationMs: 812 }))
+				.toBe('FlatGeobuf: 35000\u00A0objekt, 7,0\u00A0MB på 812\u00A0ms, 43103\u00A0objekt/s');
+		});
+	});
+});
@@ -0,0 +1,217 @@
+/**
+ * Tests for the nearest place name lookup
+ *
+ * Tests cover:
+ * - The binary gazetteer format and rejection of other data
+ * - Nearest-place queries against brute force, including the distance limit
+ * - Cost per fix for 100 000 places
+ * - The "near X" line under the coordinates in the real app
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface Waypoint {
+	name: string;
+	northing: number;
+	easting: number;
+}
+
+interface GazetteerPlace extends Waypoint {
+	gridDistance: number;
+}
+
+interface Gazetteer {
+	readonly size: number;
+	nearest(northing: number, easting: number, maxDistance?: number): GazetteerPlace | null;
+}
+
+interface ReplayTrace {
+	name: string;
+	fixes: { latitude: number; longitude: number }[];
+}
+
+interface ReplaySource {
+	whenComplete(): Promise<void>;
+}
+
+type App = {
+	encodeGazetteer(places: Waypoint[], cellSize?: number): Uint8Array;
+	Gazetteer: new (buffer: ArrayBuffer) => Gazetteer;
+	gazetteer: Gazetteer | null;
+	formatNearestPlace(name: string, distance: number, bearing: number): string;
+	GAZETTEER_MAX_DISTANCE: number;
+	wgs84_to_sweref99tm(latitude: number, longitude: number): { northing: number; easting: number };
+	createSyntheticTrace(kind: string, durationSeconds?: number, rateHz?: number): ReplayTrace;
+	ReplayPositionSource: new (trace: ReplayTrace, speedFactor?: number) => ReplaySource;
+	startGeolocationWatch(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: unknown;
+};
+
+/**
+ * Deterministic pseudo-random numbers in [0, 1)
+ */
+function createRandom(seed: number): () => number {
+	let state = seed;
+	return () => {
+		state = (state * 1664525 + 1013904223) >>> 0;
+		return state / 4294967296;
+	};
+}
+
+/**
+ * Places spread over Sweden's SWEREF 99 TM extent, denser in the south
+ */
+function createPlaces(count: number, seed: number): Waypoint[] {
+	const random = createRandom(seed);
+	return Array.from({ length: count }, (_, i) => ({
+		name: `Ort ${i} ${i % 7 === 0 ? 'Åäö' : ''}`.trim(),
+		northing: Math.round(6130000 + Math.pow(random(), 1.5) * 1500000),
+		easting: Math.round(260000 + random() * 660000)
+	}));
+}
+
+describe('Gazetteer', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'encodeGazetteer',
+			'Gazetteer',
+			'gazetteer',
+			'formatNearestPlace',
+			'GAZETTEER_MAX_DISTANCE',
+			'wgs84_to_sweref99tm',
+			'createSyntheticTrace',
+			'ReplayPositionSource',
+			'startGeolocationWatch',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource'
+		]);
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	const bruteForce = (places: Waypoint[], northing: number, easting: number, maxDistance: number) => {
+		let best: Waypoint | null = null;
+		let bestDistance = maxDistance;
+		for (const place of places) {
+			const distance = Math.hypot(place.northing - northing, place.easting - easting);
+			if (distance < bestDistance) {
+				best = place;
+				bestDistance = distance;
+			}
+		}
+		return best;
+	};
+
+	describe('Format', () => {
+		it('should answer from an encoded file', () => {
+			const places = [
+				{ name: 'Uppsala', ...app.wgs84_to_sweref99tm(59.86, 17.64) },
+				{ name: 'Örebro', ...app.wgs84_to_sweref99tm(59.27, 15.21) }
+			];
+			const gazetteer = new app.Gazetteer(app.encodeGazetteer(places).buffer as ArrayBuffer);
+			expect(gazetteer.size).toBe(2);
+			const here = app.wgs84_to_sweref99tm(59.3, 15.3);
+			expect(gazetteer.nearest(here.northing, here.easting)?.name).toBe('Örebro');
+		});
+
+		it('should reject other data', () => {
+			expect(() => new app.Gazetteer(new ArrayBuffer(8))).toThrow();
+			const bytes = app.encodeGazetteer(createPlaces(100, 1));
+			expect(() => new app.Gazetteer(bytes.slice(0, bytes.length - 5).buffer as ArrayBuffer)).toThrow();
+		});
+
+		it('should handle an empty list', () => {
+			const gazetteer = new app.Gazetteer(app.encodeGazetteer([]).buffer as ArrayBuffer);
+			expect(gazetteer.nearest(6580822, 674032)).toBeNull();
+		});
+	});
+
+	describe('Nearest place', () => {
+		it.each([[1000, 2], [100000, 3]])('should agree with brute force for %s places', (count, seed) => {
+			const places = createPlaces(count, seed);
+			const gazetteer = new app.Gazetteer(app.encodeGazetteer(places).buffer as ArrayBuffer);
+			const random = createRandom(seed + 10);
+			let mismatches = 0;
+			for (let i = 0; i < 2000; i++) {
+				const northing = 6100000 + random() * 1600000;
+				const easting = 200000 + random() * 800000;
+				const expected = bruteForce(places, northing, easting, app.GAZETTEER_MAX_DISTANCE);
+				const found = gazetteer.nearest(northing, easting);
+				if ((found?.name ?? null) !== (expected?.name ?? null)) {
+					mismatches++;
+				}
+			}
+			expect(mismatches).toBe(0);
+		});
+
+		it('should report nothing beyond the distance limit', () => {
+			const gazetteer = new app.Gazetteer(app.encodeGazetteer([{ name: 'Ensam', northing: 6580000, easting: 674000 }]).buffer as ArrayBuffer);
+			expect(gazetteer.nearest(6580000 + app.GAZETTEER_MAX_DISTANCE + 1, 674000)).toBeNull();
+			expect(gazetteer.nearest(6580000 + app.GAZETTEER_MAX_DISTANCE - 1, 674000)?.name).toBe('Ensam');
+			expect(gazetteer.nearest(6580100, 674000, 50)).toBeNull();
+		});
+	});
+
+	describe('Performance', () => {
+		it('should query a fix among 100 000 places in well under 10 µs', () => {
+			const gazetteer = new app.Gazetteer(app.encodeGazetteer(createPlaces(100000, 4)).buffer as ArrayBuffer);
+			const count = 100000;
+			let found = 0;
+			const start = performance.now();
+			for (let step = 0; step < count; step++) {
+				// 1 m mellan positionerna
+				if (gazetteer.nearest(6400000 + step * 0.7, 500000 + step * 0.7) !== null) {
+					found++;
+				}
+			}
+			const microseconds = (performance.now() - start) * 1000 / count;
+			console.log(`Gazetteer lookup: ${microseconds.toFixed(3)} µs per fix`);
+			expect(found).toBe(count);
+			expect(microseconds).toBeLessThan(10);
+		});
+	});
+
+	describe('Display', () => {
+		it.each([
+			[500, 45, 'Vid Ort'],
+			[4240, 44, '4,2\u00A0km NO om Ort'],
+			[25400, 181, '25\u00A0km S om Ort'],
+			[3000, 350, '3,0\u00A0km N om Ort']
+		])('should describe %s m at %s°', (distance, bearing, text) => {
+			expect(app.formatNearestPlace('Ort', distance, bearing)).toBe(text);
+		});
+
+		it('should show the place nearest to the position', async () => {
+			const line = () => document.getElementById('place-name')!;
+			expect(line().hidden).toBe(true);
+
+			const trace = app.createSyntheticTrace('walking', 30);
+			const last = trace.fixes[trace.fixes.length - 1];
+			const here = app.wgs84_to_sweref99tm(last.latitude, last.longitude);
+			app.gazetteer = new app.Gazetteer(app.encodeGazetteer([
+				// Orten ligger 3 km söder om positionen, positionen alltså norr om orten
+				{ name: 'Söderby', northing: here.northing - 3000, easting: here.easting },
+				{ name: 'Fjärran', northing: here.northing + 50000, easting: here.easting }
+			]).buffer as ArrayBuffer);
+
+			const source = new app.ReplayPositionSource(trace, Number.POSITIVE_INFINITY);
+			app.stopGeolocationWatch();
+			app.positionSource = source;
+			app.startGeolocationWatch(app.handlePositionError);
+			await source.whenComplete();
+
+			expect(line().hidden).toBe(false);
+			expect(line().textContent).toMatch(/^3,0\skm N om Söderby$/);
+		});
+	});
+});
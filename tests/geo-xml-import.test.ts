@@ -0,0 +1,283 @@
+/**
+ * Tests for the streaming GPX and KML import
+ *
+ * Tests cover:
+ * - Tags, text, entities, comments and CDATA with the input split at every offset
+ * - GPX waypoints, route points and tracks with times, hdop and extensions
+ * - KML points, line strings with coordinates split anywhere, and gx:Track
+ * - Bounded batches and throughput for 200 000 track points
+ * - The import status line
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface TrackColumns {
+	count: number;
+	timestamp: Float64Array;
+	northing: Float64Array;
+	easting: Float64Array;
+	accuracy: Float64Array;
+	speed: Float64Array;
+}
+
+interface Waypoint {
+	name: string;
+	northing: number;
+	easting: number;
+}
+
+interface XmlStreamHandler {
+	open(name: string, attributes: string): void;
+	close(name: string): void;
+	text(text: string): void;
+}
+
+interface XmlStreamParser {
+	push(text: string): void;
+	end(): void;
+}
+
+interface GeoXmlImporter {
+	onWaypoints: (waypoints: Waypoint[]) => void;
+	onTrackPoints: (columns: TrackColumns) => void;
+	onTrackEnd: () => void;
+	readonly waypointCount: number;
+	readonly trackCount: number;
+	readonly trackPointCount: number;
+	push(text: string): void;
+	end(): void;
+}
+
+interface GeoImportStats {
+	waypointCount: number;
+	trackCount: number;
+	trackPointCount: number;
+	byteCount: number;
+	durationMs: number;
+}
+
+type App = {
+	GEO_IMPORT_BATCH_SIZE: number;
+	XmlStreamParser: new (handler: XmlStreamHandler) => XmlStreamParser;
+	GeoXmlImporter: new (defaultStartTime: number) => GeoXmlImporter;
+	getXmlAttribute(attributes: string, name: string): string | null;
+	isGeoXmlFileName(name: string): boolean;
+	projectToSweref99tm(latitude: number, longitude: number): { northing: number; easting: number };
+	formatGeoImportStatus(stats: GeoImportStats): string;
+};
+
+interface ImportedTrack {
+	timestamp: number[];
+	northing: number[];
+	easting: number[];
+	accuracy: number[];
+	speed: number[];
+}
+
+/**
+ * Runs an import in pieces of the given size and collects what it hands on
+ */
+function runImport(app: App, text: string, pieceSize: number = text.length, startTime: number = 0) {
+	const importer = new app.GeoXmlImporter(startTime);
+	const waypoints: Waypoint[] = [];
+	const tracks: ImportedTrack[] = [];
+	let current: ImportedTrack | null = null;
+	importer.onWaypoints = (batch) => waypoints.push(...batch);
+	importer.onTrackPoints = (columns) => {
+		current ??= { timestamp: [], northing: [], easting: [], accuracy: [], speed: [] };
+		for (let i = 0; i < columns.count; i++) {
+			current.timestamp.push(columns.timestamp[i]);
+			current.northing.push(columns.northing[i]);
+			current.easting.push(columns.easting[i]);
+			current.accuracy.push(columns.accuracy[i]);
+			current.speed.push(columns.speed[i]);
+		}
+	};
+	importer.onTrackEnd = () => {
+		tracks.push(current!);
+		current = null;
+	};
+	for (let i = 0; i < text.length; i += pieceSize) {
+		importer.push(text.slice(i, i + pieceSize));
+	}
+	importer.end();
+	return { importer, waypoints, tracks };
+}
+
+const GPX = `<?xml version="1.0" encoding="UTF-8"?>
+<gpx version="1.1" creator="test" xmlns="http://www.topografix.com/GPX/1/1" xmlns:sweref="https://sweref99.nu/gpx">
+	<metadata><name>Plan</name><time>2020-01-01T00:00:00Z</time></metadata>
+	<!-- <wpt lat="1" lon="1"> i en kommentar räknas inte -->
+	<wpt lat="59.3268" lon='18.0717'><name>Slottet &amp; &#229;n</name></wpt>
+	<wpt lat="57.7089" lon="11.9746"/>
+	<rte><name>Rutt</name><rtept lat="55.6050" lon="13.0038"><name><![CDATA[Malmö <C>]]></name></rtept></rte>
+	<trk><name>Promenad</name>
+		<trkseg>
+			<trkpt lat="59.3" lon="18.0"><ele>12</ele><time>2024-06-01T10:00:00Z</time><hdop>0.8</hdop></trkpt>
+			<trkpt lat="59.3001" lon="18.0001"><time>2024-06-01T10:00:01Z</time>
+				<extensions><sweref:accuracy>3.5</sweref:accuracy><sweref:speed>1.25</sweref:speed></extensions>
+			</trkpt>
+		</trkseg>
+		<trkseg><trkpt lat="59.3002" lon="18.0002"><time>2024-06-01T10:00:05Z</time></trkpt></trkseg>
+	</trk>
+	<trk><trkseg><trkpt lat="91" lon="18"/><trkpt lat="67.8558" lon="20.2253"/></trkseg></trk>
+	<trk><trkseg></trkseg></trk>
+</gpx>`;
+
+const KML = `<?xml version="1.0" encoding="UTF-8"?>
+<kml xmlns="http://www.opengis.net/kml/2.2" xmlns:gx="http://www.google.com/kml/ext/2.2">
+<Document><name>Dokument</name><Folder>
+	<Placemark><Point><coordinates>18.0717,59.3268,0</coordinates></Point><name>Slottet</name></Placemark>
+	<Placemark><name>Väg</name><LineString><tessellate>1</tessellate><coordinates>
+		18.0,59.3,0 18.001,59.301,0
+		18.002,59.302
+	</coordinates></LineString></Placemark>
+	<Placemark><name>Tomt</name><Polygon><outerBoundaryIs><LinearRing><coordinates>18,59 18.1,59 18,59.1 18,59</coordinates></LinearRing></outerBoundaryIs></Polygon></Placemark>
+	<Placemark><TimeStamp><when>2024-01-01T00:00:00Z</when></TimeStamp><gx:Track>
+		<when>2024-06-01T10:00:00Z</when><when>2024-06-01T10:00:02Z</when>
+		<gx:coord>18.0 59.3 10</gx:coord><gx:coord>18.001 59.301 10</gx:coord>
+	</gx:Track></Placemark>
+</Folder></Document></kml>`;
+
+describe('GPX and KML import', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'GEO_IMPORT_BATCH_SIZE',
+			'XmlStreamParser',
+			'GeoXmlImporter',
+			'getXmlAttribute',
+			'isGeoXmlFileName',
+			'projectToSweref99tm',
+			'formatGeoImportStatus'
+		]);
+	});
+
+	describe('XML parser', () => {
+		const xml = '<?xml version="1.0"?><!DOCTYPE a><a x="1 > 0" y=\'&lt;b&gt;\'><!-- <b> --><b/>t&amp;u<![CDATA[<c>]]><p:c>v&#x41;</p:c></a>';
+
+		it('should report the same events wherever the input is split', () => {
+			const parse = (pieceSize: number) => {
+				const events: string[] = [];
+				let text = '';
+				const flush = () => {
+					if (text !== '') {
+						events.push(`text ${text}`);
+						text = '';
+					}
+				};
+				const parser = new app.XmlStreamParser({
+					open: (name, attributes) => { flush(); events.push(`open ${name} ${app.getXmlAttribute(attributes, 'x')} ${app.getXmlAttribute(attributes, 'y')}`); },
+					close: (name) => { flush(); events.push(`close ${name}`); },
+					text: (piece) => { text += piece; }
+				});
+				for (let i = 0; i < xml.length; i += pieceSize) {
+					parser.push(xml.slice(i, i + pieceSize));
+				}
+				parser.end();
+				flush();
+				return events;
+			};
+			const expected = ['open a 1 > 0 <b>', 'open b null null', 'close b', 'text t&u<c>', 'open c null null', 'text vA', 'close c', 'close a'];
+			for (let pieceSize = 1; pieceSize <= xml.length; pieceSize++) {
+				expect(parse(pieceSize)).toEqual(expected);
+			}
+		});
+
+		it('should recognise GPX and KML file names', () => {
+			expect(app.isGeoXmlFileName('Spår.GPX')).toBe(true);
+			expect(app.isGeoXmlFileName('plan.kml')).toBe(true);
+			expect(app.isGeoXmlFileName('punkter.csv')).toBe(false);
+			expect(app.isGeoXmlFileName('plan.kmz')).toBe(false);
+		});
+	});
+
+	describe('GPX', () => {
+		it('should import waypoints, route points and tracks in any piece size', () => {
+			for (const pieceSize of [1, 7, 64, GPX.length]) {
+				const { importer, waypoints, tracks } = runImport(app, GPX, pieceSize);
+				const castle = app.projectToSweref99tm(59.3268, 18.0717);
+				expect(waypoints.map((waypoint) => waypoint.name)).toEqual(['Slottet & ån', 'Punkt 2', 'Malmö <C>']);
+				expect(waypoints[0].northing).toBeCloseTo(castle.northing, 6);
+				expect(waypoints[0].easting).toBeCloseTo(castle.easting, 6);
+
+				// Segmenten i ett trk blir ett spår; ogiltiga punkter och tomma spår hoppas över
+				expect(tracks.length).toBe(2);
+				expect(importer.trackCount).toBe(2);
+				expect(importer.trackPointCount).toBe(4);
+				const [walk, north] = tracks;
+				expect(walk.timestamp).toEqual([Date.UTC(2024, 5, 1, 10, 0, 0), Date.UTC(2024, 5, 1, 10, 0, 1), Date.UTC(2024, 5, 1, 10, 0, 5)]);
+				expect(walk.accuracy).toEqual([4, 3.5, 5]);
+				expect(walk.speed[1]).toBe(1.25);
+				expect(Number.isNaN(walk.speed[0])).toBe(true);
+				expect(walk.northing[0]).toBeCloseTo(app.projectToSweref99tm(59.3, 18.0).northing, 6);
+				// Utan tid följer punkten den förra med en sekund
+				expect(north.timestamp).toEqual([Date.UTC(2024, 5, 1, 10, 0, 6)]);
+			}
+		});
+	});
+
+	describe('KML', () => {
+		it('should import points, line strings and gx:Track but not polygons', () => {
+			const startTime = Date.UTC(2024, 0, 1);
+			for (const pieceSize of [1, 5, KML.length]) {
+				const { waypoints, tracks } = runImport(app, KML, pieceSize, startTime);
+				expect(waypoints.map((waypoint) => waypoint.name)).toEqual(['Slottet']);
+				expect(waypoints[0].easting).toBeCloseTo(app.projectToSweref99tm(59.3268, 18.0717).easting, 6);
+
+				expect(tracks.length).toBe(2);
+				const [road, recorded] = tracks;
+				expect(road.northing.length).toBe(3);
+				expect(road.northing[2]).toBeCloseTo(app.projectToSweref99tm(59.302, 18.002).northing, 6);
+				expect(road.timestamp).toEqual([startTime, startTime + 1000, startTime + 2000]);
+				expect(recorded.timestamp).toEqual([Date.UTC(2024, 5, 1, 10, 0, 0), Date.UTC(2024, 5, 1, 10, 0, 2)]);
+				expect(recorded.easting[1]).toBeCloseTo(app.projectToSweref99tm(59.301, 18.001).easting, 6);
+			}
+		});
+	});
+
+	describe('Large files', () => {
+		it('should import 200 000 track points in bounded batches', () => {
+			const count = 200000;
+			const parts = ['<gpx><trk><trkseg>'];
+			for (let i = 0; i < count; i++) {
+				const time = new Date(Date.UTC(2024, 5, 1) + i * 1000).toISOString();
+				parts.push(`<trkpt lat="${(59 + i * 1e-5).toFixed(6)}" lon="${(18 + i * 1e-5).toFixed(6)}"><ele>10.0</ele><time>${time}</time></trkpt>\n`);
+			}
+			parts.push('</trkseg></trk></gpx>');
+			const text = parts.join('');
+
+			const importer = new app.GeoXmlImporter(0);
+			let largestBatch = 0;
+			let received = 0;
+			let lastTimestamp = 0;
+			importer.onTrackPoints = (columns) => {
+				largestBatch = Math.max(largestBatch, columns.count);
+				received += columns.count;
+				lastTimestamp = columns.timestamp[columns.count - 1];
+			};
+			const start = performance.now();
+			for (let i = 0; i < text.length; i += 64 * 1024) {
+				importer.push(text.slice(i, i + 64 * 1024));
+			}
+			importer.end();
+			const seconds = (performance.now() - start) / 1000;
+
+			expect(received).toBe(count);
+			expect(largestBatch).toBe(app.GEO_IMPORT_BATCH_SIZE);
+			expect(lastTimestamp).toBe(Date.UTC(2024, 5, 1) + (count - 1) * 1000);
+			console.log(`GPX import, ${count} track points (${(text.length / 1e6).toFixed(1)} MB): ${Math.round(count / seconds)} points/s`);
+		});
+	});
+
+	describe('Status', () => {
+		it('should describe an import with its throughput', () => {
+			expect(app.formatGeoImportStatus({ waypointCount: 12, trackCount: 1, trackPointCount: 35000, byteCount: 1e6, durationMs: 500 }))
+				.toBe('12 punkter och 1 spår (35000\u00A0positioner) importerade, 70024\u00A0punkter/s');
+		});
+	});
+});
@@ -0,0 +1,302 @@
+/**
+ * Tests for the geofence engine
+ *
+ * Tests cover:
+ * - Packed R-tree point queries against a brute-force box scan
+ * - Even-odd point-in-polygon with holes and multipolygons
+ * - GeoJSON import in WGS 84 and SWEREF 99 TM
+ * - Entry and exit events with hysteresis at the boundary
+ * - Cost per fix for 10 000 parcels
+ * - Entry and exit notifications in the real app
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface GeofencePolygon {
+	name: string;
+	coordinates: Float64Array;
+	ringStarts: Int32Array;
+}
+
+interface GeofenceEvents {
+	entered: string[];
+	exited: string[];
+	changed: boolean;
+}
+
+interface GeofenceEngine {
+	readonly size: number;
+	insideNames(): string[];
+	reset(): void;
+	update(northing: number, easting: number): GeofenceEvents;
+}
+
+interface PackedRTree {
+	search(northing: number, easting: number, results: number[]): number[];
+}
+
+interface ReplayTrace {
+	name: string;
+	fixes: { latitude: number; longitude: number }[];
+}
+
+interface ReplaySource {
+	whenComplete(): Promise<void>;
+}
+
+type App = {
+	PackedRTree: new (bounds: Float64Array) => PackedRTree;
+	GeofenceEngine: new (polygons: GeofencePolygon[]) => GeofenceEngine;
+	isInsideGeofence(polygon: GeofencePolygon, northing: number, easting: number): boolean;
+	parseGeofenceGeoJson(text: string): GeofencePolygon[];
+	projectToSweref99tm(latitude: number, longitude: number): { northing: number; easting: number };
+	wgs84_to_sweref99tm(latitude: number, longitude: number): { northing: number; easting: number };
+	geofenceEngine: GeofenceEngine | null;
+	createSyntheticTrace(kind: string, durationSeconds?: number, rateHz?: number): ReplayTrace;
+	ReplayPositionSource: new (trace: ReplayTrace, speedFactor?: number) => ReplaySource;
+	startGeolocationWatch(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: unknown;
+};
+
+const ORIGIN_NORTHING = 6580000;
+const ORIGIN_EASTING = 674000;
+
+/**
+ * Deterministic uniform samples in [0, 1)
+ */
+function createRandom(seed: number): () => number {
+	let state = seed;
+	return () => {
+		state = (state * 16807) % 2147483647;
+		return state / 2147483647;
+	};
+}
+
+/**
+ * Builds a polygon from rings of [north, east] offsets from the origin
+ */
+function createPolygon(name: string, rings: [number, number][][]): GeofencePolygon {
+	const coordinates: number[] = [];
+	const ringStarts = [0];
+	for (const ring of rings) {
+		for (const [north, east] of ring) {
+			coordinates.push(ORIGIN_NORTHING + north, ORIGIN_EASTING + east);
+		}
+		ringStarts.push(coordinates.length / 2);
+	}
+	return { name, coordinates: Float64Array.from(coordinates), ringStarts: Int32Array.from(ringStarts) };
+}
+
+/**
+ * Regular polygon approximating a circle of [north, east] offsets
+ */
+function circle(north: number, east: number, radius: number, vertices = 16): [number, number][] {
+	return Array.from({ length: vertices }, (_, i): [number, number] => [
+		north + radius * Math.cos(2 * Math.PI * i / vertices),
+		east + radius * Math.sin(2 * Math.PI * i / vertices)
+	]);
+}
+
+const square = (north: number, east: number, side: number): [number, number][] =>
+	[[north, east], [north + side, east], [north + side, east + side], [north, east + side]];
+
+describe('Geofence', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'PackedRTree',
+			'GeofenceEngine',
+			'isInsideGeofence',
+			'parseGeofenceGeoJson',
+			'projectToSweref99tm',
+			'wgs84_to_sweref99tm',
+			'geofenceEngine',
+			'createSyntheticTrace',
+			'ReplayPositionSource',
+			'startGeolocationWatch',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource'
+		]);
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	describe('Packed R-tree', () => {
+		it('should find nothing in an empty tree', () => {
+			expect(new app.PackedRTree(new Float64Array(0)).search(ORIGIN_NORTHING, ORIGIN_EASTING, [])).toEqual([]);
+		});
+
+		it.each([1, 16, 17, 300, 5000])('should match a brute-force scan over %s boxes', (count) => {
+			const random = createRandom(count);
+			const bounds = new Float64Array(count * 4);
+			for (let i = 0; i < count; i++) {
+				const north = ORIGIN_NORTHING + 20000 * random();
+				const east = ORIGIN_EASTING + 20000 * random();
+				bounds.set([north, east, north + 2000 * random(), east + 2000 * random()], 4 * i);
+			}
+			const tree = new app.PackedRTree(bounds);
+			const results: number[] = [];
+			for (let query = 0; query < 100; query++) {
+				const north = ORIGIN_NORTHING - 1000 + 24000 * random();
+				const east = ORIGIN_EASTING - 1000 + 24000 * random();
+				const expected: number[] = [];
+				for (let i = 0; i < count; i++) {
+					if (north >= bounds[4 * i] && east >= bounds[4 * i + 1] && north <= bounds[4 * i + 2] && east <= bounds[4 * i + 3]) {
+						expected.push(i);
+					}
+				}
+				expect(tree.search(north, east, results).slice().sort((a, b) => a - b)).toEqual(expected);
+			}
+		});
+	});
+
+	describe('Point in polygon', () => {
+		const parcel = createPolygon('Skifte', [square(0, 0, 100), square(40, 40, 20), square(200, 0, 50)]);
+
+		it.each([
+			[10, 10, true],
+			[50, 50, false],
+			[70, 70, true],
+			[120, 50, false],
+			[220, 20, true],
+			[-1, 50, false]
+		])('should tell whether %s, %s is inside', (north, east, inside) => {
+			expect(app.isInsideGeofence(parcel, ORIGIN_NORTHING + north, ORIGIN_EASTING + east)).toBe(inside);
+		});
+	});
+
+	describe('GeoJSON import', () => {
+		it('should project WGS 84 polygons and drop the closing position', () => {
+			const ring = [[18.07, 59.33], [18.08, 59.33], [18.08, 59.34], [18.07, 59.34], [18.07, 59.33]];
+			const [polygon] = app.parseGeofenceGeoJson(JSON.stringify({
+				type: 'FeatureCollection',
+				features: [
+					{ type: 'Feature', properties: { namn: 'Kvarteret' }, geometry: { type: 'Polygon', coordinates: [ring] } },
+					{ type: 'Feature', properties: {}, geometry: { type: 'Point', coordinates: [18.07, 59.33] } }
+				]
+			}));
+			expect(polygon.name).toBe('Kvarteret');
+			expect(Array.from(polygon.ringStarts)).toEqual([0, 4]);
+			const corner = app.projectToSweref99tm(59.34, 18.08);
+			expect(polygon.coordinates[4]).toBeCloseTo(corner.northing, 6);
+			expect(polygon.coordinates[5]).toBeCloseTo(corner.easting, 6);
+		});
+
+		it('should read SWEREF 99 TM multipolygons in either axis order', () => {
+			const polygons = app.parseGeofenceGeoJson(JSON.stringify({
+				type: 'FeatureCollection',
+				features: [
+					{ type: 'Feature', properties: { id: 7 }, geometry: { type: 'MultiPolygon', coordinates: [
+						[[[674000, 6580000], [674100, 6580000], [674100, 6580100]]],
+						[[[674500, 6580000], [674600, 6580000], [674600, 6580100]]]
+					] } },
+					{ type: 'Feature', geometry: { type: 'Polygon', coordinates: [[[6580000, 674000], [6580000, 674100], [6580100, 674100]]] } }
+				]
+			}));
+			expect(polygons.map((polygon) => polygon.name)).toEqual(['7', 'Område 2']);
+			expect(Array.from(polygons[0].ringStarts)).toEqual([0, 3, 6]);
+			expect(Array.from(polygons[0].coordinates.subarray(0, 2))).toEqual([6580000, 674000]);
+			expect(Array.from(polygons[1].coordinates.subarray(2, 4))).toEqual([6580000, 674100]);
+		});
+	});
+
+	describe('Entry and exit', () => {
+		it('should set the state silently on the first position', () => {
+			const engine = new app.GeofenceEngine([createPolygon('A', [square(0, 0, 100)])]);
+			const events = engine.update(ORIGIN_NORTHING + 50, ORIGIN_EASTING + 50);
+			expect(events).toEqual({ entered: [], exited: [], changed: true });
+			expect(engine.insideNames()).toEqual(['A']);
+		});
+
+		it('should report no change for a first position outside all areas', () => {
+			const engine = new app.GeofenceEngine([createPolygon('A', [square(0, 0, 100)])]);
+			expect(engine.update(ORIGIN_NORTHING - 50, ORIGIN_EASTING - 50)).toEqual({ entered: [], exited: [], changed: false });
+			expect(engine.update(ORIGIN_NORTHING + 50, ORIGIN_EASTING + 50)).toEqual({ entered: ['A'], exited: [], changed: true });
+		});
+
+		it('should report one entry and one exit for a walk with jitter across the area', () => {
+			const engine = new app.GeofenceEngine([createPolygon('A', [square(0, 0, 100)]), createPolygon('B', [square(0, 200, 100)])]);
+			const random = createRandom(3);
+			const entered: string[] = [];
+			const exited: string[] = [];
+			engine.update(ORIGIN_NORTHING + 50, ORIGIN_EASTING - 50);
+			for (let east = -50; east <= 150; east += 0.5) {
+				const events = engine.update(ORIGIN_NORTHING + 50, ORIGIN_EASTING + east + 4 * (random() - 0.5));
+				entered.push(...events.entered);
+				exited.push(...events.exited);
+			}
+			expect(entered).toEqual(['A']);
+			expect(exited).toEqual(['A']);
+			expect(engine.insideNames()).toEqual([]);
+		});
+
+		it('should handle overlapping areas', () => {
+			const engine = new app.GeofenceEngine([createPolygon('Fastighet', [square(0, 0, 100)]), createPolygon('Arbetsområde', [circle(50, 50, 20)])]);
+			engine.update(ORIGIN_NORTHING - 50, ORIGIN_EASTING + 50);
+			expect(engine.update(ORIGIN_NORTHING + 10, ORIGIN_EASTING + 50).entered).toEqual(['Fastighet']);
+			expect(engine.update(ORIGIN_NORTHING + 50, ORIGIN_EASTING + 50).entered).toEqual(['Arbetsområde']);
+			expect(engine.insideNames()).toEqual(['Fastighet', 'Arbetsområde']);
+			expect(engine.update(ORIGIN_NORTHING - 50, ORIGIN_EASTING + 50).exited).toEqual(['Fastighet', 'Arbetsområde']);
+		});
+	});
+
+	describe('Benchmark', () => {
+		it('should test a fix against 10 000 parcels in a few microseconds', () => {
+			// 100 × 100 fastigheter med 16 hörn, 60 m isär
+			const polygons: GeofencePolygon[] = [];
+			for (let row = 0; row < 100; row++) {
+				for (let column = 0; column < 100; column++) {
+					polygons.push(createPolygon(`${row}:${column}`, [circle(60 * row + 30, 60 * column + 30, 28)]));
+				}
+			}
+			const buildStart = performance.now();
+			const engine = new app.GeofenceEngine(polygons);
+			const buildTime = performance.now() - buildStart;
+
+			const random = createRandom(17);
+			const fixes = 20000;
+			let north = 3000;
+			let east = 3000;
+			let events = 0;
+			const start = performance.now();
+			for (let i = 0; i < fixes; i++) {
+				north = Math.min(Math.max(north + 3 * (random() - 0.5), 0), 6000);
+				east = Math.min(Math.max(east + 3 * (random() - 0.3), 0), 6000);
+				const result = engine.update(ORIGIN_NORTHING + north, ORIGIN_EASTING + east);
+				events += result.entered.length + result.exited.length;
+			}
+			const perFix = (performance.now() - start) / fixes;
+
+			console.log(`Geofence, ${polygons.length} polygons: built in ${buildTime.toFixed(1)} ms, ${(perFix * 1000).toFixed(2)} µs per fix, ${events} events`);
+			expect(events).toBeGreaterThan(0);
+			expect(perFix).toBeLessThan(0.05);
+		});
+	});
+
+	describe('Display', () => {
+		it('should notify when leaving an area', async () => {
+			const trace = app.createSyntheticTrace('walking', 120);
+			const first = app.wgs84_to_sweref99tm(trace.fixes[0].latitude, trace.fixes[0].longitude);
+			const ring = circle(first.northing - ORIGIN_NORTHING, first.easting - ORIGIN_EASTING, 25);
+			app.geofenceEngine = new app.GeofenceEngine([createPolygon('Startplatsen', [ring])]);
+
+			const source = new app.ReplayPositionSource(trace, Number.POSITIVE_INFINITY);
+			app.stopGeolocationWatch();
+			app.positionSource = source;
+			app.startGeolocationWatch(app.handlePositionError);
+			await source.whenComplete();
+
+			expect(document.getElementById('notification-content')?.textContent).toBe('Lämnat Startplatsen');
+			expect(document.getElementById('geofence-inside')?.textContent).toBe('Utanför alla områden');
+		});
+	});
+});
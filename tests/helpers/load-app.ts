@@ -0,0 +1,73 @@
+/**
+ * Loads the real application into the jsdom test environment
+ *
+ * Most tests copy the logic they cover (see tests/README.md). Pipeline and
+ * soak tests instead need the actual code path from a position fix to the
+ * DOM, so this helper sets up the markup from _site/index.html (or another
+ * page), transpiles the scripts listed there in load order and evaluates
+ * them as one classic script, like the browser does. Top-level `let`/`const` bindings are not
+ * visible outside an indirect eval, so the requested names are returned as
+ * getter/setter handles.
+ */
+
+import * as fs from 'fs';
+import * as path from 'path';
+import * as ts from 'typescript';
+
+const ROOT = path.join(__dirname, '..', '..');
+
+/**
+ * jsdom lacks showModal() and close() on dialog elements
+ */
+function installDialogPolyfill(): void {
+	const prototype = (typeof HTMLDialogElement === 'function' ? HTMLDialogElement.prototype : HTMLElement.prototype) as unknown as Record<string, unknown>;
+	if (typeof prototype.showModal !== 'function') {
+		prototype.showModal = function (this: HTMLElement) {
+			this.setAttribute('open', '');
+		};
+	}
+	if (typeof prototype.close !== 'function') {
+		prototype.close = function (this: HTMLElement) {
+			this.removeAttribute('open');
+		};
+	}
+}
+
+/**
+ * Script files in the order the page loads them
+ */
+function readScriptOrder(html: string): string[] {
+	const names: string[] = [];
+	const pattern = /<script[^>]*\bsrc="([^"]+)\.js"/g;
+	let match: RegExpExecArray | null;
+	while ((match = pattern.exec(html)) !== null) {
+		names.push(path.basename(match[1]));
+	}
+	return names;
+}
+
+/**
+ * Loads the app and returns live handles to the named top-level bindings
+ *
+ * @param names - Functions, classes and variables to expose; assigning to a
+ * handle assigns the binding inside the app (e.g. `positionSource`)
+ * @param page - Page in _site whose markup and scripts are loaded
+ */
+export function loadApp<T extends Record<string, unknown>>(names: (keyof T & string)[], page: string = 'index.html'): T {
+	const html = fs.readFileSync(path.join(ROOT, '_site', page), 'utf8');
+	const body = /<body[^>]*>([\s\S]*)<\/body>/.exec(html);
+	document.body.innerHTML = body ? body[1].replace(/<script\b[\s\S]*?<\/script>/g, '') : '';
+
+	installDialogPolyfill();
+
+	const sources = readScriptOrder(html).map((name) => {
+		const fileName = path.join(ROOT, 'src', `${name}.ts`);
+		return ts.transpileModule(fs.readFileSync(fileName, 'utf8'), {
+			fileName,
+			compilerOptions: { target: ts.ScriptTarget.ES2020, module: ts.ModuleKind.ES2020 }
+		}).outputText;
+	});
+	const handles = names.map((name) => `get ${name}() { return ${name}; }, set ${name}(value) { ${name} = value; }`);
+	const code = `${sources.join('\n;\n')}\n;({ ${handles.join(', ')} });`;
+	return (0, eval)(code) as T;
+}
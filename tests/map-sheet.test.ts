@@ -0,0 +1,121 @@
+/**
+ * Tests for the map sheet names
+ *
+ * Tests cover:
+ * - Sheet names at and around sheet corners
+ * - Larger sheets containing the smaller ones
+ * - Reuse of the names for consecutive positions
+ * - The map sheet line in the real app
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+type MapSheetSize = 5000 | 10000 | 50000;
+
+interface ReplayTrace {
+	name: string;
+	fixes: { latitude: number; longitude: number }[];
+}
+
+interface ReplaySource {
+	whenComplete(): Promise<void>;
+}
+
+type App = {
+	MAP_SHEET_SIZES: readonly MapSheetSize[];
+	mapSheetIndex(northing: number, easting: number, size: MapSheetSize): number;
+	formatMapSheet(northing: number, easting: number, size: MapSheetSize): string;
+	formatMapSheets(northing: number, easting: number): string[];
+	createMapSheetNamer(): (northing: number, easting: number) => readonly string[];
+	createSyntheticTrace(kind: string, durationSeconds?: number, rateHz?: number): ReplayTrace;
+	ReplayPositionSource: new (trace: ReplayTrace, speedFactor?: number) => ReplaySource;
+	startGeolocationWatch(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: unknown;
+};
+
+describe('Map sheets', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'MAP_SHEET_SIZES',
+			'mapSheetIndex',
+			'formatMapSheet',
+			'formatMapSheets',
+			'createMapSheetNamer',
+			'createSyntheticTrace',
+			'ReplayPositionSource',
+			'startGeolocationWatch',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource'
+		]);
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	describe('Names', () => {
+		it.each([
+			[6580822.123, 674032.456, ['6580_670', '6580_670', '6550_650']],
+			[6580000, 675000, ['6580_675', '6580_670', '6550_650']],
+			[6579999.999, 674999.999, ['6575_670', '6570_670', '6550_650']],
+			[7670000, 181000, ['7670_180', '7670_180', '7650_150']]
+		])('should name the sheets at N %s', (northing, easting, names) => {
+			expect(app.formatMapSheets(northing, easting)).toEqual(names);
+		});
+
+		it('should change the index exactly when the name changes', () => {
+			for (const size of app.MAP_SHEET_SIZES) {
+				for (let step = 0; step < 2000; step++) {
+					const northing = 6500000 + step * 37.3;
+					const easting = 500000 + step * 41.9;
+					const sameName = app.formatMapSheet(northing, easting, size) === app.formatMapSheet(northing + 60, easting - 60, size);
+					const sameIndex = app.mapSheetIndex(northing, easting, size) === app.mapSheetIndex(northing + 60, easting - 60, size);
+					expect(sameIndex).toBe(sameName);
+				}
+			}
+		});
+
+		it('should put each sheet inside the larger sheets', () => {
+			for (let step = 0; step < 1000; step++) {
+				const northing = 6130000 + step * 1531.7;
+				const easting = 260000 + step * 661.3;
+				const [small, , large] = app.formatMapSheets(northing, easting).map((name) => name.split('_').map(Number));
+				expect(small[0] - large[0]).toBeGreaterThanOrEqual(0);
+				expect(small[0] - large[0]).toBeLessThan(50);
+				expect(small[1] - large[1]).toBeGreaterThanOrEqual(0);
+				expect(small[1] - large[1]).toBeLessThan(50);
+			}
+		});
+
+		it('should reuse the names until the position leaves the smallest sheet', () => {
+			const name = app.createMapSheetNamer();
+			const first = name(6580100, 670100);
+			expect(name(6584900, 674900)).toBe(first);
+			expect(name(6585000, 674900)).not.toBe(first);
+			expect(name(6585000, 674900)).toEqual(['6585_670', '6580_670', '6550_650']);
+		});
+	});
+
+	describe('Display', () => {
+		it('should show the sheets of the position', async () => {
+			const trace = app.createSyntheticTrace('walking', 30);
+
+			const source = new app.ReplayPositionSource(trace, Number.POSITIVE_INFINITY);
+			app.stopGeolocationWatch();
+			app.positionSource = source;
+			app.startGeolocationWatch(app.handlePositionError);
+			await source.whenComplete();
+
+			expect(document.getElementById('map-sheet')!.textContent)
+				.toMatch(/^Ruta 5\skm\s\d{4}_\d{3}, 10\skm\s\d{4}_\d{3}, 50\skm\s\d{4}_\d{3}$/);
+		});
+	});
+});
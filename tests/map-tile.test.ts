@@ -0,0 +1,356 @@
+/**
+ * Tests for the offline map tiles and their caches
+ *
+ * Tests cover:
+ * - Round trips of the binary tile format and its size per point
+ * - Tile keys for a view and for the path ahead
+ * - The byte-bounded LRU used in memory and in the service worker
+ * - Tile loading in the map view: visible tiles first, prefetching along
+ *   the direction of travel, the concurrency limit and missing tiles
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface MapFeature {
+	kind: number;
+	geometry: number;
+	name: string;
+	coordinates: Int32Array;
+	ringStarts: Int32Array;
+}
+
+interface MapTile {
+	size: number;
+	minNorthing: number;
+	minEasting: number;
+	features: MapFeature[];
+}
+
+interface ByteLru<V> {
+	readonly size: number;
+	readonly bytes: number;
+	has(key: string): boolean;
+	get(key: string): V | undefined;
+	set(key: string, value: V, bytes: number): string[];
+	delete(key: string): boolean;
+	keys(): IterableIterator<string>;
+}
+
+interface MapView {
+	readonly zoom: number;
+	readonly tileCount: number;
+	setZoom(zoomIndex: number): void;
+	setVisible(visible: boolean): void;
+	setPosition(northing: number, easting: number, accuracy: number, gridBearing: number | null, speed: number | null): void;
+	frameStats(): { count: number; mean: number; p95: number; max: number };
+}
+
+type App = {
+	MAP_FEATURE_KIND: Record<string, number>;
+	MAP_GEOMETRY: Record<string, number>;
+	encodeMapTile(tile: MapTile): Uint8Array;
+	decodeMapTile(bytes: Uint8Array): MapTile;
+	mapTileKey(size: number, row: number, column: number): string;
+	mapTileUrl(key: string): string;
+	chooseMapTileSize(viewWidth: number): number;
+	collectMapTiles(minNorthing: number, minEasting: number, maxNorthing: number, maxEasting: number, size: number, keys: string[]): void;
+	collectMapTilesAhead(northing: number, easting: number, gridBearing: number, distance: number, size: number, keys: string[]): void;
+	ByteLru: new <V>(maxBytes: number) => ByteLru<V>;
+	MapView: new (canvas: HTMLCanvasElement, loadTile: (url: string) => Promise<ArrayBuffer | null>, zoomIndex?: number) => MapView;
+	formatMapStatus(tileCount: number, frames: { count: number; mean: number; p95: number; max: number }): string;
+};
+
+/**
+ * Deterministic pseudo-random numbers in [0, 1)
+ */
+function createRandom(seed: number): () => number {
+	let state = seed;
+	return () => {
+		state = (state * 1664525 + 1013904223) >>> 0;
+		return state / 4294967296;
+	};
+}
+
+/**
+ * Waits until pending promise callbacks have run
+ */
+async function flushPromises(): Promise<void> {
+	for (let i = 0; i < 10; i++) {
+		await Promise.resolve();
+	}
+}
+
+describe('Map tiles', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'MAP_FEATURE_KIND',
+			'MAP_GEOMETRY',
+			'encodeMapTile',
+			'decodeMapTile',
+			'mapTileKey',
+			'mapTileUrl',
+			'chooseMapTileSize',
+			'collectMapTiles',
+			'collectMapTilesAhead',
+			'ByteLru',
+			'MapView',
+			'formatMapStatus'
+		]);
+	});
+
+	/**
+	 * A 5 km tile with a winding road, a lake with an island and a place
+	 */
+	const createTile = (): MapTile => {
+		const random = createRandom(7);
+		const minNorthing = 6580000;
+		const minEasting = 670000;
+		const road = Array.from({ length: 400 }, (_, i) => [
+			minNorthing + Math.round(i * 12.5),
+			minEasting + 2500 + Math.round(800 * Math.sin(i / 30) + random() * 20)
+		]);
+		const lake = Array.from({ length: 60 }, (_, i) => [
+			minNorthing + 1500 + Math.round(900 * Math.cos(i * Math.PI / 30)),
+			minEasting + 1500 + Math.round(600 * Math.sin(i * Math.PI / 30))
+		]);
+		const island = [[1450, 1450], [1450, 1550], [1550, 1550], [1550, 1450]]
+			.map(([n, e]) => [minNorthing + n, minEasting + e]);
+		return {
+			size: 5000,
+			minNorthing,
+			minEasting,
+			features: [
+				{
+					kind: app.MAP_FEATURE_KIND.ROAD,
+					geometry: app.MAP_GEOMETRY.LINE,
+					name: '',
+					coordinates: Int32Array.from(road.flat()),
+					ringStarts: Int32Array.from([0, road.length])
+				},
+				{
+					kind: app.MAP_FEATURE_KIND.WATER,
+					geometry: app.MAP_GEOMETRY.POLYGON,
+					name: 'Sjön',
+					coordinates: Int32Array.from([...lake.flat(), ...island.flat()]),
+					ringStarts: Int32Array.from([0, lake.length, lake.length + island.length])
+				},
+				{
+					kind: app.MAP_FEATURE_KIND.PLACE,
+					geometry: app.MAP_GEOMETRY.POINT,
+					name: 'Åby',
+					coordinates: Int32Array.from([minNorthing + 4000, minEasting + 4000]),
+					ringStarts: Int32Array.from([0, 1])
+				}
+			]
+		};
+	};
+
+	describe('Binary format', () => {
+		it('should round-trip lines, polygons with holes and named points', () => {
+			const tile = createTile();
+			const decoded = app.decodeMapTile(app.encodeMapTile(tile));
+			expect(decoded.size).toBe(5000);
+			expect(decoded.minNorthing).toBe(tile.minNorthing);
+			expect(decoded.minEasting).toBe(tile.minEasting);
+			expect(decoded.features).toHaveLength(3);
+			decoded.features.forEach((feature, i) => {
+				expect(feature.kind).toBe(tile.features[i].kind);
+				expect(feature.geometry).toBe(tile.features[i].geometry);
+				expect(feature.name).toBe(tile.features[i].name);
+				expect(Array.from(feature.ringStarts)).toEqual(Array.from(tile.features[i].ringStarts));
+				expect(Array.from(feature.coordinates)).toEqual(Array.from(tile.features[i].coordinates));
+			});
+		});
+
+		it('should take a few bytes per point', () => {
+			const tile = createTile();
+			const points = tile.features.reduce((sum, feature) => sum + feature.coordinates.length / 2, 0);
+			const bytes = app.encodeMapTile(tile).length;
+			console.log(`Map tile: ${bytes} bytes for ${points} points, ${(bytes / points).toFixed(2)} bytes per point`);
+			expect(bytes / points).toBeLessThan(5);
+		});
+
+		it('should reject other data', () => {
+			expect(() => app.decodeMapTile(new Uint8Array(24))).toThrow();
+			const bytes = app.encodeMapTile(createTile());
+			expect(() => app.decodeMapTile(bytes.subarray(0, bytes.length - 3))).toThrow();
+		});
+	});
+
+	describe('Tile keys', () => {
+		it('should name tiles like the map sheets', () => {
+			expect(app.mapTileKey(5000, 1316, 134)).toBe('5/6580_670');
+			expect(app.mapTileUrl('5/6580_670')).toBe('tiles/5/6580_670.bin');
+		});
+
+		it.each([[1000, 5000], [15000, 5000], [20000, 10000], [100000, 50000], [1000000, 50000]])(
+			'should use coarser tiles for wider views (%s m)', (viewWidth, size) => {
+				expect(app.chooseMapTileSize(viewWidth)).toBe(size);
+			});
+
+		it('should list the tiles overlapping a view', () => {
+			const keys: string[] = [];
+			app.collectMapTiles(6579000, 669000, 6581000, 671000, 5000, keys);
+			expect(keys.sort()).toEqual(['5/6575_665', '5/6575_670', '5/6580_665', '5/6580_670']);
+		});
+
+		it('should list the tiles ahead along the direction of travel, nearest first', () => {
+			const keys: string[] = [];
+			app.collectMapTilesAhead(6582500, 672500, 90, 12000, 5000, keys);
+			expect(keys).toEqual(['5/6580_670', '5/6580_675', '5/6580_680']);
+
+			const diagonal: string[] = [];
+			app.collectMapTilesAhead(6582500, 672500, 45, 20000, 5000, diagonal);
+			expect(diagonal[0]).toBe('5/6580_670');
+			expect(diagonal[diagonal.length - 1]).toBe('5/6595_685');
+		});
+	});
+
+	describe('Byte-bounded LRU', () => {
+		it('should evict the least recently used entries beyond the byte limit', () => {
+			const lru = new app.ByteLru<string>(100);
+			expect(lru.set('a', 'A', 40)).toEqual([]);
+			expect(lru.set('b', 'B', 40)).toEqual([]);
+			expect(lru.get('a')).toBe('A');
+			expect(lru.set('c', 'C', 40)).toEqual(['b']);
+			expect(Array.from(lru.keys())).toEqual(['a', 'c']);
+			expect(lru.bytes).toBe(80);
+		});
+
+		it('should replace an entry and keep the byte count', () => {
+			const lru = new app.ByteLru<number>(100);
+			lru.set('a', 1, 30);
+			lru.set('a', 2, 50);
+			expect(lru.size).toBe(1);
+			expect(lru.bytes).toBe(50);
+			expect(lru.delete('a')).toBe(true);
+			expect(lru.bytes).toBe(0);
+		});
+
+		it('should not keep an entry larger than the limit', () => {
+			const lru = new app.ByteLru<null>(100);
+			lru.set('a', null, 60);
+			expect(lru.set('huge', null, 150)).toEqual(['a', 'huge']);
+			expect(lru.size).toBe(0);
+		});
+
+		it('should stay within the limit over many insertions', () => {
+			const lru = new app.ByteLru<null>(10000);
+			const random = createRandom(3);
+			for (let i = 0; i < 5000; i++) {
+				lru.set(`k${Math.floor(random() * 500)}`, null, 1 + Math.floor(random() * 400));
+				expect(lru.bytes).toBeLessThanOrEqual(10000);
+			}
+		});
+	});
+
+	describe('Map view loading', () => {
+		const createView = (tileExists: (url: string) => boolean) => {
+			const requested: string[] = [];
+			const pending: (() => void)[] = [];
+			const bytes = app.encodeMapTile(createTile());
+			const loader = (url: string) => {
+				requested.push(url);
+				return new Promise<ArrayBuffer | null>((resolve) => {
+					pending.push(() => resolve(tileExists(url) ? bytes.slice().buffer as ArrayBuffer : null));
+				});
+			};
+			const canvas = document.createElement('canvas');
+			canvas.width = 300;
+			canvas.height = 300;
+			// 10 m per pixel: 3 km across, inside at most 2 × 2 tiles of 5 km
+			const view = new app.MapView(canvas, loader, 3);
+			const settle = async () => {
+				while (pending.length > 0) {
+					pending.splice(0).forEach((resolve) => resolve());
+					await flushPromises();
+				}
+			};
+			return { view, requested, settle, pending };
+		};
+
+		it('should load nothing while hidden', async () => {
+			const { view, requested } = createView(() => true);
+			view.setPosition(6582500, 672500, 5, null, null);
+			await flushPromises();
+			expect(requested).toHaveLength(0);
+		});
+
+		it('should load the visible tiles once', async () => {
+			const { view, requested, settle } = createView(() => true);
+			view.setVisible(true);
+			view.setPosition(6582500, 672500, 5, null, null);
+			await settle();
+			expect(requested).toEqual(['tiles/5/6580_670.bin']);
+			expect(view.tileCount).toBe(1);
+
+			view.setPosition(6582510, 672510, 5, null, null);
+			await settle();
+			expect(requested).toHaveLength(1);
+		});
+
+		it('should not ask again for tiles that do not exist', async () => {
+			const { view, requested, settle } = createView(() => false);
+			view.setVisible(true);
+			view.setPosition(6579900, 669900, 5, null, null);
+			await settle();
+			expect(requested).toHaveLength(4);
+			view.setPosition(6579950, 669950, 5, null, null);
+			await settle();
+			expect(requested).toHaveLength(4);
+			expect(view.tileCount).toBe(0);
+		});
+
+		it('should prefetch the tiles ahead when moving, after the visible ones', async () => {
+			const { view, requested, settle } = createView(() => true);
+			view.setVisible(true);
+			// 20 m/s österut i två minuter är 2,4 km, så minst en ruta framåt
+			view.setPosition(6582500, 672500, 5, 90, 20);
+			await settle();
+			expect(requested[0]).toBe('tiles/5/6580_670.bin');
+			expect(requested).toContain('tiles/5/6580_675.bin');
+
+			// 300 m/s i två minuter är 36 km, men förhämtningen stannar sex rutor framåt
+			const { view: fast, requested: fastRequested, settle: fastSettle } = createView(() => true);
+			fast.setVisible(true);
+			fast.setPosition(6582500, 672500, 5, 0, 300);
+			await fastSettle();
+			expect(fastRequested).toContain('tiles/5/6610_670.bin');
+			expect(fastRequested).not.toContain('tiles/5/6615_670.bin');
+		});
+
+		it('should not prefetch while standing still', async () => {
+			const { view, requested, settle } = createView(() => true);
+			view.setVisible(true);
+			view.setPosition(6582500, 672500, 5, 90, 0.2);
+			await settle();
+			expect(requested).toEqual(['tiles/5/6580_670.bin']);
+		});
+
+		it('should fetch at most four tiles at a time', async () => {
+			const { view, requested, pending, settle } = createView(() => true);
+			view.setVisible(true);
+			view.setZoom(6);
+			// 100 m per pixel: 30 km across in 10 km tiles, plus tiles ahead
+			view.setPosition(6585000, 675000, 5, 45, 50);
+			await flushPromises();
+			expect(pending.length).toBeLessThanOrEqual(4);
+			await settle();
+			expect(requested.length).toBeGreaterThan(4);
+			expect(requested.every((url) => url.startsWith('tiles/10/'))).toBe(true);
+		});
+	});
+
+	describe('Status', () => {
+		it('should show tiles and frame times', () => {
+			expect(app.formatMapStatus(3, { count: 0, mean: 0, p95: 0, max: 0 })).toBe('3\u00A0rutor');
+			expect(app.formatMapStatus(9, { count: 12, mean: 1.24, p95: 2.04, max: 3 }))
+				.toBe('9\u00A0rutor · ritning 1,2\u00A0ms (p95 2,0\u00A0ms)');
+		});
+	});
+});
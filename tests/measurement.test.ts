@@ -0,0 +1,234 @@
+/**
+ * Tests for the running distance, perimeter and area measurement
+ *
+ * Tests cover:
+ * - Distance, perimeter and shoelace area for exact polygons
+ * - Scale factor correction to ground distance and area
+ * - Suppression of stationary jitter and noisy walks around a known plot
+ * - Accuracy against the ground truth of the synthetic replay traces
+ * - The measurement switch and display in the real app
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface ReplayTrace {
+	name: string;
+	fixes: { timestamp: number; latitude: number; longitude: number; accuracy: number }[];
+	truth?: { latitude: number; longitude: number; speed: number }[];
+}
+
+interface ReplaySource {
+	whenComplete(): Promise<void>;
+}
+
+interface MeasurementTotals {
+	distance: number;
+	perimeter: number;
+	area: number;
+	vertexCount: number;
+}
+
+interface Measurement {
+	reset(): void;
+	update(northing: number, easting: number, accuracy: number, scaleFactor: number): MeasurementTotals;
+	totals(): MeasurementTotals;
+}
+
+type App = {
+	SwerefMeasurement: new () => Measurement;
+	projectToSweref99tm(latitude: number, longitude: number, withGridFactors?: boolean): { northing: number; easting: number; scaleFactor?: number };
+	createSyntheticTrace(kind: string, durationSeconds?: number, rateHz?: number): ReplayTrace;
+	ReplayPositionSource: new (trace: ReplayTrace, speedFactor?: number) => ReplaySource;
+	startGeolocationWatch(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: unknown;
+};
+
+const ORIGIN_NORTHING = 6580000;
+const ORIGIN_EASTING = 674000;
+
+/**
+ * Deterministic standard normal samples
+ */
+function createGaussian(seed: number): () => number {
+	let state = seed;
+	const uniform = () => {
+		state = (state * 16807) % 2147483647;
+		return state / 2147483647;
+	};
+	return () => Math.sqrt(-2 * Math.log(uniform())) * Math.cos(2 * Math.PI * uniform());
+}
+
+describe('Measurement', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'SwerefMeasurement',
+			'projectToSweref99tm',
+			'createSyntheticTrace',
+			'ReplayPositionSource',
+			'startGeolocationWatch',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource'
+		]);
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	describe('SwerefMeasurement', () => {
+		const walk = (measurement: Measurement, corners: [number, number][], scaleFactor = 1) => {
+			let totals = measurement.totals();
+			for (const [north, east] of corners) {
+				totals = measurement.update(ORIGIN_NORTHING + north, ORIGIN_EASTING + east, 1, scaleFactor);
+			}
+			return totals;
+		};
+
+		it('should start at zero', () => {
+			expect(new app.SwerefMeasurement().totals()).toEqual({ distance: 0, perimeter: 0, area: 0, vertexCount: 0 });
+		});
+
+		it('should sum the distance and close the perimeter', () => {
+			const totals = walk(new app.SwerefMeasurement(), [[0, 0], [0, 30], [40, 30]]);
+			expect(totals.distance).toBeCloseTo(70, 9);
+			expect(totals.perimeter).toBeCloseTo(120, 9);
+			expect(totals.area).toBeCloseTo(600, 9);
+			expect(totals.vertexCount).toBe(3);
+		});
+
+		it('should give the same area in both directions of travel', () => {
+			const plot: [number, number][] = [[0, 0], [0, 50], [20, 70], [60, 40], [30, -10]];
+			const forward = walk(new app.SwerefMeasurement(), plot);
+			const backward = walk(new app.SwerefMeasurement(), [plot[0], ...plot.slice(1).reverse()]);
+			expect(forward.area).toBeCloseTo(backward.area, 9);
+			expect(forward.perimeter).toBeCloseTo(backward.perimeter, 9);
+		});
+
+		it('should turn grid lengths and areas into ground values', () => {
+			const totals = walk(new app.SwerefMeasurement(), [[0, 0], [0, 100], [100, 100], [100, 0]], 0.9996);
+			expect(totals.perimeter).toBeCloseTo(400 / 0.9996, 9);
+			expect(totals.area).toBeCloseTo(10000 / (0.9996 * 0.9996), 6);
+		});
+
+		it('should not count jitter at rest', () => {
+			const measurement = new app.SwerefMeasurement();
+			const gaussian = createGaussian(7);
+			let totals = measurement.totals();
+			for (let i = 0; i < 3600; i++) {
+				totals = measurement.update(ORIGIN_NORTHING + 2 * gaussian(), ORIGIN_EASTING + 2 * gaussian(), 5, 1);
+			}
+			expect(totals.distance).toBe(0);
+			expect(totals.vertexCount).toBe(1);
+		});
+
+		it('should measure a noisy walk around a 100 m square', () => {
+			const measurement = new app.SwerefMeasurement();
+			const gaussian = createGaussian(11);
+			const side = 100;
+			const speed = 1.4;
+			let biasNorth = 0;
+			let biasEast = 0;
+			let totals = measurement.totals();
+			for (let second = 0; second <= 4 * side / speed; second++) {
+				const travelled = second * speed;
+				const along = travelled % side;
+				const leg = Math.floor(travelled / side) % 4;
+				const north = [along, side, side - along, 0][leg];
+				const east = [0, along, side, side - along][leg];
+				biasNorth = biasNorth * 0.98 + 0.15 * gaussian();
+				biasEast = biasEast * 0.98 + 0.15 * gaussian();
+				totals = measurement.update(
+					ORIGIN_NORTHING + north + biasNorth + 2 * gaussian(),
+					ORIGIN_EASTING + east + biasEast + 2 * gaussian(),
+					5,
+					1
+				);
+			}
+			expect(Math.abs(totals.area - 10000)).toBeLessThan(500);
+			expect(Math.abs(totals.perimeter - 400)).toBeLessThan(25);
+		});
+
+		it('should start over after reset', () => {
+			const measurement = new app.SwerefMeasurement();
+			walk(measurement, [[0, 0], [0, 30], [40, 30]]);
+			measurement.reset();
+			expect(walk(measurement, [[100, 100], [100, 110]]).distance).toBeCloseTo(10, 9);
+		});
+	});
+
+	describe('Accuracy against synthetic ground truth', () => {
+		// Största tillåtna relativa fel i sträcka
+		const cases: [string, number][] = [
+			['walking', 0.06],
+			['driving', 0.03]
+		];
+
+		it.each(cases)('should follow the distance of the %s trace', (kind, maxError) => {
+			const trace = app.createSyntheticTrace(kind, 3600);
+			const measurement = new app.SwerefMeasurement();
+			let truthDistance = 0;
+			let totals = measurement.totals();
+			const start = performance.now();
+
+			trace.fixes.forEach((fix, i) => {
+				const measured = app.projectToSweref99tm(fix.latitude, fix.longitude, true);
+				totals = measurement.update(measured.northing, measured.easting, fix.accuracy, measured.scaleFactor!);
+				if (i > 0) {
+					const a = app.projectToSweref99tm(trace.truth![i - 1].latitude, trace.truth![i - 1].longitude, true);
+					const b = app.projectToSweref99tm(trace.truth![i].latitude, trace.truth![i].longitude);
+					truthDistance += Math.hypot(b.northing - a.northing, b.easting - a.easting) / a.scaleFactor!;
+				}
+			});
+
+			const error = Math.abs(totals.distance - truthDistance) / truthDistance;
+			console.log(`Measurement ${kind}: ${totals.distance.toFixed(0)} m of ${truthDistance.toFixed(0)} m, ${totals.vertexCount} vertices, ${((performance.now() - start) / trace.fixes.length * 1000).toFixed(1)} µs/fix incl. projections`);
+			expect(error).toBeLessThan(maxError);
+		});
+
+		it('should add no distance for an hour at rest', () => {
+			const trace = app.createSyntheticTrace('stationary', 3600);
+			const measurement = new app.SwerefMeasurement();
+			let totals = measurement.totals();
+			for (const fix of trace.fixes) {
+				const measured = app.projectToSweref99tm(fix.latitude, fix.longitude, true);
+				totals = measurement.update(measured.northing, measured.easting, fix.accuracy, measured.scaleFactor!);
+			}
+			expect(totals.distance).toBe(0);
+		});
+	});
+
+	describe('Display', () => {
+		const replay = async (trace: ReplayTrace) => {
+			const source = new app.ReplayPositionSource(trace, Number.POSITIVE_INFINITY);
+			app.stopGeolocationWatch();
+			app.positionSource = source;
+			app.startGeolocationWatch(app.handlePositionError);
+			await source.whenComplete();
+		};
+
+		it('should measure only while switched on', async () => {
+			const toggle = document.getElementById('measure-toggle') as HTMLInputElement;
+			const status = document.getElementById('measure-status')!;
+			const initial = status.textContent;
+			await replay(app.createSyntheticTrace('walking', 120));
+			expect(status.textContent).toBe(initial);
+
+			toggle.click();
+			await replay(app.createSyntheticTrace('driving', 120));
+			expect(status.textContent).toMatch(/^Sträcka 1,\d{2}\skm\nOmkrets \d+(,\d{2})?\s(k?m)\nYta \d+(,\d{2})?\s(m²|ha)$/);
+		});
+
+		it('should reset to zero', () => {
+			(document.getElementById('measure-reset-btn') as HTMLButtonElement).click();
+			expect(document.getElementById('measure-status')?.textContent).toMatch(/^Sträcka 0\sm\nOmkrets 0\sm\nYta 0\sm²$/);
+		});
+	});
+});
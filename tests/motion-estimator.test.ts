@@ -0,0 +1,242 @@
+/**
+ * Tests for speed and course derived from successive SWEREF 99 TM fixes
+ *
+ * Tests cover:
+ * - Scale factor and meridian convergence from the projection applied to speed and course
+ * - Constant-velocity motion, standstill and window restarts
+ * - Receivers with several fixes per second
+ * - Rejection of outlying fixes
+ * - Accuracy against the ground truth of the synthetic replay traces
+ * - Display of derived values when the device reports no speed or course
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface GnssFix {
+	timestamp: number;
+	latitude: number;
+	longitude: number;
+	accuracy: number;
+	altitude: number | null;
+	speed: number | null;
+	heading: number | null;
+}
+
+interface ReplayTrace {
+	name: string;
+	fixes: GnssFix[];
+	truth?: { latitude: number; longitude: number; speed: number }[];
+}
+
+interface MotionEstimate {
+	speed: number;
+	course: number | null;
+}
+
+interface MotionEstimator {
+	reset(): void;
+	update(timestamp: number, northing: number, easting: number, accuracy: number, convergence: number, scaleFactor: number): MotionEstimate | null;
+}
+
+interface ReplaySource {
+	whenComplete(): Promise<void>;
+}
+
+type App = {
+	SwerefMotionEstimator: new () => MotionEstimator;
+	createSyntheticTrace(kind: string, durationSeconds?: number, rateHz?: number): ReplayTrace;
+	wgs84_to_sweref99tm(lat: number, lon: number, withGridFactors?: boolean): { northing: number; easting: number; convergence?: number; scaleFactor?: number };
+	ReplayPositionSource: new (trace: ReplayTrace, speedFactor?: number) => ReplaySource;
+	startGeolocationWatch(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: unknown;
+};
+
+const START = Date.UTC(2025, 5, 1, 10, 0, 0);
+
+/**
+ * Smallest angle between two courses, degrees
+ */
+function courseDifference(a: number, b: number): number {
+	const difference = Math.abs(a - b) % 360;
+	return difference > 180 ? 360 - difference : difference;
+}
+
+describe('Motion estimator', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'SwerefMotionEstimator',
+			'createSyntheticTrace',
+			'wgs84_to_sweref99tm',
+			'ReplayPositionSource',
+			'startGeolocationWatch',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource'
+		]);
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	describe('SwerefMotionEstimator', () => {
+		const feed = (estimator: MotionEstimator, seconds: number, velocityNorth: number, velocityEast: number, convergence = 0, scaleFactor = 0.9996) => {
+			let estimate: MotionEstimate | null = null;
+			for (let i = 0; i <= seconds; i++) {
+				estimate = estimator.update(START + i * 1000, 6580000 + velocityNorth * i, 500000 + velocityEast * i, 5, convergence, scaleFactor);
+			}
+			return estimate;
+		};
+
+		it('should give no estimate until the window spans two seconds', () => {
+			const estimator = new app.SwerefMotionEstimator();
+			expect(estimator.update(START, 6580000, 500000, 5, 0, 0.9996)).toBeNull();
+			expect(estimator.update(START + 1000, 6580010, 500000, 5, 0, 0.9996)).toBeNull();
+			expect(estimator.update(START + 2000, 6580020, 500000, 5, 0, 0.9996)).not.toBeNull();
+		});
+
+		it('should give an estimate within three seconds from a 10 Hz receiver', () => {
+			const estimator = new app.SwerefMotionEstimator();
+			let estimate: MotionEstimate | null = null;
+			let firstEstimateMs: number | null = null;
+			for (let i = 0; i <= 200; i++) {
+				estimate = estimator.update(START + i * 100, 6580000 + i, 500000, 5, 0, 0.9996);
+				if (estimate !== null && firstEstimateMs === null) {
+					firstEstimateMs = i * 100;
+				}
+			}
+			expect(firstEstimateMs).not.toBeNull();
+			expect(firstEstimateMs!).toBeLessThanOrEqual(3000);
+			expect(estimate!.speed).toBeCloseTo(10 / 0.9996, 6);
+			expect(estimate!.course).toBeCloseTo(0, 6);
+		});
+
+		it('should derive speed and course of a constant motion', () => {
+			const estimate = feed(new app.SwerefMotionEstimator(), 20, 10, 10)!;
+			expect(estimate.speed).toBeCloseTo(Math.hypot(10, 10) / 0.9996, 6);
+			expect(estimate.course).toBeCloseTo(45, 6);
+		});
+
+		it('should turn the grid bearing into a true course', () => {
+			// Meridiankonvergensen i Stockholm
+			const estimate = feed(new app.SwerefMotionEstimator(), 20, 10, 0, 2.65)!;
+			expect(estimate.course).toBeCloseTo(2.65, 6);
+		});
+
+		it('should turn grid distances into ground distances', () => {
+			// Skalfaktorn vid Haparanda, långt från medelmeridianen
+			const estimate = feed(new app.SwerefMotionEstimator(), 20, 10, 0, 0, 1.0015)!;
+			expect(estimate.speed).toBeCloseTo(10 / 1.0015, 6);
+		});
+
+		it('should report standstill and no course for position noise alone', () => {
+			const estimator = new app.SwerefMotionEstimator();
+			let estimate: MotionEstimate | null = null;
+			for (let i = 0; i <= 20; i++) {
+				estimate = estimator.update(START + i * 1000, 6580000 + (i % 3) - 1, 500000 + ((i * 7) % 5) - 2, 5, 0, 0.9996);
+			}
+			expect(estimate!.speed).toBe(0);
+			expect(estimate!.course).toBeNull();
+		});
+
+		it('should ignore single outlying fixes', () => {
+			const estimator = new app.SwerefMotionEstimator();
+			let estimate: MotionEstimate | null = null;
+			for (let i = 0; i <= 30; i++) {
+				const spike = i % 5 === 0 ? 80 : 0;
+				estimate = estimator.update(START + i * 1000, 6580000 + 14 * i + spike, 500000, 5, 0, 0.9996);
+			}
+			expect(estimate!.speed).toBeCloseTo(14 / 0.9996, 6);
+			expect(estimate!.course).toBeCloseTo(0, 6);
+		});
+
+		it('should ignore fixes that are not newer than the previous one', () => {
+			const estimator = new app.SwerefMotionEstimator();
+			estimator.update(START + 1000, 6580000, 500000, 5, 0, 0.9996);
+			expect(estimator.update(START + 1000, 6580010, 500000, 5, 0, 0.9996)).toBeNull();
+			expect(estimator.update(START, 6580010, 500000, 5, 0, 0.9996)).toBeNull();
+		});
+
+		it('should start over after a long gap', () => {
+			const estimator = new app.SwerefMotionEstimator();
+			feed(estimator, 10, 10, 0);
+			expect(estimator.update(START + 120000, 6590000, 500000, 5, 0, 0.9996)).toBeNull();
+		});
+	});
+
+	describe('Accuracy against synthetic ground truth', () => {
+		// Största tillåtna RMS-fel i fart (m/s) och medelfel i kurs (grader)
+		const cases: [string, number, number][] = [
+			['walking', 0.4, 25],
+			['driving', 0.6, 15],
+			['stationary', 0.3, 0]
+		];
+
+		it.each(cases)('should follow the %s trace despite outliers', (kind, maxSpeedError, maxCourseError) => {
+			const trace = app.createSyntheticTrace(kind, 3600);
+			const estimator = new app.SwerefMotionEstimator();
+			let speedSquared = 0;
+			let courseError = 0;
+			let courseCount = 0;
+			let count = 0;
+			const start = performance.now();
+
+			trace.fixes.forEach((fix, i) => {
+				// Var tjugonde position hamnar 50 m fel, som vid flervägsfel
+				const latitude = i % 20 === 7 ? fix.latitude + 50 / 111320 : fix.latitude;
+				const measured = app.wgs84_to_sweref99tm(latitude, fix.longitude, true);
+				const estimate = estimator.update(fix.timestamp, measured.northing, measured.easting, fix.accuracy, measured.convergence!, measured.scaleFactor!);
+				if (estimate === null) {
+					return;
+				}
+				speedSquared += (estimate.speed - trace.truth![i].speed) ** 2;
+				count++;
+				if (estimate.course !== null && fix.heading !== null) {
+					courseError += courseDifference(estimate.course, fix.heading);
+					courseCount++;
+				}
+			});
+
+			const speedRms = Math.sqrt(speedSquared / count);
+			const meanCourseError = courseCount > 0 ? courseError / courseCount : 0;
+			console.log(`Derived motion ${kind}: speed ${speedRms.toFixed(3)} m/s, course ${meanCourseError.toFixed(1)}°, ${((performance.now() - start) / trace.fixes.length * 1000).toFixed(1)} µs/fix incl. projection`);
+			expect(count).toBeGreaterThan(trace.fixes.length - 5);
+			expect(speedRms).toBeLessThan(maxSpeedError);
+			expect(meanCourseError).toBeLessThanOrEqual(maxCourseError);
+			if (kind !== 'stationary') {
+				expect(courseCount).toBeGreaterThan(trace.fixes.length * 0.9);
+			}
+		});
+	});
+
+	describe('Display', () => {
+		const replay = async (fixes: GnssFix[]) => {
+			const source = new app.ReplayPositionSource({ name: 'display', fixes }, Number.POSITIVE_INFINITY);
+			app.stopGeolocationWatch();
+			app.positionSource = source;
+			app.startGeolocationWatch(app.handlePositionError);
+			await source.whenComplete();
+		};
+
+		it('should show derived speed and course when the device reports none', async () => {
+			const fixes = app.createSyntheticTrace('driving', 30).fixes.map((fix) => ({ ...fix, speed: null, heading: null }));
+			await replay(fixes);
+			expect(document.getElementById('speed')?.textContent).toMatch(/^≈\d+/);
+			expect(document.getElementById('course')?.textContent).toMatch(/^\d+°$/);
+		});
+
+		it('should prefer the speed and course reported by the device', async () => {
+			const fixes = app.createSyntheticTrace('driving', 30).fixes.map((fix) => ({ ...fix, heading: 123 }));
+			await replay(fixes);
+			expect(document.getElementById('speed')?.textContent).toMatch(/^\d+/);
+			expect(document.getElementById('course')?.textContent).toBe('123°');
+		});
+	});
+});
@@ -0,0 +1,244 @@
+/**
+ * Tests for the Kalman position filter in the SWEREF 99 TM plane
+ *
+ * Tests cover:
+ * - Start, convergence and velocity estimation for simple motions
+ * - Restarts after gaps and jumps, and rejection of out-of-order fixes
+ * - Accuracy against the ground truth of the synthetic replay traces
+ * - The selectable filtered display in the real app
+ *
+ * Loads the actual application via tests/helpers/load-app.ts so that the
+ * synthetic traces and the filter are the shipped code.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface GnssFix {
+	timestamp: number;
+	latitude: number;
+	longitude: number;
+	accuracy: number;
+	altitude: number | null;
+	speed: number | null;
+	heading: number | null;
+}
+
+interface ReplayTrace {
+	name: string;
+	fixes: GnssFix[];
+	truth?: { latitude: number; longitude: number; speed: number }[];
+}
+
+interface FilteredPosition {
+	northing: number;
+	easting: number;
+	velocityNorth: number;
+	velocityEast: number;
+	sigma: number;
+}
+
+interface KalmanFilter {
+	reset(): void;
+	update(timestamp: number, northing: number, easting: number, accuracy: number): FilteredPosition | null;
+}
+
+interface ReplaySource {
+	whenComplete(): Promise<void>;
+}
+
+type App = {
+	SwerefKalmanFilter: new () => KalmanFilter;
+	GEOLOCATION_ACCURACY_TO_SIGMA: number;
+	createSyntheticTrace(kind: string, durationSeconds?: number, rateHz?: number): ReplayTrace;
+	wgs84_to_sweref99tm(lat: number, lon: number): { northing: number; easting: number };
+	ReplayPositionSource: new (trace: ReplayTrace, speedFactor?: number) => ReplaySource;
+	startGeolocationWatch(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: unknown;
+};
+
+const START = Date.UTC(2025, 5, 1, 10, 0, 0);
+
+describe('Position filter', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'SwerefKalmanFilter',
+			'GEOLOCATION_ACCURACY_TO_SIGMA',
+			'createSyntheticTrace',
+			'wgs84_to_sweref99tm',
+			'ReplayPositionSource',
+			'startGeolocationWatch',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource'
+		]);
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	describe('SwerefKalmanFilter', () => {
+		it('should start at the first measurement with its accuracy', () => {
+			const filter = new app.SwerefKalmanFilter();
+			const estimate = filter.update(START, 6580000, 674000, 5)!;
+			expect(estimate.northing).toBe(6580000);
+			expect(estimate.easting).toBe(674000);
+			expect(estimate.velocityNorth).toBe(0);
+			expect(estimate.sigma).toBeCloseTo(5 * app.GEOLOCATION_ACCURACY_TO_SIGMA, 6);
+		});
+
+		it('should shrink its uncertainty for repeated measurements at rest', () => {
+			const filter = new app.SwerefKalmanFilter();
+			let estimate = filter.update(START, 6580000, 674000, 5)!;
+			for (let i = 1; i <= 60; i++) {
+				estimate = filter.update(START + i * 1000, 6580000 + (i % 2 === 0 ? 2 : -2), 674000, 5)!;
+			}
+			expect(Math.abs(estimate.northing - 6580000)).toBeLessThan(0.5);
+			expect(Math.hypot(estimate.velocityNorth, estimate.velocityEast)).toBeLessThan(0.1);
+			expect(estimate.sigma).toBeLessThan(5 * app.GEOLOCATION_ACCURACY_TO_SIGMA / 2);
+		});
+
+		it('should estimate a constant velocity', () => {
+			const filter = new app.SwerefKalmanFilter();
+			let estimate: FilteredPosition | null = null;
+			for (let i = 0; i <= 60; i++) {
+				estimate = filter.update(START + i * 1000, 6580000 + 3 * i, 674000 - 4 * i, 5);
+			}
+			expect(estimate!.velocityNorth).toBeCloseTo(3, 1);
+			expect(estimate!.velocityEast).toBeCloseTo(-4, 1);
+			expect(estimate!.northing).toBeCloseTo(6580180, 0);
+		});
+
+		it('should restart after a long gap', () => {
+			const filter = new app.SwerefKalmanFilter();
+			filter.update(START, 6580000, 674000, 5);
+			filter.update(START + 1000, 6580001, 674000, 5);
+			const estimate = filter.update(START + 120000, 6580500, 674200, 5)!;
+			expect(estimate.northing).toBe(6580500);
+			expect(estimate.easting).toBe(674200);
+			expect(estimate.velocityNorth).toBe(0);
+		});
+
+		it('should restart after a jump far outside the expected error', () => {
+			const filter = new app.SwerefKalmanFilter();
+			for (let i = 0; i < 10; i++) {
+				filter.update(START + i * 1000, 6580000, 674000, 5);
+			}
+			const estimate = filter.update(START + 10000, 6590000, 674000, 5)!;
+			expect(estimate.northing).toBe(6590000);
+		});
+
+		it('should ignore fixes older than the previous one', () => {
+			const filter = new app.SwerefKalmanFilter();
+			filter.update(START + 1000, 6580000, 674000, 5);
+			expect(filter.update(START, 6580010, 674000, 5)).toBeNull();
+		});
+
+		it('should start over after reset', () => {
+			const filter = new app.SwerefKalmanFilter();
+			filter.update(START, 6580000, 674000, 5);
+			filter.reset();
+			expect(filter.update(START + 1000, 6580003, 674000, 5)!.northing).toBe(6580003);
+		});
+	});
+
+	describe('Accuracy against synthetic ground truth', () => {
+		// Högsta tillåtna kvot mellan filtrerat och rått positionsfel (RMS)
+		const cases: [string, number, number][] = [
+			['walking', 0.8, 0.3],
+			['driving', 0.9, 1.0],
+			['stationary', 0.6, 0.2]
+		];
+
+		it.each(cases)('should reduce the position error of the %s trace', (kind, maxErrorRatio, maxSpeedError) => {
+			const trace = app.createSyntheticTrace(kind, 3600);
+			const filter = new app.SwerefKalmanFilter();
+			let rawSquared = 0;
+			let filteredSquared = 0;
+			let speedSquared = 0;
+			let count = 0;
+			const start = performance.now();
+
+			trace.fixes.forEach((fix, i) => {
+				const measured = app.wgs84_to_sweref99tm(fix.latitude, fix.longitude);
+				const truePoint = trace.truth![i];
+				const truth = app.wgs84_to_sweref99tm(truePoint.latitude, truePoint.longitude);
+				const estimate = filter.update(fix.timestamp, measured.northing, measured.easting, fix.accuracy)!;
+				// Filtret behöver några positioner för att hitta hastigheten
+				if (i < 30) {
+					return;
+				}
+				rawSquared += (measured.northing - truth.northing) ** 2 + (measured.easting - truth.easting) ** 2;
+				filteredSquared += (estimate.northing - truth.northing) ** 2 + (estimate.easting - truth.easting) ** 2;
+				speedSquared += (Math.hypot(estimate.velocityNorth, estimate.velocityEast) - truePoint.speed) ** 2;
+				count++;
+			});
+
+			const rawRms = Math.sqrt(rawSquared / count);
+			const filteredRms = Math.sqrt(filteredSquared / count);
+			const speedRms = Math.sqrt(speedSquared / count);
+			console.log(`Kalman ${kind}: raw ${rawRms.toFixed(2)} m, filtered ${filteredRms.toFixed(2)} m, speed ${speedRms.toFixed(3)} m/s, ${((performance.now() - start) / trace.fixes.length * 1000).toFixed(1)} µs/fix incl. projection`);
+			expect(filteredRms).toBeLessThan(rawRms * maxErrorRatio);
+			expect(speedRms).toBeLessThan(maxSpeedError);
+		});
+	});
+
+	describe('Filtered display', () => {
+		/**
+		 * Replays a stationary trace and counts how often the displayed northing changes
+		 */
+		const countNorthingChanges = async (filterEnabled: boolean): Promise<number> => {
+			const toggle = document.getElementById('position-filter') as HTMLInputElement;
+			if (toggle.checked !== filterEnabled) {
+				toggle.click();
+			}
+			const trace = app.createSyntheticTrace('stationary', 300);
+			const source = new app.ReplayPositionSource(trace, Number.POSITIVE_INFINITY);
+			const values: string[] = [];
+			const collect = (records: MutationRecord[]) => {
+				for (const record of records) {
+					record.addedNodes.forEach((node) => values.push(node.textContent ?? ''));
+				}
+			};
+			const observer = new MutationObserver(collect);
+			observer.observe(document.getElementById('sweref-n')!, { childList: true });
+
+			app.stopGeolocationWatch();
+			app.positionSource = source;
+			app.startGeolocationWatch(app.handlePositionError);
+			await source.whenComplete();
+			collect(observer.takeRecords());
+			observer.disconnect();
+			app.stopGeolocationWatch();
+
+			let changes = 0;
+			for (let i = 1; i < values.length; i++) {
+				if (values[i] !== values[i - 1]) {
+					changes++;
+				}
+			}
+			return changes;
+		};
+
+		it('should persist the filter setting', () => {
+			const toggle = document.getElementById('position-filter') as HTMLInputElement;
+			toggle.checked = false;
+			toggle.click();
+			expect(localStorage.getItem('sweref99-position-filter')).toBe('true');
+			toggle.click();
+			expect(localStorage.getItem('sweref99-position-filter')).toBe('false');
+		});
+
+		it('should change the displayed coordinates less often at rest when filtered', async () => {
+			const raw = await countNorthingChanges(false);
+			const filtered = await countNorthingChanges(true);
+			console.log(`Displayed northing changes at rest: raw ${raw}, filtered ${filtered}`);
+			expect(filtered).toBeLessThan(raw / 2);
+		});
+	});
+});
@@ -0,0 +1,182 @@
+/**
+ * Tests for trace replay and the replay measurement harness
+ *
+ * Tests cover:
+ * - Deterministic synthetic traces with ground truth
+ * - Format detection for GPX, the app's CSV export and NMEA traces
+ * - Replaying walking, driving and stationary traces through the real
+ *   position pipeline, from handlePositionSuccess to the DOM
+ *
+ * Unlike most test files, this one loads the actual application via
+ * tests/helpers/load-app.ts. See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface GnssFix {
+	timestamp: number;
+	latitude: number;
+	longitude: number;
+	accuracy: number;
+	altitude: number | null;
+	speed: number | null;
+	heading: number | null;
+}
+
+interface ReplayTrace {
+	name: string;
+	fixes: GnssFix[];
+	truth?: { latitude: number; longitude: number; speed: number }[];
+}
+
+interface ReplayReport {
+	trace: string;
+	fixCount: number;
+	speedFactor: number;
+	wallMs: number;
+	latencyMs: { mean: number; p95: number; max: number };
+	processingMs: { mean: number; p95: number; max: number };
+	domWritesPerFix: number;
+	heapBytesPerFix: number | null;
+}
+
+interface ReplaySource {
+	trace: ReplayTrace;
+	speedFactor: number;
+	isSupported(): boolean;
+}
+
+type App = {
+	createSyntheticTrace(kind: string, durationSeconds?: number, rateHz?: number): ReplayTrace;
+	parseReplayTrace(name: string, text: string): ReplayTrace;
+	ReplayPositionSource: new (trace: ReplayTrace, speedFactor?: number) => ReplaySource;
+	measureReplay(source: ReplaySource, root: Node, readHeapBytes?: () => number | null): Promise<ReplayReport>;
+	startGeolocationWatch(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: unknown;
+};
+
+describe('Trace replay', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'createSyntheticTrace',
+			'parseReplayTrace',
+			'ReplayPositionSource',
+			'measureReplay',
+			'startGeolocationWatch',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource'
+		]);
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	describe('createSyntheticTrace', () => {
+		it('should produce the same trace every time', () => {
+			const first = app.createSyntheticTrace('walking', 60);
+			const second = app.createSyntheticTrace('walking', 60);
+			expect(second.fixes).toEqual(first.fixes);
+			expect(second.truth).toEqual(first.truth);
+		});
+
+		it('should produce one fix and one truth point per sample', () => {
+			const trace = app.createSyntheticTrace('driving', 30, 10);
+			expect(trace.fixes).toHaveLength(300);
+			expect(trace.truth).toHaveLength(300);
+			expect(trace.fixes[1].timestamp - trace.fixes[0].timestamp).toBe(100);
+		});
+
+		it('should keep a stationary trace near its true position', () => {
+			const trace = app.createSyntheticTrace('stationary');
+			const truth = trace.truth![0];
+			for (const fix of trace.fixes) {
+				const north = (fix.latitude - truth.latitude) * 111320;
+				expect(Math.abs(north)).toBeLessThan(20);
+			}
+			expect(trace.fixes.every((fix) => fix.heading === null)).toBe(true);
+		});
+
+		it('should move a driving trace about ten times further than a walking trace', () => {
+			const distance = (trace: ReplayTrace) => {
+				const first = trace.truth![0];
+				const last = trace.truth![trace.truth!.length - 1];
+				return Math.hypot(last.latitude - first.latitude, (last.longitude - first.longitude) * Math.cos(first.latitude * Math.PI / 180));
+			};
+			const walking = app.createSyntheticTrace('walking', 60);
+			const driving = app.createSyntheticTrace('driving', 60);
+			expect(distance(driving)).toBeGreaterThan(distance(walking) * 5);
+		});
+	});
+
+	describe('parseReplayTrace', () => {
+		it('should parse GPX track points with SWEREF extensions', () => {
+			const gpx = [
+				'<?xml version="1.0" encoding="UTF-8"?>',
+				'<gpx version="1.1"><trk><trkseg>',
+				'<trkpt lat="59.3293" lon="18.0686"><time>2025-06-01T10:00:00.000Z</time><extensions><sweref:accuracy>3.5</sweref:accuracy><sweref:speed>1.2</sweref:speed></extensions></trkpt>',
+				'<trkpt lat="59.3294" lon="18.0687"><time>2025-06-01T10:00:01.000Z</time><hdop>1.2</hdop></trkpt>',
+				'</trkseg></trk></gpx>'
+			].join('\n');
+			const trace = app.parseReplayTrace('test.gpx', gpx);
+			expect(trace.fixes).toHaveLength(2);
+			expect(trace.fixes[0]).toMatchObject({ latitude: 59.3293, longitude: 18.0686, accuracy: 3.5, speed: 1.2 });
+			expect(trace.fixes[1].accuracy).toBeCloseTo(6);
+			expect(trace.fixes[1].timestamp - trace.fixes[0].timestamp).toBe(1000);
+		});
+
+		it('should parse the CSV track export', () => {
+			const csv = [
+				'tid,sweref99tm_n,sweref99tm_e,wgs84_lat,wgs84_lon,noggrannhet_m,fart_ms',
+				'2025-06-01T10:00:00.000Z,6580822,674032,59.3293,18.0686,4,',
+				'2025-06-01T10:00:01.000Z,6580823,674033,59.32931,18.06861,4,1.5',
+				''
+			].join('\n');
+			const trace = app.parseReplayTrace('test.csv', csv);
+			expect(trace.fixes).toHaveLength(2);
+			expect(trace.fixes[0].speed).toBeNull();
+			expect(trace.fixes[1]).toMatchObject({ latitude: 59.32931, accuracy: 4, speed: 1.5 });
+		});
+
+		it('should parse a raw NMEA log', () => {
+			const nmea = [
+				'$GPGGA,100000.00,5919.758,N,01804.116,E,1,08,1.0,20.0,M,0.0,M,,*63',
+				'$GPRMC,100000.00,A,5919.758,N,01804.116,E,0.0,0.0,010625,,,A*5A'
+			].join('\n');
+			const trace = app.parseReplayTrace('test.nmea', nmea);
+			expect(trace.fixes).toHaveLength(1);
+			expect(trace.fixes[0].latitude).toBeCloseTo(59.3293, 4);
+			expect(trace.fixes[0].timestamp).toBe(Date.UTC(2025, 5, 1, 10, 0, 0));
+		});
+
+		it('should reject a trace without positions as a replay source', () => {
+			const trace = app.parseReplayTrace('empty.txt', 'no positions here');
+			expect(new app.ReplayPositionSource(trace).isSupported()).toBe(false);
+		});
+	});
+
+	describe('Replay through the position pipeline', () => {
+		it.each(['walking', 'driving', 'stationary'])('should display every fix of the %s trace', async (kind) => {
+			const trace = app.createSyntheticTrace(kind);
+			const source = new app.ReplayPositionSource(trace, Number.POSITIVE_INFINITY);
+
+			app.stopGeolocationWatch();
+			app.positionSource = source;
+			const report = app.measureReplay(source, document.body, () => process.memoryUsage().heapUsed);
+			app.startGeolocationWatch(app.handlePositionError);
+			const result = await report;
+			console.log(`Replay ${kind}:`, JSON.stringify(result));
+
+			expect(result.fixCount).toBe(trace.fixes.length);
+			expect(result.domWritesPerFix).toBeGreaterThan(0);
+			expect(result.domWritesPerFix).toBeLessThan(30);
+			expect(result.heapBytesPerFix).not.toBeNull();
+			expect(document.getElementById('sweref-n')?.textContent).toMatch(/^N\s\d/);
+		});
+	});
+});
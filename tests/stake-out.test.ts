@@ -0,0 +1,212 @@
+/**
+ * Tests for stake-out navigation to a target SWEREF 99 TM coordinate
+ *
+ * Tests cover:
+ * - Offsets, ground distance and grid bearing in every quadrant
+ * - Parsing of entered target coordinates
+ * - Render throttling of fast position streams
+ * - Setting a target by coordinate or waypoint name and the display
+ *   during a 10 Hz replay in the real app
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface StakeoutTarget {
+	name: string | null;
+	northing: number;
+	easting: number;
+}
+
+interface StakeoutOffset {
+	deltaNorth: number;
+	deltaEast: number;
+	distance: number;
+	gridBearing: number;
+}
+
+interface RenderThrottle {
+	request(): void;
+	cancel(): void;
+}
+
+interface ReplayTrace {
+	name: string;
+	fixes: { latitude: number; longitude: number }[];
+}
+
+interface ReplaySource {
+	whenComplete(): Promise<void>;
+}
+
+type App = {
+	computeStakeoutOffset(target: StakeoutTarget, northing: number, easting: number, scaleFactor: number): StakeoutOffset;
+	parseStakeoutCoordinate(text: string): StakeoutTarget | null;
+	RenderThrottle: new (intervalMs: number, render: () => void) => RenderThrottle;
+	STAKEOUT_RENDER_INTERVAL_MS: number;
+	buildWaypointIndex(names: string[], northing: ArrayLike<number>, easting: ArrayLike<number>): unknown;
+	WaypointGridIndex: new (data: unknown) => unknown;
+	waypointIndex: unknown;
+	wgs84_to_sweref99tm(latitude: number, longitude: number): { northing: number; easting: number };
+	createSyntheticTrace(kind: string, durationSeconds?: number, rateHz?: number): ReplayTrace;
+	ReplayPositionSource: new (trace: ReplayTrace, speedFactor?: number) => ReplaySource;
+	startGeolocationWatch(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: unknown;
+};
+
+const TARGET: StakeoutTarget = { name: null, northing: 6580822, easting: 674032 };
+
+const wait = (ms: number) => new Promise((resolve) => setTimeout(resolve, ms));
+
+describe('Stake-out', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'computeStakeoutOffset',
+			'parseStakeoutCoordinate',
+			'RenderThrottle',
+			'STAKEOUT_RENDER_INTERVAL_MS',
+			'buildWaypointIndex',
+			'WaypointGridIndex',
+			'waypointIndex',
+			'wgs84_to_sweref99tm',
+			'createSyntheticTrace',
+			'ReplayPositionSource',
+			'startGeolocationWatch',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource'
+		]);
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	describe('Offsets', () => {
+		const cases: [number, number, number][] = [
+			[30, 40, 53.13],
+			[-30, 40, 126.87],
+			[-30, -40, 233.13],
+			[30, -40, 306.87],
+			[10, 0, 0],
+			[0, -10, 270]
+		];
+
+		it.each(cases)('should give grid bearing for ΔN %s, ΔE %s', (deltaNorth, deltaEast, bearing) => {
+			const offset = app.computeStakeoutOffset(TARGET, TARGET.northing - deltaNorth, TARGET.easting - deltaEast, 1);
+			expect(offset.deltaNorth).toBeCloseTo(deltaNorth, 9);
+			expect(offset.deltaEast).toBeCloseTo(deltaEast, 9);
+			expect(offset.distance).toBeCloseTo(Math.hypot(deltaNorth, deltaEast), 9);
+			expect(offset.gridBearing).toBeCloseTo(bearing, 2);
+		});
+
+		it('should turn the grid distance into ground distance', () => {
+			const offset = app.computeStakeoutOffset(TARGET, TARGET.northing - 30, TARGET.easting - 40, 0.9996);
+			expect(offset.distance).toBeCloseTo(50 / 0.9996, 9);
+		});
+	});
+
+	describe('Coordinate entry', () => {
+		const valid: [string, number, number][] = [
+			['6580822 674032', 6580822, 674032],
+			['N 6580822,5 E 674032,25', 6580822.5, 674032.25],
+			['6580822.5, 674032.25', 6580822.5, 674032.25],
+			['6580822,674032', 6580822, 674032],
+			['6580822;674032,125', 6580822, 674032.125]
+		];
+
+		it.each(valid)('should read "%s"', (text, northing, easting) => {
+			expect(app.parseStakeoutCoordinate(text)).toEqual({ name: null, northing, easting });
+		});
+
+		it.each(['', '6580822', '59.33 18.07', '1 2 3', 'GP12'])('should reject "%s"', (text) => {
+			expect(app.parseStakeoutCoordinate(text)).toBeNull();
+		});
+	});
+
+	describe('Render throttle', () => {
+		it('should render the first request at once and merge the rest', async () => {
+			let renders = 0;
+			const throttle = new app.RenderThrottle(50, () => renders++);
+			throttle.request();
+			expect(renders).toBe(1);
+			for (let i = 0; i < 20; i++) {
+				throttle.request();
+			}
+			expect(renders).toBe(1);
+			await wait(80);
+			expect(renders).toBe(2);
+		});
+
+		it('should drop a cancelled render', async () => {
+			let renders = 0;
+			const throttle = new app.RenderThrottle(50, () => renders++);
+			throttle.request();
+			throttle.request();
+			throttle.cancel();
+			await wait(80);
+			expect(renders).toBe(1);
+		});
+	});
+
+	describe('Display', () => {
+		const input = () => document.getElementById('stakeout-target') as HTMLInputElement;
+		const status = () => document.getElementById('stakeout-status')!;
+
+		const replay = async (trace: ReplayTrace) => {
+			const source = new app.ReplayPositionSource(trace, Number.POSITIVE_INFINITY);
+			app.stopGeolocationWatch();
+			app.positionSource = source;
+			app.startGeolocationWatch(app.handlePositionError);
+			await source.whenComplete();
+		};
+
+		it('should show the offsets to an entered target', async () => {
+			const trace = app.createSyntheticTrace('walking', 30);
+			const last = trace.fixes[trace.fixes.length - 1];
+			const here = app.wgs84_to_sweref99tm(last.latitude, last.longitude);
+			input().value = `${(here.northing + 12.34).toFixed(2)} ${(here.easting - 5).toFixed(2)}`;
+			(document.getElementById('stakeout-set-btn') as HTMLButtonElement).click();
+			expect(status().textContent).toMatch(/^Mål N\s\d{7} E\s\d{6}$/);
+
+			await replay(trace);
+			await wait(app.STAKEOUT_RENDER_INTERVAL_MS + 50);
+			expect(status().textContent).toMatch(/^Mål N\s\d{7} E\s\d{6}\nΔN \+12,3\sm ΔE −5,0\sm\nAvstånd 13\sm\nRiktning i rutnät 33\d°$/);
+		});
+
+		it('should limit renders of a 10 Hz source', async () => {
+			const trace = app.createSyntheticTrace('driving', 60, 10);
+			let renders = 0;
+			const observer = new MutationObserver((records) => {
+				renders += records.length;
+			});
+			observer.observe(status(), { childList: true, characterData: true, subtree: true });
+
+			await replay(trace);
+			await wait(app.STAKEOUT_RENDER_INTERVAL_MS + 50);
+			observer.disconnect();
+			// Uppspelningen går snabbare än realtid, så nästan alla positioner slås ihop
+			expect(renders).toBeGreaterThan(0);
+			expect(renders).toBeLessThan(trace.fixes.length / 20);
+		});
+
+		it('should pick a stored waypoint by name', () => {
+			app.waypointIndex = new app.WaypointGridIndex(app.buildWaypointIndex(['GP12'], [6580822], [674032]));
+			input().value = 'GP12';
+			input().dispatchEvent(new KeyboardEvent('keydown', { key: 'Enter' }));
+			expect(status().textContent).toMatch(/^Mål GP12\nΔN [+−][\d,]+\sm ΔE [+−][\d,]+\sm\nAvstånd [\d,]+\sk?m\nRiktning i rutnät \d+°$/);
+		});
+
+		it('should end the stake-out', () => {
+			(document.getElementById('stakeout-clear-btn') as HTMLButtonElement).click();
+			expect(status().textContent).toBe('Inget mål');
+			expect(localStorage.getItem('sweref99-stakeout-target')).toBeNull();
+		});
+	});
+});
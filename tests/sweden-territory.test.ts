@@ -0,0 +1,210 @@
+/**
+ * Tests for the Swedish territory test
+ *
+ * Tests cover:
+ * - Places in Sweden, including the Torne valley, Gotland and Öland
+ * - Places just across the land borders and the Öresund, Kattegat and
+ *   Åland sea limits
+ * - Both sides of the border at Haparanda/Tornio and Svinesund
+ * - Agreement with an exact polygon test for points spread over the grid
+ *   and clustered along the boundary
+ * - isInSweden on geolocation positions, including Oslo and Copenhagen,
+ *   which the former latitude/longitude box let through
+ * - Cost per fix
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+type App = {
+	isInSwedishTerritory(northing: number, easting: number): boolean;
+	isInSweden(pos: GeolocationPosition, sweref: { northing: number; easting: number }): boolean;
+	wgs84_to_sweref99tm(latitude: number, longitude: number): { northing: number; easting: number };
+	TERRITORY_EDGES: readonly number[];
+	TERRITORY_GRID: { MIN_NORTHING: number; MIN_EASTING: number; CELL_SIZE: number; COLUMNS: number; ROWS: number };
+};
+
+/**
+ * Deterministic pseudo-random numbers in [0, 1)
+ */
+function createRandom(seed: number): () => number {
+	let state = seed;
+	return () => {
+		state = (state * 1664525 + 1013904223) >>> 0;
+		return state / 4294967296;
+	};
+}
+
+describe('Swedish territory', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'isInSwedishTerritory',
+			'isInSweden',
+			'wgs84_to_sweref99tm',
+			'TERRITORY_EDGES',
+			'TERRITORY_GRID'
+		]);
+	});
+
+	const isInside = (latitude: number, longitude: number) => {
+		const { northing, easting } = app.wgs84_to_sweref99tm(latitude, longitude);
+		return app.isInSwedishTerritory(northing, easting);
+	};
+
+	/** Even-odd test against every edge */
+	const isInsideExact = (northing: number, easting: number) => {
+		const edges = app.TERRITORY_EDGES;
+		let inside = false;
+		for (let i = 0; i < edges.length; i += 4) {
+			const [n1, e1, n2, e2] = [edges[i], edges[i + 1], edges[i + 2], edges[i + 3]];
+			if ((n1 > northing) !== (n2 > northing) && easting < e1 + (northing - n1) * (e2 - e1) / (n2 - n1)) {
+				inside = !inside;
+			}
+		}
+		return inside;
+	};
+
+	describe('Places', () => {
+		const inSweden: [string, number, number][] = [
+			['Stockholm', 59.33, 18.07],
+			['Göteborg', 57.71, 11.97],
+			['Malmö', 55.60, 13.00],
+			['Kiruna', 67.86, 20.23],
+			['Abisko', 68.35, 18.83],
+			['Luleå', 65.58, 22.15],
+			['Haparanda', 65.84, 24.13],
+			['Strömstad', 58.94, 11.17],
+			['Visby', 57.64, 18.30],
+			['Borgholm', 56.88, 16.65],
+			['Sälen', 61.16, 13.27],
+			['Ystad', 55.43, 13.82]
+		];
+
+		const abroad: [string, number, number][] = [
+			['Oslo', 59.91, 10.75],
+			['Halden', 59.12, 11.39],
+			['Trondheim', 63.43, 10.40],
+			['Narvik', 68.44, 17.43],
+			['Tornio', 65.85, 24.20],
+			['Vaasa', 63.10, 21.62],
+			['Mariehamn', 60.10, 19.94],
+			['Köpenhamn', 55.68, 12.57],
+			['Helsingør', 56.04, 12.61],
+			['Skagen', 57.72, 10.59],
+			['Læsø', 57.27, 11.00],
+			['Rønne', 55.10, 14.70],
+			['Berlin', 52.52, 13.40]
+		];
+
+		it.each(inSweden)('should place %s in Sweden', (_name, latitude, longitude) => {
+			expect(isInside(latitude, longitude)).toBe(true);
+		});
+
+		it.each(abroad)('should place %s outside Sweden', (_name, latitude, longitude) => {
+			expect(isInside(latitude, longitude)).toBe(false);
+		});
+
+		// Ungefär en kilometer på var sida om gränsen vid de stora övergångarna
+		const crossings: [string, [number, number], [number, number]][] = [
+			['Haparanda and Tornio', [65.835, 24.125], [65.850, 24.160]],
+			['Svinesund', [59.085, 11.275], [59.105, 11.250]]
+		];
+
+		it.each(crossings)('should tell the sides of the border apart at %s', (_name, swedish, foreign) => {
+			expect(isInside(...swedish)).toBe(true);
+			expect(isInside(...foreign)).toBe(false);
+		});
+
+		it('should reject coordinates outside the grid', () => {
+			expect(app.isInSwedishTerritory(0, 0)).toBe(false);
+			expect(app.isInSwedishTerritory(Number.NaN, 674032)).toBe(false);
+		});
+	});
+
+	describe('isInSweden', () => {
+		const position = (latitude: number, longitude: number) => ({
+			coords: { latitude, longitude, accuracy: 5, altitude: null, altitudeAccuracy: null, heading: null, speed: null },
+			timestamp: Date.now()
+		}) as GeolocationPosition;
+
+		it.each([
+			['Stockholm', 59.33, 18.07, true],
+			['Haparanda', 65.84, 24.13, true],
+			['Oslo', 59.91, 10.75, false],
+			['Köpenhamn', 55.68, 12.57, false],
+			['Tornio', 65.85, 24.20, false]
+		] as const)('should test %s against the territory', (_name, latitude, longitude, expected) => {
+			const pos = position(latitude, longitude);
+			expect(app.isInSweden(pos, app.wgs84_to_sweref99tm(latitude, longitude))).toBe(expected);
+		});
+
+		it('should reject invalid latitude and longitude before the grid lookup', () => {
+			// Projektionen av en giltig punkt får inte rädda en ogiltig position
+			const sweref = app.wgs84_to_sweref99tm(59.33, 18.07);
+			expect(app.isInSweden(position(91, 18.07), sweref)).toBe(false);
+			expect(app.isInSweden(position(59.33, Number.NaN), sweref)).toBe(false);
+		});
+	});
+
+	describe('Agreement with the polygon', () => {
+		it('should match the exact test over the whole grid', () => {
+			const grid = app.TERRITORY_GRID;
+			const random = createRandom(40);
+			let mismatches = 0;
+			for (let i = 0; i < 20000; i++) {
+				const northing = grid.MIN_NORTHING + random() * grid.ROWS * grid.CELL_SIZE;
+				const easting = grid.MIN_EASTING + random() * grid.COLUMNS * grid.CELL_SIZE;
+				if (app.isInSwedishTerritory(northing, easting) !== isInsideExact(northing, easting)) {
+					mismatches++;
+				}
+			}
+			expect(mismatches).toBe(0);
+		});
+
+		it('should match the exact test next to the boundary', () => {
+			const edges = app.TERRITORY_EDGES;
+			const random = createRandom(41);
+			let mismatches = 0;
+			for (let i = 0; i < 20000; i++) {
+				// En punkt på en slumpvis kant, förskjuten upp till 50 m
+				const e = Math.floor(random() * edges.length / 4) * 4;
+				const t = random();
+				const northing = edges[e] + t * (edges[e + 2] - edges[e]) + (random() - 0.5) * 100;
+				const easting = edges[e + 1] + t * (edges[e + 3] - edges[e + 1]) + (random() - 0.5) * 100;
+				if (app.isInSwedishTerritory(northing, easting) !== isInsideExact(northing, easting)) {
+					mismatches++;
+				}
+			}
+			expect(mismatches).toBe(0);
+		});
+	});
+
+	describe('Performance', () => {
+		it('should test a fix in well under 5 µs', () => {
+			const grid = app.TERRITORY_GRID;
+			const random = createRandom(42);
+			const count = 100000;
+			const northings = new Float64Array(count);
+			const eastings = new Float64Array(count);
+			for (let i = 0; i < count; i++) {
+				northings[i] = grid.MIN_NORTHING + random() * grid.ROWS * grid.CELL_SIZE;
+				eastings[i] = grid.MIN_EASTING + random() * grid.COLUMNS * grid.CELL_SIZE;
+			}
+			let inside = 0;
+			const start = performance.now();
+			for (let i = 0; i < count; i++) {
+				if (app.isInSwedishTerritory(northings[i], eastings[i])) {
+					inside++;
+				}
+			}
+			const microseconds = (performance.now() - start) * 1000 / count;
+			console.log(`Territory test: ${microseconds.toFixed(3)} µs per fix, ${inside} of ${count} inside`);
+			expect(inside).toBeGreaterThan(0);
+			expect(microseconds).toBeLessThan(5);
+		});
+	});
+});
@@ -0,0 +1,234 @@
+/**
+ * Tests for the SWEREF 99 TM forward projection with grid factors
+ *
+ * Tests cover:
+ * - Coordinates on the central meridian against the GRS80 meridian arc
+ * - Meridian convergence and point scale factor against finite differences
+ *   of the projected coordinates
+ * - Batch and single-point results
+ * - The inverse projection back to latitude and longitude
+ * - Cost of the fused pass compared with the coordinate-only path
+ * - The metadata display
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface SwerefProjection {
+	northing: number;
+	easting: number;
+	convergence?: number;
+	scaleFactor?: number;
+}
+
+interface ReplayTrace {
+	name: string;
+	fixes: unknown[];
+}
+
+interface ReplaySource {
+	whenComplete(): Promise<void>;
+}
+
+type App = {
+	projectToSweref99tm(latitude: number, longitude: number, withGridFactors?: boolean): SwerefProjection;
+	projectToSweref99tmBatch(
+		latitudes: Float64Array,
+		longitudes: Float64Array,
+		northings: Float64Array,
+		eastings: Float64Array,
+		convergences?: Float64Array,
+		scaleFactors?: Float64Array
+	): void;
+	unprojectSweref99tmBatch(northings: Float64Array, eastings: Float64Array, latitudes: Float64Array, longitudes: Float64Array): void;
+	createSyntheticTrace(kind: string, durationSeconds?: number, rateHz?: number): ReplayTrace;
+	ReplayPositionSource: new (trace: ReplayTrace, speedFactor?: number) => ReplaySource;
+	startGeolocationWatch(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: unknown;
+};
+
+const GRS80_A = 6378137;
+const GRS80_E2 = (1 / 298.257222101) * (2 - 1 / 298.257222101);
+const RADIANS = Math.PI / 180;
+
+// Punkter över hela Sverige, även långt från medelmeridianen
+const POINTS: [number, number][] = [
+	[55.34, 11.2],
+	[56.0, 16.5],
+	[57.7, 11.97],
+	[59.3293, 18.0686],
+	[62.39, 17.3],
+	[65.58, 22.15],
+	[67.86, 20.23],
+	[68.9, 23.9]
+];
+
+describe('SWEREF 99 TM projection', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'projectToSweref99tm',
+			'projectToSweref99tmBatch',
+			'unprojectSweref99tmBatch',
+			'createSyntheticTrace',
+			'ReplayPositionSource',
+			'startGeolocationWatch',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource'
+		]);
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	describe('Coordinates', () => {
+		it('should give the scaled meridian arc on the central meridian', () => {
+			// Meridianbågen till 60° på GRS80 är 6 654 072,819 m
+			const result = app.projectToSweref99tm(60, 15);
+			expect(result.northing).toBeCloseTo(6654072.819 * 0.9996, 2);
+			expect(result.easting).toBe(500000);
+		});
+
+		it('should be symmetric about the central meridian', () => {
+			const east = app.projectToSweref99tm(63, 19);
+			const west = app.projectToSweref99tm(63, 11);
+			expect(east.northing).toBeCloseTo(west.northing, 6);
+			expect(east.easting - 500000).toBeCloseTo(500000 - west.easting, 6);
+		});
+
+		it('should leave out the grid factors unless asked for', () => {
+			const result = app.projectToSweref99tm(59.3293, 18.0686);
+			expect(result.convergence).toBeUndefined();
+			expect(result.scaleFactor).toBeUndefined();
+		});
+	});
+
+	describe('Grid factors', () => {
+		it('should have no convergence and the central scale factor on the central meridian', () => {
+			const result = app.projectToSweref99tm(62, 15, true);
+			expect(result.convergence).toBe(0);
+			expect(result.scaleFactor).toBeCloseTo(0.9996, 10);
+		});
+
+		it.each(POINTS)('should match finite differences at %f, %f', (latitude, longitude) => {
+			const step = 1e-6;
+			const result = app.projectToSweref99tm(latitude, longitude, true);
+			const north = app.projectToSweref99tm(latitude + step, longitude);
+			const south = app.projectToSweref99tm(latitude - step, longitude);
+			const east = app.projectToSweref99tm(latitude, longitude + step);
+			const west = app.projectToSweref99tm(latitude, longitude - step);
+
+			const phi = latitude * RADIANS;
+			const w = Math.sqrt(1 - GRS80_E2 * Math.sin(phi) ** 2);
+			const meridianRadius = GRS80_A * (1 - GRS80_E2) / (w * w * w);
+			const parallelRadius = GRS80_A * Math.cos(phi) / w;
+
+			// Sann nordriktning i rutnätet; meridiankonvergensen är vinkeln till rutnätsnord
+			const dNorth = north.northing - south.northing;
+			const dEast = north.easting - south.easting;
+			const convergence = -Math.atan2(dEast, dNorth) / RADIANS;
+			const scaleNorth = Math.hypot(dNorth, dEast) / (meridianRadius * 2 * step * RADIANS);
+			const scaleEast = Math.hypot(east.northing - west.northing, east.easting - west.easting) / (parallelRadius * 2 * step * RADIANS);
+
+			expect(result.convergence!).toBeCloseTo(convergence, 6);
+			expect(result.scaleFactor!).toBeCloseTo(scaleNorth, 7);
+			// Projektionen är konform: samma skala i alla riktningar
+			expect(result.scaleFactor!).toBeCloseTo(scaleEast, 7);
+		});
+
+		it('should give the same values in batch', () => {
+			const latitudes = Float64Array.from(POINTS, (point) => point[0]);
+			const longitudes = Float64Array.from(POINTS, (point) => point[1]);
+			const northings = new Float64Array(POINTS.length);
+			const eastings = new Float64Array(POINTS.length);
+			const convergences = new Float64Array(POINTS.length);
+			const scaleFactors = new Float64Array(POINTS.length);
+			app.projectToSweref99tmBatch(latitudes, longitudes, northings, eastings, convergences, scaleFactors);
+
+			POINTS.forEach(([latitude, longitude], i) => {
+				const single = app.projectToSweref99tm(latitude, longitude, true);
+				expect(northings[i]).toBe(single.northing);
+				expect(eastings[i]).toBe(single.easting);
+				expect(convergences[i]).toBe(single.convergence);
+				expect(scaleFactors[i]).toBe(single.scaleFactor);
+			});
+		});
+	});
+
+	describe('Inverse', () => {
+		it('should return every point to within 1e-9 degrees', () => {
+			const latitudes = Float64Array.from(POINTS, (point) => point[0]);
+			const longitudes = Float64Array.from(POINTS, (point) => point[1]);
+			const northings = new Float64Array(POINTS.length);
+			const eastings = new Float64Array(POINTS.length);
+			app.projectToSweref99tmBatch(latitudes, longitudes, northings, eastings);
+			const backLatitudes = new Float64Array(POINTS.length);
+			const backLongitudes = new Float64Array(POINTS.length);
+			app.unprojectSweref99tmBatch(northings, eastings, backLatitudes, backLongitudes);
+
+			POINTS.forEach(([latitude, longitude], i) => {
+				// 1e-9° är ungefär 0,1 mm
+				expect(Math.abs(backLatitudes[i] - latitude)).toBeLessThan(1e-9);
+				expect(Math.abs(backLongitudes[i] - longitude)).toBeLessThan(1e-9);
+			});
+		});
+
+		it('should give the central meridian at the false easting', () => {
+			const latitudes = new Float64Array(1);
+			const longitudes = new Float64Array(1);
+			app.unprojectSweref99tmBatch(Float64Array.of(6654072.819 * 0.9996), Float64Array.of(500000), latitudes, longitudes);
+			expect(latitudes[0]).toBeCloseTo(60, 8);
+			expect(longitudes[0]).toBe(15);
+		});
+	});
+
+	describe('Benchmark', () => {
+		it('should cost less than the extra transforms needed to derive the grid factors', () => {
+			const count = 100000;
+			const latitudes = new Float64Array(count);
+			const longitudes = new Float64Array(count);
+			for (let i = 0; i < count; i++) {
+				latitudes[i] = 55.3 + 13.7 * ((i * 0.6180339887) % 1);
+				longitudes[i] = 11 + 13 * ((i * 0.7548776662) % 1);
+			}
+			const northings = new Float64Array(count);
+			const eastings = new Float64Array(count);
+			const convergences = new Float64Array(count);
+			const scaleFactors = new Float64Array(count);
+
+			// Bästa av flera varv, så att JIT-uppvärmning inte räknas
+			let coordinateOnly = Number.POSITIVE_INFINITY;
+			let fused = Number.POSITIVE_INFINITY;
+			for (let round = 0; round < 5; round++) {
+				let start = performance.now();
+				app.projectToSweref99tmBatch(latitudes, longitudes, northings, eastings);
+				coordinateOnly = Math.min(coordinateOnly, performance.now() - start);
+				start = performance.now();
+				app.projectToSweref99tmBatch(latitudes, longitudes, northings, eastings, convergences, scaleFactors);
+				fused = Math.min(fused, performance.now() - start);
+			}
+
+			console.log(`SWEREF 99 TM projection: ${(coordinateOnly / count * 1e6).toFixed(0)} ns/point coordinates only, ${(fused / count * 1e6).toFixed(0)} ns/point with grid factors`);
+			// Konvergens och skala ur differenser skulle kräva minst två projektioner till
+			expect(fused).toBeLessThan(coordinateOnly * 3);
+		});
+	});
+
+	describe('Display', () => {
+		it('should show convergence and scale factor in the metadata', async () => {
+			const source = new app.ReplayPositionSource(app.createSyntheticTrace('walking', 10), Number.POSITIVE_INFINITY);
+			app.stopGeolocationWatch();
+			app.positionSource = source;
+			app.startGeolocationWatch(app.handlePositionError);
+			await source.whenComplete();
+			expect(document.getElementById('grid-factors')?.textContent).toMatch(/^γ\s-?\d+,\d{2}° k\s\d,\d{6}$/);
+		});
+	});
+});
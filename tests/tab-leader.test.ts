@@ -0,0 +1,482 @@
+/**
+ * Unit tests for multi-tab leader election
+ *
+ * Tests cover:
+ * - A single leader among several joined tabs
+ * - Broadcast from the leader to followers only
+ * - Failover when the leader leaves or its tab closes
+ * - Followers leaving the queue without becoming leader
+ * - Yielding leadership to a waiting tab
+ * - The leader switching to a position source chosen in a follower tab
+ * - Only the leader tab notifying, checking geofences and recording a fix
+ */
+
+import { loadApp } from './helpers/load-app';
+
+/**
+ * Fake Web Locks and BroadcastChannel shared by simulated tabs in one test.
+ * Locks are granted FIFO per name like the real LockManager.
+ */
+interface FakeLockRequest {
+	name: string;
+	callback: () => unknown;
+	signal?: AbortSignal;
+	resolve: (value: unknown) => void;
+	reject: (error: unknown) => void;
+}
+
+class FakeLockManager {
+	private held = new Set<string>();
+	private queue: FakeLockRequest[] = [];
+
+	request(name: string, options: { signal?: AbortSignal }, callback: () => unknown): Promise<unknown> {
+		return new Promise((resolve, reject) => {
+			const request: FakeLockRequest = { name, callback, signal: options.signal, resolve, reject };
+			options.signal?.addEventListener('abort', () => {
+				const index = this.queue.indexOf(request);
+				if (index !== -1) {
+					this.queue.splice(index, 1);
+					reject(new DOMException('Aborted', 'AbortError'));
+				}
+			});
+			this.queue.push(request);
+			this.grant();
+		});
+	}
+
+	async query(): Promise<{ held: { name: string }[]; pending: { name: string }[] }> {
+		return {
+			held: [...this.held].map((name) => ({ name })),
+			pending: this.queue.map((request) => ({ name: request.name }))
+		};
+	}
+
+	private grant(): void {
+		const request = this.queue.find((r) => !this.held.has(r.name));
+		if (!request) {
+			return;
+		}
+		this.queue.splice(this.queue.indexOf(request), 1);
+		this.held.add(request.name);
+		Promise.resolve(request.callback()).then((value) => {
+			this.held.delete(request.name);
+			request.resolve(value);
+			this.grant();
+		});
+	}
+}
+
+class FakeBroadcastChannel {
+	static channels: FakeBroadcastChannel[] = [];
+	onmessage: ((event: { data: unknown }) => void) | null = null;
+
+	constructor(public name: string) {
+		FakeBroadcastChannel.channels.push(this);
+	}
+
+	postMessage(data: unknown): void {
+		for (const channel of FakeBroadcastChannel.channels) {
+			if (channel !== this && channel.name === this.name) {
+				channel.onmessage?.({ data: JSON.parse(JSON.stringify(data)) });
+			}
+		}
+	}
+
+	close(): void {
+		FakeBroadcastChannel.channels = FakeBroadcastChannel.channels.filter((c) => c !== this);
+	}
+}
+
+/**
+ * Types and class from src/tab-leader.ts - redefined here for testing.
+ * See tests/README.md for details.
+ */
+interface TabLeaderCallbacks<T> {
+	/** Called when this tab has become leader */
+	onLeader(): void;
+	/** Called in followers for each message broadcast by the leader */
+	onMessage(message: T): void;
+	/** Called in the leader when a follower joins, e.g. to resend the latest state */
+	onFollowerJoined?(): void;
+}
+
+/**
+ * Messages on the channel: leader data, or a follower announcing itself
+ */
+type TabLeaderChannelMessage<T> =
+	| { kind: 'data'; payload: T }
+	| { kind: 'join' };
+
+function isTabLeaderElectionSupported(): boolean {
+	return typeof navigator !== 'undefined' && 'locks' in navigator && typeof BroadcastChannel === 'function';
+}
+
+/**
+ * TabLeaderElection - väljer en ledarflik bland de flikar som deltar
+ *
+ * Flikar deltar från join() till leave(). Ledarskapet hålls så länge låset
+ * är taget; det lämnas bara vid leave(), yieldToWaitingTab() eller när
+ * fliken stängs.
+ */
+class TabLeaderElection<T> {
+	private channel: BroadcastChannel;
+	private joined: boolean = false;
+	private leader: boolean = false;
+	private abortController: AbortController | null = null;
+	private releaseLock: (() => void) | null = null;
+
+	constructor(private name: string, private callbacks: TabLeaderCallbacks<T>) {
+		this.channel = new BroadcastChannel(name);
+		this.channel.onmessage = (event: MessageEvent<TabLeaderChannelMessage<T>>) => {
+			const message = event.data;
+			if (message.kind === 'join') {
+				if (this.leader) {
+					this.callbacks.onFollowerJoined?.();
+				}
+			} else if (this.joined && !this.leader) {
+				this.callbacks.onMessage(message.payload);
+			}
+		};
+	}
+
+	isJoined(): boolean {
+		return this.joined;
+	}
+
+	isLeader(): boolean {
+		return this.leader;
+	}
+
+	/**
+	 * Starts taking part in the election
+	 * The tab is a follower until the lock is granted.
+	 */
+	join(): void {
+		if (this.joined) {
+			return;
+		}
+		this.joined = true;
+		this.requestLock();
+		this.post({ kind: 'join' });
+	}
+
+	/**
+	 * Stops taking part, releasing leadership or leaving the queue
+	 */
+	leave(): void {
+		if (!this.joined) {
+			return;
+		}
+		this.joined = false;
+		this.dropLock();
+	}
+
+	/**
+	 * Sends data from the leader to all followers
+	 */
+	broadcast(payload: T): void {
+		if (this.leader) {
+			this.post({ kind: 'data', payload });
+		}
+	}
+
+	/**
+	 * Hands leadership to the next waiting tab, if there is one, and queues up again
+	 * @returns true if leadership was given up
+	 */
+	async yieldToWaitingTab(): Promise<boolean> {
+		if (!this.leader) {
+			return false;
+		}
+		const state = await navigator.locks.query();
+		const hasWaitingTab = state.pending?.some((lock) => lock.name === this.name) ?? false;
+		if (!hasWaitingTab || !this.leader) {
+			return false;
+		}
+		this.dropLock();
+		this.requestLock();
+		return true;
+	}
+
+	private post(message: TabLeaderChannelMessage<T>): void {
+		this.channel.postMessage(message);
+	}
+
+	private requestLock(): void {
+		const abortController = new AbortController();
+		this.abortController = abortController;
+
+		navigator.locks.request(this.name, { signal: abortController.signal }, () => {
+			// Begäran kan ha beviljats precis efter att fliken lämnade kön
+			if (abortController.signal.aborted) {
+				return;
+			}
+			this.abortController = null;
+			this.leader = true;
+			this.callbacks.onLeader();
+			return new Promise<void>((resolve) => {
+				this.releaseLock = resolve;
+			});
+		}).catch((error) => {
+			if (!(error instanceof DOMException && error.name === 'AbortError')) {
+				console.warn('Kunde inte begära ledarlås:', error);
+			}
+		});
+	}
+
+	private dropLock(): void {
+		if (this.leader) {
+			this.leader = false;
+			this.releaseLock?.();
+			this.releaseLock = null;
+		}
+		this.abortController?.abort();
+		this.abortController = null;
+	}
+}
+
+const flush = (): Promise<void> => new Promise((resolve) => setTimeout(resolve, 0));
+
+interface SimulatedTab {
+	election: TabLeaderElection<number>;
+	received: number[];
+	leaderCount: number;
+	followerJoins: number;
+}
+
+function openTab(): SimulatedTab {
+	const tab: SimulatedTab = { election: null as unknown as TabLeaderElection<number>, received: [], leaderCount: 0, followerJoins: 0 };
+	tab.election = new TabLeaderElection<number>('test-lock', {
+		onLeader: () => tab.leaderCount++,
+		onMessage: (value) => tab.received.push(value),
+		onFollowerJoined: () => tab.followerJoins++
+	});
+	return tab;
+}
+
+describe('Tab leader election', () => {
+	beforeEach(() => {
+		FakeBroadcastChannel.channels = [];
+		Object.defineProperty(navigator, 'locks', { value: new FakeLockManager(), configurable: true });
+		(globalThis as unknown as { BroadcastChannel: unknown }).BroadcastChannel = FakeBroadcastChannel;
+	});
+
+	test('should report support when locks and channels exist', () => {
+		expect(isTabLeaderElectionSupported()).toBe(true);
+	});
+
+	test('should elect exactly one leader', async () => {
+		const tabs = [openTab(), openTab(), openTab()];
+		tabs.forEach((tab) => tab.election.join());
+		await flush();
+		expect(tabs.map((tab) => tab.election.isLeader())).toEqual([true, false, false]);
+		expect(tabs.map((tab) => tab.leaderCount)).toEqual([1, 0, 0]);
+	});
+
+	test('should deliver broadcasts to joined followers only', async () => {
+		const [leader, follower, idle] = [openTab(), openTab(), openTab()];
+		leader.election.join();
+		follower.election.join();
+		await flush();
+		leader.election.broadcast(42);
+		follower.election.broadcast(7);
+		expect(follower.received).toEqual([42]);
+		expect(leader.received).toEqual([]);
+		expect(idle.received).toEqual([]);
+	});
+
+	test('should notify the leader when a follower joins', async () => {
+		const [leader, follower] = [openTab(), openTab()];
+		leader.election.join();
+		await flush();
+		follower.election.join();
+		expect(leader.followerJoins).toBe(1);
+		expect(follower.followerJoins).toBe(0);
+	});
+
+	test('should fail over to the next tab when the leader leaves', async () => {
+		const [first, second, third] = [openTab(), openTab(), openTab()];
+		[first, second, third].forEach((tab) => tab.election.join());
+		await flush();
+		first.election.leave();
+		await flush();
+		expect(first.election.isLeader()).toBe(false);
+		expect(second.election.isLeader()).toBe(true);
+		expect(third.election.isLeader()).toBe(false);
+	});
+
+	test('should not make a follower leader after it has left', async () => {
+		const [leader, follower, waiting] = [openTab(), openTab(), openTab()];
+		[leader, follower, waiting].forEach((tab) => tab.election.join());
+		await flush();
+		follower.election.leave();
+		leader.election.leave();
+		await flush();
+		expect(follower.leaderCount).toBe(0);
+		expect(waiting.election.isLeader()).toBe(true);
+	});
+
+	test('should yield to a waiting tab and queue up again', async () => {
+		const [first, second] = [openTab(), openTab()];
+		first.election.join();
+		second.election.join();
+		await flush();
+		expect(await first.election.yieldToWaitingTab()).toBe(true);
+		await flush();
+		expect(second.election.isLeader()).toBe(true);
+		expect(first.election.isJoined()).toBe(true);
+		second.election.leave();
+		await flush();
+		expect(first.election.isLeader()).toBe(true);
+		expect(first.leaderCount).toBe(2);
+	});
+
+	test('should keep leadership when no tab is waiting', async () => {
+		const tab = openTab();
+		tab.election.join();
+		await flush();
+		expect(await tab.election.yieldToWaitingTab()).toBe(false);
+		expect(tab.election.isLeader()).toBe(true);
+	});
+});
+
+type PositionApp = {
+	POSITION_SOURCE_STORAGE_KEY: string;
+	POSITION_SOURCE_URL_STORAGE_KEY: string;
+	startGeolocationWatch(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: { kind: string };
+};
+
+describe('Position source chosen in another tab', () => {
+	let app: PositionApp;
+	const geolocation = { watchPosition: jest.fn(() => 3), clearWatch: jest.fn(), getCurrentPosition: jest.fn() };
+
+	beforeAll(() => {
+		Object.defineProperty(navigator, 'geolocation', { configurable: true, value: geolocation });
+		app = loadApp<PositionApp>([
+			'POSITION_SOURCE_STORAGE_KEY',
+			'POSITION_SOURCE_URL_STORAGE_KEY',
+			'startGeolocationWatch',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource'
+		]);
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	test('should restart the leader watch with the source saved by a follower', () => {
+		const previous = { kind: 'gnss-websocket', isSupported: () => true, watchPosition: jest.fn(() => 9), clearWatch: jest.fn() };
+		app.positionSource = previous;
+		app.startGeolocationWatch(app.handlePositionError);
+
+		// Följarfliken sparar källa och adress; ledaren får en storage-händelse för varje
+		localStorage.setItem(app.POSITION_SOURCE_STORAGE_KEY, 'browser');
+		window.dispatchEvent(new StorageEvent('storage', { key: app.POSITION_SOURCE_STORAGE_KEY }));
+		window.dispatchEvent(new StorageEvent('storage', { key: app.POSITION_SOURCE_URL_STORAGE_KEY }));
+
+		expect(previous.clearWatch.mock.calls).toEqual([[9]]);
+		expect(app.positionSource.kind).toBe('browser');
+		expect(geolocation.watchPosition).toHaveBeenCalledTimes(1);
+		expect((document.getElementById('position-source') as HTMLSelectElement).value).toBe('browser');
+	});
+
+	test('should ignore changes to other stored settings', () => {
+		const current = app.positionSource;
+		window.dispatchEvent(new StorageEvent('storage', { key: 'sweref99-position-filter' }));
+		expect(app.positionSource).toBe(current);
+		expect(geolocation.watchPosition).toHaveBeenCalledTimes(1);
+	});
+});
+
+type SharedFixApp = {
+	requestPositioning(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: unknown;
+	lastPositionFix: { latitude: number; inSweden: boolean } | null;
+	showNotification: (message: string) => void;
+	checkGeofences: (northing: number, easting: number) => void;
+	recordTrackFix: (fix: unknown) => void;
+};
+
+describe('Position fixes shared between tabs', () => {
+	let app: SharedFixApp;
+	let onSuccess: ((position: GeolocationPosition) => void) | null = null;
+	const notifications = jest.fn();
+	const geofenceChecks = jest.fn();
+	const recordedFixes = jest.fn();
+
+	beforeAll(() => {
+		FakeBroadcastChannel.channels = [];
+		Object.defineProperty(navigator, 'locks', { value: new FakeLockManager(), configurable: true });
+		app = loadApp<SharedFixApp>([
+			'requestPositioning',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource',
+			'lastPositionFix',
+			'showNotification',
+			'checkGeofences',
+			'recordTrackFix'
+		]);
+		app.positionSource = {
+			kind: 'browser',
+			isSupported: () => true,
+			watchPosition: (success: (position: GeolocationPosition) => void) => {
+				onSuccess = success;
+				return 1;
+			},
+			clearWatch: () => {
+				onSuccess = null;
+			}
+		};
+		app.showNotification = notifications;
+		app.checkGeofences = geofenceChecks;
+		app.recordTrackFix = recordedFixes;
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	test('should notify, check geofences and record only in the leader tab', async () => {
+		const otherTabFixes: unknown[] = [];
+		const otherTab = new TabLeaderElection<unknown>('sweref99-position', {
+			onLeader: () => {},
+			onMessage: (fix) => otherTabFixes.push(fix)
+		});
+
+		// Appen blir ledare och den andra fliken följare
+		app.requestPositioning(app.handlePositionError);
+		await flush();
+		otherTab.join();
+		expect(onSuccess).not.toBeNull();
+
+		// En position i Oslo, utanför Sverige
+		onSuccess?.({
+			coords: { latitude: 59.9139, longitude: 10.7522, accuracy: 5, altitude: null, altitudeAccuracy: null, heading: null, speed: null },
+			timestamp: Date.now()
+		} as GeolocationPosition);
+		expect(otherTabFixes).toHaveLength(1);
+
+		// Rollerna byts: den andra fliken leder och sänder samma position till appen
+		app.stopGeolocationWatch();
+		await flush();
+		app.requestPositioning(app.handlePositionError);
+		await flush();
+		expect(onSuccess).toBeNull();
+		otherTab.broadcast(otherTabFixes[0]);
+
+		expect(app.lastPositionFix).toMatchObject({ latitude: 59.9139, inSweden: false });
+		expect(document.getElementById('sweref-n')?.textContent).toMatch(/^N\s\d/);
+		expect(notifications).toHaveBeenCalledTimes(1);
+		expect(geofenceChecks).toHaveBeenCalledTimes(1);
+		expect(recordedFixes).toHaveBeenCalledTimes(1);
+		otherTab.leave();
+	});
+});
@@ -0,0 +1,184 @@
+/**
+ * Tests for the time series behind the data quality chart
+ *
+ * Tests cover:
+ * - Largest-Triangle-Three-Buckets downsampling to a pixel width
+ * - Bounded min/max buckets that keep peaks over sessions of any length
+ * - Accuracy, speed and fix interval series fed from track fixes
+ * - The chart status line
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface TimeSeriesBuffer {
+	readonly length: number;
+	readonly max: number;
+	readonly last: number;
+	readonly capacity: number;
+	push(time: number, value: number): void;
+	clear(): void;
+	toArrays(time: Float64Array, value: Float64Array): number;
+}
+
+interface QualityChart {
+	readonly series: readonly [TimeSeriesBuffer, TimeSeriesBuffer, TimeSeriesBuffer];
+	readonly fixCount: number;
+	append(timestamp: number, accuracy: number, speed: number): void;
+	clear(): void;
+}
+
+type App = {
+	TIME_SERIES_MAX_BUCKETS: number;
+	downsampleLttb(time: Float64Array, value: Float64Array, count: number, threshold: number, outTime: Float64Array, outValue: Float64Array): number;
+	TimeSeriesBuffer: new (maxBuckets?: number) => TimeSeriesBuffer;
+	QualityChart: new (canvas: HTMLCanvasElement, labels: readonly [string, string, string]) => QualityChart;
+	formatQualityChartStatus(fixCount: number, frames: { count: number; drawnCount: number; mean: number; p95: number; max: number }): string;
+};
+
+/**
+ * Deterministic pseudo-random numbers in [0, 1)
+ */
+function createRandom(seed: number): () => number {
+	let state = seed;
+	return () => {
+		state = (state * 1664525 + 1013904223) >>> 0;
+		return state / 4294967296;
+	};
+}
+
+describe('Time series', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'TIME_SERIES_MAX_BUCKETS',
+			'downsampleLttb',
+			'TimeSeriesBuffer',
+			'QualityChart',
+			'formatQualityChartStatus'
+		]);
+	});
+
+	/**
+	 * Noisy accuracy around 5 m with one 80 m spike at index 6000
+	 */
+	const createSeries = (count: number) => {
+		const random = createRandom(5);
+		const time = new Float64Array(count);
+		const value = new Float64Array(count);
+		for (let i = 0; i < count; i++) {
+			time[i] = i * 1000;
+			value[i] = 5 + random() * 2;
+		}
+		value[6000] = 80;
+		return { time, value };
+	};
+
+	describe('LTTB', () => {
+		it('should keep the series when it already fits', () => {
+			const time = Float64Array.from([0, 1, 2]);
+			const value = Float64Array.from([3, 1, 2]);
+			const outTime = new Float64Array(10);
+			const outValue = new Float64Array(10);
+			expect(app.downsampleLttb(time, value, 3, 10, outTime, outValue)).toBe(3);
+			expect(Array.from(outValue.subarray(0, 3))).toEqual([3, 1, 2]);
+		});
+
+		it('should return the threshold number of points in time order with the ends kept', () => {
+			const { time, value } = createSeries(10000);
+			const outTime = new Float64Array(300);
+			const outValue = new Float64Array(300);
+			expect(app.downsampleLttb(time, value, 10000, 300, outTime, outValue)).toBe(300);
+			expect(outTime[0]).toBe(0);
+			expect(outTime[299]).toBe(9999000);
+			for (let i = 1; i < 300; i++) {
+				expect(outTime[i]).toBeGreaterThan(outTime[i - 1]);
+			}
+		});
+
+		it('should keep a spike', () => {
+			const { time, value } = createSeries(10000);
+			const outTime = new Float64Array(100);
+			const outValue = new Float64Array(100);
+			app.downsampleLttb(time, value, 10000, 100, outTime, outValue);
+			expect(Math.max(...outValue)).toBe(80);
+		});
+	});
+
+	describe('Bounded buckets', () => {
+		it('should keep every point until the buckets are full', () => {
+			const buffer = new app.TimeSeriesBuffer(8);
+			for (let i = 0; i < 8; i++) {
+				buffer.push(i, i * 10);
+			}
+			const time = new Float64Array(buffer.capacity);
+			const value = new Float64Array(buffer.capacity);
+			expect(buffer.toArrays(time, value)).toBe(8);
+			expect(Array.from(value.subarray(0, 8))).toEqual([0, 10, 20, 30, 40, 50, 60, 70]);
+		});
+
+		it('should stay bounded and keep the extremes over a million points', () => {
+			const buffer = new app.TimeSeriesBuffer();
+			const random = createRandom(9);
+			for (let i = 0; i < 1000000; i++) {
+				const value = i === 123456 ? 500 : i === 654321 ? -1 : random() * 10;
+				buffer.push(i, value);
+			}
+			const time = new Float64Array(buffer.capacity);
+			const value = new Float64Array(buffer.capacity);
+			const count = buffer.toArrays(time, value);
+			expect(buffer.length).toBe(1000000);
+			expect(count).toBeLessThanOrEqual(2 * (app.TIME_SERIES_MAX_BUCKETS + 1));
+			expect(count).toBeGreaterThan(app.TIME_SERIES_MAX_BUCKETS / 2);
+			expect(buffer.max).toBe(500);
+			const kept = Array.from(value.subarray(0, count));
+			expect(kept).toContain(500);
+			expect(kept).toContain(-1);
+			expect(time[kept.indexOf(500)]).toBe(123456);
+			for (let i = 1; i < count; i++) {
+				expect(time[i]).toBeGreaterThan(time[i - 1]);
+			}
+		});
+
+		it('should skip values that are not finite', () => {
+			const buffer = new app.TimeSeriesBuffer();
+			buffer.push(0, 1);
+			buffer.push(1, Number.NaN);
+			buffer.push(2, 3);
+			expect(buffer.length).toBe(2);
+			expect(buffer.last).toBe(3);
+			buffer.clear();
+			expect(buffer.length).toBe(0);
+			expect(buffer.max).toBe(-Infinity);
+		});
+	});
+
+	describe('Quality chart series', () => {
+		it('should record accuracy, speed and the time between fixes', () => {
+			const chart = new app.QualityChart(document.createElement('canvas'), ['Noggrannhet', 'Hastighet', 'Intervall']);
+			chart.append(1000, 5, 1.5);
+			chart.append(2000, 4, Number.NaN);
+			chart.append(7000, 12, 2);
+			const [accuracy, speed, interval] = chart.series;
+			expect(chart.fixCount).toBe(3);
+			expect(accuracy.max).toBe(12);
+			expect(speed.length).toBe(2);
+			expect(interval.length).toBe(2);
+			expect(interval.max).toBe(5);
+			expect(interval.last).toBe(5);
+
+			chart.clear();
+			chart.append(9000, 3, 0);
+			expect(chart.series[2].length).toBe(0);
+		});
+
+		it('should describe the fix count and the drawing time', () => {
+			expect(app.formatQualityChartStatus(0, { count: 0, drawnCount: 0, mean: 0, p95: 0, max: 0 })).toBe('0\u00A0punkter');
+			expect(app.formatQualityChartStatus(3600, { count: 4, drawnCount: 900, mean: 0.42, p95: 0.6, max: 0.6 }))
+				.toBe('3600\u00A0punkter · ritning 0,4\u00A0ms');
+		});
+	});
+});
@@ -0,0 +1,499 @@
+/**
+ * Unit tests and benchmark for the binary track chunk format
+ *
+ * Tests cover:
+ * - Zigzag encoding of signed deltas, including values beyond 32 bits
+ * - Round trip of time, SWEREF 99 TM, accuracy and speed columns
+ * - Chunk header reading without decoding the columns
+ * - Rejection of values that cannot be stored, and of corrupt and truncated chunks
+ * - Size and throughput compared with plain Float64Array columns
+ * - The real track recorder skipping unstorable fixes and recovering from a
+ *   chunk that cannot be encoded
+ */
+
+import { loadApp } from './helpers/load-app';
+
+/**
+ * Types and codec from src/track-store.ts and src/track-codec.ts -
+ * redefined here for testing. See tests/README.md for details.
+ */
+interface TrackColumns {
+	count: number;
+	timestamp: Float64Array;
+	northing: Float64Array;
+	easting: Float64Array;
+	accuracy: Float64Array;
+	speed: Float64Array;
+}
+
+function createTrackColumns(capacity: number): TrackColumns {
+	return {
+		count: 0,
+		timestamp: new Float64Array(capacity),
+		northing: new Float64Array(capacity),
+		easting: new Float64Array(capacity),
+		accuracy: new Float64Array(capacity),
+		speed: new Float64Array(capacity)
+	};
+}
+
+/**
+ * Decoded chunk header
+ */
+interface TrackChunkHeader {
+	version: number;
+	count: number;
+	startTime: number;
+	endTime: number;
+	columnLengths: number[];
+}
+
+const TRACK_CODEC_MAGIC_0 = 0x53; // 'S'
+const TRACK_CODEC_MAGIC_1 = 0x54; // 'T'
+const TRACK_CODEC_VERSION = 1;
+const TRACK_CODEC_COLUMN_COUNT = 5;
+const TRACK_CODEC_HEADER_BYTES = 24 + 4 * TRACK_CODEC_COLUMN_COUNT;
+
+/**
+ * Fixed-point scale factors for the integer columns
+ */
+const TRACK_CODEC_SCALE = {
+	COORDINATE: 1000, // mm
+	ACCURACY: 100, // cm
+	SPEED: 100 // cm/s
+} as const;
+
+/**
+ * Growable byte buffer with varint writing
+ */
+class ByteWriter {
+	bytes: Uint8Array;
+	length: number = 0;
+
+	constructor(capacity: number) {
+		this.bytes = new Uint8Array(capacity);
+	}
+
+	ensureCapacity(extra: number): void {
+		const required = this.length + extra;
+		if (required <= this.bytes.length) {
+			return;
+		}
+		let capacity = this.bytes.length * 2;
+		while (capacity < required) {
+			capacity *= 2;
+		}
+		const grown = new Uint8Array(capacity);
+		grown.set(this.bytes.subarray(0, this.length));
+		this.bytes = grown;
+	}
+
+	/**
+	 * Writes a non-negative integer up to 2^53 as LEB128 varint
+	 */
+	writeVarint(value: number): void {
+		this.ensureCapacity(8);
+		const bytes = this.bytes;
+		let pos = this.length;
+		// Snabb väg med bitoperationer när värdet ryms i 31 bitar
+		while (value > 0x7fffffff) {
+			bytes[pos++] = (value % 0x80) | 0x80;
+			value = Math.floor(value / 0x80);
+		}
+		while (value >= 0x80) {
+			bytes[pos++] = (value & 0x7f) | 0x80;
+			value >>>= 7;
+		}
+		bytes[pos++] = value;
+		this.length = pos;
+	}
+
+	toUint8Array(): Uint8Array {
+		return this.bytes.slice(0, this.length);
+	}
+}
+
+/**
+ * Maps signed integers to unsigned so small magnitudes get short varints
+ * Uses arithmetic instead of bit operations to stay exact beyond 32 bits.
+ */
+function zigzagEncode(value: number): number {
+	return value >= 0 ? value * 2 : -value * 2 - 1;
+}
+
+function zigzagDecode(value: number): number {
+	return value % 2 === 0 ? value / 2 : -(value + 1) / 2;
+}
+
+function scaleSpeed(speed: number): number {
+	// 0 betyder att enheten inte rapporterade någon fart
+	return Number.isNaN(speed) ? 0 : Math.round(Math.max(0, speed) * TRACK_CODEC_SCALE.SPEED) + 1;
+}
+
+function unscaleSpeed(value: number): number {
+	return value === 0 ? Number.NaN : (value - 1) / TRACK_CODEC_SCALE.SPEED;
+}
+
+/**
+ * Writes one column as zigzag-encoded deltas
+ * @throws Error if a scaled value or delta does not fit in a safe integer,
+ * since writeVarint would loop forever on Infinity and truncate larger values
+ */
+function writeDeltaColumn(writer: ByteWriter, source: Float64Array, count: number, scale: (value: number) => number): number {
+	const start = writer.length;
+	let previous = 0;
+	for (let i = 0; i < count; i++) {
+		const value = scale(source[i]);
+		const delta = zigzagEncode(value - previous);
+		// Fångar även NaN, som annars skulle kodas som 0
+		if (!Number.isSafeInteger(value) || !(delta <= Number.MAX_SAFE_INTEGER)) {
+			throw new Error(`Spårblocket kan inte lagra värdet ${source[i]}`);
+		}
+		writer.writeVarint(delta);
+		previous = value;
+	}
+	return writer.length - start;
+}
+
+/**
+ * Encodes a column chunk into the binary chunk format
+ * @throws Error if a column holds a value that cannot be stored
+ */
+function encodeTrackChunk(columns: TrackColumns): Uint8Array {
+	const { count } = columns;
+	const writer = new ByteWriter(TRACK_CODEC_HEADER_BYTES + count * 10);
+	writer.length = TRACK_CODEC_HEADER_BYTES;
+
+	const columnLengths = [
+		writeDeltaColumn(writer, columns.timestamp, count, Math.round),
+		writeDeltaColumn(writer, columns.northing, count, (v) => Math.round(v * TRACK_CODEC_SCALE.COORDINATE)),
+		writeDeltaColumn(writer, columns.easting, count, (v) => Math.round(v * TRACK_CODEC_SCALE.COORDINATE)),
+		writeDeltaColumn(writer, columns.accuracy, count, (v) => Math.round(v * TRACK_CODEC_SCALE.ACCURACY)),
+		writeDeltaColumn(writer, columns.speed, count, scaleSpeed)
+	];
+
+	const view = new DataView(writer.bytes.buffer, writer.bytes.byteOffset, TRACK_CODEC_HEADER_BYTES);
+	view.setUint8(0, TRACK_CODEC_MAGIC_0);
+	view.setUint8(1, TRACK_CODEC_MAGIC_1);
+	view.setUint8(2, TRACK_CODEC_VERSION);
+	view.setUint8(3, 0);
+	view.setUint32(4, count, true);
+	view.setFloat64(8, count > 0 ? Math.round(columns.timestamp[0]) : 0, true);
+	view.setFloat64(16, count > 0 ? Math.round(columns.timestamp[count - 1]) : 0, true);
+	columnLengths.forEach((length, i) => view.setUint32(24 + i * 4, length, true));
+
+	return writer.toUint8Array();
+}
+
+/**
+ * Reads the chunk header without decoding any column data
+ * @throws Error if the data is not a supported track chunk
+ */
+function readTrackChunkHeader(bytes: Uint8Array): TrackChunkHeader {
+	if (bytes.length < TRACK_CODEC_HEADER_BYTES || bytes[0] !== TRACK_CODEC_MAGIC_0 || bytes[1] !== TRACK_CODEC_MAGIC_1) {
+		throw new Error('Ogiltigt spårblock');
+	}
+	const view = new DataView(bytes.buffer, bytes.byteOffset, TRACK_CODEC_HEADER_BYTES);
+	const version = view.getUint8(2);
+	if (version !== TRACK_CODEC_VERSION) {
+		throw new Error(`Spårblock har okänd version ${version}`);
+	}
+
+	const columnLengths: number[] = [];
+	for (let i = 0; i < TRACK_CODEC_COLUMN_COUNT; i++) {
+		columnLengths.push(view.getUint32(24 + i * 4, true));
+	}
+	return {
+		version,
+		count: view.getUint32(4, true),
+		startTime: view.getFloat64(8, true),
+		endTime: view.getFloat64(16, true),
+		columnLengths
+	};
+}
+
+function readDeltaColumn(bytes: Uint8Array, start: number, end: number, target: Float64Array, count: number, unscale: (value: number) => number): void {
+	let pos = start;
+	let previous = 0;
+	for (let i = 0; i < count; i++) {
+		let raw = 0;
+		let multiplier = 1;
+		let byte: number;
+		do {
+			if (pos >= end) {
+				throw new Error('Spårblocket är trunkerat');
+			}
+			byte = bytes[pos++];
+			raw += (byte & 0x7f) * multiplier;
+			multiplier *= 0x80;
+		} while (byte & 0x80);
+
+		previous += zigzagDecode(raw);
+		target[i] = unscale(previous);
+	}
+}
+
+/**
+ * Decodes a binary chunk into columns
+ */
+function decodeTrackChunk(bytes: Uint8Array): TrackColumns {
+	const header = readTrackChunkHeader(bytes);
+	const columns = createTrackColumns(header.count);
+	columns.count = header.count;
+
+	const targets: [Float64Array, (value: number) => number][] = [
+		[columns.timestamp, (v) => v],
+		[columns.northing, (v) => v / TRACK_CODEC_SCALE.COORDINATE],
+		[columns.easting, (v) => v / TRACK_CODEC_SCALE.COORDINATE],
+		[columns.accuracy, (v) => v / TRACK_CODEC_SCALE.ACCURACY],
+		[columns.speed, unscaleSpeed]
+	];
+
+	let offset = TRACK_CODEC_HEADER_BYTES;
+	targets.forEach(([target, unscale], i) => {
+		const end = offset + header.columnLengths[i];
+		if (end > bytes.length) {
+			throw new Error('Spårblocket är trunkerat');
+		}
+		readDeltaColumn(bytes, offset, end, target, header.count, unscale);
+		offset = end;
+	});
+
+	return columns;
+}
+
+/**
+ * Synthetic 1 Hz walk: ~1.4 m/s heading north-east with GNSS noise
+ */
+function makeWalk(count: number, startTime: number = Date.UTC(2025, 5, 1, 8)): TrackColumns {
+	const columns = createTrackColumns(count);
+	columns.count = count;
+	let seed = 42;
+	const noise = (): number => {
+		seed = (seed * 1103515245 + 12345) % 2147483648;
+		return seed / 2147483648 - 0.5;
+	};
+	for (let i = 0; i < count; i++) {
+		columns.timestamp[i] = startTime + i * 1000;
+		columns.northing[i] = 6580822.123 + i * 1.2 + noise() * 2;
+		columns.easting[i] = 674032.456 + i * 0.7 + noise() * 2;
+		columns.accuracy[i] = 4 + Math.abs(noise()) * 3;
+		columns.speed[i] = i % 50 === 0 ? Number.NaN : 1.4 + noise() * 0.2;
+	}
+	return columns;
+}
+
+const FLOAT64_BYTES_PER_FIX = 5 * Float64Array.BYTES_PER_ELEMENT;
+
+describe('Track chunk codec', () => {
+	describe('zigzag encoding', () => {
+		test('should map small signed values to small unsigned values', () => {
+			expect(zigzagEncode(0)).toBe(0);
+			expect(zigzagEncode(-1)).toBe(1);
+			expect(zigzagEncode(1)).toBe(2);
+			expect(zigzagEncode(-2)).toBe(3);
+		});
+
+		test('should round trip values beyond 32 bits', () => {
+			for (const value of [6580822123, -6580822123, 1748764800000, -1, 0, 2 ** 40]) {
+				expect(zigzagDecode(zigzagEncode(value))).toBe(value);
+			}
+		});
+	});
+
+	describe('round trip', () => {
+		test('should preserve timestamps exactly', () => {
+			const input = makeWalk(256);
+			const output = decodeTrackChunk(encodeTrackChunk(input));
+			expect(output.count).toBe(256);
+			expect(Array.from(output.timestamp)).toEqual(Array.from(input.timestamp));
+		});
+
+		test('should preserve SWEREF 99 TM coordinates to the millimetre', () => {
+			const input = makeWalk(256);
+			const output = decodeTrackChunk(encodeTrackChunk(input));
+			for (let i = 0; i < input.count; i++) {
+				expect(Math.abs(output.northing[i] - input.northing[i])).toBeLessThanOrEqual(0.0005);
+				expect(Math.abs(output.easting[i] - input.easting[i])).toBeLessThanOrEqual(0.0005);
+			}
+		});
+
+		test('should preserve accuracy and speed to the centimetre', () => {
+			const input = makeWalk(256);
+			const output = decodeTrackChunk(encodeTrackChunk(input));
+			for (let i = 0; i < input.count; i++) {
+				expect(Math.abs(output.accuracy[i] - input.accuracy[i])).toBeLessThanOrEqual(0.005);
+				if (Number.isNaN(input.speed[i])) {
+					expect(output.speed[i]).toBeNaN();
+				} else {
+					expect(Math.abs(output.speed[i] - input.speed[i])).toBeLessThanOrEqual(0.005);
+				}
+			}
+		});
+
+		test('should handle large jumps and backwards time', () => {
+			const input = makeWalk(3);
+			input.northing[1] = 7700000;
+			input.easting[1] = 250000;
+			input.timestamp[2] = input.timestamp[0] - 5000;
+			const output = decodeTrackChunk(encodeTrackChunk(input));
+			expect(output.northing[1]).toBe(7700000);
+			expect(output.easting[1]).toBe(250000);
+			expect(output.timestamp[2]).toBe(input.timestamp[0] - 5000);
+		});
+
+		test.each([
+			['timestamp', Infinity],
+			['northing', Number.NaN],
+			['easting', -Infinity],
+			['accuracy', 2 ** 60],
+			['speed', Infinity]
+		] as const)('should reject %s %p instead of writing a corrupt chunk', (column, value) => {
+			const input = makeWalk(3);
+			input[column][1] = value;
+			expect(() => encodeTrackChunk(input)).toThrow('Spårblocket kan inte lagra värdet');
+		});
+
+		test('should reject a delta beyond 2^53', () => {
+			const input = makeWalk(2);
+			input.timestamp[0] = -(2 ** 52);
+			input.timestamp[1] = 2 ** 52;
+			expect(() => encodeTrackChunk(input)).toThrow('Spårblocket kan inte lagra värdet');
+		});
+
+		test('should encode an empty chunk', () => {
+			const output = decodeTrackChunk(encodeTrackChunk(createTrackColumns(0)));
+			expect(output.count).toBe(0);
+		});
+	});
+
+	describe('chunk header', () => {
+		test('should expose count and time range without decoding columns', () => {
+			const input = makeWalk(100);
+			const header = readTrackChunkHeader(encodeTrackChunk(input));
+			expect(header.version).toBe(TRACK_CODEC_VERSION);
+			expect(header.count).toBe(100);
+			expect(header.startTime).toBe(input.timestamp[0]);
+			expect(header.endTime).toBe(input.timestamp[99]);
+			expect(header.columnLengths).toHaveLength(TRACK_CODEC_COLUMN_COUNT);
+		});
+
+		test('should reject data without the magic bytes', () => {
+			const bytes = encodeTrackChunk(makeWalk(10));
+			bytes[0] = 0;
+			expect(() => readTrackChunkHeader(bytes)).toThrow();
+		});
+
+		test('should reject truncated column data', () => {
+			const bytes = encodeTrackChunk(makeWalk(10));
+			expect(() => decodeTrackChunk(bytes.subarray(0, bytes.length - 3))).toThrow();
+		});
+	});
+
+	describe('size and throughput', () => {
+		test('should use far fewer bytes per fix than Float64Array columns', () => {
+			const input = makeWalk(256);
+			const bytesPerFix = encodeTrackChunk(input).length / input.count;
+			console.log(`Binärt spårformat: ${bytesPerFix.toFixed(2)} byte/position (Float64Array: ${FLOAT64_BYTES_PER_FIX})`);
+			expect(bytesPerFix).toBeLessThan(FLOAT64_BYTES_PER_FIX / 3);
+		});
+
+		test('should report encode and decode throughput', () => {
+			const chunks = 200;
+			const input = makeWalk(256);
+			const rawBytes = chunks * input.count * FLOAT64_BYTES_PER_FIX;
+
+			let encoded: Uint8Array = new Uint8Array(0);
+			const encodeStart = performance.now();
+			for (let i = 0; i < chunks; i++) {
+				encoded = encodeTrackChunk(input);
+			}
+			const encodeMs = performance.now() - encodeStart;
+
+			const decodeStart = performance.now();
+			let decodedCount = 0;
+			for (let i = 0; i < chunks; i++) {
+				decodedCount += decodeTrackChunk(encoded).count;
+			}
+			const decodeMs = performance.now() - decodeStart;
+
+			const mbPerSecond = (ms: number): string => (rawBytes / 1e6 / (ms / 1000)).toFixed(1);
+			console.log(`Binärt spårformat: kodning ${mbPerSecond(encodeMs)} MB/s, avkodning ${mbPerSecond(decodeMs)} MB/s (räknat på Float64Array-storlek)`);
+			expect(decodedCount).toBe(chunks * input.count);
+		});
+	});
+});
+
+describe('Track recorder', () => {
+	interface Recorder {
+		start(startTime: number): void;
+		append(fix: { timestamp: number; northing: number; easting: number; accuracy: number; speed: number | null }): boolean;
+		getFixCount(): number;
+	}
+	type RecorderApp = {
+		TrackRecorder: new () => Recorder;
+		encodeTrackChunk: (columns: TrackColumns) => Uint8Array;
+	};
+
+	let app: RecorderApp;
+	let encodedCounts: number[];
+	let failNextEncode: boolean;
+
+	beforeAll(() => {
+		app = loadApp<RecorderApp>(['TrackRecorder', 'encodeTrackChunk']);
+		const encode = app.encodeTrackChunk;
+		app.encodeTrackChunk = (columns) => {
+			if (failNextEncode) {
+				failNextEncode = false;
+				throw new Error('Spårblocket kan inte lagra värdet');
+			}
+			encodedCounts.push(columns.count);
+			return encode(columns);
+		};
+	});
+
+	function appendWalk(recorder: Recorder, count: number, accuracyAt: (i: number) => number = () => 4): void {
+		for (let i = 0; i < count; i++) {
+			recorder.append({ timestamp: 1_700_000_000_000 + i * 1000, northing: 6580000 + i, easting: 674000, accuracy: accuracyAt(i), speed: 1.2 });
+		}
+	}
+
+	test('should skip an infinite accuracy at fix 256 and keep recording', () => {
+		encodedCounts = [];
+		failNextEncode = false;
+		const recorder = new app.TrackRecorder();
+		recorder.start(0);
+
+		appendWalk(recorder, 600, (i) => (i === 255 ? Number.POSITIVE_INFINITY : 4));
+
+		expect(recorder.getFixCount()).toBe(599);
+		expect(encodedCounts).toEqual([256, 256]);
+	});
+
+	test.each([Number.NaN, Number.POSITIVE_INFINITY, 2 ** 60])('should reject timestamp %p', (timestamp) => {
+		const recorder = new app.TrackRecorder();
+		recorder.start(0);
+
+		expect(recorder.append({ timestamp, northing: 6580000, easting: 674000, accuracy: 4, speed: null })).toBe(false);
+		expect(recorder.getFixCount()).toBe(0);
+	});
+
+	test('should store an infinite speed as unknown', () => {
+		const recorder = new app.TrackRecorder();
+		recorder.start(0);
+
+		expect(recorder.append({ timestamp: 0, northing: 6580000, easting: 674000, accuracy: 4, speed: Number.POSITIVE_INFINITY })).toBe(true);
+	});
+
+	test('should empty the buffer when a chunk cannot be encoded', () => {
+		encodedCounts = [];
+		failNextEncode = true;
+		const recorder = new app.TrackRecorder();
+		recorder.start(0);
+
+		appendWalk(recorder, 512);
+
+		expect(recorder.getFixCount()).toBe(512);
+		expect(encodedCounts).toEqual([256]);
+	});
+});
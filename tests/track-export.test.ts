@@ -0,0 +1,325 @@
+/**
+ * Unit tests for incremental track export serialization
+ *
+ * Tests cover:
+ * - CSV header and row formatting with SWEREF 99 TM and WGS 84 columns
+ * - GeoJSON output that stays valid across chunk boundaries
+ * - GPX track points with SWEREF 99 TM extensions
+ * - Missing speed values
+ * - Map sheet columns in every format
+ * - WGS 84 columns from the real inverse projection, same as for single fixes
+ */
+
+import { loadApp } from './helpers/load-app';
+
+/**
+ * Types and serializers from src/track-store.ts, src/map-sheet.ts and src/track-export.ts -
+ * redefined here for testing. See tests/README.md for details.
+ */
+interface TrackColumns {
+	count: number;
+	timestamp: Float64Array;
+	northing: Float64Array;
+	easting: Float64Array;
+	accuracy: Float64Array;
+	speed: Float64Array;
+}
+
+interface Wgs84Columns {
+	latitude: Float64Array;
+	longitude: Float64Array;
+}
+
+interface TrackRecord {
+	id: number;
+	startTime: number;
+	endTime: number;
+	fixCount: number;
+	chunkCount: number;
+}
+
+interface TrackSerializer {
+	mimeType: string;
+	extension: string;
+	header(track: TrackRecord): string;
+	chunk(columns: TrackColumns, wgs84: Wgs84Columns): string;
+	footer(): string;
+}
+
+const MAP_SHEET_SIZES = [5000, 10000, 50000] as const;
+
+type MapSheetSize = typeof MAP_SHEET_SIZES[number];
+
+function mapSheetIndex(northing: number, easting: number, size: MapSheetSize): number {
+	return Math.floor(northing / size) * Math.ceil(10000000 / size) + Math.floor(easting / size);
+}
+
+function formatMapSheet(northing: number, easting: number, size: MapSheetSize): string {
+	const northKm = Math.floor(northing / size) * size / 1000;
+	const eastKm = Math.floor(easting / size) * size / 1000;
+	return `${northKm}_${eastKm}`;
+}
+
+function formatMapSheets(northing: number, easting: number): string[] {
+	return MAP_SHEET_SIZES.map((size) => formatMapSheet(northing, easting, size));
+}
+
+function createMapSheetNamer(): (northing: number, easting: number) => readonly string[] {
+	let lastIndex = Number.NaN;
+	let lastNames: readonly string[] = [];
+	return (northing, easting) => {
+		const index = mapSheetIndex(northing, easting, MAP_SHEET_SIZES[0]);
+		if (index !== lastIndex) {
+			lastIndex = index;
+			lastNames = formatMapSheets(northing, easting);
+		}
+		return lastNames;
+	};
+}
+
+const GPX_SWEREF_NAMESPACE = 'https://sweref99.nu/gpx/1';
+const MAP_SHEET_FIELDS = MAP_SHEET_SIZES.map((size) => `ruta_${size / 1000}km`);
+const CSV_HEADER = `tid,sweref99tm_n,sweref99tm_e,wgs84_lat,wgs84_lon,noggrannhet_m,fart_ms,${MAP_SHEET_FIELDS.join(',')}\n`;
+
+function formatExportTime(timestamp: number): string {
+	return new Date(timestamp).toISOString();
+}
+
+function formatExportSpeed(speed: number): string {
+	return Number.isNaN(speed) ? '' : speed.toFixed(2);
+}
+
+function createGpxSerializer(): TrackSerializer {
+	const nameSheets = createMapSheetNamer();
+	return {
+		mimeType: 'application/gpx+xml',
+		extension: 'gpx',
+		header: (track) => (
+			'<?xml version="1.0" encoding="UTF-8"?>\n' +
+			`<gpx version="1.1" creator="sweref99.nu" xmlns="http://www.topografix.com/GPX/1/1" xmlns:sweref="${GPX_SWEREF_NAMESPACE}">\n` +
+			`<trk><name>${formatExportTime(track.startTime)}</name><trkseg>\n`
+		),
+		chunk: (columns, wgs84) => {
+			let out = '';
+			for (let i = 0; i < columns.count; i++) {
+				const speed = formatExportSpeed(columns.speed[i]);
+				const sheets = nameSheets(columns.northing[i], columns.easting[i]);
+				out += `<trkpt lat="${wgs84.latitude[i].toFixed(8)}" lon="${wgs84.longitude[i].toFixed(8)}">` +
+					`<time>${formatExportTime(columns.timestamp[i])}</time>` +
+					`<extensions><sweref:n>${columns.northing[i].toFixed(3)}</sweref:n><sweref:e>${columns.easting[i].toFixed(3)}</sweref:e>` +
+					`<sweref:accuracy>${columns.accuracy[i].toFixed(1)}</sweref:accuracy>` +
+					(speed ? `<sweref:speed>${speed}</sweref:speed>` : '') +
+					sheets.map((sheet, k) => `<sweref:sheet km="${MAP_SHEET_SIZES[k] / 1000}">${sheet}</sweref:sheet>`).join('') +
+					'</extensions></trkpt>\n';
+			}
+			return out;
+		},
+		footer: () => '</trkseg></trk>\n</gpx>\n'
+	};
+}
+
+function createGeoJsonSerializer(): TrackSerializer {
+	let hasWrittenFeature = false;
+	const nameSheets = createMapSheetNamer();
+	return {
+		mimeType: 'application/geo+json',
+		extension: 'geojson',
+		header: () => '{"type":"FeatureCollection","features":[\n',
+		chunk: (columns, wgs84) => {
+			let out = '';
+			for (let i = 0; i < columns.count; i++) {
+				const speed = formatExportSpeed(columns.speed[i]);
+				const sheets = nameSheets(columns.northing[i], columns.easting[i]);
+				out += (hasWrittenFeature ? ',\n' : '') +
+					`{"type":"Feature","geometry":{"type":"Point","coordinates":[${wgs84.longitude[i].toFixed(8)},${wgs84.latitude[i].toFixed(8)}]},` +
+					`"properties":{"tid":"${formatExportTime(columns.timestamp[i])}","sweref99tm_n":${columns.northing[i].toFixed(3)},"sweref99tm_e":${columns.easting[i].toFixed(3)},` +
+					`"noggrannhet_m":${columns.accuracy[i].toFixed(1)},"fart_ms":${speed || 'null'}` +
+					sheets.map((sheet, k) => `,"${MAP_SHEET_FIELDS[k]}":"${sheet}"`).join('') + '}}';
+				hasWrittenFeature = true;
+			}
+			return out;
+		},
+		footer: () => '\n]}\n'
+	};
+}
+
+function createCsvSerializer(): TrackSerializer {
+	const nameSheets = createMapSheetNamer();
+	return {
+		mimeType: 'text/csv',
+		extension: 'csv',
+		header: () => CSV_HEADER,
+		chunk: (columns, wgs84) => {
+			let out = '';
+			for (let i = 0; i < columns.count; i++) {
+				out += `${formatExportTime(columns.timestamp[i])},${columns.northing[i].toFixed(3)},${columns.easting[i].toFixed(3)},` +
+					`${wgs84.latitude[i].toFixed(8)},${wgs84.longitude[i].toFixed(8)},` +
+					`${columns.accuracy[i].toFixed(1)},${formatExportSpeed(columns.speed[i])},` +
+					`${nameSheets(columns.northing[i], columns.easting[i]).join(',')}\n`;
+			}
+			return out;
+		},
+		footer: () => ''
+	};
+}
+
+interface TestChunk {
+	columns: TrackColumns;
+	wgs84: Wgs84Columns;
+}
+
+/**
+ * Builds a chunk of fixes heading north from Stockholm
+ */
+function makeColumns(count: number, startIndex: number = 0): TestChunk {
+	const wgs84: Wgs84Columns = {
+		latitude: new Float64Array(count),
+		longitude: new Float64Array(count)
+	};
+	const columns: TrackColumns = {
+		count,
+		timestamp: new Float64Array(count),
+		northing: new Float64Array(count),
+		easting: new Float64Array(count),
+		accuracy: new Float64Array(count),
+		speed: new Float64Array(count)
+	};
+	for (let i = 0; i < count; i++) {
+		const n = startIndex + i;
+		columns.timestamp[i] = Date.UTC(2025, 5, 1, 12, 0, n);
+		wgs84.latitude[i] = 59.3293 + n * 0.00001;
+		wgs84.longitude[i] = 18.0686;
+		columns.northing[i] = 6580822.123 + n * 1.1;
+		columns.easting[i] = 674032.456;
+		columns.accuracy[i] = 4;
+		columns.speed[i] = n % 2 === 0 ? 1.1 : Number.NaN;
+	}
+	return { columns, wgs84 };
+}
+
+const track: TrackRecord = { id: 1, startTime: Date.UTC(2025, 5, 1, 12), endTime: 0, fixCount: 0, chunkCount: 0 };
+
+function serialize(serializer: TrackSerializer, chunks: TestChunk[]): string {
+	return serializer.header(track) + chunks.map((c) => serializer.chunk(c.columns, c.wgs84)).join('') + serializer.footer();
+}
+
+describe('Track export serialization', () => {
+	describe('CSV', () => {
+		test('should write header and one row per fix', () => {
+			const out = serialize(createCsvSerializer(), [makeColumns(3)]);
+			const lines = out.trim().split('\n');
+			expect(lines[0]).toBe(CSV_HEADER.trim());
+			expect(lines).toHaveLength(4);
+		});
+
+		test('should include SWEREF 99 TM and WGS 84 columns', () => {
+			const out = serialize(createCsvSerializer(), [makeColumns(1)]);
+			const row = out.trim().split('\n')[1].split(',');
+			expect(row[0]).toBe('2025-06-01T12:00:00.000Z');
+			expect(row[1]).toBe('6580822.123');
+			expect(row[2]).toBe('674032.456');
+			expect(row[3]).toBe('59.32930000');
+			expect(row[4]).toBe('18.06860000');
+			expect(row[5]).toBe('4.0');
+			expect(row[6]).toBe('1.10');
+		});
+
+		test('should leave speed empty when unknown', () => {
+			const out = serialize(createCsvSerializer(), [makeColumns(2)]);
+			expect(out.trim().split('\n')[2].split(',')[6]).toBe('');
+		});
+
+		test('should name the map sheets of each fix', () => {
+			const out = serialize(createCsvSerializer(), [makeColumns(1)]);
+			const row = out.trim().split('\n')[1].split(',');
+			expect(row.slice(7)).toEqual(['6580_670', '6580_670', '6550_650']);
+		});
+	});
+
+	describe('GeoJSON', () => {
+		test('should produce valid JSON across chunk boundaries', () => {
+			const out = serialize(createGeoJsonSerializer(), [makeColumns(3), makeColumns(2, 3), makeColumns(4, 5)]);
+			const parsed = JSON.parse(out);
+			expect(parsed.type).toBe('FeatureCollection');
+			expect(parsed.features).toHaveLength(9);
+		});
+
+		test('should produce valid JSON for an empty track', () => {
+			const parsed = JSON.parse(serialize(createGeoJsonSerializer(), []));
+			expect(parsed.features).toHaveLength(0);
+		});
+
+		test('should use WGS 84 geometry and SWEREF 99 TM properties', () => {
+			const parsed = JSON.parse(serialize(createGeoJsonSerializer(), [makeColumns(2)]));
+			const [first, second] = parsed.features;
+			expect(first.geometry.coordinates).toEqual([18.0686, 59.3293]);
+			expect(first.properties.sweref99tm_n).toBeCloseTo(6580822.123, 3);
+			expect(first.properties.sweref99tm_e).toBeCloseTo(674032.456, 3);
+			expect(first.properties.fart_ms).toBe(1.1);
+			expect(second.properties.fart_ms).toBeNull();
+		});
+
+		test('should include map sheet properties', () => {
+			const parsed = JSON.parse(serialize(createGeoJsonSerializer(), [makeColumns(1)]));
+			expect(parsed.features[0].properties.ruta_5km).toBe('6580_670');
+			expect(parsed.features[0].properties.ruta_50km).toBe('6550_650');
+		});
+	});
+
+	describe('GPX', () => {
+		test('should write one trkpt per fix and close the document', () => {
+			const out = serialize(createGpxSerializer(), [makeColumns(3), makeColumns(2, 3)]);
+			expect(out.match(/<trkpt /g)).toHaveLength(5);
+			expect(out.trim().endsWith('</gpx>')).toBe(true);
+		});
+
+		test('should declare the SWEREF extension namespace', () => {
+			const out = serialize(createGpxSerializer(), [makeColumns(1)]);
+			expect(out).toContain(`xmlns:sweref="${GPX_SWEREF_NAMESPACE}"`);
+			expect(out).toContain('<sweref:n>6580822.123</sweref:n>');
+		});
+
+		test('should omit speed element when unknown', () => {
+			const out = serialize(createGpxSerializer(), [makeColumns(2)]);
+			expect(out.match(/<sweref:speed>/g)).toHaveLength(1);
+		});
+
+		test('should name the map sheets in the extensions', () => {
+			const out = serialize(createGpxSerializer(), [makeColumns(1)]);
+			expect(out).toContain('<sweref:sheet km="5">6580_670</sweref:sheet><sweref:sheet km="10">6580_670</sweref:sheet>');
+		});
+	});
+});
+
+describe('WGS 84 columns', () => {
+	type App = {
+		computeWgs84Columns(columns: TrackColumns, drift: { dn: number; de: number }): Wgs84Columns;
+		sweref99tm_to_wgs84(northing: number, easting: number): { latitude: number; longitude: number };
+		itrf2Etrs89Correction: { dn: number; de: number };
+	};
+
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>(['computeWgs84Columns', 'sweref99tm_to_wgs84', 'itrf2Etrs89Correction']);
+	});
+
+	test('should match sweref99tm_to_wgs84 for every fix in the chunk', () => {
+		const { columns } = makeColumns(100);
+		const wgs84 = app.computeWgs84Columns(columns, app.itrf2Etrs89Correction);
+
+		for (let i = 0; i < columns.count; i++) {
+			const single = app.sweref99tm_to_wgs84(columns.northing[i], columns.easting[i]);
+			expect(wgs84.latitude[i]).toBe(single.latitude);
+			expect(wgs84.longitude[i]).toBe(single.longitude);
+		}
+	});
+
+	test('should not change the stored SWEREF 99 TM columns', () => {
+		const { columns } = makeColumns(3);
+		const northing = Array.from(columns.northing);
+		app.computeWgs84Columns(columns, app.itrf2Etrs89Correction);
+
+		expect(Array.from(columns.northing)).toEqual(northing);
+	});
+});
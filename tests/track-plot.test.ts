@@ -0,0 +1,295 @@
+/**
+ * Tests for the incremental track plot
+ *
+ * Tests cover:
+ * - Levels of detail built while points are added, and the level chosen
+ *   for a scale
+ * - Constant drawing work per new point, from 100 to 100 000 points
+ * - Full redraws from a simplified level, skipping segments outside the canvas
+ * - Following the newest point until the view is panned
+ * - The plot status line
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface TrackColumns {
+	count: number;
+	timestamp: Float64Array;
+	northing: Float64Array;
+	easting: Float64Array;
+	accuracy: Float64Array;
+	speed: Float64Array;
+}
+
+interface TimingStats {
+	mean: number;
+	p95: number;
+	max: number;
+}
+
+interface TrackPlotStats {
+	fixCount: number;
+	drawnCount: number;
+	tolerance: number;
+	append: TimingStats;
+	redraw: TimingStats;
+}
+
+interface TrackPlotPoints {
+	count: number;
+	northing: Float64Array;
+	easting: Float64Array;
+}
+
+interface TrackPlotLevel {
+	readonly tolerance: number;
+	readonly points: TrackPlotPoints;
+	readonly window: TrackPlotPoints;
+	readonly drawnCount: number;
+	push(northing: number, easting: number): void;
+}
+
+interface TrackPlot {
+	readonly fixCount: number;
+	readonly scale: number;
+	resize(width: number, height: number, pixelRatio: number, color: string): void;
+	clear(): void;
+	load(columns: TrackColumns): void;
+	append(northing: number, easting: number): void;
+	zoom(factor: number): void;
+	pan(dx: number, dy: number): void;
+	fit(): void;
+	stats(): TrackPlotStats;
+}
+
+type App = {
+	TRACK_PLOT_TOLERANCES: readonly number[];
+	TRACK_PLOT_WINDOW_SIZE: number;
+	TrackPlotLevel: new (tolerance: number, windowSize?: number) => TrackPlotLevel;
+	TrackPlot: new (canvas: { width: number; height: number }, context: unknown) => TrackPlot;
+	chooseTrackPlotLevel(metresPerPixel: number): number;
+	createTrackColumns(capacity: number): TrackColumns;
+	handleTrackPlotRequest(plot: TrackPlot, request: { type: string }): Promise<{ type: string; stats: TrackPlotStats } | null>;
+	formatTrackPlotStats(stats: TrackPlotStats): string;
+};
+
+/**
+ * 2D context stand-in that counts the drawing calls
+ */
+function createCountingContext() {
+	const calls = { moveTo: 0, lineTo: 0, stroke: 0, clearRect: 0 };
+	const context = {
+		strokeStyle: '',
+		lineWidth: 1,
+		lineCap: 'butt',
+		lineJoin: 'miter',
+		setTransform: () => undefined,
+		beginPath: () => undefined,
+		clearRect: () => { calls.clearRect++; },
+		moveTo: () => { calls.moveTo++; },
+		lineTo: () => { calls.lineTo++; },
+		stroke: () => { calls.stroke++; }
+	};
+	const reset = () => {
+		calls.moveTo = 0;
+		calls.lineTo = 0;
+		calls.stroke = 0;
+		calls.clearRect = 0;
+	};
+	return { context, calls, reset };
+}
+
+/**
+ * A smooth loop of about 2 × 2 km with GNSS-like noise, one point per metre or so
+ */
+function createLoopColumns(app: App, count: number): TrackColumns {
+	const columns = app.createTrackColumns(count);
+	let state = 11;
+	const noise = () => {
+		state = (state * 1664525 + 1013904223) >>> 0;
+		return (state / 4294967296 - 0.5) * 0.6;
+	};
+	for (let i = 0; i < count; i++) {
+		const angle = i / count * 2 * Math.PI * 16;
+		columns.northing[i] = 6580000 + 1000 * Math.sin(angle) + 300 * Math.sin(angle * 7) + noise();
+		columns.easting[i] = 670000 + 1000 * Math.cos(angle) + noise();
+	}
+	columns.count = count;
+	return columns;
+}
+
+describe('Track plot', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'TRACK_PLOT_TOLERANCES',
+			'TRACK_PLOT_WINDOW_SIZE',
+			'TrackPlotLevel',
+			'TrackPlot',
+			'chooseTrackPlotLevel',
+			'createTrackColumns',
+			'handleTrackPlotRequest',
+			'formatTrackPlotStats'
+		]);
+	});
+
+	const createPlot = () => {
+		const canvas = { width: 0, height: 0 };
+		const counting = createCountingContext();
+		const plot = new app.TrackPlot(canvas, counting.context);
+		plot.resize(400, 300, 1, '#000');
+		return { plot, canvas, ...counting };
+	};
+
+	describe('Levels of detail', () => {
+		it('should keep fewer points at coarser levels', () => {
+			const columns = createLoopColumns(app, 20000);
+			const levels = app.TRACK_PLOT_TOLERANCES.map((tolerance) => new app.TrackPlotLevel(tolerance));
+			for (let i = 0; i < columns.count; i++) {
+				levels.forEach((level) => level.push(columns.northing[i], columns.easting[i]));
+			}
+			expect(levels[0].drawnCount).toBe(20000);
+			for (let i = 1; i < levels.length; i++) {
+				expect(levels[i].drawnCount).toBeLessThan(levels[i - 1].drawnCount);
+				expect(levels[i].window.count).toBeLessThanOrEqual(app.TRACK_PLOT_WINDOW_SIZE);
+			}
+			console.log(`Track plot levels for 20000 points: ${levels.map((level) => `${level.tolerance} m: ${level.drawnCount}`).join(', ')}`);
+		});
+
+		it('should keep the simplified points in order and within tolerance', () => {
+			const columns = createLoopColumns(app, 5000);
+			const level = new app.TrackPlotLevel(4, 256);
+			for (let i = 0; i < columns.count; i++) {
+				level.push(columns.northing[i], columns.easting[i]);
+			}
+			const kept = [
+				...Array.from({ length: level.points.count }, (_, i) => [level.points.northing[i], level.points.easting[i]]),
+				...Array.from({ length: level.window.count }, (_, i) => [level.window.northing[i], level.window.easting[i]])
+			];
+			expect(kept[0]).toEqual([columns.northing[0], columns.easting[0]]);
+			expect(kept[kept.length - 1]).toEqual([columns.northing[4999], columns.easting[4999]]);
+
+			// Varje punkt ska ligga inom toleransen från segmentet mellan de behållna punkterna runt den
+			let segment = 0;
+			for (let i = 0; i < columns.count; i++) {
+				const n = columns.northing[i];
+				const e = columns.easting[i];
+				if (segment + 1 < kept.length && n === kept[segment + 1][0] && e === kept[segment + 1][1]) {
+					segment++;
+					continue;
+				}
+				const [an, ae] = kept[segment];
+				const [bn, be] = kept[Math.min(segment + 1, kept.length - 1)];
+				const length = Math.hypot(bn - an, be - ae);
+				const t = length === 0 ? 0 : Math.max(0, Math.min(1, ((n - an) * (bn - an) + (e - ae) * (be - ae)) / (length * length)));
+				expect(Math.hypot(n - (an + t * (bn - an)), e - (ae + t * (be - ae)))).toBeLessThanOrEqual(4 + 1e-6);
+			}
+			expect(segment).toBe(kept.length - 1);
+		});
+
+		it.each([[0.5, 0], [2, 1], [10, 2], [50, 3], [200, 4], [1000, 5]])(
+			'should draw at %s m per pixel from a level under half a pixel', (metresPerPixel, level) => {
+				expect(app.chooseTrackPlotLevel(metresPerPixel)).toBe(level);
+			});
+	});
+
+	describe('Incremental drawing', () => {
+		it('should draw one segment per new point regardless of track length', () => {
+			const { plot, calls, reset } = createPlot();
+			const perAppend: number[] = [];
+			for (const count of [100, 100000]) {
+				plot.clear();
+				plot.load(createLoopColumns(app, count));
+				plot.fit();
+				reset();
+				for (let i = 0; i < 50; i++) {
+					plot.append(6580000 + i, 670000);
+				}
+				expect(calls.clearRect).toBe(0);
+				expect(calls.stroke).toBe(50);
+				perAppend.push(calls.lineTo / 50);
+			}
+			expect(perAppend).toEqual([1, 1]);
+			console.log(`Track plot: ${plot.stats().append.mean.toFixed(4)} ms per new point at 100000 points`);
+		});
+
+		it('should redraw 100 000 points from a simplified level when zoomed out', () => {
+			const { plot, calls, reset } = createPlot();
+			plot.load(createLoopColumns(app, 100000));
+			reset();
+			plot.fit();
+			const stats = plot.stats();
+			expect(stats.fixCount).toBe(100000);
+			expect(stats.tolerance).toBeGreaterThan(0);
+			expect(stats.drawnCount).toBeLessThan(10000);
+			expect(calls.lineTo).toBe(stats.drawnCount);
+			console.log(`Track plot: redraw of 100000 points drew ${stats.drawnCount} at ${stats.tolerance} m tolerance in ${stats.redraw.max.toFixed(2)} ms`);
+		});
+
+		it('should skip segments outside the canvas', () => {
+			const { plot } = createPlot();
+			plot.load(createLoopColumns(app, 20000));
+			plot.fit();
+			const fitted = plot.stats().drawnCount;
+			plot.zoom(1 / 64);
+			const zoomed = plot.stats();
+			expect(zoomed.tolerance).toBe(0);
+			expect(zoomed.drawnCount).toBeLessThan(fitted);
+			expect(zoomed.drawnCount).toBeLessThan(20000 / 4);
+		});
+	});
+
+	describe('Following', () => {
+		it('should move the view when the newest point nears the edge', () => {
+			const { plot, calls, reset } = createPlot();
+			plot.append(6580000, 670000);
+			reset();
+			// 5 m per pixel: 1 km åt öster är långt utanför 400 pixlar
+			plot.append(6580000, 671000);
+			expect(calls.clearRect).toBe(1);
+		});
+
+		it('should stop following after a pan and resume after fit', () => {
+			const { plot, calls, reset } = createPlot();
+			plot.append(6580000, 670000);
+			plot.pan(10, 0);
+			reset();
+			plot.append(6580000, 671000);
+			expect(calls.clearRect).toBe(0);
+			expect(calls.lineTo).toBe(1);
+
+			plot.fit();
+			reset();
+			plot.append(6580000, 690000);
+			expect(calls.clearRect).toBe(1);
+		});
+	});
+
+	describe('Messages and status', () => {
+		it('should answer a stats request and clear on an empty load', async () => {
+			const { plot } = createPlot();
+			plot.load(createLoopColumns(app, 100));
+			const response = await app.handleTrackPlotRequest(plot, { type: 'stats' });
+			expect(response?.stats.fixCount).toBe(100);
+			await app.handleTrackPlotRequest(plot, { type: 'load', trackId: null, chunkCount: 0 } as { type: string });
+			expect(plot.fixCount).toBe(0);
+		});
+
+		it('should describe the drawn points and the time per new point', () => {
+			const empty = { mean: 0, p95: 0, max: 0 };
+			expect(app.formatTrackPlotStats({ fixCount: 0, drawnCount: 0, tolerance: 0, append: empty, redraw: empty }))
+				.toBe('Ritade 0 av 0\u00A0punkter');
+			expect(app.formatTrackPlotStats({
+				fixCount: 100000,
+				drawnCount: 412,
+				tolerance: 16,
+				append: { mean: 0.0123, p95: 0.02, max: 0.05 },
+				redraw: empty
+			})).toBe('Ritade 412 av 100000\u00A0punkter · 0,012\u00A0ms per ny punkt');
+		});
+	});
+});
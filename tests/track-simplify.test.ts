@@ -0,0 +1,356 @@
+/**
+ * Unit tests for streaming Douglas–Peucker track simplification
+ *
+ * Tests cover:
+ * - Point-to-segment distance in the SWEREF 99 TM plane
+ * - Removal of collinear points and retention of real corners
+ * - Tolerance guarantee for every removed point across window boundaries
+ * - Identical results regardless of how input is split into chunks
+ * - Removed-point statistics
+ */
+
+/**
+ * Types and functions from src/track-store.ts and src/track-simplify.ts -
+ * redefined here for testing. See tests/README.md for details.
+ */
+interface TrackColumns {
+	count: number;
+	timestamp: Float64Array;
+	northing: Float64Array;
+	easting: Float64Array;
+	accuracy: Float64Array;
+	speed: Float64Array;
+}
+
+function createTrackColumns(capacity: number): TrackColumns {
+	return {
+		count: 0,
+		timestamp: new Float64Array(capacity),
+		northing: new Float64Array(capacity),
+		easting: new Float64Array(capacity),
+		accuracy: new Float64Array(capacity),
+		speed: new Float64Array(capacity)
+	};
+}
+
+/**
+ * Result statistics for one simplification run
+ */
+interface TrackSimplifyStats {
+	inputCount: number;
+	outputCount: number;
+	removedCount: number;
+	durationMs: number;
+}
+
+/**
+ * Number of points per Douglas–Peucker window
+ * Large enough that window boundaries rarely keep extra points, small enough
+ * that the quadratic worst case stays cheap.
+ */
+const SIMPLIFY_WINDOW_SIZE = 4096;
+
+/**
+ * Squared distance from point P to segment AB in the projected plane
+ */
+function squaredSegmentDistance(px: number, py: number, ax: number, ay: number, bx: number, by: number): number {
+	let dx = bx - ax;
+	let dy = by - ay;
+	const lengthSq = dx * dx + dy * dy;
+	if (lengthSq > 0) {
+		const t = ((px - ax) * dx + (py - ay) * dy) / lengthSq;
+		if (t > 1) {
+			ax = bx;
+			ay = by;
+		} else if (t > 0) {
+			ax += dx * t;
+			ay += dy * t;
+		}
+	}
+	dx = px - ax;
+	dy = py - ay;
+	return dx * dx + dy * dy;
+}
+
+/**
+ * Marks the points Douglas–Peucker keeps between index 0 and count - 1
+ * Iterative with an explicit stack, so long windows cannot overflow the call stack.
+ *
+ * @param keep - Output flags, 1 for kept points
+ * @param stack - Scratch space of at least 2 * count entries
+ */
+function douglasPeuckerMark(
+	northing: Float64Array,
+	easting: Float64Array,
+	count: number,
+	tolerance: number,
+	keep: Uint8Array,
+	stack: Int32Array
+): void {
+	keep.fill(0, 0, count);
+	if (count === 0) {
+		return;
+	}
+	keep[0] = 1;
+	keep[count - 1] = 1;
+
+	const toleranceSq = tolerance * tolerance;
+	let top = 0;
+	stack[top++] = 0;
+	stack[top++] = count - 1;
+
+	while (top > 0) {
+		const last = stack[--top];
+		const first = stack[--top];
+		let maxDistanceSq = toleranceSq;
+		let index = -1;
+
+		for (let i = first + 1; i < last; i++) {
+			const distanceSq = squaredSegmentDistance(
+				easting[i], northing[i],
+				easting[first], northing[first],
+				easting[last], northing[last]
+			);
+			if (distanceSq > maxDistanceSq) {
+				maxDistanceSq = distanceSq;
+				index = i;
+			}
+		}
+
+		if (index !== -1) {
+			keep[index] = 1;
+			stack[top++] = first;
+			stack[top++] = index;
+			stack[top++] = index;
+			stack[top++] = last;
+		}
+	}
+}
+
+function copyTrackFix(source: TrackColumns, sourceIndex: number, target: TrackColumns, targetIndex: number): void {
+	target.timestamp[targetIndex] = source.timestamp[sourceIndex];
+	target.northing[targetIndex] = source.northing[sourceIndex];
+	target.easting[targetIndex] = source.easting[sourceIndex];
+	target.accuracy[targetIndex] = source.accuracy[sourceIndex];
+	target.speed[targetIndex] = source.speed[sourceIndex];
+}
+
+/**
+ * StreamingSimplifier - Douglas–Peucker över ett glidande fönster
+ *
+ * push() tar emot block i tidsordning och emit() anropas för varje behållen
+ * punkt i samma ordning. finish() måste anropas efter sista blocket.
+ */
+class StreamingSimplifier {
+	private points: TrackColumns;
+	private keep: Uint8Array;
+	private stack: Int32Array;
+	private inputCount: number = 0;
+	private outputCount: number = 0;
+
+	constructor(
+		private tolerance: number,
+		private emit: (columns: TrackColumns, index: number) => void,
+		private windowSize: number = SIMPLIFY_WINDOW_SIZE
+	) {
+		this.points = createTrackColumns(windowSize);
+		this.keep = new Uint8Array(windowSize);
+		this.stack = new Int32Array(windowSize * 2);
+	}
+
+	push(columns: TrackColumns): void {
+		for (let i = 0; i < columns.count; i++) {
+			copyTrackFix(columns, i, this.points, this.points.count++);
+			this.inputCount++;
+			if (this.points.count === this.windowSize) {
+				this.process(false);
+			}
+		}
+	}
+
+	finish(): void {
+		this.process(true);
+	}
+
+	getStats(durationMs: number): TrackSimplifyStats {
+		return {
+			inputCount: this.inputCount,
+			outputCount: this.outputCount,
+			removedCount: this.inputCount - this.outputCount,
+			durationMs
+		};
+	}
+
+	private process(isFinal: boolean): void {
+		const points = this.points;
+		const count = points.count;
+		if (count === 0) {
+			return;
+		}
+
+		douglasPeuckerMark(points.northing, points.easting, count, this.tolerance, this.keep, this.stack);
+
+		// Sista punkten skickas först när fönstret avslutar spåret
+		const emitEnd = isFinal ? count : count - 1;
+		for (let i = 0; i < emitEnd; i++) {
+			if (this.keep[i]) {
+				this.emit(points, i);
+				this.outputCount++;
+			}
+		}
+
+		if (isFinal) {
+			points.count = 0;
+		} else {
+			copyTrackFix(points, count - 1, points, 0);
+			points.count = 1;
+		}
+	}
+}
+
+interface PlanePoint {
+	n: number;
+	e: number;
+}
+
+function makeTrack(points: PlanePoint[]): TrackColumns {
+	const columns = createTrackColumns(points.length);
+	columns.count = points.length;
+	points.forEach((p, i) => {
+		columns.timestamp[i] = i * 1000;
+		columns.northing[i] = p.n;
+		columns.easting[i] = p.e;
+		columns.accuracy[i] = 4;
+		columns.speed[i] = 1.4;
+	});
+	return columns;
+}
+
+/**
+ * Noisy walk with turns, deterministic
+ */
+function makeWalk(count: number): PlanePoint[] {
+	const points: PlanePoint[] = [];
+	let seed = 7;
+	const noise = (): number => {
+		seed = (seed * 1103515245 + 12345) % 2147483648;
+		return seed / 2147483648 - 0.5;
+	};
+	let n = 6580000;
+	let e = 674000;
+	let heading = 0;
+	for (let i = 0; i < count; i++) {
+		if (i % 300 === 0) {
+			heading += 1.2;
+		}
+		n += Math.cos(heading) * 1.4 + noise() * 0.6;
+		e += Math.sin(heading) * 1.4 + noise() * 0.6;
+		points.push({ n, e });
+	}
+	return points;
+}
+
+function simplify(columns: TrackColumns[], tolerance: number, windowSize?: number): { kept: PlanePoint[]; stats: TrackSimplifyStats } {
+	const kept: PlanePoint[] = [];
+	const simplifier = new StreamingSimplifier(tolerance, (c, i) => {
+		kept.push({ n: c.northing[i], e: c.easting[i] });
+	}, windowSize);
+	columns.forEach((c) => simplifier.push(c));
+	simplifier.finish();
+	return { kept, stats: simplifier.getStats(0) };
+}
+
+function splitIntoChunks(points: PlanePoint[], size: number): TrackColumns[] {
+	const chunks: TrackColumns[] = [];
+	for (let i = 0; i < points.length; i += size) {
+		chunks.push(makeTrack(points.slice(i, i + size)));
+	}
+	return chunks;
+}
+
+/**
+ * Distance from each original point to the nearest segment of the simplified line
+ */
+function maxDeviation(original: PlanePoint[], simplified: PlanePoint[]): number {
+	let max = 0;
+	for (const p of original) {
+		let best = Infinity;
+		for (let i = 0; i < simplified.length - 1; i++) {
+			const a = simplified[i];
+			const b = simplified[i + 1];
+			best = Math.min(best, squaredSegmentDistance(p.e, p.n, a.e, a.n, b.e, b.n));
+		}
+		max = Math.max(max, Math.sqrt(best));
+	}
+	return max;
+}
+
+describe('Track simplification', () => {
+	describe('squaredSegmentDistance', () => {
+		test('should measure perpendicular distance inside the segment', () => {
+			expect(squaredSegmentDistance(5, 3, 0, 0, 10, 0)).toBe(9);
+		});
+
+		test('should measure distance to the nearest endpoint outside the segment', () => {
+			expect(squaredSegmentDistance(13, 4, 0, 0, 10, 0)).toBe(25);
+			expect(squaredSegmentDistance(-3, 4, 0, 0, 10, 0)).toBe(25);
+		});
+
+		test('should handle a degenerate segment', () => {
+			expect(squaredSegmentDistance(3, 4, 0, 0, 0, 0)).toBe(25);
+		});
+	});
+
+	describe('StreamingSimplifier', () => {
+		test('should reduce a straight line to its endpoints', () => {
+			const points = Array.from({ length: 1000 }, (_, i) => ({ n: 6580000 + i, e: 674000 + i * 0.5 }));
+			const { kept, stats } = simplify([makeTrack(points)], 0.5);
+			expect(kept).toEqual([points[0], points[999]]);
+			expect(stats.removedCount).toBe(998);
+		});
+
+		test('should keep a corner larger than the tolerance', () => {
+			const points = [
+				{ n: 0, e: 0 }, { n: 50, e: 0 }, { n: 100, e: 0 },
+				{ n: 100, e: 50 }, { n: 100, e: 100 }
+			];
+			const { kept } = simplify([makeTrack(points)], 1);
+			expect(kept).toEqual([points[0], points[2], points[4]]);
+		});
+
+		test('should keep every removed point within tolerance', () => {
+			const points = makeWalk(5000);
+			const { kept } = simplify(splitIntoChunks(points, 256), 2);
+			expect(kept.length).toBeLessThan(points.length / 5);
+			expect(maxDeviation(points, kept)).toBeLessThanOrEqual(2);
+		});
+
+		test('should keep the tolerance guarantee across small windows', () => {
+			const points = makeWalk(3000);
+			const { kept } = simplify(splitIntoChunks(points, 100), 1.5, 64);
+			expect(kept[0]).toEqual(points[0]);
+			expect(kept[kept.length - 1]).toEqual(points[points.length - 1]);
+			expect(maxDeviation(points, kept)).toBeLessThanOrEqual(1.5);
+		});
+
+		test('should not depend on how input is split into chunks', () => {
+			const points = makeWalk(2000);
+			const whole = simplify([makeTrack(points)], 1).kept;
+			const chunked = simplify(splitIntoChunks(points, 37), 1).kept;
+			expect(chunked).toEqual(whole);
+		});
+
+		test('should pass through single points and empty input', () => {
+			expect(simplify([makeTrack([{ n: 1, e: 2 }])], 1).kept).toEqual([{ n: 1, e: 2 }]);
+			expect(simplify([], 1).stats.outputCount).toBe(0);
+		});
+
+		test('should report input, output and removed counts', () => {
+			const points = makeWalk(1000);
+			const { kept, stats } = simplify(splitIntoChunks(points, 256), 3);
+			expect(stats.inputCount).toBe(1000);
+			expect(stats.outputCount).toBe(kept.length);
+			expect(stats.removedCount).toBe(1000 - kept.length);
+		});
+	});
+});
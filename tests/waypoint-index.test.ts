@@ -0,0 +1,249 @@
+/**
+ * Tests for the waypoint grid index and CSV import
+ *
+ * Tests cover:
+ * - Nearest-k results against a brute-force search for spread, clustered
+ *   and duplicate points, and for positions outside the grid
+ * - Query time per fix for 10 000 and 100 000 points
+ * - Parsing of SWEREF 99 TM and WGS84 CSV files
+ * - The nearest waypoint display in the real app
+ *
+ * Loads the actual application via tests/helpers/load-app.ts.
+ * See tests/README.md for details.
+ */
+
+import { loadApp } from './helpers/load-app';
+
+interface WaypointIndexData {
+	names: string[];
+	northing: Float64Array;
+	easting: Float64Array;
+	cellSize: number;
+	columns: number;
+	rows: number;
+}
+
+interface WaypointNeighbor {
+	name: string;
+	northing: number;
+	easting: number;
+	gridDistance: number;
+}
+
+interface WaypointGridIndex {
+	readonly size: number;
+	nearest(northing: number, easting: number, k: number): WaypointNeighbor[];
+}
+
+interface ReplayTrace {
+	name: string;
+	fixes: { latitude: number; longitude: number }[];
+}
+
+interface ReplaySource {
+	whenComplete(): Promise<void>;
+}
+
+type App = {
+	buildWaypointIndex(names: string[], northing: ArrayLike<number>, easting: ArrayLike<number>): WaypointIndexData;
+	WaypointGridIndex: new (data: WaypointIndexData) => WaypointGridIndex;
+	parseWaypointCsv(text: string): { name: string; northing: number; easting: number }[];
+	projectToSweref99tm(latitude: number, longitude: number): { northing: number; easting: number };
+	waypointIndex: WaypointGridIndex | null;
+	createSyntheticTrace(kind: string, durationSeconds?: number, rateHz?: number): ReplayTrace;
+	ReplayPositionSource: new (trace: ReplayTrace, speedFactor?: number) => ReplaySource;
+	startGeolocationWatch(onError: (error: GeolocationPositionError) => void): void;
+	stopGeolocationWatch(): void;
+	handlePositionError(error: GeolocationPositionError): void;
+	positionSource: unknown;
+};
+
+/**
+ * Deterministic uniform samples in [0, 1)
+ */
+function createRandom(seed: number): () => number {
+	let state = seed;
+	return () => {
+		state = (state * 16807) % 2147483647;
+		return state / 2147483647;
+	};
+}
+
+function bruteForceDistances(northing: Float64Array, easting: Float64Array, queryNorth: number, queryEast: number, k: number): number[] {
+	const distances = Array.from(northing, (north, i) => Math.hypot(north - queryNorth, easting[i] - queryEast));
+	return distances.sort((a, b) => a - b).slice(0, k);
+}
+
+describe('Waypoint index', () => {
+	let app: App;
+
+	beforeAll(() => {
+		app = loadApp<App>([
+			'buildWaypointIndex',
+			'WaypointGridIndex',
+			'parseWaypointCsv',
+			'projectToSweref99tm',
+			'waypointIndex',
+			'createSyntheticTrace',
+			'ReplayPositionSource',
+			'startGeolocationWatch',
+			'stopGeolocationWatch',
+			'handlePositionError',
+			'positionSource'
+		]);
+	});
+
+	afterAll(() => {
+		app.stopGeolocationWatch();
+	});
+
+	const createIndex = (northing: Float64Array, easting: Float64Array) => {
+		const names = Array.from(northing, (_, i) => `P${i}`);
+		return new app.WaypointGridIndex(app.buildWaypointIndex(names, northing, easting));
+	};
+
+	describe('Nearest points', () => {
+		it('should find nothing in an empty index', () => {
+			const index = createIndex(new Float64Array(0), new Float64Array(0));
+			expect(index.size).toBe(0);
+			expect(index.nearest(6580000, 674000, 3)).toEqual([]);
+		});
+
+		it('should return all points, closest first, when k exceeds the count', () => {
+			const index = createIndex(Float64Array.of(6580010, 6580000, 6580100), Float64Array.of(674000, 674000, 674000));
+			const neighbors = index.nearest(6580001, 674000, 5);
+			expect(neighbors.map((neighbor) => neighbor.name)).toEqual(['P1', 'P0', 'P2']);
+			expect(neighbors[0].gridDistance).toBeCloseTo(1, 9);
+		});
+
+		it('should match brute force for points spread over a municipality', () => {
+			const random = createRandom(3);
+			const count = 5000;
+			const northing = Float64Array.from({ length: count }, () => 6560000 + 40000 * random());
+			const easting = Float64Array.from({ length: count }, () => 650000 + 40000 * random());
+			const index = createIndex(northing, easting);
+
+			for (let query = 0; query < 200; query++) {
+				// Även positioner långt utanför punkternas utbredning
+				const queryNorth = 6500000 + 160000 * random();
+				const queryEast = 600000 + 140000 * random();
+				const expected = bruteForceDistances(northing, easting, queryNorth, queryEast, 5);
+				const found = index.nearest(queryNorth, queryEast, 5).map((neighbor) => neighbor.gridDistance);
+				found.forEach((distance, i) => expect(distance).toBeCloseTo(expected[i], 6));
+			}
+		});
+
+		it('should match brute force for clustered and duplicate points', () => {
+			const random = createRandom(5);
+			const northing: number[] = [];
+			const easting: number[] = [];
+			// Tätt packade grundpunkter i några få byar, plus enstaka punkter i glesbygd
+			for (let cluster = 0; cluster < 4; cluster++) {
+				const centerNorth = 6400000 + 800000 * random();
+				const centerEast = 300000 + 500000 * random();
+				for (let i = 0; i < 1000; i++) {
+					northing.push(centerNorth + 50 * random());
+					easting.push(centerEast + 50 * random());
+				}
+			}
+			for (let i = 0; i < 20; i++) {
+				northing.push(northing[i]);
+				easting.push(easting[i]);
+				northing.push(6200000 + 1400000 * random());
+				easting.push(270000 + 650000 * random());
+			}
+			const northingArray = Float64Array.from(northing);
+			const eastingArray = Float64Array.from(easting);
+			const index = createIndex(northingArray, eastingArray);
+
+			for (let query = 0; query < 200; query++) {
+				const source = Math.floor(random() * northing.length);
+				const queryNorth = northing[source] + 2000 * (random() - 0.5);
+				const queryEast = easting[source] + 2000 * (random() - 0.5);
+				const expected = bruteForceDistances(northingArray, eastingArray, queryNorth, queryEast, 3);
+				const found = index.nearest(queryNorth, queryEast, 3).map((neighbor) => neighbor.gridDistance);
+				found.forEach((distance, i) => expect(distance).toBeCloseTo(expected[i], 6));
+			}
+		});
+
+		it('should keep names and coordinates together when sorting into cells', () => {
+			const index = createIndex(Float64Array.of(6600000, 6500000, 6700000), Float64Array.of(500000, 600000, 700000));
+			expect(index.nearest(6500001, 600001, 1)[0]).toMatchObject({ name: 'P1', northing: 6500000, easting: 600000 });
+		});
+	});
+
+	describe('Benchmark', () => {
+		it.each([10000, 100000])('should find the nearest 3 of %s points in well under a millisecond', (count) => {
+			const random = createRandom(9);
+			const northing = Float64Array.from({ length: count }, () => 6150000 + 1500000 * random());
+			const easting = Float64Array.from({ length: count }, () => 260000 + 660000 * random());
+			const buildStart = performance.now();
+			const index = createIndex(northing, easting);
+			const buildTime = performance.now() - buildStart;
+
+			const queries = 10000;
+			let checksum = 0;
+			const start = performance.now();
+			for (let query = 0; query < queries; query++) {
+				checksum += index.nearest(6150000 + 1500000 * random(), 260000 + 660000 * random(), 3)[0].gridDistance;
+			}
+			const perQuery = (performance.now() - start) / queries;
+
+			console.log(`Waypoint index, ${count} points: built in ${buildTime.toFixed(1)} ms, ${(perQuery * 1000).toFixed(1)} µs per nearest-3 query`);
+			expect(checksum).toBeGreaterThan(0);
+			expect(perQuery).toBeLessThan(0.1);
+		});
+	});
+
+	describe('CSV import', () => {
+		it('should read SWEREF 99 TM coordinates and skip a header', () => {
+			const waypoints = app.parseWaypointCsv('namn,N,E\nGP1,6580822.5,674032\n"GP 2",6580900,674100\n\n');
+			expect(waypoints).toEqual([
+				{ name: 'GP1', northing: 6580822.5, easting: 674032 },
+				{ name: 'GP 2', northing: 6580900, easting: 674100 }
+			]);
+		});
+
+		it('should accept semicolons and tabs with decimal commas', () => {
+			const waypoints = app.parseWaypointCsv('A;6580822,5;674032,25\r\nB\t6580000,75\t674000');
+			expect(waypoints).toEqual([
+				{ name: 'A', northing: 6580822.5, easting: 674032.25 },
+				{ name: 'B', northing: 6580000.75, easting: 674000 }
+			]);
+		});
+
+		it('should project WGS84 latitude and longitude', () => {
+			const [waypoint] = app.parseWaypointCsv('Slottet,59.3268,18.0717');
+			const expected = app.projectToSweref99tm(59.3268, 18.0717);
+			expect(waypoint.northing).toBeCloseTo(expected.northing, 6);
+			expect(waypoint.easting).toBeCloseTo(expected.easting, 6);
+		});
+
+		it('should skip lines without a name or two numbers', () => {
+			expect(app.parseWaypointCsv(',6580000,674000\nC,abc,674000\nD,6580000')).toEqual([]);
+		});
+	});
+
+	describe('Display', () => {
+		it('should show the nearest waypoints with distance and bearing', async () => {
+			const trace = app.createSyntheticTrace('walking', 30);
+			const last = trace.fixes[trace.fixes.length - 1];
+			const here = app.projectToSweref99tm(last.latitude, last.longitude);
+			// En punkt rakt norrut i rutnätet och en längre bort österut
+			const data = app.buildWaypointIndex(
+				['Norr', 'Öster'],
+				[here.northing + 150, here.northing],
+				[here.easting, here.easting + 2500]
+			);
+			app.waypointIndex = new app.WaypointGridIndex(data);
+
+			const source = new app.ReplayPositionSource(trace, Number.POSITIVE_INFINITY);
+			app.stopGeolocationWatch();
+			app.positionSource = source;
+			app.startGeolocationWatch(app.handlePositionError);
+			await source.whenComplete();
+
+			expect(document.getElementById('waypoint-nearest')?.textContent).toMatch(/^Norr 1\d{2}\sm (35[0-9]|[0-9])°\nÖster 2,\d{2}\skm (8\d|9\d)°$/);
+		});
+	});
+});